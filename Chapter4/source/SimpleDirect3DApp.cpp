@@ -37,45 +37,45 @@ void SimpleDirect3DApp::Update(const Engine::GameTimer& gt) { }
 
 void SimpleDirect3DApp::Draw(const Engine::GameTimer& gt)
 {
-	//  Ҵ ʱȭ
+	// 명령 할당자 초기화
 	ThrowIfFailed(mDirectCmdListAlloc->Reset());
 
-	//   ʱȭ
+	// 명령 목록 초기화
 	ThrowIfFailed(mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr));
 
-	//  ۸  Ÿ · ȯ
+	// 현재 백버퍼를 렌더 타겟 상태로 전환
     mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(
         CurrentBackBuffer(),
         D3D12_RESOURCE_STATE_PRESENT,	D3D12_RESOURCE_STATE_RENDER_TARGET));
 
-	// Ʈ  簢 . ̴   ʱȭ    
+	// 뷰포트와 가위 사각형을 설정. 이는 명령 목록이 초기화 될 때마다 설정해줘야 함
     mCommandList->RSSetViewports(1, &mScreenViewport);
 	mCommandList->RSSetScissorRects(1, &mScissorRect);
 
-    //  ۿ  ۸ ʱȭ
+    // 현재 백버퍼와 깊이 버퍼를 초기화
     mCommandList->ClearRenderTargetView(CurrentBackBufferView(),
 		Colors::LightSteelBlue, 0, nullptr);
     mCommandList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
 
-	//  ۿ  ۸  Ÿ 
+	// 현재 백버퍼와 깊이 버퍼를 렌더 타겟으로 설정
 	mCommandList->OMSetRenderTargets(1, &CurrentBackBufferView(), true, &DepthStencilView());
 
-    //  ۸ Ʈ · ȯ
+    // 현재 백버퍼를 프레젠트 상태로 전환
     mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(
         CurrentBackBuffer(),
 		D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
 
-	//   ݰ, 
+	// 명령 목록을 닫고, 실행
 	ThrowIfFailed(mCommandList->Close());
 
 	ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
 	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
-	//  ü Ʈ
+	// 스왑 체인 프레젠트
 	ThrowIfFailed(mSwapChain->Present(0, 0));
-	mCurrentBackBuffer = (mCurrentBackBuffer + 1) % SwapChainBufferCount;
+	mCurrentBackBuffer = (mCurrentBackBuffer + 1) % mSwapChainBufferCount;
 
-	// GPU  Ϸ  
+	// GPU가 명령을 완료할 때까지 대기
 	FlushCommandQueue();
 }
 
@@ -19,7 +19,7 @@ VertexOut VS(VertexIn vin)
 {
     VertexOut vout;
     
-    //    ȯ
+    // 동차 절단 공간으로 변환
     vout.PosH = mul(float4(vin.PosL, 1.0f), gWorldViewProj);
     vout.Color = vin.Color;
     
@@ -2,14 +2,10 @@
 
 using namespace Engine;
 
-FrameResource::FrameResource(ID3D12Device* device, UINT passCount, UINT objectCount)
+FrameResource::FrameResource(ID3D12Device* device, const ObjectBindingLayout& objectLayout)
 {
-	ThrowIfFailed(device->CreateCommandAllocator(
-		D3D12_COMMAND_LIST_TYPE_DIRECT,
-		IID_PPV_ARGS(CmdListAlloc.GetAddressOf())));
-
-	PassCB = std::make_unique<Engine::UploadBuffer<PassConstants>>(device, passCount, true);
-	ObjectCB = std::make_unique<Engine::UploadBuffer<ObjectConstants>>(device, objectCount, true);
+	// 구조적 버퍼로 읽는 방식이면 256 바이트 정렬이 필요 없다.
+	ObjectBuffer = std::make_unique<UploadBuffer<ObjectConstants>>(device, objectLayout.ObjectCount, objectLayout.UsesConstantBufferView());
 }
 
 FrameResource::~FrameResource()
@@ -1,7 +1,10 @@
 #pragma once
 #include "Util.h"
 #include "MathHelper.h"
+#include "UploadRing.h"
+#include "DescriptorHeap.h"
 #include "UploadBuffer.h"
+#include "ObjectBindingLayout.h"
 
 struct ObjectConstants
 {
@@ -26,28 +29,25 @@ struct PassConstants
 	float DeltaTime = 0.0f;
 };
 
-struct Vertex
-{
-	DirectX::XMFLOAT3 Pos;
-	DirectX::XMFLOAT4 Color;
-};
-
 struct FrameResource
 {
 public:
-	FrameResource(ID3D12Device* device, UINT passCount, UINT objectCount);
+	// 객체 버퍼의 크기와 요소 간격은 objectLayout을 따른다.
+	FrameResource(ID3D12Device* device, const Engine::ObjectBindingLayout& objectLayout);
 	FrameResource(const FrameResource& rhs) = delete;
 	FrameResource& operator=(const FrameResource& rhs) = delete;
 	~FrameResource();
 
-	// (GPU  óϱ  Ҵڸ 缳ؼ ȵǹǷ)  Ӹ  Ҵڰ ʿ.
-	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CmdListAlloc;
-
-	//  Ӹ   ۰ ʿ
-	std::unique_ptr<Engine::UploadBuffer<PassConstants>> PassCB = nullptr;
-	std::unique_ptr<Engine::UploadBuffer<ObjectConstants>> ObjectCB = nullptr;
+	// 이 프레임의 패스 상수 버퍼. 업로드 링에서 매 프레임 새로 할당되며 Fence가 완료되면 회수된다.
+	Engine::UploadAllocation PassCB;
+	// PassCB를 가리키는 CBV. 서술자 힙의 프레임 링에서 할당된다.
+	Engine::DescriptorAllocation PassCbv;
+	// 이 프레임의 인스턴스 -> 객체 인덱스 배열 (셰이더의 gInstanceObjects). 업로드 링에서 할당된다.
+	Engine::UploadAllocation InstanceObjects;
+	// 객체 행렬 버퍼는 프레임 리소스마다 계속 유지하고, 이 프레임 리소스에서 바뀐 객체만 다시 기록한다.
+	std::unique_ptr<Engine::UploadBuffer<ObjectConstants>> ObjectBuffer;
 
-	// GPU   ҽ óߴ ϴ  
+	// GPU가 이 프레임 리소스를 처리했는지 추적하는 데 사용
 	UINT64 Fence = 0;
 };
 
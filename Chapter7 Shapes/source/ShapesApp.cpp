@@ -1,7 +1,18 @@
 #include "Application.h"
 #include "MathHelper.h"
-#include "UploadBuffer.h"
+#include "UploadRing.h"
 #include "GeometryGenerator.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "VertexEncoder.h"
+#include "MeshCache.h"
+#include "ParallelCommandRecorder.h"
+#include "TransformArray.h"
+#include "InstanceBatcher.h"
+#include "DrawQueue.h"
+#include "ResourceRegistry.h"
+#include "ObjectBinding.h"
+#include "PipelineCache.h"
 #include "FrameResource.h"
 
 using namespace Engine;
@@ -9,7 +20,64 @@ using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 using namespace DirectX::PackedVector;
 
-const int gNumFrameResources = 3;
+// 모든 프레임 리소스의 상수가 공유하는 업로드 링 크기
+const UINT64 gUploadRingByteSize = 256 * 1024;
+
+// 객체 행렬을 구조적 버퍼에 두고 루트 상수로 인덱스를 넘긴다. 객체마다 서술자를 만들지 않는다.
+// 인스턴스로 묶어 그리므로 루트 상수는 객체 인덱스가 아니라 묶음의 시작 위치이고, 셰이더가 gInstanceObjects로 객체를 찾는다.
+constexpr ObjectBindingMode gObjectBindingMode = ObjectBindingMode::RootConstantIndex;
+// 다른 방식은 셰이더가 cbuffer로 객체 상수를 읽어야 하는데, color.hlsl은 64 바이트 간격의 구조적 버퍼만 읽는다.
+static_assert(gObjectBindingMode == ObjectBindingMode::RootConstantIndex,
+	"color.hlsl reads object constants from a structured buffer indexed through a root constant");
+
+// 컬링에서 작업 하나가 처리할 렌더 아이템 수
+const size_t gRitemsPerJob = 64;
+
+// 명령 목록 하나에 기록할 최소 그리기 호출 수. 그리기가 적으면 목록을 나누지 않는다.
+const std::uint64_t gMinDrawsPerCommandList = 8;
+
+// 카메라와의 거리가 이 값만큼 멀어질 때마다 한 단계 낮은 LOD를 사용
+const float gLodDistanceStep = 15.0f;
+
+// 셰이더가 사용하는 위치와 색상만 압축해서 저장 (정점당 12 바이트)
+const VertexFormat gVertexFormat = { PositionEncoding::Unorm16x4, false, false, false, true };
+
+// 도형 생성 매개변수. 캐시 해시에 포함되므로 값이 바뀌면 다시 굽는다.
+struct ShapeBakeSettings
+{
+	// 생성/최적화 코드가 바뀌어 같은 매개변수에서 결과가 달라지면 올린다.
+	std::uint32_t Revision = 1;
+
+	float BoxWidth = 1.5f, BoxHeight = 0.5f, BoxDepth = 1.5f;
+	std::uint32_t BoxSubdivisions = 3;
+	float GridWidth = 20.0f, GridDepth = 30.0f;
+	std::uint32_t GridRows = 60, GridColumns = 40;
+	float SphereRadius = 0.5f;
+	std::uint32_t SphereSlices = 20, SphereStacks = 20;
+	float CylinderBottomRadius = 0.5f, CylinderTopRadius = 0.3f, CylinderHeight = 3.0f;
+	std::uint32_t CylinderSlices = 20, CylinderStacks = 20;
+
+	// 같은 정점 버퍼를 공유하는 LOD의 원본 대비 삼각형 비율과 허용 오차
+	float LodRatios[2] = { 0.5f, 0.25f };
+	float LodMaxError = 0.02f;
+};
+const ShapeBakeSettings gShapeBake = {};
+
+const wchar_t* gShapeCacheFilename = L"shapes.meshcache";
+// 컴파일된 PSO를 저장하는 파이프라인 라이브러리. 드라이버가 바뀌면 무시되고 다시 만들어진다.
+const wchar_t* gPipelineCacheFilename = L"shapes.psocache";
+
+// 로드 시점에 핸들을 찾을 때만 쓰는 자원 이름 (컴파일 시간 해시). 프레임 중에는 핸들만 사용한다.
+constexpr NameHash gShapeGeoName = HashName("shapeGeo");
+constexpr NameHash gStandardVSName = HashName("standardVS");
+constexpr NameHash gOpaquePSName = HashName("opaquePS");
+constexpr NameHash gOpaquePSOName = HashName("opaque");
+constexpr NameHash gOpaqueWireframePSOName = HashName("opaque_wireframe");
+
+using GeometryHandle = ResourceRegistry<std::unique_ptr<MeshGeometry>>::HandleType;
+using SubmeshHandle = ResourceRegistry<SubmeshGeometry>::HandleType;
+using ShaderHandle = ResourceRegistry<ComPtr<ID3DBlob>>::HandleType;
+using PipelineHandle = ResourceRegistry<ComPtr<ID3D12PipelineState>>::HandleType;
 
 struct RenderItem
 {
@@ -17,20 +85,67 @@ struct RenderItem
 
 	XMFLOAT4X4 World = MathHelper::Identity4x4();
 
-	//    Ǿ 
-	int NumFramesDirty = gNumFrameResources;
-	
-	//   ü  ۿ ϴ GPU   ε 
+	// 압축된 정점 위치를 메쉬 공간으로 복원하는 변환 (World 앞에 곱해진다)
+	XMFLOAT4X4 PositionDecode = MathHelper::Identity4x4();
+
+	// 랜더링할 아이템의 행렬이 들어 있는 객체 버퍼 인덱스 (셰이더의 gObjects 인덱스)
 	UINT ObjCBIndex = -1;
 
-	MeshGeometry* Geo = nullptr;
+	// Geo.Index는 정렬 키와 상태 비교에 쓰는 지오메트리 id
+	GeometryHandle Geo;
 
 	D3D12_PRIMITIVE_TOPOLOGY PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
-	// DrawIndexedInstanced ʿ ε  
+	// DrawIndexedInstanced에 필요한 인덱스 버퍼 정보
 	UINT IndexCount = 0;
 	UINT StartIndexLocation = 0;
 	int BaseVertexLocation = 0;
+
+	// 거리에 따라 선택할 인덱스 구간 (Lods[0]은 원본). 비어 있으면 항상 원본을 그린다.
+	std::vector<SubmeshGeometry> Lods;
+
+	// 절두체 컬링에 사용하는 메쉬 공간 경계 상자 (World로 변환해서 검사)
+	BoundingBox Bounds;
+};
+
+// 지오메트리를 만들 때 한 번 계산해 둔 버퍼 뷰 (그리기마다 GetGPUVirtualAddress를 호출하지 않는다)
+struct GeometryBinding
+{
+	D3D12_VERTEX_BUFFER_VIEW VertexBufferView = {};
+	D3D12_INDEX_BUFFER_VIEW IndexBufferView = {};
+};
+
+// 이 값이 같은 렌더 아이템은 인스턴스 그리기 한 번으로 묶는다. (LOD가 다르면 인덱스 구간이 달라 다른 묶음이 된다)
+struct DrawBatchKey
+{
+	UINT Geometry = 0;
+	UINT Pipeline = 0;
+	D3D12_PRIMITIVE_TOPOLOGY PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	UINT IndexCount = 0;
+	UINT StartIndexLocation = 0;
+	int BaseVertexLocation = 0;
+
+	bool operator==(const DrawBatchKey& rhs) const
+	{
+		return Geometry == rhs.Geometry && Pipeline == rhs.Pipeline && PrimitiveType == rhs.PrimitiveType &&
+			IndexCount == rhs.IndexCount && StartIndexLocation == rhs.StartIndexLocation &&
+			BaseVertexLocation == rhs.BaseVertexLocation;
+	}
+};
+
+struct DrawBatchKeyHash
+{
+	size_t operator()(const DrawBatchKey& key) const
+	{
+		std::uint64_t h = key.Geometry;
+		auto mix = [&h](std::uint64_t value) { h = (h ^ value) * 0x9E3779B97F4A7C15ull; };
+		mix(key.Pipeline);
+		mix((std::uint64_t)key.PrimitiveType);
+		mix(key.IndexCount);
+		mix(key.StartIndexLocation);
+		mix((std::uint32_t)key.BaseVertexLocation);
+		return (size_t)(h ^ (h >> 29));
+	}
 };
 
 class ShapesApp : public Application
@@ -46,6 +161,7 @@ private:
 	virtual void OnResize() override;
 	virtual void Update(const GameTimer& gt) override;
 	virtual void Draw(const GameTimer& gt) override;
+	virtual std::wstring GetFrameStatsText() const override;
 
 	virtual void OnMouseDown(WPARAM btnState, int x, int y) override;
 	virtual void OnMouseUp(WPARAM btnState, int x, int y) override;
@@ -53,44 +169,100 @@ private:
 
 	void OnKeyboardInput(const GameTimer& gt);
 	void UpdateCamera(const GameTimer& gt);
-	void UpdateObjectCBs(const GameTimer& gt);
+	void UpdateObjectBuffer(const GameTimer& gt);
+	// ri의 World가 바뀌면 호출해서 객체 버퍼에 쓸 행렬을 갱신한다.
+	void UpdateObjectTransform(const RenderItem* ri);
 	void UpdateMainPassCB(const GameTimer& gt);
+	void CullRenderItems();
+	void BuildDrawBatches();
 
-	void BuildDescriptorHeaps();
-	void BuildConstantBufferViews();
 	void BuildRootSignature();
 	void BuildShadersAndInputLayout();
 	void BuildShapeGeometry();
+	void BakeShapeGeometry(MeshCacheFile& cache, std::uint64_t paramHash);
 	void BuildPSOs();
 	void BuildFrameResources();
 	void BuildRenderItems();
-	void DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::vector<RenderItem*>& ritems);
+	void AddGeometryBinding(GeometryHandle geo);
+	void SetPassState(ID3D12GraphicsCommandList* cmdList);
+	void SetPassRootArguments(ID3D12GraphicsCommandList* cmdList);
+
+	// DrawQueue::Submit이 바뀐 상태만 명령 목록에 기록하도록 연결
+	struct DrawSink
+	{
+		ShapesApp* App = nullptr;
+		ID3D12GraphicsCommandList* CmdList = nullptr;
+
+		void SetRootSignature(std::uint32_t id);
+		void SetPipelineState(std::uint32_t id);
+		void SetGeometry(std::uint32_t id);
+		void SetPrimitiveTopology(std::uint32_t topology);
+		void Draw(const DrawItem& item);
+	};
 
 private:
 	std::vector<std::unique_ptr<FrameResource>> mFrameResources;
 	FrameResource* mCurrFrameResource = nullptr;
 	int mCurrFrameResourceIndex = 0;
 
+	// 프레임별 상수 버퍼를 나누어 주는 업로드 링
+	std::unique_ptr<UploadRing> mUploadRing;
+
+	// 객체 버퍼 배치와 그리기마다의 객체 인자 설정
+	ObjectBinding mObjectBinding;
+
+	// 객체 버퍼에 쓸 행렬 (PositionDecode * World). ObjCBIndex로 접근하며, 프레임 리소스마다 바뀐 항목을 추적한다.
+	TransformArray mObjectTransforms;
+
+	// 보이는 아이템을 같은 지오메트리/서브메쉬/PSO/토폴로지끼리 묶는다.
+	InstanceBatcher<DrawBatchKey, DrawBatchKeyHash> mDrawBatcher;
+	// 묶음마다 가장 가까운 인스턴스까지의 거리 (앞에서 뒤로 그리기 위한 정렬 키)
+	std::vector<float> mBatchDepths;
+	// 묶음을 정렬 키 순서로 정렬한 이번 프레임의 그리기
+	DrawQueue mDrawQueue;
+	// 마지막 프레임에 기록한 상태 변경과 생략한 상태 변경 수
+	DrawStateStats mDrawStats;
+
+	// 렌더 아이템을 여러 스레드에서 나누어 기록
+	std::unique_ptr<ParallelCommandRecorder> mRecorder;
+
 	ComPtr<ID3D12RootSignature> mRootSignature = nullptr;
-	ComPtr<ID3D12DescriptorHeap> mCbvHeap = nullptr;
 	ComPtr<ID3D12DescriptorHeap> mSrvDescriptorHeap = nullptr;
 
-	std::unordered_map<std::string, std::unique_ptr<MeshGeometry>> mGeometries;
-	std::unordered_map<std::string, ComPtr<ID3DBlob>> mShaders;
-	std::unordered_map<std::string, ComPtr<ID3D12PipelineState>> mPSOs;
+	// 이름은 로드할 때 핸들을 찾는 데만 쓰고, 프레임 중에는 핸들로 배열을 바로 색인한다.
+	ResourceRegistry<std::unique_ptr<MeshGeometry>> mGeometries;
+	ResourceRegistry<SubmeshGeometry> mSubmeshes;
+	ResourceRegistry<ComPtr<ID3DBlob>> mShaders;
+	ResourceRegistry<ComPtr<ID3D12PipelineState>> mPSOs;
+	// 지오메트리 핸들의 Index로 색인
+	std::vector<GeometryBinding> mGeometryBindings;
+
+	GeometryHandle mShapeGeo;
+	ShaderHandle mStandardVS;
+	ShaderHandle mOpaquePS;
+	PipelineHandle mOpaquePSO;
+	PipelineHandle mOpaqueWireframePSO;
 
 	std::vector<D3D12_INPUT_ELEMENT_DESC> mInputLayout;
 
 	std::vector<std::unique_ptr<RenderItem>> mAllRitems;
-	// PSO    з
+	// PSO 별로 렌더 아이템을 분류
 	std::vector<RenderItem*> mOpaqueRitems;
+	// 이번 프레임에 절두체 안에 있는 불투명 아이템 (mOpaqueRitems의 순서 유지)
+	std::vector<RenderItem*> mVisibleRitems;
+	std::vector<std::uint8_t> mRitemVisible;
 
 	PassConstants mMainPassCB;
 
-	UINT mPassCbvOffset = 0;
-
 	bool mIsWireframe = false;
 
+	// 현재 PSO들을 만들 때 사용한 4x MSAA 상태. 바뀌면 PSO를 다시 만든다.
+	bool mPsoMsaaState = false;
+
+	// PSO 서술 해시로 찾는 디스크 PSO 캐시. 키에는 루트 시그니처 대신 직렬화된 루트 시그니처의 해시가 들어간다.
+	std::unique_ptr<PipelineCache> mPipelineCache;
+	std::uint64_t mRootSignatureHash = 0;
+
 	XMFLOAT3 mEyePos = { 0.0f, 0.0f, 0.0f };
 	XMFLOAT4X4 mView = MathHelper::Identity4x4();
 	XMFLOAT4X4 mProj = MathHelper::Identity4x4();
@@ -105,7 +277,7 @@ private:
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance,
 	PSTR cmdLine, int showCmd)
 {
-	//   , ޸  ˻
+	// 디버깅 빌드 시, 메모리 누수 검사
 #if defined(DEBUG) | defined(_DEBUG)
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
@@ -129,7 +301,7 @@ ShapesApp::ShapesApp(HINSTANCE hInstance) : Application(hInstance)
 
 ShapesApp::~ShapesApp()
 {
-	if (mD3DDevice != nullptr) FlushCommandQueue();
+	if (mFence != nullptr) FlushCommandQueue();
 }
 
 bool ShapesApp::Initialize()
@@ -137,33 +309,24 @@ bool ShapesApp::Initialize()
 	if (!Application::Initialize())
 		return false;
 
-	// ʱȭ ɵ  Ŀǵ  ʱȭ
-	ThrowIfFailed(mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr));
-
-	// Ʈ ñ״ó 
+	// 루트 시그니처 생성
 	BuildRootSignature();
-	// ̴  Է ̾ƿ 
+	// 셰이더 및 입력 레이아웃 생성
 	BuildShadersAndInputLayout();
-	//  Ʈ 
+	// 도형 지오메트리 생성
 	BuildShapeGeometry();
-	//   
+	// 렌더 아이템 생성
 	BuildRenderItems();
-	//  ҽ 
+	// 프레임 리소스 생성
 	BuildFrameResources();
-	//   
-	BuildDescriptorHeaps();
-	//    
-	BuildConstantBufferViews();
-	//   ü(PSO) 
+	// 파이프라인 상태 객체(PSO) 생성. 캐시 파일에 있으면 컴파일하지 않는다.
+	mPipelineCache = std::make_unique<PipelineCache>(mD3DDevice.Get(), gPipelineCacheFilename);
 	BuildPSOs();
+	// 다음 실행이 컴파일 없이 시작하도록 바로 저장한다. (MSAA를 바꾸며 생긴 PSO는 종료할 때 저장된다)
+	mPipelineCache->Save();
 
-	// ʱȭ Ŀǵ 
-	ThrowIfFailed(mCommandList->Close());
-	ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
-	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
-
-	// GPU ʱȭ Ŀǵ带 Ϸ  
-	FlushCommandQueue();
+	// 지오메트리 업로드를 복사 큐에 제출하고, 그래픽 큐는 CPU를 막지 않고 GPU에서 복사 완료를 기다린다.
+	mUploadBatcher->WaitGPU(mCommandQueue.Get(), mUploadBatcher->Flush());
 
 	return true;
 }
@@ -172,7 +335,11 @@ void ShapesApp::OnResize()
 {
 	Application::OnResize();
 
-	//   Ʈ
+	// F2로 4x MSAA가 바뀌면 샘플 설정이 맞지 않으므로 PSO를 교체한다.
+	if (mPSOs.GetCount() != 0 && mPsoMsaaState != m4xMsaaState)
+		BuildPSOs();
+
+	// 투영 행렬 업데이트
 	XMMATRIX P = XMMatrixPerspectiveFovLH(0.25f * MathHelper::Pi, AspectRatio(), 1.0f, 1000.0f);
 	XMStoreFloat4x4(&mProj, P);
 }
@@ -182,74 +349,96 @@ void ShapesApp::Update(const GameTimer& gt)
 	OnKeyboardInput(gt);
 	UpdateCamera(gt);
 
-	//   ҽ ̵
-	mCurrFrameResourceIndex = (mCurrFrameResourceIndex + 1) % gNumFrameResources;
+	// 다음 프레임 리소스로 이동
+	mCurrFrameResourceIndex = (mCurrFrameResourceIndex + 1) % mNumFrameResources;
 	mCurrFrameResource = mFrameResources[mCurrFrameResourceIndex].get();
 
-	// GPU   ҽ óߴ Ȯ
-	if(mCurrFrameResource->Fence != 0 && mFence->GetCompletedValue() < mCurrFrameResource->Fence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-		ThrowIfFailed(mFence->SetEventOnCompletion(mCurrFrameResource->Fence, eventHandle));
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	// GPU가 이 프레임 리소스를 처리했는지 확인
+	mFence->WaitCPU(mCurrFrameResource->Fence);
+
+	// GPU가 끝낸 프레임들의 상수 버퍼 공간 회수
+	mUploadRing->Retire();
 
-	UpdateObjectCBs(gt);
+	// 컬링은 작업 스레드에서 상수 버퍼 갱신과 동시에 진행
+	JobCounter cullJobs;
+	mJobs->Run([this]() { CullRenderItems(); }, &cullJobs);
+
+	UpdateObjectBuffer(gt);
 	UpdateMainPassCB(gt);
+
+	mJobs->Wait(cullJobs);
+
+	BuildDrawBatches();
 }
 
 void ShapesApp::Draw(const GameTimer& gt)
 {
-	auto cmdListAlloc = mCurrFrameResource->CmdListAlloc;
-
-	ThrowIfFailed(cmdListAlloc->Reset());
-
-	if (mIsWireframe)
+	// 정렬된 그리기를 비슷한 크기의 연속 구간으로 나누어, 구간마다 별도의 명령 목록에 병렬로 기록한다.
+	// 묶음마다 그리기 호출은 한 번이므로 기록 비용은 인스턴스 수와 관계없이 같다.
+	std::vector<std::uint64_t> drawCosts(mDrawQueue.GetCount(), 1);
+	std::vector<RecordRange> ranges = PartitionRecordRanges(drawCosts, mJobs->GetThreadCount(), gMinDrawsPerCommandList);
+	if (ranges.empty())
+		ranges.push_back(RecordRange());
+
+	// 구간마다 따로 세고 기록이 끝난 뒤 합친다.
+	std::vector<DrawStateStats> partStats(ranges.size());
+
+	// PSO는 DrawSink가 첫 그리기에서 설정하므로 명령 목록은 PSO 없이 시작한다.
+	mRecorder->Record(mFence->GetCompletedValue(), ranges, nullptr,
+		[&](ID3D12GraphicsCommandList* cmdList, const RecordRange& range, size_t partIndex)
 	{
-		ThrowIfFailed(mCommandList->Reset(cmdListAlloc.Get(), mPSOs["opaque_wireframe"].Get()));
-	}
-	else
-	{
-		ThrowIfFailed(mCommandList->Reset(cmdListAlloc.Get(), mPSOs["opaque"].Get()));
-	}
-	mCommandList->RSSetViewports(1, &mScreenViewport);
-	mCommandList->RSSetScissorRects(1, &mScissorRect);
-
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
-		D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
-
-	mCommandList->ClearRenderTargetView(CurrentBackBufferView(), Colors::LightSteelBlue, 0, nullptr);
-	mCommandList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
+		// 첫 번째 목록이 백 버퍼 전환과 초기화를 맡는다.
+		if (partIndex == 0)
+		{
+			mGpuFrameTimer->Begin(cmdList);
 
-	mCommandList->OMSetRenderTargets(1, &CurrentBackBufferView(), true, &DepthStencilView());
+			cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
+				D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
 
-	ID3D12DescriptorHeap* descriptorHeaps[] = { mCbvHeap.Get() };
-	mCommandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
+			cmdList->ClearRenderTargetView(CurrentBackBufferView(), Colors::LightSteelBlue, 0, nullptr);
+			cmdList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
+		}
 
-	mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+		// 명령 목록 사이에는 상태가 이어지지 않으므로 목록마다 다시 설정한다.
+		SetPassState(cmdList);
 
-	int passCbvIndex = mPassCbvOffset + mCurrFrameResourceIndex;
-	auto passCbvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(mCbvHeap->GetGPUDescriptorHandleForHeapStart());
-	passCbvHandle.Offset(passCbvIndex, mCbvSrvUavDescriptorSize);
-	mCommandList->SetGraphicsRootDescriptorTable(1, passCbvHandle);
+		DrawSink sink;
+		sink.App = this;
+		sink.CmdList = cmdList;
+		mDrawQueue.Submit(sink, range.Begin, range.End, partStats[partIndex]);
 
-	DrawRenderItems(mCommandList.Get(), mOpaqueRitems);
+		// 마지막 목록이 백 버퍼를 출력 상태로 되돌린다.
+		if (partIndex == ranges.size() - 1)
+		{
+			cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
+				D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
 
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
+			mGpuFrameTimer->End(cmdList);
+		}
+	});
 
-	ThrowIfFailed(mCommandList->Close());
+	mDrawStats = DrawStateStats();
+	for (const DrawStateStats& stats : partStats)
+		mDrawStats += stats;
 
-	ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
-	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+	// 모든 목록을 구간 순서대로 한 번에 제출
+	mRecorder->Execute(mCommandQueue.Get());
 
 	ThrowIfFailed(mSwapChain->Present(0, 0));
-	mCurrentBackBuffer = (mCurrentBackBuffer + 1) % SwapChainBufferCount;
+	mCurrentBackBuffer = (mCurrentBackBuffer + 1) % mSwapChainBufferCount;
 
-	mCurrFrameResource->Fence = ++mCurrentFence;
+	mCurrFrameResource->Fence = mFence->Signal(mCommandQueue.Get());
 
-	mCommandQueue->Signal(mFence.Get(), mCurrentFence);
+	// 이번 프레임에 할당한 상수 버퍼와 명령 할당자는 이 펜스 값이 완료되면 회수된다.
+	mUploadRing->EndFrame(mCurrFrameResource->Fence);
+	mRecorder->EndFrame(mCurrFrameResource->Fence);
+}
+
+std::wstring ShapesApp::GetFrameStatsText() const
+{
+	return L"    draws: " + std::to_wstring(mDrawStats.Draws) +
+		L"    state sets: " + std::to_wstring(mDrawStats.GetSetCalls()) +
+		L"    elided: " + std::to_wstring(mDrawStats.GetElidedCalls());
 }
 
 void ShapesApp::OnMouseDown(WPARAM btnState, int x, int y)
@@ -269,21 +458,21 @@ void ShapesApp::OnMouseMove(WPARAM btnState, int x, int y)
 {
 	if(btnState & MK_LBUTTON)
 	{
-		// 콺 ̵ Ÿ Ͽ Ÿ   
+		// 마우스 이동 거리에 비례하여 세타와 파이 각도 변경
 		float dx = XMConvertToRadians(0.25f * static_cast<float>(x - mLastMousePos.x));
 		float dy = XMConvertToRadians(0.25f * static_cast<float>(y - mLastMousePos.y));
 		mTheta += dx;
 		mPhi += dy;
-		// Ѱ 
+		// 극한값 방지
 		mPhi = MathHelper::Clamp(mPhi, 0.1f, MathHelper::Pi - 0.1f);
 	}
 	else if (btnState & MK_RBUTTON)
 	{
-		// 콺 ̵ Ÿ Ͽ  
+		// 마우스 이동 거리에 비례하여 반지름 변경
 		float dx = 0.05f * static_cast<float>(x - mLastMousePos.x);
 		float dy = 0.05f * static_cast<float>(y - mLastMousePos.y);
 		mRadius += dx - dy;
-		// Ѱ 
+		// 극한값 방지
 		mRadius = MathHelper::Clamp(mRadius, 3.0f, 150.0f);
 	}
 
@@ -301,11 +490,11 @@ void ShapesApp::OnKeyboardInput(const GameTimer& gt)
 
 void ShapesApp::UpdateCamera(const GameTimer& gt)
 {
-	//  ǥ踦  ǥ ȯ
+	// 구면 좌표계를 직교 좌표계로 변환
 	mEyePos.x = mRadius * sinf(mPhi) * cosf(mTheta);
 	mEyePos.z = mRadius * sinf(mPhi) * sinf(mTheta);
 	mEyePos.y = mRadius * cosf(mPhi);
-	//   
+	// 뷰 행렬 생성
 	XMVECTOR pos = XMVectorSet(mEyePos.x, mEyePos.y, mEyePos.z, 1.0f);
 	XMVECTOR target = XMVectorZero();
 	XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
@@ -313,25 +502,22 @@ void ShapesApp::UpdateCamera(const GameTimer& gt)
 	XMStoreFloat4x4(&mView, view);
 }
 
-void ShapesApp::UpdateObjectCBs(const GameTimer& gt)
-{
-	auto currObjectCB = mCurrFrameResource->ObjectCB.get();
-	for (auto& e : mAllRitems)
-	{
-		//   Ǿ Ȯ
-		if (e->NumFramesDirty > 0)
-		{
-			XMMATRIX world = XMLoadFloat4x4(&e->World);
-
-			ObjectConstants objConstants;
-			XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
+// TransformArray::Flush는 객체 버퍼 요소마다 전치된 World 행렬(64 바이트)만 기록한다.
+static_assert(sizeof(ObjectConstants) == sizeof(XMFLOAT4X4), "ObjectConstants must contain only the world matrix");
 
-			currObjectCB->CopyData(e->ObjCBIndex, objConstants);
+void ShapesApp::UpdateObjectBuffer(const GameTimer& gt)
+{
+	// 이 프레임 리소스의 객체 버퍼에는 마지막으로 사용한 뒤 바뀐 행렬만 전치해서 기록한다.
+	UploadBuffer<ObjectConstants>& objectBuffer = *mCurrFrameResource->ObjectBuffer;
+	mObjectTransforms.Flush(mCurrFrameResourceIndex, objectBuffer.MappedData(), objectBuffer.ElementByteSize(), mJobs.get());
+}
 
-			//   ҽ    Ƽ ÷ 
-			e->NumFramesDirty--;
-		}
-	}
+void ShapesApp::UpdateObjectTransform(const RenderItem* ri)
+{
+	// 셰이더는 압축된 위치에 PositionDecode * World를 곱한다.
+	XMFLOAT4X4 world;
+	XMStoreFloat4x4(&world, XMLoadFloat4x4(&ri->PositionDecode) * XMLoadFloat4x4(&ri->World));
+	mObjectTransforms.Set(ri->ObjCBIndex, &world._11);
 }
 
 void ShapesApp::UpdateMainPassCB(const GameTimer& gt)
@@ -358,87 +544,128 @@ void ShapesApp::UpdateMainPassCB(const GameTimer& gt)
 	mMainPassCB.TotalTime = gt.TotalTime();
 	mMainPassCB.DeltaTime = gt.DeltaTime();
 
-	auto currPassCB = mCurrFrameResource->PassCB.get();
-	currPassCB->CopyData(0, mMainPassCB);
+	UploadAllocation& passCB = mCurrFrameResource->PassCB;
+	passCB = mUploadRing->AllocateConstants(mMainPassCB);
+
+	// 패스 CBV는 이번 프레임에만 쓰므로 프레임 링에 만든다.
+	D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
+	cbvDesc.BufferLocation = passCB.GPU;
+	cbvDesc.SizeInBytes = Util::CalcConstantBufferByteSize(sizeof(PassConstants));
+	mCurrFrameResource->PassCbv = mDescriptorHeap->AllocateFrame();
+	mD3DDevice->CreateConstantBufferView(&cbvDesc, mCurrFrameResource->PassCbv.CPU);
 }
 
-void ShapesApp::BuildDescriptorHeaps()
+void ShapesApp::CullRenderItems()
 {
-	UINT objCount = (UINT)mOpaqueRitems.size();
-
-	UINT numDescriptors = (objCount + 1) * gNumFrameResources;
+	// 뷰 공간 절두체를 월드 공간으로 옮긴다.
+	XMMATRIX view = XMLoadFloat4x4(&mView);
+	XMMATRIX invView = XMMatrixInverse(&XMMatrixDeterminant(view), view);
+	BoundingFrustum frustum;
+	BoundingFrustum::CreateFromMatrix(frustum, XMLoadFloat4x4(&mProj));
+	frustum.Transform(frustum, invView);
 
-	mPassCbvOffset = objCount * gNumFrameResources;
+	mRitemVisible.resize(mOpaqueRitems.size());
+	mJobs->ParallelFor(mOpaqueRitems.size(), gRitemsPerJob, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			const RenderItem* ri = mOpaqueRitems[i];
+			BoundingBox worldBounds;
+			ri->Bounds.Transform(worldBounds, XMLoadFloat4x4(&ri->World));
+			mRitemVisible[i] = frustum.Intersects(worldBounds) ? 1 : 0;
+		}
+	});
 
-	D3D12_DESCRIPTOR_HEAP_DESC cbvHeapDesc;
-	cbvHeapDesc.NumDescriptors = numDescriptors;
-	cbvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	cbvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	cbvHeapDesc.NodeMask = 0;
-	ThrowIfFailed(mD3DDevice->CreateDescriptorHeap(&cbvHeapDesc,
-		IID_PPV_ARGS(&mCbvHeap)));
+	// 그리기 순서가 바뀌지 않도록 보이는 아이템을 순서대로 모은다.
+	mVisibleRitems.clear();
+	for (size_t i = 0; i < mOpaqueRitems.size(); ++i)
+	{
+		if (mRitemVisible[i])
+			mVisibleRitems.push_back(mOpaqueRitems[i]);
+	}
 }
 
-void ShapesApp::BuildConstantBufferViews()
+void ShapesApp::BuildDrawBatches()
 {
-	UINT objCBByteSize = Util::CalcConstantBufferByteSize(sizeof(ObjectConstants));
-	UINT objCount = (UINT)mOpaqueRitems.size();
+	UINT pipeline = mIsWireframe ? mOpaqueWireframePSO.Index : mOpaquePSO.Index;
 
-	//   ҽ  ü   (CBV) 
-	for (int frameIndex = 0; frameIndex < gNumFrameResources; ++frameIndex)
+	mDrawBatcher.Reset();
+	mBatchDepths.clear();
+	for (const RenderItem* ri : mVisibleRitems)
 	{
-		auto objectCB = mFrameResources[frameIndex]->ObjectCB->Resource();
-		for (UINT i = 0; i < objCount; ++i)
+		DrawBatchKey key;
+		key.Geometry = ri->Geo.Index;
+		key.Pipeline = pipeline;
+		key.PrimitiveType = ri->PrimitiveType;
+		key.IndexCount = ri->IndexCount;
+		key.StartIndexLocation = ri->StartIndexLocation;
+		key.BaseVertexLocation = ri->BaseVertexLocation;
+
+		XMVECTOR toEye = XMVectorSet(mEyePos.x - ri->World._41, mEyePos.y - ri->World._42, mEyePos.z - ri->World._43, 0.0f);
+		float distance = XMVectorGetX(XMVector3Length(toEye));
+
+		// 거리에 따라 LOD를 고른다. 같은 LOD를 쓰는 아이템끼리만 묶인다.
+		if (!ri->Lods.empty())
 		{
-			D3D12_GPU_VIRTUAL_ADDRESS cbAddress = objectCB->GetGPUVirtualAddress();
-
-			//   ۿ  CBV  
-			cbAddress += i * objCBByteSize;
-
-			int heapIndex = frameIndex * objCount + i;
-			auto handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(mCbvHeap->GetCPUDescriptorHandleForHeapStart());
-			handle.Offset(heapIndex, mCbvSrvUavDescriptorSize);
-
-			D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
-			cbvDesc.BufferLocation = cbAddress;
-			cbvDesc.SizeInBytes = objCBByteSize;
-
-			mD3DDevice->CreateConstantBufferView(&cbvDesc, handle);
+			size_t lod = std::min((size_t)(distance / gLodDistanceStep), ri->Lods.size() - 1);
+			key.IndexCount = ri->Lods[lod].IndexCount;
+			key.StartIndexLocation = ri->Lods[lod].StartIndexLocation;
 		}
-	}
 
-	UINT passCBByteSize = Util::CalcConstantBufferByteSize(sizeof(PassConstants));
+		// 묶음 번호는 처음 나온 순서대로 매겨진다.
+		std::uint32_t batch = mDrawBatcher.Add(key, ri->ObjCBIndex);
+		if (batch == mBatchDepths.size())
+			mBatchDepths.push_back(distance);
+		else
+			mBatchDepths[batch] = std::min(mBatchDepths[batch], distance);
+	}
+	mDrawBatcher.Build();
 
-	//   ҽ  н   (CBV) 
-	for (int frameIndex = 0; frameIndex < gNumFrameResources; ++frameIndex)
+	// 묶음 하나가 그리기 하나. 정렬 키 순서로 정렬해서 상태 변경을 줄이고, 같은 상태 안에서는 앞에서 뒤로 그린다.
+	const auto& batches = mDrawBatcher.GetBatches();
+	mDrawQueue.Reset();
+	for (size_t i = 0; i < batches.size(); ++i)
 	{
-		auto passCB = mFrameResources[frameIndex]->PassCB->Resource();
-		D3D12_GPU_VIRTUAL_ADDRESS cbAddress = passCB->GetGPUVirtualAddress();
-
-		int heapIndex = mPassCbvOffset + frameIndex;
-		auto handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(mCbvHeap->GetCPUDescriptorHandleForHeapStart());
-		handle.Offset(heapIndex, mCbvSrvUavDescriptorSize);
-
-		D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
-		cbvDesc.BufferLocation = cbAddress;
-		cbvDesc.SizeInBytes = passCBByteSize;
-
-		mD3DDevice->CreateConstantBufferView(&cbvDesc, handle);
+		const DrawBatchKey& key = batches[i].Key;
+
+		DrawItem item;
+		item.Pipeline = key.Pipeline;
+		item.RootSignature = 0;
+		item.Geometry = key.Geometry;
+		item.PrimitiveTopology = (std::uint32_t)key.PrimitiveType;
+		item.IndexCount = key.IndexCount;
+		item.InstanceCount = batches[i].InstanceCount;
+		item.StartIndexLocation = key.StartIndexLocation;
+		item.BaseVertexLocation = key.BaseVertexLocation;
+		item.StartInstance = batches[i].FirstInstance;
+		item.SortKey = DrawSortKey::Make(0, item.Pipeline, item.RootSignature, item.Geometry, mBatchDepths[i]);
+		mDrawQueue.Add(item);
 	}
+	mDrawQueue.Sort();
+
+	// 묶음 순서로 모은 객체 인덱스를 이번 프레임의 인스턴스 버퍼에 복사.
+	// 셰이더는 gInstanceObjects[묶음 시작 + SV_InstanceID]로 객체 버퍼의 행렬을 찾는다.
+	const std::vector<std::uint32_t>& instances = mDrawBatcher.GetInstances();
+	UploadAllocation& instanceObjects = mCurrFrameResource->InstanceObjects;
+	instanceObjects = mUploadRing->Allocate(std::max<UINT64>(instances.size(), 1) * sizeof(std::uint32_t));
+	if (!instances.empty())
+		memcpy(instanceObjects.CPU, instances.data(), instances.size() * sizeof(std::uint32_t));
 }
 
 void ShapesApp::BuildRootSignature()
 {
-	CD3DX12_DESCRIPTOR_RANGE cbvTable0;
-	cbvTable0.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
 	CD3DX12_DESCRIPTOR_RANGE cbvTable1;
 	cbvTable1.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 1);
+	CD3DX12_DESCRIPTOR_RANGE objectRange;
 
-	CD3DX12_ROOT_PARAMETER slotRootParameter[2];
-	slotRootParameter[0].InitAsDescriptorTable(1, &cbvTable0);
+	// 0: 객체 행렬 버퍼 (t0), 1: 패스 상수 (b1), 2: 인스턴스 -> 객체 인덱스 (t1), 3: 묶음의 인스턴스 시작 위치 (b0)
+	CD3DX12_ROOT_PARAMETER slotRootParameter[4];
+	ObjectBinding::InitBufferRootParameter(slotRootParameter[0], 0);
 	slotRootParameter[1].InitAsDescriptorTable(1, &cbvTable1);
+	slotRootParameter[2].InitAsShaderResourceView(1);
+	ObjectBinding::InitRootParameter(gObjectBindingMode, slotRootParameter[3], objectRange, 0);
 
-	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(2, slotRootParameter, 0, nullptr,
+	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(4, slotRootParameter, 0, nullptr,
 		D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
 	ComPtr<ID3DBlob> serializedRootSig = nullptr;
@@ -457,29 +684,96 @@ void ShapesApp::BuildRootSignature()
 		serializedRootSig->GetBufferPointer(),
 		serializedRootSig->GetBufferSize(),
 		IID_PPV_ARGS(mRootSignature.GetAddressOf())));
+
+	mRootSignatureHash = PipelineStateHasher::HashBytes(serializedRootSig->GetBufferPointer(), serializedRootSig->GetBufferSize());
 }
 
 void ShapesApp::BuildShadersAndInputLayout()
 {
-	mShaders["standardVS"] = Util::CompileShader(L"source\\shaders\\color.hlsl", nullptr, "VS", "vs_5_1");
-	mShaders["opaquePS"] = Util::CompileShader(L"source\\shaders\\color.hlsl", nullptr, "PS", "ps_5_1");
+	mStandardVS = mShaders.Add(gStandardVSName, Util::CompileShader(L"source\\shaders\\color.hlsl", nullptr, "VS", "vs_5_1"));
+	mOpaquePS = mShaders.Add(gOpaquePSName, Util::CompileShader(L"source\\shaders\\color.hlsl", nullptr, "PS", "ps_5_1"));
 
-	mInputLayout =
+	mInputLayout = VertexEncoder::GetInputLayout(gVertexFormat);
+}
+
+void ShapesApp::BuildShapeGeometry()
+{
+	// 생성 매개변수와 정점 형식이 같다면 이전에 구운 캐시 파일을 그대로 사용
+	std::uint32_t vertexFormat[] =
 	{
-		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{ "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		(std::uint32_t)gVertexFormat.Position,
+		gVertexFormat.Normal, gVertexFormat.Tangent, gVertexFormat.TexC, gVertexFormat.Color
 	};
+	std::uint64_t paramHash = MeshCacheFile::HashBytes(&gShapeBake, sizeof(gShapeBake));
+	paramHash = MeshCacheFile::HashBytes(vertexFormat, sizeof(vertexFormat), paramHash);
+
+	MeshCacheFile cache;
+	if (!cache.Open(gShapeCacheFilename, paramHash))
+		BakeShapeGeometry(cache, paramHash);
+
+	auto geo = std::make_unique<MeshGeometry>();
+	geo->Name = "shapeGeo";
+	cache.GetLayout(*geo);
+
+	// 매핑된 캐시 파일에서 스테이징 버퍼로 바로 복사. 두 복사는 하나의 배치로 제출된다.
+	UploadTicket ticket;
+	geo->VertexBufferGPU = mUploadBatcher->CreateBuffer(
+		cache.GetVertexData(),
+		geo->VertexBufferByteSize,
+		ticket);
+
+	geo->IndexBufferGPU = mUploadBatcher->CreateBuffer(
+		cache.GetIndexData(),
+		geo->IndexBufferByteSize,
+		ticket);
+
+	// 서브메쉬는 이름 해시로 등록하고, 렌더 아이템은 로드할 때 찾은 값을 복사해 둔다.
+	for (const auto& e : geo->DrawArgs)
+		mSubmeshes.Add(HashName(e.first.c_str()), e.second);
+
+	mShapeGeo = mGeometries.Add(gShapeGeoName, std::move(geo));
+	AddGeometryBinding(mShapeGeo);
 }
 
-void ShapesApp::BuildShapeGeometry()
+void ShapesApp::AddGeometryBinding(GeometryHandle geo)
 {
-	GeometryGenerator geoGen;
-	GeometryGenerator::MeshData box = geoGen.CreateBox(1.5f, 0.5f, 1.5f, 3);
-	GeometryGenerator::MeshData grid = geoGen.CreateGrid(20.0f, 30.0f, 60, 40);
-	GeometryGenerator::MeshData sphere = geoGen.CreateSphere(0.5f, 20, 20);
-	GeometryGenerator::MeshData cylinder = geoGen.CreateCylinder(0.5f, 0.3f, 3.0f, 20, 20);
+	const MeshGeometry& mesh = *mGeometries[geo];
+	if (mGeometryBindings.size() < mGeometries.GetSlotCount())
+		mGeometryBindings.resize(mGeometries.GetSlotCount());
 
-	// ϳ ؽ/ε ۿ   
+	GeometryBinding& binding = mGeometryBindings[geo.Index];
+	binding.VertexBufferView = mesh.VertexBufferView();
+	binding.IndexBufferView = mesh.IndexBufferView();
+}
+
+void ShapesApp::BakeShapeGeometry(MeshCacheFile& cache, std::uint64_t paramHash)
+{
+	const ShapeBakeSettings& b = gShapeBake;
+
+	GeometryGenerator geoGen;
+	GeometryGenerator::MeshData box = geoGen.CreateBox(b.BoxWidth, b.BoxHeight, b.BoxDepth, b.BoxSubdivisions);
+	GeometryGenerator::MeshData grid = geoGen.CreateGrid(b.GridWidth, b.GridDepth, b.GridRows, b.GridColumns);
+	GeometryGenerator::MeshData sphere = geoGen.CreateSphere(b.SphereRadius, b.SphereSlices, b.SphereStacks);
+	GeometryGenerator::MeshData cylinder = geoGen.CreateCylinder(
+		b.CylinderBottomRadius, b.CylinderTopRadius, b.CylinderHeight, b.CylinderSlices, b.CylinderStacks);
+
+	// 정점 캐시/오버드로우/정점 페치 순서 최적화
+	MeshOptimizer::Optimize(box);
+	MeshOptimizer::Optimize(grid);
+	MeshOptimizer::Optimize(sphere);
+	MeshOptimizer::Optimize(cylinder);
+
+	// 같은 정점 버퍼를 공유하는 단순화된 인덱스 생성
+	const std::vector<float> lodRatios(std::begin(b.LodRatios), std::end(b.LodRatios));
+	const float lodMaxError = b.LodMaxError;
+	std::vector<MeshLod> sphereLods = MeshSimplifier::BuildLodChain(sphere, lodRatios, lodMaxError);
+	std::vector<MeshLod> cylinderLods = MeshSimplifier::BuildLodChain(cylinder, lodRatios, lodMaxError);
+	for (MeshLod& lod : sphereLods)
+		MeshOptimizer::OptimizeVertexCache(lod.Indices32, (UINT)sphere.Vertices.size());
+	for (MeshLod& lod : cylinderLods)
+		MeshOptimizer::OptimizeVertexCache(lod.Indices32, (UINT)cylinder.Vertices.size());
+
+	// 하나의 버텍스/인덱스 버퍼에 모든 도형을 저장
 
 	UINT boxVertexOffset = 0;
 	UINT gridVertexOffset = (UINT)box.Vertices.size();
@@ -491,7 +785,7 @@ void ShapesApp::BuildShapeGeometry()
 	UINT sphereIndexOffset = gridIndexOffset + (UINT)grid.Indices32.size();
 	UINT cylinderIndexOffset = sphereIndexOffset + (UINT)sphere.Indices32.size();
 
-	// SubmeshGeometry 
+	// SubmeshGeometry 생성
 	SubmeshGeometry boxSubmesh;
 	boxSubmesh.IndexCount = (UINT)box.Indices32.size();
 	boxSubmesh.StartIndexLocation = boxIndexOffset;
@@ -512,87 +806,104 @@ void ShapesApp::BuildShapeGeometry()
 	cylinderSubmesh.StartIndexLocation = cylinderIndexOffset;
 	cylinderSubmesh.BaseVertexLocation = cylinderVertexOffset;
 
-	// ü ؽ  
-	auto totalVertexCount =
-		box.Vertices.size() +
-		grid.Vertices.size() +
-		sphere.Vertices.size() +
-		cylinder.Vertices.size();
-
-	std::vector<Vertex> vertices(totalVertexCount);
+	// 도형마다 자신의 경계 상자를 기준으로 정점을 압축
+	EncodedVertices encodedBox = VertexEncoder::Encode(box.Vertices, gVertexFormat, XMFLOAT4(DirectX::Colors::DarkGreen));
+	EncodedVertices encodedGrid = VertexEncoder::Encode(grid.Vertices, gVertexFormat, XMFLOAT4(DirectX::Colors::ForestGreen));
+	EncodedVertices encodedSphere = VertexEncoder::Encode(sphere.Vertices, gVertexFormat, XMFLOAT4(DirectX::Colors::Crimson));
+	EncodedVertices encodedCylinder = VertexEncoder::Encode(cylinder.Vertices, gVertexFormat, XMFLOAT4(DirectX::Colors::SteelBlue));
 
-	UINT k = 0;
-	for (size_t i = 0; i < box.Vertices.size(); ++i, ++k)
+	auto setPositionDecode = [](SubmeshGeometry& submesh, const EncodedVertices& encoded)
 	{
-		vertices[k].Pos = box.Vertices[i].Position;
-		vertices[k].Color = XMFLOAT4(DirectX::Colors::DarkGreen);
-	}
-
-	for (size_t i = 0; i < grid.Vertices.size(); ++i, ++k)
+		submesh.PositionScale = encoded.PositionScale;
+		submesh.PositionOffset = encoded.PositionOffset;
+	};
+	setPositionDecode(boxSubmesh, encodedBox);
+	setPositionDecode(gridSubmesh, encodedGrid);
+	setPositionDecode(sphereSubmesh, encodedSphere);
+	setPositionDecode(cylinderSubmesh, encodedCylinder);
+
+	// 압축 전 위치로 경계를 계산 (메쉬 공간)
+	box.ComputeBounds(boxSubmesh.Bounds, boxSubmesh.SphereBounds);
+	grid.ComputeBounds(gridSubmesh.Bounds, gridSubmesh.SphereBounds);
+	sphere.ComputeBounds(sphereSubmesh.Bounds, sphereSubmesh.SphereBounds);
+	cylinder.ComputeBounds(cylinderSubmesh.Bounds, cylinderSubmesh.SphereBounds);
+
+	// LOD 인덱스는 원본 도형들 뒤에 이어 붙인다.
+	std::vector<const std::vector<GeometryGenerator::uint32>*> indexSources =
 	{
-		vertices[k].Pos = grid.Vertices[i].Position;
-		vertices[k].Color = XMFLOAT4(DirectX::Colors::ForestGreen);
-	}
+		&box.Indices32, &grid.Indices32, &sphere.Indices32, &cylinder.Indices32
+	};
+	UINT indexCount = cylinderIndexOffset + (UINT)cylinder.Indices32.size();
 
-	for (size_t i = 0; i < sphere.Vertices.size(); ++i, ++k)
+	// LOD는 원본 정점의 일부만 사용하므로 원본의 경계를 그대로 사용해도 보수적이다.
+	auto appendLods = [&indexSources, &indexCount](const std::vector<MeshLod>& lods, const SubmeshGeometry& original)
 	{
-		vertices[k].Pos = sphere.Vertices[i].Position;
-		vertices[k].Color = XMFLOAT4(DirectX::Colors::Crimson);
-	}
+		std::vector<SubmeshGeometry> submeshes;
+		for (const MeshLod& lod : lods)
+		{
+			SubmeshGeometry submesh = original;
+			submesh.IndexCount = (UINT)lod.Indices32.size();
+			submesh.StartIndexLocation = indexCount;
+			submeshes.push_back(submesh);
 
-	for (size_t i = 0; i < cylinder.Vertices.size(); ++i, ++k)
+			indexSources.push_back(&lod.Indices32);
+			indexCount += submesh.IndexCount;
+		}
+		return submeshes;
+	};
+	std::vector<SubmeshGeometry> sphereLodSubmeshes = appendLods(sphereLods, sphereSubmesh);
+	std::vector<SubmeshGeometry> cylinderLodSubmeshes = appendLods(cylinderLods, cylinderSubmesh);
+
+	// 캐시 파일을 매핑한 메모리에 하나로 합친 정점/인덱스를 바로 기록
+	const EncodedVertices* encodedShapes[] = { &encodedBox, &encodedGrid, &encodedSphere, &encodedCylinder };
+
+	MeshGeometry layout;
+	layout.VertexByteStride = VertexEncoder::GetVertexStride(gVertexFormat);
+	for (const EncodedVertices* encoded : encodedShapes)
+		layout.VertexBufferByteSize += (UINT)encoded->Data.size();
+	// 인덱스 형식(R16/R32)은 인덱스 값에 따라 자동으로 선택된다.
+	layout.IndexFormat = Util::GetIndexFormat(indexSources, layout.IndexBufferByteSize);
+
+	layout.DrawArgs["box"] = boxSubmesh;
+	layout.DrawArgs["grid"] = gridSubmesh;
+	layout.DrawArgs["sphere"] = sphereSubmesh;
+	layout.DrawArgs["cylinder"] = cylinderSubmesh;
+	for (size_t i = 0; i < sphereLodSubmeshes.size(); ++i)
+		layout.DrawArgs["sphere_lod" + std::to_string(i + 1)] = sphereLodSubmeshes[i];
+	for (size_t i = 0; i < cylinderLodSubmeshes.size(); ++i)
+		layout.DrawArgs["cylinder_lod" + std::to_string(i + 1)] = cylinderLodSubmeshes[i];
+
+	// 파일을 만들지 못해도 이번 실행에서 사용할 메모리는 준비된다.
+	cache.Create(gShapeCacheFilename, paramHash, layout);
+
+	std::uint8_t* dest = static_cast<std::uint8_t*>(cache.GetVertexData());
+	for (const EncodedVertices* encoded : encodedShapes)
 	{
-		vertices[k].Pos = cylinder.Vertices[i].Position;
-		vertices[k].Color = XMFLOAT4(DirectX::Colors::SteelBlue);
+		memcpy(dest, encoded->Data.data(), encoded->Data.size());
+		dest += encoded->Data.size();
 	}
 
-	std::vector<uint16_t> indices;
-	indices.insert(indices.end(), std::begin(box.GetIndices16()), std::end(box.GetIndices16()));
-	indices.insert(indices.end(), std::begin(grid.GetIndices16()), std::end(grid.GetIndices16()));
-	indices.insert(indices.end(), std::begin(sphere.GetIndices16()), std::end(sphere.GetIndices16()));
-	indices.insert(indices.end(), std::begin(cylinder.GetIndices16()), std::end(cylinder.GetIndices16()));
-
-	const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
-	const UINT ibByteSize = (UINT)indices.size() * sizeof(std::uint16_t);
-
-	auto geo = std::make_unique<MeshGeometry>();
-	geo->Name = "shapeGeo";
-
-	ThrowIfFailed(D3DCreateBlob(vbByteSize, &geo->VertexBufferCPU));
-	CopyMemory(geo->VertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
-
-	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
-	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
-
-	geo->VertexBufferGPU = Util::CreateDefaultBuffer(
-		mD3DDevice.Get(),
-		mCommandList.Get(),
-		vertices.data(),
-		vbByteSize,
-		geo->VertexBufferUploader);
-
-	geo->IndexBufferGPU = Util::CreateDefaultBuffer(
-		mD3DDevice.Get(),
-		mCommandList.Get(),
-		indices.data(),
-		ibByteSize,
-		geo->IndexBufferUploader);
-
-	geo->VertexByteStride = sizeof(Vertex);
-	geo->VertexBufferByteSize = vbByteSize;
-	geo->IndexFormat = DXGI_FORMAT_R16_UINT;
-	geo->IndexBufferByteSize = ibByteSize;
-
-	geo->DrawArgs["box"] = boxSubmesh;
-	geo->DrawArgs["grid"] = gridSubmesh;
-	geo->DrawArgs["sphere"] = sphereSubmesh;
-	geo->DrawArgs["cylinder"] = cylinderSubmesh;
-
-	mGeometries[geo->Name] = std::move(geo);
+	Util::WriteIndices(indexSources, layout.IndexFormat, cache.GetIndexData());
 }
 
 void ShapesApp::BuildPSOs()
 {
+	// 기존 PSO를 교체하는 경우, GPU를 기다리지 않고 이전 PSO는 사용 중인 프레임이 끝난 뒤 해제한다.
+	// 교체할 때도 핸들은 그대로이므로 렌더 아이템과 정렬 키를 다시 만들 필요가 없다.
+	auto createPSO = [this](NameHash name, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+	{
+		PipelineHandle handle = mPSOs.Find(name);
+		if (!handle.IsValid())
+			handle = mPSOs.Add(name, nullptr);
+
+		ComPtr<ID3D12PipelineState>& pso = mPSOs[handle];
+		DeferRelease(pso);
+		pso = mPipelineCache->GetGraphicsPipeline(desc, mRootSignatureHash);
+		return handle;
+	};
+	mPsoMsaaState = m4xMsaaState;
+	const PipelineCacheStats before = mPipelineCache->GetStats();
+
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC opaquePsoDesc;
 
 	// Opaque PSO
@@ -601,13 +912,13 @@ void ShapesApp::BuildPSOs()
 	opaquePsoDesc.pRootSignature = mRootSignature.Get();
 	opaquePsoDesc.VS =
 	{
-		reinterpret_cast<BYTE*>(mShaders["standardVS"]->GetBufferPointer()),
-		mShaders["standardVS"]->GetBufferSize()
+		reinterpret_cast<BYTE*>(mShaders[mStandardVS]->GetBufferPointer()),
+		mShaders[mStandardVS]->GetBufferSize()
 	};
 	opaquePsoDesc.PS =
 	{
-		reinterpret_cast<BYTE*>(mShaders["opaquePS"]->GetBufferPointer()),
-		mShaders["opaquePS"]->GetBufferSize()
+		reinterpret_cast<BYTE*>(mShaders[mOpaquePS]->GetBufferPointer()),
+		mShaders[mOpaquePS]->GetBufferSize()
 	};
 	opaquePsoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
 	// opaquePsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_WIREFRAME; // todo:
@@ -620,45 +931,100 @@ void ShapesApp::BuildPSOs()
 	opaquePsoDesc.SampleDesc.Count = m4xMsaaState ? 4 : 1;
 	opaquePsoDesc.SampleDesc.Quality = m4xMsaaState ? (m4xMsaaQuality - 1) : 0;
 	opaquePsoDesc.DSVFormat = mDepthStencilFormat;
-	ThrowIfFailed(mD3DDevice->CreateGraphicsPipelineState(&opaquePsoDesc, IID_PPV_ARGS(&mPSOs["opaque"])));
+	mOpaquePSO = createPSO(gOpaquePSOName, opaquePsoDesc);
 
 	// Opaque wireframe PSO
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC opaqueWireframePsoDesc = opaquePsoDesc;
 	opaqueWireframePsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_WIREFRAME;
-	ThrowIfFailed(mD3DDevice->CreateGraphicsPipelineState(&opaqueWireframePsoDesc, IID_PPV_ARGS(&mPSOs["opaque_wireframe"])));
+	mOpaqueWireframePSO = createPSO(gOpaqueWireframePSOName, opaqueWireframePsoDesc);
+
+	// PSO 생성 시간 보고 (시작할 때와 MSAA를 바꿀 때)
+	const PipelineCacheStats& after = mPipelineCache->GetStats();
+	std::wstring text = L"***PSO: " + std::to_wstring(after.Requests - before.Requests) +
+		L" in " + std::to_wstring(after.CreateMs - before.CreateMs) + L" ms" +
+		L" (compiled " + std::to_wstring(after.Compiled - before.Compiled) +
+		L", library " + std::to_wstring(after.LibraryHits - before.LibraryHits) +
+		L", memory " + std::to_wstring(after.MemoryHits - before.MemoryHits) +
+		L", cache file " + (after.LibraryLoaded ? std::to_wstring(after.LibraryByteSize) + L" bytes" : std::wstring(L"not loaded")) + L")\n";
+	OutputDebugString(text.c_str());
 }
 
 void ShapesApp::BuildFrameResources()
 {
-	for(int i = 0; i < gNumFrameResources; ++i)
+	mObjectBinding = ObjectBinding(ObjectBindingLayout::Create(
+		gObjectBindingMode, (std::uint32_t)mAllRitems.size(), sizeof(ObjectConstants), (std::uint32_t)mNumFrameResources));
+
+	for(int i = 0; i < mNumFrameResources; ++i)
 	{
-		mFrameResources.push_back(std::make_unique<FrameResource>(
-			mD3DDevice.Get(),
-			1,
-			(UINT)mOpaqueRitems.size()));
+		mFrameResources.push_back(std::make_unique<FrameResource>(mD3DDevice.Get(), mObjectBinding.GetLayout()));
 	}
+
+	mUploadRing = std::make_unique<UploadRing>(mD3DDevice.Get(), gUploadRingByteSize, mFence.get());
+
+	// 프레임별 명령 할당자는 기록기의 풀에서 구간마다 꺼내 쓴다.
+	mRecorder = std::make_unique<ParallelCommandRecorder>(mD3DDevice.Get(), mJobs.get());
 }
 
 void ShapesApp::BuildRenderItems()
 {
+	// 이름으로 등록된 서브메쉬. 없으면 캐시와 코드가 맞지 않는 것이므로 DxException을 던진다.
+	auto findSubmesh = [this](NameHash name)
+	{
+		SubmeshHandle handle = mSubmeshes.Find(name);
+		ThrowIfFailed(handle.IsValid() ? S_OK : HRESULT_FROM_WIN32(ERROR_NOT_FOUND));
+		return mSubmeshes[handle];
+	};
+	SubmeshGeometry boxSubmesh = findSubmesh(HashName("box"));
+	SubmeshGeometry gridSubmesh = findSubmesh(HashName("grid"));
+	SubmeshGeometry cylinderSubmesh = findSubmesh(HashName("cylinder"));
+	SubmeshGeometry sphereSubmesh = findSubmesh(HashName("sphere"));
+
+	// "<name>", "<name>_lod1", "<name>_lod2", ... 를 순서대로 수집
+	auto gatherLods = [this](const std::string& name)
+	{
+		std::vector<SubmeshGeometry> lods;
+		for (int i = 0; ; ++i)
+		{
+			std::string lodName = i == 0 ? name : name + "_lod" + std::to_string(i);
+			SubmeshHandle handle = mSubmeshes.Find(HashName(lodName.c_str()));
+			if (!handle.IsValid())
+				break;
+			lods.push_back(mSubmeshes[handle]);
+		}
+		return lods;
+	};
+	std::vector<SubmeshGeometry> cylinderLods = gatherLods("cylinder");
+	std::vector<SubmeshGeometry> sphereLods = gatherLods("sphere");
+
+	auto positionDecode = [](const SubmeshGeometry& submesh)
+	{
+		XMFLOAT4X4 decode;
+		XMStoreFloat4x4(&decode, VertexEncoder::GetPositionDecodeMatrix(submesh.PositionScale, submesh.PositionOffset));
+		return decode;
+	};
+
 	auto boxRitem = std::make_unique<RenderItem>();
 	XMStoreFloat4x4(&boxRitem->World, XMMatrixScaling(2.0f, 2.0f, 2.0f) * XMMatrixTranslation(0.0f, 0.5f, 0.0f));
 	boxRitem->ObjCBIndex = 0;
-	boxRitem->Geo = mGeometries["shapeGeo"].get();
+	boxRitem->Geo = mShapeGeo;
 	boxRitem->PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	boxRitem->IndexCount = boxRitem->Geo->DrawArgs["box"].IndexCount;
-	boxRitem->StartIndexLocation = boxRitem->Geo->DrawArgs["box"].StartIndexLocation;
-	boxRitem->BaseVertexLocation = boxRitem->Geo->DrawArgs["box"].BaseVertexLocation;
+	boxRitem->IndexCount = boxSubmesh.IndexCount;
+	boxRitem->StartIndexLocation = boxSubmesh.StartIndexLocation;
+	boxRitem->BaseVertexLocation = boxSubmesh.BaseVertexLocation;
+	boxRitem->PositionDecode = positionDecode(boxSubmesh);
+	boxRitem->Bounds = boxSubmesh.Bounds;
 	mAllRitems.push_back(std::move(boxRitem));
 
 	auto gridRitem = std::make_unique<RenderItem>();
 	gridRitem->World = MathHelper::Identity4x4();
 	gridRitem->ObjCBIndex = 1;
-	gridRitem->Geo = mGeometries["shapeGeo"].get();
+	gridRitem->Geo = mShapeGeo;
 	gridRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	gridRitem->IndexCount = gridRitem->Geo->DrawArgs["grid"].IndexCount;
-	gridRitem->StartIndexLocation = gridRitem->Geo->DrawArgs["grid"].StartIndexLocation;
-	gridRitem->BaseVertexLocation = gridRitem->Geo->DrawArgs["grid"].BaseVertexLocation;
+	gridRitem->IndexCount = gridSubmesh.IndexCount;
+	gridRitem->StartIndexLocation = gridSubmesh.StartIndexLocation;
+	gridRitem->BaseVertexLocation = gridSubmesh.BaseVertexLocation;
+	gridRitem->PositionDecode = positionDecode(gridSubmesh);
+	gridRitem->Bounds = gridSubmesh.Bounds;
 	mAllRitems.push_back(std::move(gridRitem));
 
 	UINT objCBIndex = 2;
@@ -677,35 +1043,47 @@ void ShapesApp::BuildRenderItems()
 
 		XMStoreFloat4x4(&leftCylRitem->World, leftCylWorld);
 		leftCylRitem->ObjCBIndex = objCBIndex++;
-		leftCylRitem->Geo = mGeometries["shapeGeo"].get();
+		leftCylRitem->Geo = mShapeGeo;
 		leftCylRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-		leftCylRitem->IndexCount = leftCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
-		leftCylRitem->StartIndexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
-		leftCylRitem->BaseVertexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+		leftCylRitem->IndexCount = cylinderSubmesh.IndexCount;
+		leftCylRitem->StartIndexLocation = cylinderSubmesh.StartIndexLocation;
+		leftCylRitem->BaseVertexLocation = cylinderSubmesh.BaseVertexLocation;
+		leftCylRitem->PositionDecode = positionDecode(cylinderSubmesh);
+		leftCylRitem->Bounds = cylinderSubmesh.Bounds;
+		leftCylRitem->Lods = cylinderLods;
 
 		XMStoreFloat4x4(&rightCylRitem->World, rightCylWorld);
 		rightCylRitem->ObjCBIndex = objCBIndex++;
-		rightCylRitem->Geo = mGeometries["shapeGeo"].get();
+		rightCylRitem->Geo = mShapeGeo;
 		rightCylRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-		rightCylRitem->IndexCount = rightCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
-		rightCylRitem->StartIndexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
-		rightCylRitem->BaseVertexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+		rightCylRitem->IndexCount = cylinderSubmesh.IndexCount;
+		rightCylRitem->StartIndexLocation = cylinderSubmesh.StartIndexLocation;
+		rightCylRitem->BaseVertexLocation = cylinderSubmesh.BaseVertexLocation;
+		rightCylRitem->PositionDecode = positionDecode(cylinderSubmesh);
+		rightCylRitem->Bounds = cylinderSubmesh.Bounds;
+		rightCylRitem->Lods = cylinderLods;
 
 		XMStoreFloat4x4(&leftSphereRitem->World, leftSphereWorld);
 		leftSphereRitem->ObjCBIndex = objCBIndex++;
-		leftSphereRitem->Geo = mGeometries["shapeGeo"].get();
+		leftSphereRitem->Geo = mShapeGeo;
 		leftSphereRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-		leftSphereRitem->IndexCount = leftSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
-		leftSphereRitem->StartIndexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
-		leftSphereRitem->BaseVertexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+		leftSphereRitem->IndexCount = sphereSubmesh.IndexCount;
+		leftSphereRitem->StartIndexLocation = sphereSubmesh.StartIndexLocation;
+		leftSphereRitem->BaseVertexLocation = sphereSubmesh.BaseVertexLocation;
+		leftSphereRitem->PositionDecode = positionDecode(sphereSubmesh);
+		leftSphereRitem->Bounds = sphereSubmesh.Bounds;
+		leftSphereRitem->Lods = sphereLods;
 
 		XMStoreFloat4x4(&rightSphereRitem->World, rightSphereWorld);
 		rightSphereRitem->ObjCBIndex = objCBIndex++;
-		rightSphereRitem->Geo = mGeometries["shapeGeo"].get();
+		rightSphereRitem->Geo = mShapeGeo;
 		rightSphereRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-		rightSphereRitem->IndexCount = rightSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
-		rightSphereRitem->StartIndexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
-		rightSphereRitem->BaseVertexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+		rightSphereRitem->IndexCount = sphereSubmesh.IndexCount;
+		rightSphereRitem->StartIndexLocation = sphereSubmesh.StartIndexLocation;
+		rightSphereRitem->BaseVertexLocation = sphereSubmesh.BaseVertexLocation;
+		rightSphereRitem->PositionDecode = positionDecode(sphereSubmesh);
+		rightSphereRitem->Bounds = sphereSubmesh.Bounds;
+		rightSphereRitem->Lods = sphereLods;
 
 		mAllRitems.push_back(std::move(leftCylRitem));
 		mAllRitems.push_back(std::move(rightCylRitem));
@@ -715,27 +1093,64 @@ void ShapesApp::BuildRenderItems()
 
 	for (auto& e : mAllRitems)
 		mOpaqueRitems.push_back(e.get());
+
+	// 모든 행렬을 기록하고 프레임 리소스마다 더티로 표시
+	mObjectTransforms = TransformArray((std::uint32_t)mNumFrameResources);
+	mObjectTransforms.Resize(mAllRitems.size());
+	for (auto& e : mAllRitems)
+		UpdateObjectTransform(e.get());
 }
 
-void ShapesApp::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::vector<RenderItem*>& ritems)
+void ShapesApp::SetPassState(ID3D12GraphicsCommandList* cmdList)
 {
-	UINT objCBByteSize = Util::CalcConstantBufferByteSize(sizeof(ObjectConstants));
+	cmdList->RSSetViewports(1, &mScreenViewport);
+	cmdList->RSSetScissorRects(1, &mScissorRect);
 
-	auto objectCB = mCurrFrameResource->ObjectCB->Resource();
+	cmdList->OMSetRenderTargets(1, &CurrentBackBufferView(), true, &DepthStencilView());
 
-	for (size_t i = 0; i < ritems.size(); ++i)
-	{
-		auto ri = ritems[i];
+	ID3D12DescriptorHeap* descriptorHeaps[] = { mDescriptorHeap->GetHeap() };
+	cmdList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
-		cmdList->IASetVertexBuffers(0, 1, &ri->Geo->VertexBufferView());
-		cmdList->IASetIndexBuffer(&ri->Geo->IndexBufferView());
-		cmdList->IASetPrimitiveTopology(ri->PrimitiveType);
+	// 루트 시그니처와 루트 인자는 DrawSink가 첫 그리기 전에 설정한다.
+}
 
-		UINT cbvIndex = mCurrFrameResourceIndex * (UINT)mOpaqueRitems.size() + ri->ObjCBIndex;
-		auto cbvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(mCbvHeap->GetGPUDescriptorHandleForHeapStart());
-		cbvHandle.Offset(cbvIndex, mCbvSrvUavDescriptorSize);
+void ShapesApp::SetPassRootArguments(ID3D12GraphicsCommandList* cmdList)
+{
+	cmdList->SetGraphicsRootDescriptorTable(1, mCurrFrameResource->PassCbv.GPU);
 
-		cmdList->SetGraphicsRootDescriptorTable(0, cbvHandle);
-		cmdList->DrawIndexedInstanced(ri->IndexCount, 1, ri->StartIndexLocation, ri->BaseVertexLocation, 0);
-	}
+	cmdList->SetGraphicsRootShaderResourceView(0, mCurrFrameResource->ObjectBuffer->Resource()->GetGPUVirtualAddress());
+	cmdList->SetGraphicsRootShaderResourceView(2, mCurrFrameResource->InstanceObjects.GPU);
+}
+
+// DrawSink는 여러 스레드에서 동시에 사용되므로 App의 멤버를 읽기만 한다.
+void ShapesApp::DrawSink::SetRootSignature(std::uint32_t id)
+{
+	// 루트 시그니처는 하나(id 0)뿐이다. 바뀌면 이전 루트 인자가 무효가 되므로 다시 설정한다.
+	CmdList->SetGraphicsRootSignature(App->mRootSignature.Get());
+	App->SetPassRootArguments(CmdList);
+}
+
+void ShapesApp::DrawSink::SetPipelineState(std::uint32_t id)
+{
+	// id는 PSO 핸들의 Index
+	CmdList->SetPipelineState(App->mPSOs.GetAt(id).Get());
+}
+
+void ShapesApp::DrawSink::SetGeometry(std::uint32_t id)
+{
+	const GeometryBinding& binding = App->mGeometryBindings[id];
+	CmdList->IASetVertexBuffers(0, 1, &binding.VertexBufferView);
+	CmdList->IASetIndexBuffer(&binding.IndexBufferView);
+}
+
+void ShapesApp::DrawSink::SetPrimitiveTopology(std::uint32_t topology)
+{
+	CmdList->IASetPrimitiveTopology((D3D12_PRIMITIVE_TOPOLOGY)topology);
+}
+
+void ShapesApp::DrawSink::Draw(const DrawItem& item)
+{
+	// 셰이더가 SV_InstanceID에 더할 이 묶음의 시작 위치 (gInstanceBase)
+	App->mObjectBinding.BindInstanceBase(CmdList, 3, item.StartInstance);
+	CmdList->DrawIndexedInstanced(item.IndexCount, item.InstanceCount, item.StartIndexLocation, item.BaseVertexLocation, 0);
 }
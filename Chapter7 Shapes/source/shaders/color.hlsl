@@ -1,6 +1,19 @@
-cbuffer cbPerObject : register(b0)
+struct ObjectData
 {
-    float4x4 gWorld;
+    float4x4 World;
+};
+
+// All object transforms, indexed by render item.
+StructuredBuffer<ObjectData> gObjects : register(t0);
+
+// Object index of each instance, packed batch by batch.
+StructuredBuffer<uint> gInstanceObjects : register(t1);
+
+cbuffer cbInstance : register(b0)
+{
+    // Offset of the current batch in gInstanceObjects, set per draw by
+    // ObjectBinding::BindInstanceBase in the root constant slot.
+    uint gInstanceBase;
 };
 
 cbuffer cbPass : register(b1)
@@ -33,12 +46,14 @@ struct VertexOut
     float4 Color : COLOR;
 };
 
-VertexOut VS(VertexIn vin)
+VertexOut VS(VertexIn vin, uint instanceID : SV_InstanceID)
 {
     VertexOut vout;
     
+    float4x4 world = gObjects[gInstanceObjects[gInstanceBase + instanceID]].World;
+
     // Transform to homogeneous clip space.
-    float4 posW = mul(float4(vin.PosL, 1.0f), gWorld);
+    float4 posW = mul(float4(vin.PosL, 1.0f), world);
     vout.PosH = mul(posW, gViewProj);
     
     // Pass through the color.
@@ -1,7 +1,13 @@
 #include "Application.h"
 #include <WindowsX.h>
+#include <shellapi.h>
+#include <thread>
 #include <vector>
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
 namespace Engine
 {
 	using Microsoft::WRL::ComPtr;
@@ -17,15 +23,23 @@ namespace Engine
 	Application::Application(HINSTANCE hInstance) 
 		: mhAppInst(hInstance)
 	{
-		assert(mApp == nullptr); // app ΰ ̻  ,  ߻
+		assert(mApp == nullptr); // app이 두개 이상 생성될 시, 오류 발생
 		mApp = this;
 	}
 
 	Application::~Application()
 	{
-		//   
-		if (mD3DDevice != nullptr)
+		// 명령 목록 방출
+		if (mFence != nullptr)
 			FlushCommandQueue();
+		// GPU가 유휴 상태이므로 남은 지연 해제 객체를 모두 해제
+		mDeferredReleases.ReleaseAll();
+
+		// 남아 있는 버퍼들은 할당기 없이도 힙 블록을 유지한다.
+		Util::SetBufferAllocator(nullptr);
+
+		if (mPacingTimer != nullptr)
+			CloseHandle(mPacingTimer);
 	}
 
 	Application* Application::GetApp()
@@ -38,7 +52,9 @@ namespace Engine
 		if (m4xMsaaState != value)
 		{
 			m4xMsaaState = value;
-			// 4x MSAA ° ǾǷ,  üΰ ۸ ٽ 
+			// 이전 스왑 체인을 해제하기 전에 마지막으로 제출한 프레임이 끝날 때까지 대기
+			mFence->WaitCPU(mFence->GetLastSignaledValue());
+			// 4x MSAA 상태가 변경되었으므로, 스왑 체인과 버퍼를 다시 생성
 			CreateSwapChain();
 			OnResize();
 		}
@@ -61,17 +77,36 @@ namespace Engine
 			// Otherwise, do animation/game stuff.
 			else
 			{
+				// 입력과 시간을 읽기 전에 앞선 프레임을 기다리고 잠든다.
+				if (!mAppPaused)
+					PaceFrame();
+
 				mTimer.Tick();
 
+				// 복사가 끝난 업로드의 스테이징 버퍼 해제
+				mUploadBatcher->Retire();
+				// GPU가 사용을 마친 지연 해제 객체 해제
+				mDeferredReleases.Retire(mFence->GetCompletedValue());
+				// GPU가 사용을 마친 서술자 회수
+				mDescriptorHeap->Retire();
+
 				if (!mAppPaused)
 				{
 					CalculateFrameStats();
+
+					auto frameStart = std::chrono::steady_clock::now();
+					double fenceWaitMs = mFence->GetWaitStats().TotalWaitMs;
 					Update(mTimer);
 					Draw(mTimer);
+					// 이번 프레임에 받은 프레임 링 서술자는 방금 Signal한 펜스가 통과하면 회수된다.
+					mDescriptorHeap->EndFrame(mFence->GetLastSignaledValue());
+					EndFrameTiming(frameStart, fenceWaitMs);
 				}
 				else
 				{
 					Sleep(100);
+					// 일시정지한 동안의 간격은 Present 간격으로 재지 않는다.
+					mHasLastPresentTime = false;
 				}
 			}
 		}
@@ -81,11 +116,20 @@ namespace Engine
 
 	bool Application::Initialize()
 	{
-		//  â ʱȭ
+		// 시작 설정을 읽고 페이싱 준비
+		ParseCommandLine();
+		mFramePacingSettings.MaxFramesInFlight = (std::uint32_t)mNumFrameResources;
+		mFramePacer = FramePacer(mFramePacingSettings);
+		mFrameFences.assign(mNumFrameResources, 0);
+		mPacingTimer = CreateWaitableTimerEx(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+		// 작업 시스템 생성 (이 스레드가 0번 덱을 사용)
+		mJobs = std::make_unique<JobSystem>();
+		// 윈도우 창 초기화
 		if (!InitMainWindow()) return false;
-		// Direct3D ʱȭ
+		// Direct3D 초기화
 		if (!InitDirect3D()) return false;
-		// â ũ 
+		// 창 크기 조정
 		OnResize();
 		return true;
 	}
@@ -93,22 +137,22 @@ namespace Engine
 	{
 		switch (msg)
 		{	
-			//  â Ȱȭ/Ȱȭ   ۵
+			// 윈도우 창이 활성화/비활성화 될 때 전송됨
 		case WM_ACTIVATE:
 			if (LOWORD(wParam) == WA_INACTIVE)
 			{
-				// â Ȱȭ ,  Ͻ
+				// 윈도우창이 비활성화 시, 게임 일시정지
 				mAppPaused = true;
 				mTimer.Stop();
 			}
 			else
 			{
-				// â Ȱȭ ,  簳
+				// 윈도우창이 활성화 시, 게임 재개
 				mAppPaused = false;
 				mTimer.Start();
 			}
 			return 0;
-			//  â ũⰡ   ۵
+			// 윈도우 창 크기가 변경될 때 전송됨
 		case WM_SIZE:
 			// Save the new client area dimensions.
 			mClientWidth = LOWORD(lParam);
@@ -146,13 +190,13 @@ namespace Engine
 						mMaximized = false;
 						OnResize();
 					}
-					//  ڰ  ٸ 巡ϰ ִ ̶,
+					// 만약 사용자가 리사이즈 바를 드래그하고 있는 중이라면,
 					else if (mResizing)
 					{
-						// WM_SIZE ޽  ۵Ǵµ,
-						// Žø  ũ⸦ ϴ  ȿ̰, ӵ Ƿ,
-						// ڰ  ٿ    WM_EXITSIZEMOVE ޽ ۵ǹǷ,
-						// ̶ ۸ 缳Ѵ.
+						// WM_SIZE 메시지가 연속적으로 전송되는데,
+						// 수신시마다 버퍼 크기를 변경하는 것은 비효율적이고, 속도가 느리므로,
+						// 사용자가 사이즈 바에서 손을 때는 순간에 WM_EXITSIZEMOVE 메시지가 전송되므로,
+						// 이때 버퍼를 재설정한다.
 					}
 					// API call such as SetWindowPos or mSwapChain->SetFullscreenState.
 					else 
@@ -162,14 +206,14 @@ namespace Engine
 				}
 			}
 			return 0;
-			// WM_ENTERSIZEMOVE ڰ  ٸ   ۵
+			// WM_ENTERSIZEMOVE는 사용자가 리사이즈 바를 잡을 때 전송됨
 		case WM_ENTERSIZEMOVE:
 			mAppPaused = true;
 			mResizing = true;
 			mTimer.Stop();
 			return 0;
-			// WM_EXITSIZEMOVE ڰ  ٿ    ۵
-			// ⼭   ο â ũ⿡ ° 缳Ѵ.
+			// WM_EXITSIZEMOVE는 사용자가 리사이즈 바에서 손을 뗄 때 전송됨
+			// 여기서 모든 것을 새로운 창 크기에 맞게 재설정한다.
 		case WM_EXITSIZEMOVE:
 			mAppPaused = false;
 			mResizing = false;
@@ -177,15 +221,15 @@ namespace Engine
 			OnResize();
 			return 0;
 
-			// WM_DESTROY â ı  ۵
+			// WM_DESTROY는 창이 파괴될 때 전송됨
 		case WM_DESTROY:
 			PostQuitMessage(0);
 			return 0;
-			// WM_MENUCHAR ޴ ȰȭǾ ְ, ڰ Ű  Ű ش ʴ Ű   ۵
+			// WM_MENUCHAR는 메뉴가 활성화되어 있고, 사용자가 단축키나 엑셀러레이터 키에 해당하지 않는 키를 눌렀을 때 전송됨
 		case WM_MENUCHAR:
 			// Don't beep when we alt-enter.
 			return MAKELRESULT(0, MNC_CLOSE);
-			//  ũⰡ ʹ ۾  
+			// 윈도우 크기가 너무 작아지는 것을 방지
 		case WM_GETMINMAXINFO:
 			((MINMAXINFO*)lParam)->ptMinTrackSize.x = 200;
 			((MINMAXINFO*)lParam)->ptMinTrackSize.y = 200;
@@ -221,36 +265,37 @@ namespace Engine
 	{
 		assert(mD3DDevice);
 		assert(mSwapChain);
-		assert(mDirectCmdListAlloc);
+		assert(mResizeCmdListAlloc);
 
-		//      Ƿ, 
-		FlushCommandQueue();
-		//   ʱȭ
-		ThrowIfFailed(mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr));
+		// ResizeBuffers 전에 스왑 체인 버퍼에 대한 참조가 모두 해제되어 있어야 하고 GPU도 사용을 마쳐야 한다.
+		// 새 명령을 Signal해서 큐 전체를 비우는 대신, 마지막으로 제출한 프레임의 펜스만 기다린다.
+		mFence->WaitCPU(mFence->GetLastSignaledValue());
+		// 명령 목록을 초기화 (이전 OnResize의 명령도 위에서 끝났으므로 할당자를 재사용할 수 있다)
+		ThrowIfFailed(mResizeCmdListAlloc->Reset());
+		ThrowIfFailed(mCommandList->Reset(mResizeCmdListAlloc.Get(), nullptr));
 
-		//   ü   ٽ ۸ 
-		for (int i = 0; i < SwapChainBufferCount; ++i)
+		// 모든 스왑 체인 버퍼를 해제
+		for (int i = 0; i < mSwapChainBufferCount; ++i)
 			mSwapChainBuffer[i].Reset();
-		mDepthStencilBuffer.Reset();
+		// 깊이 스텐실 버퍼는 스왑 체인과 무관하므로 지연 해제
+		DeferRelease(mDepthStencilBuffer, mFence->GetLastSignaledValue());
 
-		//  ü  ũ 
+		// 스왑 체인 버퍼 크기 조정
 		ThrowIfFailed(mSwapChain->ResizeBuffers(
-			SwapChainBufferCount,
+			mSwapChainBufferCount,
 			mClientWidth, mClientHeight,
 			mBackBufferFormat,
 			DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH));
 
 		mCurrentBackBuffer = 0;
 
-		//  ü ۵鿡   Ÿ 並 ٽ 
-		CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHeapHandle(mRtvHeap->GetCPUDescriptorHandleForHeapStart());
-		for (UINT i = 0; i < SwapChainBufferCount; ++i)
+		// 스왑 체인 버퍼들에 대한 렌더 타겟 뷰를 같은 칸에 다시 생성
+		for (int i = 0; i < mSwapChainBufferCount; ++i)
 		{
 			ThrowIfFailed(mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mSwapChainBuffer[i])));
-			mD3DDevice->CreateRenderTargetView(mSwapChainBuffer[i].Get(), nullptr, rtvHeapHandle);
-			rtvHeapHandle.Offset(1, mRtvDescriptorSize);
+			mD3DDevice->CreateRenderTargetView(mSwapChainBuffer[i].Get(), nullptr, mSwapChainRtvs[i].CPU);
 		}
-		// -ٽ   並 ٽ 
+		// 깊이-스텐실 버퍼 및 뷰를 다시 생성
 		D3D12_RESOURCE_DESC depthStencilDesc;
 		depthStencilDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
 		depthStencilDesc.Alignment = 0;
@@ -258,22 +303,22 @@ namespace Engine
 		depthStencilDesc.Height = mClientHeight;
 		depthStencilDesc.DepthOrArraySize = 1;
 		depthStencilDesc.MipLevels = 1;
-		// SSAO éͿ  ۷κ ͸ б  SRV ʿϴ.
-		//   ڿ  ΰ 並 ؾѴ.
-		// 1. SRV Ÿ: DXGI_FORMAT_R24_UNORM_X8_TYPELESS
-		// 2. DSV Ÿ: DXGI_FORMAT_D24_UNORM_S8_UINT
-		//   ҽ typeless  ؾ Ѵ.
+		// SSAO 챕터에서 깊이 버퍼로부터 데이터를 읽기 위해 SRV가 필요하다.
+		// 따라서 동일한 자원에 대해 두가지 뷰를 생성해야한다.
+		// 1. SRV 타입: DXGI_FORMAT_R24_UNORM_X8_TYPELESS
+		// 2. DSV 타입: DXGI_FORMAT_D24_UNORM_S8_UINT
+		// 따라서 버퍼 리소스를 typeless 포맷으로 생성해야 한다.
 		depthStencilDesc.Format = DXGI_FORMAT_R24G8_TYPELESS;
 		depthStencilDesc.SampleDesc.Count = m4xMsaaState ? 4 : 1;
 		depthStencilDesc.SampleDesc.Quality = m4xMsaaState ? (m4xMsaaQuality - 1) : 0;
 		depthStencilDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
 		depthStencilDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
 
-		D3D12_CLEAR_VALUE optClear; // ʱȭ 
+		D3D12_CLEAR_VALUE optClear; // 초기화 값
 		optClear.Format = mDepthStencilFormat;
 		optClear.DepthStencil.Depth = 1.0f;
 		optClear.DepthStencil.Stencil = 0;
-		// -ٽ  
+		// 깊이-스텐실 버퍼 생성
 		ThrowIfFailed(mD3DDevice->CreateCommittedResource(
 			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
 			D3D12_HEAP_FLAG_NONE,
@@ -282,7 +327,7 @@ namespace Engine
 			&optClear,
 			IID_PPV_ARGS(mDepthStencilBuffer.GetAddressOf())));
 
-		//  ҽ  Ӹʷ 0 並 .
+		// 모든 리소스에 대한 밉맵레벨 0인 뷰를 만든다.
 		D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc;
 		dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
 		dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
@@ -290,21 +335,21 @@ namespace Engine
 		dsvDesc.Texture2D.MipSlice = 0;
 		mD3DDevice->CreateDepthStencilView(mDepthStencilBuffer.Get(), &dsvDesc, DepthStencilView());
 
-		// -ٽ ۸ Ϲ ¿ -ٽ  · ȯ
+		// 깊이-스텐실 버퍼를 일반 상태에서 깊이-스텐실 쓰기 상태로 전환
 		mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(
 			mDepthStencilBuffer.Get(),
 			D3D12_RESOURCE_STATE_COMMON,
 			D3D12_RESOURCE_STATE_DEPTH_WRITE));
 
-		//   ݰ, 
+		// 명령 목록을 닫고, 실행
 		ThrowIfFailed(mCommandList->Close());
 		ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
 		mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
-		// GPU  Ϸ  
-		FlushCommandQueue();
+		// 완료를 기다리지 않고 펜스만 Signal한다. 이후 프레임과 다음 OnResize는 이 펜스 값 이후에 실행된다.
+		mFence->Signal(mCommandQueue.Get());
 
-		// Ʈ   簢 Ŭ̾Ʈ  ũ⿡ ° 
+		// 뷰포트 및 가위 사각형을 클라이언트 영역 크기에 맞게 설정
 		mScreenViewport.TopLeftX = 0;
 		mScreenViewport.TopLeftY = 0;
 		mScreenViewport.Width = static_cast<float>(mClientWidth);
@@ -317,19 +362,17 @@ namespace Engine
 
 	void Application::CreateRtvAndDsvDescriptorHeaps()
 	{
-		D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc;
-		rtvHeapDesc.NumDescriptors = SwapChainBufferCount;
-		rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-		rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-		rtvHeapDesc.NodeMask = 0;
-		ThrowIfFailed(mD3DDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&mRtvHeap)));
-
-		D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc;
-		dsvHeapDesc.NumDescriptors = 1;
-		dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
-		dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-		dsvHeapDesc.NodeMask = 0;
-		ThrowIfFailed(mD3DDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&mDsvHeap)));
+		// 힙 크기는 스왑 체인 버퍼 수와 무관하다. 파생 클래스가 렌더 타겟을 더 만들면 같은 힙에서 칸을 받는다.
+		mRtvHeap = std::make_unique<StagingDescriptorHeap>(mD3DDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, 16);
+		mDsvHeap = std::make_unique<StagingDescriptorHeap>(mD3DDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_DSV, 8);
+
+		mSwapChainRtvs.resize(mSwapChainBufferCount);
+		for (DescriptorAllocation& rtv : mSwapChainRtvs)
+			rtv = mRtvHeap->Allocate();
+		mDepthStencilDsv = mDsvHeap->Allocate();
+
+		mDescriptorHeap = std::make_unique<ShaderVisibleDescriptorHeap>(mD3DDevice.Get(),
+			mPersistentDescriptorCount, mFrameDescriptorCount, mFence.get());
 	}
 
 	bool Application::InitMainWindow()
@@ -352,7 +395,7 @@ namespace Engine
 			return false;
 		}
 
-		//  ڽ ũ 
+		// 윈도우 박스 크기 계산
 		RECT R = { 0, 0, mClientWidth, mClientHeight };
 		AdjustWindowRect(&R, WS_OVERLAPPEDWINDOW, false);
 		int width = R.right - R.left;
@@ -373,7 +416,7 @@ namespace Engine
 
 	bool Application::InitDirect3D()
 	{
-		// D3D12   Ȱȭ
+		// D3D12 디버그 계층 활성화
 		#if defined(DEBUG) || defined(_DEBUG)
 		
 		#endif	
@@ -385,12 +428,12 @@ namespace Engine
 
 		ThrowIfFailed(CreateDXGIFactory1(IID_PPV_ARGS(&mDxgiFactory)));
 
-		// ϵ ̽  õ
+		// 하드웨어 디바이스 생성 시도
 		HRESULT hardwareResult = D3D12CreateDevice(
-			nullptr, // ⺻ 
+			nullptr, // 기본 어댑터
 			D3D_FEATURE_LEVEL_11_0,
 			IID_PPV_ARGS(&mD3DDevice));
-		// н Ʈ ̽(WARP) 
+		// 실패시 소프트웨어 디바이스(WARP) 생성
 		if (FAILED(hardwareResult))
 		{
 			ComPtr<IDXGIAdapter> pWarpAdapter;
@@ -400,33 +443,40 @@ namespace Engine
 				D3D_FEATURE_LEVEL_11_0,
 				IID_PPV_ARGS(&mD3DDevice)));
 		}
-		// CPU/GPU ȭ  潺 
-		ThrowIfFailed(mD3DDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+		// 이후 CreateDefaultBuffer로 만드는 버퍼는 힙 블록 안에 배치된다.
+		mBufferAllocator = std::make_unique<PlacedBufferAllocator>(mD3DDevice.Get());
+		Util::SetBufferAllocator(mBufferAllocator.get());
+
+		mUploadBatcher = std::make_unique<UploadBatcher>(mD3DDevice.Get());
+
+		// CPU/GPU 동기화를 위한 펜스 생성
+		mFence = std::make_unique<Fence>(mD3DDevice.Get());
 
 		mRtvDescriptorSize = mD3DDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
 		mDsvDescriptorSize = mD3DDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
 		mCbvSrvUavDescriptorSize = mD3DDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
-		// 4x MSAA ǰ  Ȯ
-		// Direct3D 11 ư  ϵ 4x MSAA ϹǷ,
-		// ǰ ظ Ȯϸ 
+		// 4x MSAA 품질 수준을 확인
+		// Direct3D 11이 돌아가는 모든 하드웨어는 4x MSAA를 지원하므로,
+		// 품질 수준만을 확인하면 됨
 		D3D12_FEATURE_DATA_MULTISAMPLE_QUALITY_LEVELS msQualityLevels;
 		msQualityLevels.Format = mBackBufferFormat;
 		msQualityLevels.SampleCount = 4;
 		msQualityLevels.Flags = D3D12_MULTISAMPLE_QUALITY_LEVELS_FLAG_NONE;
-		msQualityLevels.NumQualityLevels = 0; // ᱣ  
+		msQualityLevels.NumQualityLevels = 0; // 결괏값이 여기 저장됨
 		ThrowIfFailed(mD3DDevice->CheckFeatureSupport(
 			D3D12_FEATURE_MULTISAMPLE_QUALITY_LEVELS,
 			&msQualityLevels,
 			sizeof(msQualityLevels)));
 		m4xMsaaQuality = msQualityLevels.NumQualityLevels;
-		assert(m4xMsaaQuality > 0 && "Unexpected MSAA quality level."); // ǰ  0 Ŀ 
+		assert(m4xMsaaQuality > 0 && "Unexpected MSAA quality level."); // 품질 수준이 0보다 커야 함
 #ifdef _DEBUG
 		LogAdapters();
 #endif
-		CreateCommandObjects(); // ɴ⿭, Ҵ, ɸ 
-		CreateSwapChain();    // ü 
-		CreateRtvAndDsvDescriptorHeaps(); // RTV, DSV   
+		CreateCommandObjects(); // 명령대기열, 명령할당자, 명령목록 생성
+		mGpuFrameTimer = std::make_unique<GpuFrameTimer>(mD3DDevice.Get(), mCommandQueue.Get(), mNumFrameResources);
+		CreateSwapChain();    // 스왑체인 생성
+		CreateRtvAndDsvDescriptorHeaps(); // RTV, DSV, 셰이더 가시 서술자 힙 생성
 
 		return true;
 	}
@@ -435,24 +485,26 @@ namespace Engine
 		D3D12_COMMAND_QUEUE_DESC queueDesc = {};
 		queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
 		queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
-		//  ⿭ 
+		// 명령 대기열 생성
 		ThrowIfFailed(mD3DDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue)));
-		//  Ҵ 
+		// 명령 할당자 생성
 		ThrowIfFailed(mD3DDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(mDirectCmdListAlloc.GetAddressOf())));
-		//   
+		ThrowIfFailed(mD3DDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(mResizeCmdListAlloc.GetAddressOf())));
+		// 명령 목록 생성
 		ThrowIfFailed(mD3DDevice->CreateCommandList(
 			0,
 			D3D12_COMMAND_LIST_TYPE_DIRECT,
-			mDirectCmdListAlloc.Get(), //  Ҵ
-			nullptr, // ʱ   ü
+			mDirectCmdListAlloc.Get(), // 명령 할당자
+			nullptr, // 초기 파이프라인 상태 객체
 			IID_PPV_ARGS(mCommandList.GetAddressOf())));
 
-		//   ÿ  ̹Ƿ,  Reset ȣϱ ؼ Close ݾ 
+		// 명령 목록은 생성시엔 기록 상태이므로, 이후 Reset을 호출하기 위해선 Close로 닫아줘야 함
 		mCommandList->Close(); 
 	}
 	void Application::CreateSwapChain()
 	{
-		//  ü ٽ ϱ    ü 
+		// 스왑 체인을 다시 생성하기 전에 이전 스왑 체인과 버퍼를 정리
+		mSwapChainBuffer.assign(mSwapChainBufferCount, nullptr);
 		mSwapChain.Reset();
 
 		DXGI_SWAP_CHAIN_DESC sd = {};
@@ -466,13 +518,13 @@ namespace Engine
 		sd.SampleDesc.Count = m4xMsaaState ? 4 : 1;
 		sd.SampleDesc.Quality = m4xMsaaState ? (m4xMsaaQuality - 1) : 0;
 		sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-		sd.BufferCount = SwapChainBufferCount;
+		sd.BufferCount = mSwapChainBufferCount;
 		sd.OutputWindow = mhMainWnd;
 		sd.Windowed = true;
 		sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
 		sd.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
 
-		//  ü  ⿭ ̿ؼ Flush Ѵ.
+		// 스왑 체인은 명령 대기열을 이용해서 Flush를 수행한다.
 		ThrowIfFailed(mDxgiFactory->CreateSwapChain(
 			mCommandQueue.Get(),
 			&sd,
@@ -481,24 +533,81 @@ namespace Engine
 
 	void Application::FlushCommandQueue()
 	{
-		// 潺  ϳ ,
-		//  Ÿ  ɵ ǥѴ.
-		++mCurrentFence;
+		// 현재 울타리 지점을 설정(하는 명령을 GPU에 추가)하고,
+		// CPU가 그 지점에 도달할 때까지 대기한다. (대기 이벤트는 펜스가 재사용)
+		mFence->WaitCPU(mFence->Signal(mCommandQueue.Get()));
+	}
+
+	void Application::PaceFrame()
+	{
+		const FramePacingDecision& decision = mFramePacer.GetDecision();
 
-		//  Ÿ  (ϴ  GPU ߰)Ѵ.
-		ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), mCurrentFence));
+		// FramesInFlight 프레임 전에 제출한 프레임이 끝나야 새 프레임을 시작한다.
+		// (FramesInFlight <= mNumFrameResources이므로 이번에 쓸 프레임 리소스도 비어 있다)
+		if (mFrameCount >= decision.FramesInFlight)
+			mFence->WaitCPU(mFrameFences[(mFrameCount - decision.FramesInFlight) % mFrameFences.size()]);
 
-		// CPU  Ÿ    
-		if (mFence->GetCompletedValue() < mCurrentFence)
+		if (decision.SleepMs > 0.0)
+			SleepFor(decision.SleepMs);
+	}
+
+	void Application::EndFrameTiming(std::chrono::steady_clock::time_point frameStart, double fenceWaitMsAtStart)
+	{
+		auto now = std::chrono::steady_clock::now();
+
+		mFrameFences[mFrameCount % mFrameFences.size()] = mFence->GetLastSignaledValue();
+		++mFrameCount;
+		mGpuFrameTimer->EndFrame(mFence->GetLastSignaledValue());
+
+		FrameTimingSample sample;
+		// Update와 Draw 안에서 펜스를 기다린 시간은 CPU 시간에서 뺀다.
+		double fenceWaitMs = mFence->GetWaitStats().TotalWaitMs - fenceWaitMsAtStart;
+		sample.CpuMs = std::max(std::chrono::duration<double, std::milli>(now - frameStart).count() - fenceWaitMs, 0.0);
+		sample.GpuMs = mGpuFrameTimer->Collect(mFence->GetCompletedValue());
+		// Present는 Draw의 마지막에 호출되므로 Draw가 끝난 시점 사이의 간격으로 잰다.
+		if (mHasLastPresentTime)
+			sample.PresentIntervalMs = std::chrono::duration<double, std::milli>(now - mLastPresentTime).count();
+		mLastPresentTime = now;
+		mHasLastPresentTime = true;
+
+		mFramePacer.AddSample(sample);
+	}
+
+	void Application::SleepFor(double ms)
+	{
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double, std::milli>(ms);
+
+		// 타이머로 대부분을 잠들고, 남은 짧은 시간은 양보하며 기다린다.
+		if (mPacingTimer != nullptr && ms > 1.0)
 		{
-			HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-			// 潺  Ÿ  ϸ ̺Ʈ ߻ǵ 潺 ˸ 
-			ThrowIfFailed(mFence->SetEventOnCompletion(mCurrentFence, eventHandle));
-			// ̺Ʈ ߻  
-			WaitForSingleObject(eventHandle, INFINITE);
-			// ̺Ʈ ڵ ݱ
-			CloseHandle(eventHandle);
+			LARGE_INTEGER dueTime;
+			dueTime.QuadPart = -(LONGLONG)((ms - 0.5) * 10000.0); // 100ns 단위, 음수는 상대 시간
+			if (SetWaitableTimer(mPacingTimer, &dueTime, 0, nullptr, nullptr, false))
+				WaitForSingleObject(mPacingTimer, INFINITE);
 		}
+		while (std::chrono::steady_clock::now() < deadline)
+			std::this_thread::yield();
+	}
+
+	void Application::ParseCommandLine()
+	{
+		int argc = 0;
+		LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+		if (argv == nullptr)
+			return;
+
+		for (int i = 1; i + 1 < argc; ++i)
+		{
+			if (_wcsicmp(argv[i], L"-swapchainbuffers") == 0)
+				mSwapChainBufferCount = _wtoi(argv[++i]);
+			else if (_wcsicmp(argv[i], L"-framesinflight") == 0)
+				mNumFrameResources = _wtoi(argv[++i]);
+		}
+		LocalFree(argv);
+
+		// 플립 모델 스왑 체인은 버퍼가 2개 이상 필요하다.
+		mSwapChainBufferCount = std::min(std::max(mSwapChainBufferCount, 2), DXGI_MAX_SWAP_CHAIN_BUFFERS);
+		mNumFrameResources = std::min(std::max(mNumFrameResources, 1), 8);
 	}
 
 	void Application::CalculateFrameStats()
@@ -509,23 +618,34 @@ namespace Engine
 
 		frameCount++;
 
-		// 1ʸ   и   ð 
+		// 1초마다의 프레임 수와 밀리초 단위의 프레임 시간을 계산
 		if ((mTimer.TotalTime() - timeElapsed) >= 1.0f)
 		{
-			float fps = (float)frameCount; // ʴ  
-			float mspf = 1000.0f / fps;    //   и
+			float fps = (float)frameCount; // 초당 프레임 수
+			float mspf = 1000.0f / fps;    // 프레임 당 밀리초
+			// 프레임 당 GPU를 기다린 밀리초
+			float waitmspf = mFence != nullptr ? (float)mFence->GetWaitStats().TotalWaitMs / frameCount : 0.0f;
+			const FramePacingDecision& pacing = mFramePacer.GetDecision();
 
 			std::wstring fpsString = std::to_wstring(fps);
 			std::wstring mspfString = std::to_wstring(mspf);
+			std::wstring waitString = std::to_wstring(waitmspf);
 
 			std::wstring windowText = mMainWndCaption +
 				L"    fps: " + fpsString +
-				L"    mspf: " + mspfString;
+				L"    mspf: " + mspfString +
+				L"    gpu wait: " + waitString +
+				L"    frames in flight: " + std::to_wstring(pacing.FramesInFlight) +
+				L"    pacing sleep: " + std::to_wstring(pacing.SleepMs) +
+				GetFrameStatsText();
+
+			if (mFence != nullptr)
+				mFence->ResetWaitStats();
 
-			//  ĸ ٿ 
+			// 윈도우 캡션 바에 출력
 			SetWindowText(mhMainWnd, windowText.c_str());
 
-			//    ʱȭ
+			// 다음 계산을 위해 초기화
 			frameCount = 0;
 			timeElapsed += 1.0f;
 		}
@@ -584,7 +704,7 @@ namespace Engine
 		UINT count = 0;
 		UINT flags = 0;
 
-		// Ʈ    nullptr 
+		// 리스트 갯수를 얻기 위해 nullptr를 전달
 		output->GetDisplayModeList(format, flags, &count, nullptr);
 
 		std::vector<DXGI_MODE_DESC> modeList(count);
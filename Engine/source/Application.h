@@ -8,8 +8,17 @@
 #include "EngineHeader.h"
 #include "Util.h"
 #include "GameTimer.h"
-
-// ʼ D3D12 ̺귯 ũ
+#include "Fence.h"
+#include "PlacedBufferAllocator.h"
+#include "UploadBatcher.h"
+#include "DeferredReleaseQueue.h"
+#include "JobSystem.h"
+#include "FramePacer.h"
+#include "GpuFrameTimer.h"
+#include "DescriptorHeap.h"
+#include <chrono>
+
+// 필수적인 D3D12 라이브러리들을 링크
 #pragma comment(lib,"d3dcompiler.lib")
 #pragma comment(lib, "D3D12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -34,123 +43,206 @@ namespace Engine
 		inline bool Get4xMsaaState() const { return m4xMsaaState; }
 		inline void Set4xMsaaState(bool value);
 		/// <summary>
-		/// ø̼ 
+		/// 어플리케이션 실행
 		/// </summary>
 		int Run();
 		/// <summary>
-		/// ø̼ ʱȭ
+		/// 어플리케이션 초기화
 		/// </summary>
 		virtual bool Initialize();
 		/// <summary>
-		/// ǽ, ǵ Լ ó  ޼ ݵ ⺻ Լ ޵Ǿ  
+		/// 재정의시, 재정의된 함수에서 처리되지 못한 메세지는 반드시 기본 함수로 전달되어야 함 
 		/// </summary>
 		virtual LRESULT MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 	protected:
 		static Application* mApp;
 
-		HINSTANCE mhAppInst = nullptr; // α׷ νϽ ڵ
-		HWND mhMainWnd = nullptr;      //   ڵ
-		bool mAppPaused = false;       // ø̼ Ͻ 
-		bool mMinimized = false;     // ø̼ ּȭ 
-		bool mMaximized = false;     // ø̼ üȭ 
-		bool mResizing = false;       //  ũ  (=  ٸ 巡 ) 
+		HINSTANCE mhAppInst = nullptr; // 프로그램 인스턴스 핸들
+		HWND mhMainWnd = nullptr;      // 메인 윈도우 핸들
+		bool mAppPaused = false;       // 애플리케이션 일시정지 여부
+		bool mMinimized = false;     // 애플리케이션 최소화 여부
+		bool mMaximized = false;     // 애플리케이션 전체화면 여부
+		bool mResizing = false;       // 윈도우 크기 조절 중(= 리사이즈 바를 드래그 중) 여부
 		
-		// 4x MSAA Ѵٸ true (⺻ false)
-		bool m4xMsaaState = false; // 4x MSAA Ȱȭ 
-		UINT m4xMsaaQuality = 0;   // 4x MSAA ǰ 
+		// 4x MSAA를 사용한다면 true (기본은 false)
+		bool m4xMsaaState = false; // 4x MSAA 활성화 여부
+		UINT m4xMsaaQuality = 0;   // 4x MSAA 품질 수준
 		
-		// DeltaTime ü  ð ϴ Ÿ̸
-		GameTimer mTimer;          //  Ÿ̸
+		// DeltaTime과 전체 게임 시간을 관리하는 타이머
+		GameTimer mTimer;          // 게임 타이머
 		
-		Microsoft::WRL::ComPtr<ID3D12Device> mD3DDevice; // ̽
-		Microsoft::WRL::ComPtr<IDXGIFactory4> mDxgiFactory; // DXGI 丮
-
-		// CPU/GPU ȭ  潺 
-		UINT64 mCurrentFence = 0;
-		Microsoft::WRL::ComPtr<ID3D12Fence> mFence;
-
-		//  ⿭,  Ҵ,   
-		Microsoft::WRL::ComPtr<ID3D12CommandQueue> mCommandQueue; //  ⿭
-		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> mDirectCmdListAlloc; //  Ҵ
-		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> mCommandList; //  
-
-		//  ü 
-		Microsoft::WRL::ComPtr<IDXGISwapChain> mSwapChain; //  ü
-		static const int SwapChainBufferCount = 2; //  ü  
-		int mCurrentBackBuffer = 0; //   ε
-		Microsoft::WRL::ComPtr<ID3D12Resource> mSwapChainBuffer[SwapChainBufferCount]; //  ü 
-		Microsoft::WRL::ComPtr<ID3D12Resource> mDepthStencilBuffer; // -ٽ 
-
-		//   
-		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mRtvHeap; // RTV  
-		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mDsvHeap; // DSV  
+		Microsoft::WRL::ComPtr<ID3D12Device> mD3DDevice; // 디바이스
+		Microsoft::WRL::ComPtr<IDXGIFactory4> mDxgiFactory; // DXGI 팩토리
+
+		// Util::CreateDefaultBuffer로 만드는 버퍼들을 큰 힙 블록 안에 배치하는 할당기
+		std::unique_ptr<PlacedBufferAllocator> mBufferAllocator;
+
+		// 프레임마다 CPU 작업(상수 갱신, 컬링, 명령 기록)을 나누어 실행하는 작업 시스템
+		std::unique_ptr<JobSystem> mJobs;
+
+		// 전용 복사 큐로 지오메트리 업로드를 모아서 제출 (스테이징 버퍼는 매 프레임 자동으로 회수됨)
+		std::unique_ptr<UploadBatcher> mUploadBatcher;
+
+		// CPU/GPU 동기화를 위한 펜스 (마지막으로 Signal한 값은 mFence->GetLastSignaledValue())
+		std::unique_ptr<Fence> mFence;
+
+		// 프레임 페이싱: 측정값으로 진행 중인 프레임 수와 프레임 시작 전에 잠들 시간을 정한다.
+		FramePacer mFramePacer;
+		// 파생 클래스가 프레임의 첫 명령 목록에 Begin, 마지막 명령 목록에 End를 기록하면 GPU 시간을 잴 수 있다.
+		std::unique_ptr<GpuFrameTimer> mGpuFrameTimer;
+
+		// mFence가 통과하면 해제할 객체들 (교체된 PSO, 이전 깊이 버퍼, 업로드 버퍼 등. 매 프레임 회수됨)
+		DeferredReleaseQueue<Microsoft::WRL::ComPtr<IUnknown>> mDeferredReleases;
+
+		// 명령 대기열, 명령 할당자, 명령 목록 변수
+		Microsoft::WRL::ComPtr<ID3D12CommandQueue> mCommandQueue; // 명령 대기열
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> mDirectCmdListAlloc; // 명령 할당자
+		// OnResize 전용 명령 할당자. OnResize는 GPU를 기다리지 않고 반환하므로 mDirectCmdListAlloc과 분리한다.
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> mResizeCmdListAlloc;
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> mCommandList; // 명령 목록
+
+		// 스왑 체인 변수
+		Microsoft::WRL::ComPtr<IDXGISwapChain> mSwapChain; // 스왑 체인
+		int mCurrentBackBuffer = 0; // 현재 백버퍼 인덱스
+		std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> mSwapChainBuffer; // 스왑 체인 버퍼 (mSwapChainBufferCount개)
+		Microsoft::WRL::ComPtr<ID3D12Resource> mDepthStencilBuffer; // 깊이-스텐실 버퍼
+
+		// 서술자 힙 변수
+		std::unique_ptr<StagingDescriptorHeap> mRtvHeap; // RTV 서술자 힙 (칸을 재사용하고 모자라면 늘어난다)
+		std::unique_ptr<StagingDescriptorHeap> mDsvHeap; // DSV 서술자 힙
+		std::vector<DescriptorAllocation> mSwapChainRtvs; // 스왑 체인 버퍼마다의 RTV
+		DescriptorAllocation mDepthStencilDsv;            // 깊이-스텐실 버퍼의 DSV
+		// 셰이더 가시 CBV/SRV/UAV 힙 (영속 영역 + 프레임 링). Run이 매 프레임 회수하고 Draw 뒤에 프레임을 닫는다.
+		std::unique_ptr<ShaderVisibleDescriptorHeap> mDescriptorHeap;
 		
-		UINT mRtvDescriptorSize = 0; // RTV  ũ
-		UINT mDsvDescriptorSize = 0; // DSV  ũ
-		UINT mCbvSrvUavDescriptorSize = 0; // CBV/SRV/UAV  ũ
+		UINT mRtvDescriptorSize = 0; // RTV 서술자 크기
+		UINT mDsvDescriptorSize = 0; // DSV 서술자 크기
+		UINT mCbvSrvUavDescriptorSize = 0; // CBV/SRV/UAV 서술자 크기
 
-		// Ʈ   簢
+		// 뷰포트 및 가위 사각형
 		D3D12_VIEWPORT mScreenViewport;
 		D3D12_RECT mScissorRect;
 
-		// ӵǴ Ŭ ݵ  Ʒ  ڿ ʱȭ ؾ 
-		std::wstring mMainWndCaption = L"Direct3D Application"; //  â 
-		D3D_DRIVER_TYPE md3dDriverType = D3D_DRIVER_TYPE_HARDWARE; // ̽ ̹ Ÿ
-		DXGI_FORMAT mBackBufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM; //  
-		DXGI_FORMAT mDepthStencilFormat = DXGI_FORMAT_D24_UNORM_S8_UINT; // -ٽ  
-		int mClientWidth = 800;  // Ŭ̾Ʈ  ʺ
-		int mClientHeight = 600; // Ŭ̾Ʈ  
-
-	//  Լ
+		// 상속되는 클래스는 반드시 이 아래 변수들을 생성자에서 초기화 해야 함
+		std::wstring mMainWndCaption = L"Direct3D Application"; // 윈도우 창 제목
+		D3D_DRIVER_TYPE md3dDriverType = D3D_DRIVER_TYPE_HARDWARE; // 디바이스 드라이버 타입
+		DXGI_FORMAT mBackBufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM; // 백버퍼 포맷
+		DXGI_FORMAT mDepthStencilFormat = DXGI_FORMAT_D24_UNORM_S8_UINT; // 깊이-스텐실 버퍼 포맷
+		int mClientWidth = 800;  // 클라이언트 영역 너비
+		int mClientHeight = 600; // 클라이언트 영역 높이
+		// 명령줄의 -swapchainbuffers N, -framesinflight N 으로도 바꿀 수 있다.
+		int mSwapChainBufferCount = 2; // 스왑 체인 버퍼 개수
+		int mNumFrameResources = 3;    // 동시에 진행할 수 있는 최대 프레임 수 (파생 클래스는 프레임 리소스를 이만큼 만든다)
+		FramePacingSettings mFramePacingSettings; // MaxFramesInFlight는 mNumFrameResources로 맞춰진다
+		UINT mPersistentDescriptorCount = 4096; // mDescriptorHeap의 영속 영역 서술자 수
+		UINT mFrameDescriptorCount = 4096;      // mDescriptorHeap의 프레임 링 서술자 수 (진행 중인 모든 프레임 합)
+
+	// 재정의 함수들
 	protected:
-		virtual void OnResize(); //  ũ   ȣ
+		virtual void OnResize(); // 윈도우 크기 조절 시 호출
 		virtual void CreateRtvAndDsvDescriptorHeaps();
 
-		// ƽ ȣǴ Ʈ   Լ
+		// 틱당 호출되는 업데이트 및 렌더링 함수
 		virtual void Update(const GameTimer& gt) = 0;
 		virtual void Draw(const GameTimer& gt) = 0;
+
+		// 파생 클래스가 윈도우 캡션의 프레임 통계 뒤에 덧붙일 문자열 (1초마다 호출)
+		virtual std::wstring GetFrameStatsText() const { return std::wstring(); }
 		
-		// 콺 Է ̺Ʈ ó Լ
+		// 마우스 입력 이벤트 처리 함수들
 		virtual void OnMouseDown(WPARAM btnState, int x, int y) {}
 		virtual void OnMouseUp(WPARAM btnState, int x, int y) {}
 		virtual void OnMouseMove(WPARAM btnState, int x, int y) {}
 
 	protected:
 		/// <summary>
-		///  â ʱȭ(Initialize Լ ȣ)
+		/// 윈도우 창 초기화(Initialize 함수에서 호출됨)
 		/// </summary>
 		bool InitMainWindow();
 		/// <summary>
-		/// Direct3D ʱȭ(Initialize Լ ȣ)
+		/// Direct3D 초기화(Initialize 함수에서 호출됨)
 		/// </summary>
 		/// <returns></returns>
 		bool InitDirect3D();
 		/// <summary>
-		///  ť,  Ҵ,    Լ
+		/// 명령 큐, 명령 할당자, 명령 목록 생성 함수
 		/// </summary>
 		void CreateCommandObjects();
 		/// <summary>
-		/// 	ü  Լ
+		/// 스왑	체인 생성 함수
 		/// </summary>
 		void CreateSwapChain();
 
 		/// <summary>
-		/// CPU/GPU ȭ  Flush Լ
+		/// CPU/GPU 동기화를 위한 Flush 함수
 		/// </summary>
 		void FlushCommandQueue();
 
+		/// <summary>
+		/// 페이싱이 정한 깊이만큼 앞선 프레임이 끝날 때까지 기다린 뒤, 정해진 시간만큼 잠든다.
+		/// 입력과 시간을 읽기 전에 호출한다. (Run에서 호출됨)
+		/// </summary>
+		void PaceFrame();
+		/// <summary>
+		/// 방금 제출한 프레임의 펜스를 기록하고 측정값을 페이싱에 넘긴다. (Run에서 Draw 뒤에 호출됨)
+		/// </summary>
+		void EndFrameTiming(std::chrono::steady_clock::time_point frameStart, double fenceWaitMsAtStart);
+
+		/// <summary>
+		/// object를 비우고, mFence가 lastUsedFence를 통과하면 해제되도록 예약한다.
+		/// 작업 스레드에서도 호출할 수 있다.
+		/// </summary>
+		/// <param name="lastUsedFence">object를 마지막으로 사용한 프레임의 펜스 값</param>
+		template<typename T>
+		void DeferRelease(Microsoft::WRL::ComPtr<T>& object, UINT64 lastUsedFence)
+		{
+			if (object == nullptr)
+				return;
+
+			Microsoft::WRL::ComPtr<IUnknown> unknown;
+			unknown.Attach(object.Detach());
+			mDeferredReleases.Enqueue(lastUsedFence, std::move(unknown));
+		}
+		/// <summary>
+		/// 다음에 Signal될 프레임이 끝나면 해제되도록 예약한다. 기록 중인 명령 목록이 사용한 객체에도 안전하다.
+		/// mFence를 읽으므로 메인 스레드에서만 호출한다.
+		/// </summary>
+		template<typename T>
+		void DeferRelease(Microsoft::WRL::ComPtr<T>& object)
+		{
+			DeferRelease(object, mFence->GetLastSignaledValue() + 1);
+		}
+
 		inline ID3D12Resource* CurrentBackBuffer() const { return mSwapChainBuffer[mCurrentBackBuffer].Get(); }
-		inline D3D12_CPU_DESCRIPTOR_HANDLE CurrentBackBufferView() const { return CD3DX12_CPU_DESCRIPTOR_HANDLE(mRtvHeap->GetCPUDescriptorHandleForHeapStart(), mCurrentBackBuffer, mRtvDescriptorSize); }
-		inline D3D12_CPU_DESCRIPTOR_HANDLE DepthStencilView() const { return mDsvHeap->GetCPUDescriptorHandleForHeapStart(); }
+		inline D3D12_CPU_DESCRIPTOR_HANDLE CurrentBackBufferView() const { return mSwapChainRtvs[mCurrentBackBuffer].CPU; }
+		inline D3D12_CPU_DESCRIPTOR_HANDLE DepthStencilView() const { return mDepthStencilDsv.CPU; }
 
 		/// <summary>
-		///      Լ
+		/// 프레임 통계 계산 및 출력 함수
 		/// </summary>
 		void CalculateFrameStats();
 
+		/// <summary>
+		/// 명령줄에서 시작 설정(스왑 체인 버퍼 수, 진행 중인 프레임 수)을 읽는다.
+		/// </summary>
+		void ParseCommandLine();
+
 		void LogAdapters();
 		void LogAdapterOutputs(IDXGIAdapter* adapter);
 		void LogOutputDisplayModes(IDXGIOutput* output, DXGI_FORMAT format);
+
+	private:
+		// Sleep보다 정밀하게 잠든다. (고해상도 대기 타이머 사용)
+		void SleepFor(double ms);
+
+		// 최근 mNumFrameResources개 프레임이 Signal한 펜스 값 (mFrameCount로 순환)
+		std::vector<UINT64> mFrameFences;
+		UINT64 mFrameCount = 0;
+
+		HANDLE mPacingTimer = nullptr;
+
+		std::chrono::steady_clock::time_point mLastPresentTime;
+		bool mHasLastPresentTime = false;
 	};
 
 }
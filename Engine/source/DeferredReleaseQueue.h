@@ -0,0 +1,134 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#ifndef DEFERREDRELEASEQUEUE_H
+#define DEFERREDRELEASEQUEUE_H
+namespace Engine
+{
+	/// <summary>
+	/// GPU가 아직 사용 중일 수 있는 객체를 펜스 값과 함께 보관했다가, 펜스가 그 값을 통과하면 해제하는 큐.
+	/// 객체는 마지막으로 사용한 프레임의 펜스 값과 함께 넣는다.
+	///
+	/// Enqueue는 잠금 없이(lock-free) 여러 스레드에서 동시에 호출할 수 있고,
+	/// Retire/ReleaseAll은 한 스레드(보통 메인 스레드)에서만 호출한다.
+	/// 펜스 값만 다루므로 플랫폼에 독립적이며, 정수 펜스로 단독 검증할 수 있다.
+	/// </summary>
+	template<typename T>
+	class DeferredReleaseQueue
+	{
+	public:
+		DeferredReleaseQueue() = default;
+		DeferredReleaseQueue(const DeferredReleaseQueue& rhs) = delete;
+		DeferredReleaseQueue& operator=(const DeferredReleaseQueue& rhs) = delete;
+		~DeferredReleaseQueue()
+		{
+			ReleaseAll();
+		}
+
+		/// <summary>
+		/// 펜스가 fenceValue에 도달하면 해제할 객체를 추가. 어느 스레드에서든 호출할 수 있다.
+		/// 여러 스레드가 넣으면 펜스 값의 순서가 섞일 수 있지만, 해제는 항상 펜스 값 기준으로 이루어진다.
+		/// </summary>
+		void Enqueue(std::uint64_t fenceValue, T object)
+		{
+			Node* node = new Node{ Entry{ fenceValue, std::move(object) }, nullptr };
+
+			// 들어오는 목록의 머리에 붙인다. 소비자는 목록 전체를 한 번에 가져가므로 ABA 문제가 없다.
+			node->Next = mIncoming.load(std::memory_order_relaxed);
+			while (!mIncoming.compare_exchange_weak(node->Next, node,
+				std::memory_order_release, std::memory_order_relaxed))
+			{
+			}
+
+			mEnqueuedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// completedFenceValue 이하의 펜스 값으로 들어온 객체를 해제
+		/// </summary>
+		/// <returns>해제된 객체 수</returns>
+		size_t Retire(std::uint64_t completedFenceValue)
+		{
+			TakeIncoming();
+
+			size_t count = 0;
+			while (!mPending.empty() && mPending.front().FenceValue <= completedFenceValue)
+			{
+				std::pop_heap(mPending.begin(), mPending.end(), LaterFence());
+				mPending.pop_back();
+				++count;
+			}
+			mReleasedCount += count;
+			return count;
+		}
+
+		/// <summary>
+		/// 펜스와 관계없이 모든 객체를 해제. GPU가 유휴 상태일 때(종료 시 Flush 이후 등)만 호출한다.
+		/// </summary>
+		size_t ReleaseAll()
+		{
+			TakeIncoming();
+
+			size_t count = mPending.size();
+			mPending.clear();
+			mReleasedCount += count;
+			return count;
+		}
+
+		// 마지막 Retire 시점에 해제를 기다리던 객체 수 (소비자 스레드 전용)
+		size_t GetPendingCount() const { return mPending.size(); }
+		// 가장 먼저 해제될 객체의 펜스 값 (없으면 0, 소비자 스레드 전용)
+		std::uint64_t GetOldestPendingFence() const { return mPending.empty() ? 0 : mPending.front().FenceValue; }
+
+		std::uint64_t GetEnqueuedCount() const { return mEnqueuedCount.load(std::memory_order_relaxed); }
+		std::uint64_t GetReleasedCount() const { return mReleasedCount; }
+
+	private:
+		struct Entry
+		{
+			std::uint64_t FenceValue;
+			T Object;
+		};
+
+		struct Node
+		{
+			Entry Item;
+			Node* Next;
+		};
+
+		// 펜스 값이 가장 작은 항목이 힙의 맨 앞에 오도록 하는 비교자
+		struct LaterFence
+		{
+			bool operator()(const Entry& lhs, const Entry& rhs) const { return lhs.FenceValue > rhs.FenceValue; }
+		};
+
+		/// <summary>
+		/// 생산자들이 넣은 목록을 통째로 가져와 펜스 값 기준 최소 힙으로 옮긴다.
+		/// </summary>
+		void TakeIncoming()
+		{
+			Node* node = mIncoming.exchange(nullptr, std::memory_order_acquire);
+			while (node != nullptr)
+			{
+				Node* next = node->Next;
+				mPending.push_back(std::move(node->Item));
+				std::push_heap(mPending.begin(), mPending.end(), LaterFence());
+				delete node;
+				node = next;
+			}
+		}
+
+		// 생산자 스레드들이 넣는 단일 연결 목록 (역순)
+		std::atomic<Node*> mIncoming{ nullptr };
+		std::atomic<std::uint64_t> mEnqueuedCount{ 0 };
+
+		// 소비자 스레드만 접근하는 대기 목록
+		std::vector<Entry> mPending;
+		std::uint64_t mReleasedCount = 0;
+	};
+}
+#endif
@@ -0,0 +1,150 @@
+#include "DescriptorAllocator.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace Engine
+{
+	DescriptorFreeList::DescriptorFreeList(uint32 capacity) : mCapacity(capacity)
+	{
+		if (capacity > 0)
+			mFreeBlocks[0] = capacity;
+	}
+
+	DescriptorFreeList::uint32 DescriptorFreeList::Allocate(uint32 count)
+	{
+		assert(count > 0);
+
+		for (auto it = mFreeBlocks.begin(); it != mFreeBlocks.end(); ++it)
+		{
+			if (it->second < count)
+				continue;
+
+			uint32 offset = it->first;
+			uint32 remaining = it->second - count;
+			mFreeBlocks.erase(it);
+			if (remaining > 0)
+				mFreeBlocks[offset + count] = remaining;
+
+			++mStats.AllocationCount;
+			mStats.UsedDescriptors += count;
+			mStats.PeakUsedDescriptors = std::max(mStats.PeakUsedDescriptors, mStats.UsedDescriptors);
+			return offset;
+		}
+
+		++mStats.FailedAllocations;
+		return InvalidOffset;
+	}
+
+	void DescriptorFreeList::Free(uint32 offset, uint32 count)
+	{
+		assert(count > 0 && offset + count <= mCapacity);
+		++mStats.FreeCount;
+		mStats.UsedDescriptors -= count;
+
+		auto next = mFreeBlocks.lower_bound(offset);
+		assert((next == mFreeBlocks.end() || offset + count <= next->first) && "이미 해제된 서술자");
+
+		// 뒤의 빈 구간과 합친다.
+		if (next != mFreeBlocks.end() && offset + count == next->first)
+		{
+			count += next->second;
+			next = mFreeBlocks.erase(next);
+		}
+		// 앞의 빈 구간과 합친다.
+		if (next != mFreeBlocks.begin())
+		{
+			auto prev = std::prev(next);
+			assert(prev->first + prev->second <= offset && "이미 해제된 서술자");
+			if (prev->first + prev->second == offset)
+			{
+				prev->second += count;
+				count = 0;
+			}
+		}
+		if (count > 0)
+			mFreeBlocks.emplace_hint(next, offset, count);
+	}
+
+	void DescriptorFreeList::Free(uint32 offset, uint32 count, uint64 fenceValue)
+	{
+		assert(fenceValue >= mLastFenceValue);
+		mLastFenceValue = fenceValue;
+		mPendingFrees.push_back({ fenceValue, offset, count });
+	}
+
+	void DescriptorFreeList::Retire(uint64 completedFenceValue)
+	{
+		while (!mPendingFrees.empty() && mPendingFrees.front().FenceValue <= completedFenceValue)
+		{
+			const PendingFree& pending = mPendingFrees.front();
+			Free(pending.Offset, pending.Count);
+			mPendingFrees.pop_front();
+		}
+	}
+
+	DescriptorFreeList::uint32 DescriptorFreeList::GetLargestFreeBlock() const
+	{
+		uint32 largest = 0;
+		for (const auto& block : mFreeBlocks)
+			largest = std::max(largest, block.second);
+		return largest;
+	}
+
+	DescriptorSlotPool::DescriptorSlotPool(uint32 pageSize) : mPageSize(pageSize)
+	{
+		assert(pageSize > 0);
+	}
+
+	DescriptorSlotPool::uint32 DescriptorSlotPool::Allocate()
+	{
+		if (mFreeSlots.empty())
+		{
+			// 새 페이지의 칸은 낮은 번호부터 나가도록 거꾸로 넣는다.
+			uint32 first = mPageCount * mPageSize;
+			for (uint32 i = mPageSize; i > 0; --i)
+				mFreeSlots.push_back(first + i - 1);
+			++mPageCount;
+			mAllocated.resize((size_t)mPageCount * mPageSize, false);
+		}
+
+		uint32 slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+		mAllocated[slot] = true;
+
+		++mStats.AllocationCount;
+		++mStats.UsedDescriptors;
+		mStats.PeakUsedDescriptors = std::max(mStats.PeakUsedDescriptors, mStats.UsedDescriptors);
+		return slot;
+	}
+
+	void DescriptorSlotPool::Free(uint32 slot)
+	{
+		assert(slot < mAllocated.size() && mAllocated[slot] && "할당되지 않은 칸");
+		mAllocated[slot] = false;
+		mFreeSlots.push_back(slot);
+
+		++mStats.FreeCount;
+		--mStats.UsedDescriptors;
+	}
+
+	ShaderVisibleDescriptorAllocator::ShaderVisibleDescriptorAllocator(uint32 persistentCount, uint32 frameCount)
+		: mPersistentCount(persistentCount), mFrameCount(frameCount), mPersistent(persistentCount), mFrame(frameCount)
+	{
+	}
+
+	ShaderVisibleDescriptorAllocator::uint32 ShaderVisibleDescriptorAllocator::AllocateFrame(uint32 count, const RingAllocator::WaitForFence& waitForFence)
+	{
+		// 링의 단위는 바이트 대신 서술자 개수이며, 서술자 테이블은 정렬이 필요 없다.
+		RingAllocator::uint64 offset = mFrame.Allocate(count, 1, waitForFence);
+		if (offset == RingAllocator::InvalidOffset)
+			return InvalidOffset;
+		return mPersistentCount + (uint32)offset;
+	}
+
+	void ShaderVisibleDescriptorAllocator::Retire(uint64 completedFenceValue)
+	{
+		mFrame.Retire(completedFenceValue);
+		mPersistent.Retire(completedFenceValue);
+	}
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include "EngineHeader.h"
+#include "RingAllocator.h"
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+#ifndef DESCRIPTORALLOCATOR_H
+#define DESCRIPTORALLOCATOR_H
+namespace Engine
+{
+	/// <summary>
+	/// 서술자 할당기 통계 (단위는 서술자 개수)
+	/// </summary>
+	struct DescriptorAllocatorStats
+	{
+		std::uint64_t AllocationCount = 0;
+		std::uint64_t FreeCount = 0;
+		std::uint64_t FailedAllocations = 0;
+		std::uint32_t UsedDescriptors = 0;     // 할당된 서술자 수 (회수를 기다리는 것 포함)
+		std::uint32_t PeakUsedDescriptors = 0;
+	};
+
+	/// <summary>
+	/// [0, capacity) 서술자 구간을 연속된 블록으로 나누어 주는 빈 목록 할당기. 오프셋만 관리하므로 장치 없이 검증할 수 있다.
+	/// 빈 구간은 오프셋 순으로 보관해 처음 맞는 곳에 할당하고, 해제할 때 이웃한 빈 구간과 합친다.
+	/// GPU가 아직 읽을 수 있는 서술자는 펜스 값과 함께 해제해 두었다가 Retire에서 돌려받는다.
+	/// </summary>
+	class D3D_API DescriptorFreeList
+	{
+	public:
+		using uint32 = std::uint32_t;
+		using uint64 = std::uint64_t;
+
+		// 할당 실패를 나타내는 오프셋
+		enum : uint32 { InvalidOffset = 0xFFFFFFFF };
+
+		explicit DescriptorFreeList(uint32 capacity = 0);
+
+		/// <summary>
+		/// 연속된 count개 서술자 할당
+		/// </summary>
+		/// <returns>공간이 없으면 InvalidOffset</returns>
+		uint32 Allocate(uint32 count);
+
+		/// <summary>
+		/// GPU가 사용하지 않는 블록을 바로 반환
+		/// </summary>
+		void Free(uint32 offset, uint32 count);
+		/// <summary>
+		/// fenceValue가 완료되면 반환되도록 예약. fenceValue는 이전 호출보다 작아서는 안 된다.
+		/// </summary>
+		void Free(uint32 offset, uint32 count, uint64 fenceValue);
+
+		/// <summary>
+		/// completedFenceValue까지 완료된 예약 해제를 반환
+		/// </summary>
+		void Retire(uint64 completedFenceValue);
+
+		uint32 GetCapacity() const { return mCapacity; }
+		// 한 번에 할당할 수 있는 가장 큰 연속 구간
+		uint32 GetLargestFreeBlock() const;
+		const DescriptorAllocatorStats& GetStats() const { return mStats; }
+
+	private:
+		struct PendingFree
+		{
+			uint64 FenceValue;
+			uint32 Offset;
+			uint32 Count;
+		};
+
+		uint32 mCapacity = 0;
+		// 빈 구간의 시작 -> 개수
+		std::map<uint32, uint32> mFreeBlocks;
+		std::deque<PendingFree> mPendingFrees;
+		uint64 mLastFenceValue = 0;
+
+		DescriptorAllocatorStats mStats;
+	};
+
+	/// <summary>
+	/// 서술자 하나 단위로 칸을 재사용하는 풀. 칸이 모자라면 pageSize개씩 페이지를 늘린다.
+	/// CPU 전용(스테이징) 힙처럼 GPU가 직접 읽지 않는 서술자에 사용하므로 해제하면 바로 재사용한다.
+	/// 칸 번호 = 페이지 번호 * pageSize + 페이지 안의 위치
+	/// </summary>
+	class D3D_API DescriptorSlotPool
+	{
+	public:
+		using uint32 = std::uint32_t;
+
+		enum : uint32 { InvalidSlot = 0xFFFFFFFF };
+
+		explicit DescriptorSlotPool(uint32 pageSize = 64);
+
+		/// <summary>
+		/// 빈 칸 하나를 꺼낸다. 없으면 페이지를 하나 늘린다 (GetPageCount가 바뀐다).
+		/// </summary>
+		uint32 Allocate();
+		void Free(uint32 slot);
+
+		uint32 GetPageSize() const { return mPageSize; }
+		uint32 GetPageCount() const { return mPageCount; }
+		// 0이면 다음 Allocate가 페이지를 늘린다.
+		uint32 GetFreeCount() const { return (uint32)mFreeSlots.size(); }
+		uint32 GetPage(uint32 slot) const { return slot / mPageSize; }
+		uint32 GetIndexInPage(uint32 slot) const { return slot % mPageSize; }
+		const DescriptorAllocatorStats& GetStats() const { return mStats; }
+
+	private:
+		uint32 mPageSize = 0;
+		uint32 mPageCount = 0;
+		// 가장 최근에 반환된 칸부터 재사용한다.
+		std::vector<uint32> mFreeSlots;
+		// 이중 해제 검사용
+		std::vector<bool> mAllocated;
+
+		DescriptorAllocatorStats mStats;
+	};
+
+	/// <summary>
+	/// 셰이더 가시 힙 하나를 두 영역으로 나누어 관리한다.
+	/// [0, persistentCount): 자원과 수명이 같은 서술자 (DescriptorFreeList). 오프셋이 그대로 바인드리스 인덱스가 된다.
+	/// [persistentCount, persistentCount + frameCount): 한 프레임만 쓰는 서술자 (RingAllocator, 펜스로 회수).
+	/// 반환하는 오프셋은 모두 힙 시작 기준이다.
+	/// </summary>
+	class D3D_API ShaderVisibleDescriptorAllocator
+	{
+	public:
+		using uint32 = std::uint32_t;
+		using uint64 = std::uint64_t;
+
+		enum : uint32 { InvalidOffset = 0xFFFFFFFF };
+
+		ShaderVisibleDescriptorAllocator(uint32 persistentCount, uint32 frameCount);
+
+		uint32 AllocatePersistent(uint32 count) { return mPersistent.Allocate(count); }
+		void FreePersistent(uint32 offset, uint32 count, uint64 fenceValue) { mPersistent.Free(offset, count, fenceValue); }
+
+		/// <summary>
+		/// 이번 프레임에만 쓸 연속된 count개 서술자. 공간이 없으면 waitForFence로 가장 오래된 프레임을 기다린다.
+		/// </summary>
+		/// <returns>진행 중인 프레임을 모두 회수해도 모자라면 InvalidOffset</returns>
+		uint32 AllocateFrame(uint32 count, const RingAllocator::WaitForFence& waitForFence);
+
+		/// <summary>
+		/// 지난 EndFrame 이후의 프레임 할당을 fenceValue에 묶는다.
+		/// </summary>
+		void EndFrame(uint64 fenceValue) { mFrame.EndFrame(fenceValue); }
+		/// <summary>
+		/// completedFenceValue까지 완료된 프레임 영역과 예약 해제된 영속 블록을 회수
+		/// </summary>
+		void Retire(uint64 completedFenceValue);
+
+		uint32 GetPersistentCount() const { return mPersistentCount; }
+		uint32 GetFrameCount() const { return mFrameCount; }
+		uint32 GetCapacity() const { return mPersistentCount + mFrameCount; }
+		const DescriptorFreeList& GetPersistentAllocator() const { return mPersistent; }
+		const RingAllocator& GetFrameAllocator() const { return mFrame; }
+
+	private:
+		uint32 mPersistentCount = 0;
+		uint32 mFrameCount = 0;
+		DescriptorFreeList mPersistent;
+		RingAllocator mFrame;
+	};
+}
+#endif
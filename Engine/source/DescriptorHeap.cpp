@@ -0,0 +1,134 @@
+#include "DescriptorHeap.h"
+
+namespace Engine
+{
+	ShaderVisibleDescriptorHeap::ShaderVisibleDescriptorHeap(ID3D12Device* device, UINT persistentCount, UINT frameCount, Fence* fence)
+		: mDevice(device), mFence(fence), mAllocator(persistentCount, frameCount)
+	{
+		D3D12_DESCRIPTOR_HEAP_DESC heapDesc;
+		heapDesc.NumDescriptors = persistentCount + frameCount;
+		heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+		heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+		heapDesc.NodeMask = 0;
+		ThrowIfFailed(device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&mHeap)));
+
+		mCPUStart = mHeap->GetCPUDescriptorHandleForHeapStart();
+		mGPUStart = mHeap->GetGPUDescriptorHandleForHeapStart();
+		mDescriptorSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	}
+
+	DescriptorAllocation ShaderVisibleDescriptorHeap::AllocatePersistent(UINT count)
+	{
+		UINT index = mAllocator.AllocatePersistent(count);
+		if (index == ShaderVisibleDescriptorAllocator::InvalidOffset)
+			ThrowIfFailed(E_OUTOFMEMORY);
+		return MakeAllocation(index, count);
+	}
+
+	void ShaderVisibleDescriptorHeap::FreePersistent(DescriptorAllocation& allocation)
+	{
+		if (!allocation.IsValid())
+			return;
+		mAllocator.FreePersistent(allocation.Index, allocation.Count, mFence->GetLastSignaledValue() + 1);
+		allocation = DescriptorAllocation();
+	}
+
+	DescriptorAllocation ShaderVisibleDescriptorHeap::AllocateFrame(UINT count)
+	{
+		UINT index = mAllocator.AllocateFrame(count,
+			[this](UINT64 fenceValue)
+		{
+			mFence->WaitCPU(fenceValue);
+			return mFence->GetCompletedValue();
+		});
+		if (index == ShaderVisibleDescriptorAllocator::InvalidOffset)
+			ThrowIfFailed(E_OUTOFMEMORY);
+		return MakeAllocation(index, count);
+	}
+
+	DescriptorAllocation ShaderVisibleDescriptorHeap::CopyToFrame(const D3D12_CPU_DESCRIPTOR_HANDLE* sources, UINT count)
+	{
+		DescriptorAllocation allocation = AllocateFrame(count);
+		// 원본이 흩어져 있어도 범위 크기를 1로 주면 한 번에 복사할 수 있다.
+		mDevice->CopyDescriptors(1, &allocation.CPU, &count, count, sources, nullptr, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		return allocation;
+	}
+
+	void ShaderVisibleDescriptorHeap::EndFrame(UINT64 fenceValue)
+	{
+		mAllocator.EndFrame(fenceValue);
+	}
+
+	void ShaderVisibleDescriptorHeap::Retire()
+	{
+		mAllocator.Retire(mFence->GetCompletedValue());
+	}
+
+	void ShaderVisibleDescriptorHeap::InitBindlessRange(CD3DX12_DESCRIPTOR_RANGE& range, D3D12_DESCRIPTOR_RANGE_TYPE type, UINT baseRegister, UINT registerSpace)
+	{
+		// 크기 제한이 없는 범위는 다른 범위와 겹치지 않도록 전용 레지스터 공간에 둔다.
+		range.Init(type, UINT_MAX, baseRegister, registerSpace, 0);
+	}
+
+	D3D12_CPU_DESCRIPTOR_HANDLE ShaderVisibleDescriptorHeap::GetCPUHandle(UINT index) const
+	{
+		return CD3DX12_CPU_DESCRIPTOR_HANDLE(mCPUStart, index, mDescriptorSize);
+	}
+
+	D3D12_GPU_DESCRIPTOR_HANDLE ShaderVisibleDescriptorHeap::GetGPUHandle(UINT index) const
+	{
+		return CD3DX12_GPU_DESCRIPTOR_HANDLE(mGPUStart, index, mDescriptorSize);
+	}
+
+	DescriptorAllocation ShaderVisibleDescriptorHeap::MakeAllocation(UINT index, UINT count) const
+	{
+		DescriptorAllocation allocation;
+		allocation.CPU = GetCPUHandle(index);
+		allocation.GPU = GetGPUHandle(index);
+		allocation.Index = index;
+		allocation.Count = count;
+		return allocation;
+	}
+
+	StagingDescriptorHeap::StagingDescriptorHeap(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT pageSize)
+		: mDevice(device), mType(type), mPool(pageSize)
+	{
+		mDescriptorSize = device->GetDescriptorHandleIncrementSize(type);
+	}
+
+	DescriptorAllocation StagingDescriptorHeap::Allocate()
+	{
+		// 풀이 페이지를 늘려야 하면 칸을 꺼내기 전에 힙부터 만든다.
+		// 생성이 실패해 예외가 나가도 풀은 그대로이므로 칸이 새지 않는다.
+		if (mPool.GetFreeCount() == 0)
+		{
+			D3D12_DESCRIPTOR_HEAP_DESC heapDesc;
+			heapDesc.NumDescriptors = mPool.GetPageSize();
+			heapDesc.Type = mType;
+			heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+			heapDesc.NodeMask = 0;
+
+			Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> page;
+			ThrowIfFailed(mDevice->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&page)));
+			mPages.push_back(page);
+		}
+
+		UINT slot = mPool.Allocate();
+		assert(mPages.size() == mPool.GetPageCount());
+
+		DescriptorAllocation allocation;
+		allocation.CPU = CD3DX12_CPU_DESCRIPTOR_HANDLE(mPages[mPool.GetPage(slot)]->GetCPUDescriptorHandleForHeapStart(),
+			mPool.GetIndexInPage(slot), mDescriptorSize);
+		allocation.Index = slot;
+		allocation.Count = 1;
+		return allocation;
+	}
+
+	void StagingDescriptorHeap::Free(DescriptorAllocation& allocation)
+	{
+		if (!allocation.IsValid())
+			return;
+		mPool.Free(allocation.Index);
+		allocation = DescriptorAllocation();
+	}
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include "EngineHeader.h"
+#include "DescriptorAllocator.h"
+#include "Fence.h"
+#include "Util.h"
+
+#ifndef DESCRIPTORHEAP_H
+#define DESCRIPTORHEAP_H
+namespace Engine
+{
+	/// <summary>
+	/// 힙에서 받은 연속된 서술자. CPU 전용 힙의 서술자는 GPU 핸들이 0이다.
+	/// </summary>
+	struct DescriptorAllocation
+	{
+		enum : std::uint32_t { InvalidIndex = 0xFFFFFFFF };
+
+		D3D12_CPU_DESCRIPTOR_HANDLE CPU = {};
+		D3D12_GPU_DESCRIPTOR_HANDLE GPU = {};
+		std::uint32_t Index = InvalidIndex; // 셰이더 가시 힙에서는 힙 시작 기준 위치 (= 바인드리스 인덱스), 스테이징 힙에서는 칸 번호
+		std::uint32_t Count = 0;
+
+		bool IsValid() const { return Index != InvalidIndex; }
+	};
+
+	/// <summary>
+	/// 큰 셰이더 가시 CBV/SRV/UAV 힙 하나. SetDescriptorHeaps로 프레임 내내 이 힙만 설정하면 된다.
+	/// 앞쪽은 자원과 수명이 같은 서술자(영속 영역), 뒤쪽은 한 프레임만 쓰는 서술자(프레임 링)이며,
+	/// 할당 규칙은 ShaderVisibleDescriptorAllocator가 담당한다.
+	///
+	/// 바인드리스: 영속 서술자의 Index를 루트 상수나 상수 버퍼로 넘기고, 셰이더는 InitBindlessRange로 만든
+	/// 크기 제한 없는 테이블(힙 시작에 설정)에서 그 인덱스로 읽는다.
+	/// </summary>
+	class D3D_API ShaderVisibleDescriptorHeap
+	{
+	public:
+		/// <param name="persistentCount">영속 영역 서술자 수</param>
+		/// <param name="frameCount">프레임 링 서술자 수. 진행 중인 모든 프레임의 할당이 들어갈 수 있어야 한다.</param>
+		/// <param name="fence">EndFrame에 넘기는 값을 Signal하는 펜스</param>
+		ShaderVisibleDescriptorHeap(ID3D12Device* device, UINT persistentCount, UINT frameCount, Fence* fence);
+		ShaderVisibleDescriptorHeap(const ShaderVisibleDescriptorHeap& rhs) = delete;
+		ShaderVisibleDescriptorHeap& operator=(const ShaderVisibleDescriptorHeap& rhs) = delete;
+
+		/// <summary>
+		/// 영속 영역에서 연속된 count개 할당. 공간이 없으면 E_OUTOFMEMORY로 DxException을 던진다.
+		/// </summary>
+		DescriptorAllocation AllocatePersistent(UINT count = 1);
+		/// <summary>
+		/// 다음에 Signal될 프레임이 끝나면 반환되도록 예약하고 allocation을 비운다. 메인 스레드에서만 호출한다.
+		/// </summary>
+		void FreePersistent(DescriptorAllocation& allocation);
+
+		/// <summary>
+		/// 이번 프레임에만 쓸 연속된 count개 할당. 공간이 없으면 GPU가 이전 프레임을 끝낼 때까지 기다리고,
+		/// 진행 중인 프레임을 모두 기다려도 부족하면 E_OUTOFMEMORY로 DxException을 던진다.
+		/// </summary>
+		DescriptorAllocation AllocateFrame(UINT count = 1);
+		/// <summary>
+		/// CPU 전용 힙의 서술자들을 프레임 링으로 복사해 하나의 서술자 테이블로 만든다.
+		/// </summary>
+		DescriptorAllocation CopyToFrame(const D3D12_CPU_DESCRIPTOR_HANDLE* sources, UINT count);
+
+		/// <summary>
+		/// 이번 프레임의 할당을 fenceValue에 묶는다. 커맨드 큐에 fenceValue를 Signal한 뒤 호출한다.
+		/// </summary>
+		void EndFrame(UINT64 fenceValue);
+		/// <summary>
+		/// GPU가 완료한 프레임 링 공간과 예약 해제된 영속 서술자 회수
+		/// </summary>
+		void Retire();
+
+		/// <summary>
+		/// 바인드리스 테이블의 범위. 영속 영역 전체를 space 공간의 baseRegister부터 크기 제한 없이 노출한다.
+		/// (SRV/UAV는 리소스 바인딩 티어 2, CBV는 티어 3 이상 필요)
+		/// 이 범위로 만든 테이블에는 GetBindlessTableStart를 설정한다.
+		/// </summary>
+		static void InitBindlessRange(CD3DX12_DESCRIPTOR_RANGE& range, D3D12_DESCRIPTOR_RANGE_TYPE type, UINT baseRegister, UINT registerSpace);
+		D3D12_GPU_DESCRIPTOR_HANDLE GetBindlessTableStart() const { return GetGPUHandle(0); }
+
+		D3D12_CPU_DESCRIPTOR_HANDLE GetCPUHandle(UINT index) const;
+		D3D12_GPU_DESCRIPTOR_HANDLE GetGPUHandle(UINT index) const;
+
+		ID3D12DescriptorHeap* GetHeap() const { return mHeap.Get(); }
+		UINT GetDescriptorSize() const { return mDescriptorSize; }
+		const ShaderVisibleDescriptorAllocator& GetAllocator() const { return mAllocator; }
+
+	private:
+		DescriptorAllocation MakeAllocation(UINT index, UINT count) const;
+
+		Microsoft::WRL::ComPtr<ID3D12Device> mDevice;
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mHeap;
+		D3D12_CPU_DESCRIPTOR_HANDLE mCPUStart = {};
+		D3D12_GPU_DESCRIPTOR_HANDLE mGPUStart = {};
+		UINT mDescriptorSize = 0;
+
+		Fence* mFence = nullptr;
+
+		ShaderVisibleDescriptorAllocator mAllocator;
+	};
+
+	/// <summary>
+	/// RTV/DSV처럼 GPU가 직접 읽지 않는 CPU 전용 서술자 힙. 칸이 모자라면 같은 크기의 힙(페이지)을 하나 더 만들고,
+	/// 해제한 칸은 바로 재사용한다. 할당 규칙은 DescriptorSlotPool이 담당한다.
+	/// CBV/SRV/UAV 형식으로 만들면 셰이더 가시 힙으로 복사할 원본(스테이징) 서술자를 보관할 수 있다.
+	/// </summary>
+	class D3D_API StagingDescriptorHeap
+	{
+	public:
+		/// <param name="pageSize">힙 하나의 서술자 수</param>
+		StagingDescriptorHeap(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT pageSize);
+		StagingDescriptorHeap(const StagingDescriptorHeap& rhs) = delete;
+		StagingDescriptorHeap& operator=(const StagingDescriptorHeap& rhs) = delete;
+
+		/// <summary>
+		/// 서술자 한 칸 할당 (Count = 1)
+		/// </summary>
+		DescriptorAllocation Allocate();
+		/// <summary>
+		/// 칸을 반환하고 allocation을 비운다. 이미 비어 있으면 무시한다.
+		/// </summary>
+		void Free(DescriptorAllocation& allocation);
+
+		D3D12_DESCRIPTOR_HEAP_TYPE GetType() const { return mType; }
+		UINT GetDescriptorSize() const { return mDescriptorSize; }
+		const DescriptorSlotPool& GetPool() const { return mPool; }
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device> mDevice;
+		D3D12_DESCRIPTOR_HEAP_TYPE mType;
+		UINT mDescriptorSize = 0;
+
+		std::vector<Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>> mPages;
+		DescriptorSlotPool mPool;
+	};
+}
+#endif
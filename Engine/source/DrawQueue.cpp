@@ -0,0 +1,89 @@
+#include "DrawQueue.h"
+#include <cstring>
+
+namespace Engine
+{
+	std::uint64_t DrawSortKey::Make(std::uint32_t pass, std::uint32_t pipeline, std::uint32_t rootSignature, std::uint32_t geometry, float depth)
+	{
+		auto field = [](std::uint32_t value, int shift, int bits)
+		{
+			return (std::uint64_t(value) & ((std::uint64_t(1) << bits) - 1)) << shift;
+		};
+		return field(pass, PassShift, PassBits) |
+			field(pipeline, PipelineShift, PipelineBits) |
+			field(rootSignature, RootSignatureShift, RootSignatureBits) |
+			field(geometry, GeometryShift, GeometryBits) |
+			field(QuantizeDepth(depth), DepthShift, DepthBits);
+	}
+
+	std::uint32_t DrawSortKey::QuantizeDepth(float depth)
+	{
+		// 0 이상의 IEEE float는 비트 패턴을 부호 없는 정수로 비교해도 순서가 같다.
+		if (!(depth > 0.0f))
+			return 0;
+		std::uint32_t bits;
+		std::memcpy(&bits, &depth, sizeof(bits));
+		return bits;
+	}
+
+	void DrawQueue::Reset()
+	{
+		mItems.clear();
+	}
+
+	void DrawQueue::Sort()
+	{
+		const size_t count = mItems.size();
+		if (count < 2)
+			return;
+
+		mKeys.resize(count);
+		mOrder.resize(count);
+		mKeyScratch.resize(count);
+		mOrderScratch.resize(count);
+
+		std::uint64_t differing = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			mKeys[i] = mItems[i].SortKey;
+			mOrder[i] = (std::uint32_t)i;
+			differing |= mKeys[i] ^ mKeys[0];
+		}
+		if (differing == 0)
+			return;
+
+		for (int pass = 0; pass < 8; ++pass)
+		{
+			const int shift = pass * 8;
+			// 모든 키에서 이 바이트가 같으면 순서가 바뀌지 않는다.
+			if (((differing >> shift) & 0xFF) == 0)
+				continue;
+
+			size_t offsets[256] = {};
+			for (size_t i = 0; i < count; ++i)
+				++offsets[(mKeys[i] >> shift) & 0xFF];
+
+			size_t sum = 0;
+			for (size_t& offset : offsets)
+			{
+				size_t bucket = offset;
+				offset = sum;
+				sum += bucket;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				size_t dest = offsets[(mKeys[i] >> shift) & 0xFF]++;
+				mKeyScratch[dest] = mKeys[i];
+				mOrderScratch[dest] = mOrder[i];
+			}
+			mKeys.swap(mKeyScratch);
+			mOrder.swap(mOrderScratch);
+		}
+
+		mSorted.resize(count);
+		for (size_t i = 0; i < count; ++i)
+			mSorted[i] = mItems[mOrder[i]];
+		mItems.swap(mSorted);
+	}
+}
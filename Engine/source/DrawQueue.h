@@ -0,0 +1,206 @@
+#pragma once
+#include "EngineHeader.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifndef DRAWQUEUE_H
+#define DRAWQUEUE_H
+namespace Engine
+{
+	/// <summary>
+	/// 64비트 그리기 정렬 키. 상위 비트부터 패스, PSO, 루트 시그니처, 지오메트리, 깊이 순서로 배치해서
+	/// 키 순서대로 그리면 비싼 상태 변경일수록 적게 일어난다.
+	/// 상태 값은 앱이 정한 작은 정수 id이며, 각 필드의 비트 수를 넘으면 잘린다.
+	/// </summary>
+	struct DrawSortKey
+	{
+		static const int PassBits = 4;
+		static const int PipelineBits = 12;
+		static const int RootSignatureBits = 6;
+		static const int GeometryBits = 10;
+		static const int DepthBits = 32;
+
+		static const int DepthShift = 0;
+		static const int GeometryShift = DepthShift + DepthBits;
+		static const int RootSignatureShift = GeometryShift + GeometryBits;
+		static const int PipelineShift = RootSignatureShift + RootSignatureBits;
+		static const int PassShift = PipelineShift + PipelineBits;
+
+		/// <param name="depth">카메라와의 거리 (0 이상). 가까울수록 앞에 정렬된다.</param>
+		static std::uint64_t Make(std::uint32_t pass, std::uint32_t pipeline, std::uint32_t rootSignature, std::uint32_t geometry, float depth);
+
+		/// <summary>
+		/// 0 이상의 float를 순서를 유지하는 32비트 정수로 바꾼다. (음수와 NaN은 0)
+		/// </summary>
+		static std::uint32_t QuantizeDepth(float depth);
+
+		static std::uint32_t GetPass(std::uint64_t key) { return Field(key, PassShift, PassBits); }
+		static std::uint32_t GetPipeline(std::uint64_t key) { return Field(key, PipelineShift, PipelineBits); }
+		static std::uint32_t GetRootSignature(std::uint64_t key) { return Field(key, RootSignatureShift, RootSignatureBits); }
+		static std::uint32_t GetGeometry(std::uint64_t key) { return Field(key, GeometryShift, GeometryBits); }
+		static std::uint32_t GetDepth(std::uint64_t key) { return Field(key, DepthShift, DepthBits); }
+
+	private:
+		static std::uint32_t Field(std::uint64_t key, int shift, int bits)
+		{
+			return (std::uint32_t)((key >> shift) & ((std::uint64_t(1) << bits) - 1));
+		}
+	};
+
+	/// <summary>
+	/// 그리기 한 번에 필요한 상태 id와 DrawIndexedInstanced 인자
+	/// </summary>
+	struct DrawItem
+	{
+		std::uint64_t SortKey = 0;
+
+		std::uint32_t Pipeline = 0;
+		std::uint32_t RootSignature = 0;
+		std::uint32_t Geometry = 0;          // 정점/인덱스 버퍼 묶음
+		std::uint32_t PrimitiveTopology = 0; // D3D12_PRIMITIVE_TOPOLOGY 값
+
+		std::uint32_t IndexCount = 0;
+		std::uint32_t InstanceCount = 1;
+		std::uint32_t StartIndexLocation = 0;
+		std::int32_t BaseVertexLocation = 0;
+		std::uint32_t StartInstance = 0;     // 인스턴스 버퍼 안의 시작 위치 (앱이 루트 상수 등으로 전달)
+	};
+
+	/// <summary>
+	/// Submit이 실제로 기록한 상태 변경과 직전과 같아서 생략한 상태 변경 수
+	/// </summary>
+	struct DrawStateStats
+	{
+		std::uint64_t Draws = 0;
+
+		std::uint64_t PipelineSets = 0;
+		std::uint64_t PipelineElided = 0;
+		std::uint64_t RootSignatureSets = 0;
+		std::uint64_t RootSignatureElided = 0;
+		std::uint64_t GeometrySets = 0;       // 정점 버퍼와 인덱스 버퍼 설정을 한 번으로 센다
+		std::uint64_t GeometryElided = 0;
+		std::uint64_t TopologySets = 0;
+		std::uint64_t TopologyElided = 0;
+
+		std::uint64_t GetSetCalls() const { return PipelineSets + RootSignatureSets + GeometrySets + TopologySets; }
+		std::uint64_t GetElidedCalls() const { return PipelineElided + RootSignatureElided + GeometryElided + TopologyElided; }
+
+		DrawStateStats& operator+=(const DrawStateStats& rhs)
+		{
+			Draws += rhs.Draws;
+			PipelineSets += rhs.PipelineSets;
+			PipelineElided += rhs.PipelineElided;
+			RootSignatureSets += rhs.RootSignatureSets;
+			RootSignatureElided += rhs.RootSignatureElided;
+			GeometrySets += rhs.GeometrySets;
+			GeometryElided += rhs.GeometryElided;
+			TopologySets += rhs.TopologySets;
+			TopologyElided += rhs.TopologyElided;
+			return *this;
+		}
+	};
+
+	/// <summary>
+	/// 한 프레임의 그리기를 모아 정렬 키로 기수 정렬하고, 바뀐 상태만 기록하면서 제출한다.
+	/// 실제 명령 목록 호출은 TSink가 맡으므로 장치 없이도 기록용 싱크로 검증할 수 있다.
+	///
+	/// TSink는 다음 함수를 제공해야 한다.
+	///   void SetRootSignature(std::uint32_t id);   // 루트 시그니처가 바뀌면 루트 인자도 다시 설정해야 한다
+	///   void SetPipelineState(std::uint32_t id);
+	///   void SetGeometry(std::uint32_t id);        // 정점/인덱스 버퍼
+	///   void SetPrimitiveTopology(std::uint32_t topology);
+	///   void Draw(const DrawItem& item);
+	/// </summary>
+	class D3D_API DrawQueue
+	{
+	public:
+		void Reset();
+		void Add(const DrawItem& item) { mItems.push_back(item); }
+
+		/// <summary>
+		/// SortKey 오름차순으로 안정 정렬 (8비트씩 LSD 기수 정렬, 모든 키가 같은 바이트는 건너뛴다)
+		/// </summary>
+		void Sort();
+
+		const std::vector<DrawItem>& GetItems() const { return mItems; }
+		size_t GetCount() const { return mItems.size(); }
+
+		/// <summary>
+		/// [begin, end) 그리기를 sink에 기록. 상태는 알 수 없는 값에서 시작하므로 명령 목록마다 따로 호출해도 된다.
+		/// 여러 스레드에서 서로 다른 구간을 동시에 제출할 수 있다.
+		/// </summary>
+		template<typename TSink>
+		void Submit(TSink& sink, size_t begin, size_t end, DrawStateStats& stats) const
+		{
+			const std::uint32_t unknown = 0xFFFFFFFF;
+			std::uint32_t rootSignature = unknown;
+			std::uint32_t pipeline = unknown;
+			std::uint32_t geometry = unknown;
+			std::uint32_t topology = unknown;
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				const DrawItem& item = mItems[i];
+
+				if (item.RootSignature != rootSignature)
+				{
+					sink.SetRootSignature(item.RootSignature);
+					rootSignature = item.RootSignature;
+					++stats.RootSignatureSets;
+				}
+				else
+				{
+					++stats.RootSignatureElided;
+				}
+
+				if (item.Pipeline != pipeline)
+				{
+					sink.SetPipelineState(item.Pipeline);
+					pipeline = item.Pipeline;
+					++stats.PipelineSets;
+				}
+				else
+				{
+					++stats.PipelineElided;
+				}
+
+				if (item.Geometry != geometry)
+				{
+					sink.SetGeometry(item.Geometry);
+					geometry = item.Geometry;
+					++stats.GeometrySets;
+				}
+				else
+				{
+					++stats.GeometryElided;
+				}
+
+				if (item.PrimitiveTopology != topology)
+				{
+					sink.SetPrimitiveTopology(item.PrimitiveTopology);
+					topology = item.PrimitiveTopology;
+					++stats.TopologySets;
+				}
+				else
+				{
+					++stats.TopologyElided;
+				}
+
+				sink.Draw(item);
+				++stats.Draws;
+			}
+		}
+
+	private:
+		std::vector<DrawItem> mItems;
+
+		// 정렬용 작업 공간 (프레임 사이에 재사용)
+		std::vector<std::uint64_t> mKeys;
+		std::vector<std::uint64_t> mKeyScratch;
+		std::vector<std::uint32_t> mOrder;
+		std::vector<std::uint32_t> mOrderScratch;
+		std::vector<DrawItem> mSorted;
+	};
+}
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 
+#if defined(_WIN32)
+
 #ifdef ENGINE_EXPORTS
 
 #define D3D_API __declspec(dllexport)
@@ -9,3 +11,15 @@
 #define D3D_API __declspec(dllimport)
 
 #endif // ENGINE_EXPORTS
+
+// Windows.h의 min/max 매크로가 std::min/std::max를 가리지 않도록 한다.
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#else
+
+// 윈도우 외 환경(오프라인 메쉬 처리 등)에서는 DLL 심볼 내보내기가 필요 없음
+#define D3D_API
+
+#endif // _WIN32
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "Fence.h"
+
+namespace Engine
+{
+	Fence::Fence(ID3D12Device* device, UINT64 initialValue)
+		: mTimeline(initialValue)
+	{
+		ThrowIfFailed(device->CreateFence(initialValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+
+		mEvent = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
+		if (mEvent == nullptr)
+			ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+	}
+
+	Fence::~Fence()
+	{
+		if (mEvent != nullptr)
+			CloseHandle(mEvent);
+	}
+
+	UINT64 Fence::Signal(ID3D12CommandQueue* queue)
+	{
+		UINT64 value = mTimeline.Advance();
+		ThrowIfFailed(queue->Signal(mFence.Get(), value));
+		return value;
+	}
+
+	void Fence::Signal(ID3D12CommandQueue* queue, UINT64 value)
+	{
+		mTimeline.Advance(value);
+		ThrowIfFailed(queue->Signal(mFence.Get(), value));
+	}
+
+	bool Fence::IsComplete(UINT64 value)
+	{
+		return mTimeline.IsKnownComplete(value) || value <= GetCompletedValue();
+	}
+
+	bool Fence::WaitCPU(UINT64 value, DWORD timeoutMs)
+	{
+		return mTimeline.Wait(value, timeoutMs,
+			[this]() { return mFence->GetCompletedValue(); },
+			[this](UINT64 waitValue, std::uint32_t remainingMs) { return BlockUntil(waitValue, remainingMs); });
+	}
+
+	void Fence::WaitGPU(ID3D12CommandQueue* queue, UINT64 value)
+	{
+		if (!IsComplete(value))
+			ThrowIfFailed(queue->Wait(mFence.Get(), value));
+	}
+
+	UINT64 Fence::GetCompletedValue()
+	{
+		return mTimeline.UpdateCompleted(mFence->GetCompletedValue());
+	}
+
+	bool Fence::BlockUntil(UINT64 value, DWORD timeoutMs)
+	{
+		ThrowIfFailed(mFence->SetEventOnCompletion(value, mEvent));
+
+		ULONGLONG deadline = GetTickCount64() + timeoutMs;
+		for (;;)
+		{
+			DWORD result = WaitForSingleObject(mEvent, timeoutMs);
+			if (mFence->GetCompletedValue() >= value)
+				return true;
+			if (result == WAIT_TIMEOUT)
+				return false;
+			if (result != WAIT_OBJECT_0)
+				ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+
+			// 이전에 시간 초과로 끝난 대기의 알림이 늦게 도착한 경우. 남은 시간만큼 다시 기다린다.
+			if (timeoutMs != INFINITE)
+			{
+				ULONGLONG now = GetTickCount64();
+				if (now >= deadline)
+					return false;
+				timeoutMs = (DWORD)(deadline - now);
+			}
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "EngineHeader.h"
+#include "FenceTimeline.h"
+#include "Util.h"
+
+#ifndef FENCE_H
+#define FENCE_H
+namespace Engine
+{
+	/// <summary>
+	/// ID3D12Fence와 대기용 이벤트를 묶은 타임라인 펜스.
+	/// Signal할 때마다 값이 1씩 증가하며, 이벤트는 한 번만 만들어 모든 대기에서 재사용한다.
+	/// 대기는 잠시 완료 값을 확인한 뒤 이벤트로 잠들고, 기다린 시간은 GetWaitStats로 확인할 수 있다.
+	/// 한 스레드(보통 메인 스레드)에서만 사용한다.
+	/// </summary>
+	class D3D_API Fence
+	{
+	public:
+		Fence(ID3D12Device* device, UINT64 initialValue = 0);
+		Fence(const Fence& rhs) = delete;
+		Fence& operator=(const Fence& rhs) = delete;
+		~Fence();
+
+		/// <summary>
+		/// queue에 다음 펜스 값을 Signal
+		/// </summary>
+		/// <returns>Signal한 값. 이 값이 완료되면 지금까지 queue에 제출한 명령이 모두 끝난 것이다.</returns>
+		UINT64 Signal(ID3D12CommandQueue* queue);
+
+		/// <summary>
+		/// 호출자가 정한 값을 Signal. 마지막으로 Signal한 값보다 커야 한다.
+		/// </summary>
+		void Signal(ID3D12CommandQueue* queue, UINT64 value);
+
+		bool IsComplete(UINT64 value);
+
+		/// <summary>
+		/// value가 완료될 때까지 CPU에서 대기
+		/// </summary>
+		/// <returns>timeoutMs 안에 완료되었으면 true</returns>
+		bool WaitCPU(UINT64 value, DWORD timeoutMs = INFINITE);
+
+		/// <summary>
+		/// queue가 value의 완료를 GPU에서 기다리도록 한다. 이미 완료되었으면 아무것도 하지 않는다.
+		/// </summary>
+		void WaitGPU(ID3D12CommandQueue* queue, UINT64 value);
+
+		UINT64 GetCompletedValue();
+		UINT64 GetLastSignaledValue() const { return mTimeline.GetLastSignaledValue(); }
+
+		ID3D12Fence* Get() const { return mFence.Get(); }
+
+		const FenceWaitStats& GetWaitStats() const { return mTimeline.GetStats(); }
+		void ResetWaitStats() { mTimeline.ResetStats(); }
+
+	private:
+		bool BlockUntil(UINT64 value, DWORD timeoutMs);
+
+		Microsoft::WRL::ComPtr<ID3D12Fence> mFence;
+		HANDLE mEvent = nullptr;
+		FenceTimeline mTimeline;
+	};
+}
+#endif
@@ -0,0 +1,146 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#ifndef FENCETIMELINE_H
+#define FENCETIMELINE_H
+namespace Engine
+{
+	/// <summary>
+	/// 펜스 대기 통계. 프로파일링(프레임 통계 출력 등)에 사용한다.
+	/// </summary>
+	struct FenceWaitStats
+	{
+		std::uint64_t WaitCount = 0;        // 완료되지 않은 값을 기다린 횟수
+		std::uint64_t SpinCompletions = 0;  // 잠들기 전 스핀 중에 완료된 횟수
+		std::uint64_t BlockCount = 0;       // 이벤트로 잠든 횟수
+		std::uint64_t TimeoutCount = 0;     // 제한 시간 안에 완료되지 않은 횟수
+		double TotalWaitMs = 0.0;           // 기다린 시간 합
+		double MaxWaitMs = 0.0;             // 가장 오래 기다린 시간
+	};
+
+	/// <summary>
+	/// 단조 증가하는 펜스 값의 타임라인. Signal한 값과 관측된 완료 값을 추적하고, 스핀 후 대기 방식으로 기다린다.
+	/// 실제 펜스의 조회(poll)와 대기(block)는 함수로 받으므로 플랫폼에 독립적이며, 소프트웨어 펜스로 단독 검증할 수 있다.
+	/// 한 스레드에서만 사용한다.
+	/// </summary>
+	class FenceTimeline
+	{
+	public:
+		// WaitForSingleObject의 INFINITE와 같은 값
+		static const std::uint32_t InfiniteTimeout = 0xFFFFFFFF;
+
+		explicit FenceTimeline(std::uint64_t initialValue = 0)
+			: mLastSignaledValue(initialValue), mLastCompletedValue(initialValue)
+		{
+		}
+
+		/// <summary>
+		/// 다음에 Signal할 값을 예약하고 반환
+		/// </summary>
+		std::uint64_t Advance()
+		{
+			return ++mLastSignaledValue;
+		}
+
+		/// <summary>
+		/// 외부에서 정한 값을 Signal한다. 이전에 Signal한 값보다 커야 한다.
+		/// </summary>
+		void Advance(std::uint64_t value)
+		{
+			assert(value > mLastSignaledValue && "펜스 값은 단조 증가해야 한다");
+			mLastSignaledValue = value;
+		}
+
+		/// <summary>
+		/// 펜스에서 읽은 완료 값을 반영한다. 더 작은 값은 무시한다.
+		/// </summary>
+		/// <returns>지금까지 관측된 가장 큰 완료 값</returns>
+		std::uint64_t UpdateCompleted(std::uint64_t completedValue)
+		{
+			mLastCompletedValue = std::max(mLastCompletedValue, completedValue);
+			return mLastCompletedValue;
+		}
+
+		/// <summary>
+		/// 마지막으로 관측된 완료 값 기준으로 value가 끝났는지 여부 (펜스를 조회하지 않는다)
+		/// </summary>
+		bool IsKnownComplete(std::uint64_t value) const { return value <= mLastCompletedValue; }
+
+		/// <summary>
+		/// value가 완료될 때까지 기다린다. poll()로 완료 값을 읽으며 spinTime 동안 확인하다가,
+		/// 그래도 끝나지 않으면 block(value, timeoutMs)로 잠든다.
+		/// </summary>
+		/// <param name="poll">현재 완료 값을 반환하는 함수</param>
+		/// <param name="block">value가 완료되면 true, 제한 시간이 지나면 false를 반환하는 함수</param>
+		/// <returns>완료되었으면 true</returns>
+		template<typename TPoll, typename TBlock>
+		bool Wait(std::uint64_t value, std::uint32_t timeoutMs, TPoll&& poll, TBlock&& block)
+		{
+			if (IsKnownComplete(value) || value <= UpdateCompleted(poll()))
+				return true;
+
+			assert(value <= mLastSignaledValue && "Signal되지 않은 값을 기다리면 끝나지 않는다");
+
+			using Clock = std::chrono::steady_clock;
+			Clock::time_point start = Clock::now();
+			++mStats.WaitCount;
+
+			// 곧 끝날 프레임을 위해 커널 대기 없이 잠시 확인한다.
+			bool complete = false;
+			while (Clock::now() - start < mSpinTime)
+			{
+				if (value <= UpdateCompleted(poll()))
+				{
+					complete = true;
+					++mStats.SpinCompletions;
+					break;
+				}
+				std::this_thread::yield();
+			}
+
+			if (!complete)
+			{
+				std::uint32_t remainingMs = timeoutMs;
+				if (timeoutMs != InfiniteTimeout)
+				{
+					auto spentMs = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+					remainingMs = spentMs >= timeoutMs ? 0 : timeoutMs - (std::uint32_t)spentMs;
+				}
+
+				++mStats.BlockCount;
+				complete = block(value, remainingMs);
+				if (complete)
+					UpdateCompleted(value);
+				else
+					++mStats.TimeoutCount;
+			}
+
+			double waitMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			mStats.TotalWaitMs += waitMs;
+			mStats.MaxWaitMs = std::max(mStats.MaxWaitMs, waitMs);
+			return complete;
+		}
+
+		std::uint64_t GetLastSignaledValue() const { return mLastSignaledValue; }
+		std::uint64_t GetLastCompletedValue() const { return mLastCompletedValue; }
+
+		/// <summary>
+		/// 잠들기 전에 완료 값을 확인하는 시간 (기본 50us)
+		/// </summary>
+		void SetSpinTime(std::chrono::microseconds spinTime) { mSpinTime = spinTime; }
+
+		const FenceWaitStats& GetStats() const { return mStats; }
+		void ResetStats() { mStats = FenceWaitStats(); }
+
+	private:
+		std::uint64_t mLastSignaledValue;
+		std::uint64_t mLastCompletedValue;
+		std::chrono::microseconds mSpinTime{ 50 };
+		FenceWaitStats mStats;
+	};
+}
+#endif
@@ -0,0 +1,178 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+namespace Engine
+{
+	/// <summary>
+	/// 한 프레임의 측정값. 측정하지 못한 값은 음수로 둔다.
+	/// </summary>
+	struct FrameTimingSample
+	{
+		double CpuMs = -1.0;             // CPU가 프레임을 만드는 데 쓴 시간 (펜스 대기와 페이싱으로 잠든 시간 제외)
+		double GpuMs = -1.0;             // GPU가 한 프레임의 명령을 처리한 시간 (타임스탬프 쿼리)
+		double PresentIntervalMs = -1.0; // 직전 Present부터 이번 Present까지의 간격
+	};
+
+	/// <summary>
+	/// 측정값의 지수 이동 평균. 아직 표본이 없는 값은 음수다.
+	/// </summary>
+	struct FrameTimingAverages
+	{
+		double CpuMs = -1.0;
+		double CpuJitterMs = 0.0;        // CPU 시간이 평균에서 벗어난 정도의 평균
+		double GpuMs = -1.0;
+		double PresentIntervalMs = -1.0;
+	};
+
+	struct FramePacingSettings
+	{
+		std::uint32_t MinFramesInFlight = 1;
+		std::uint32_t MaxFramesInFlight = 3;  // 프레임 리소스 수보다 크면 안 된다
+		double TargetFrameMs = 0.0;           // 수직 동기 등으로 정해진 프레임 간격 (0이면 Present 간격으로 추정)
+		double SafetyMarginMs = 1.0;          // GPU가 굶지 않도록 남겨 두는 여유
+		double Smoothing = 0.1;               // 지수 이동 평균에서 새 표본의 가중치
+		std::uint32_t SwitchFrames = 30;      // 깊이를 바꾸려면 같은 결정이 이만큼 이어져야 한다
+	};
+
+	struct FramePacingDecision
+	{
+		std::uint32_t FramesInFlight = 2;     // CPU가 GPU보다 앞서 제출할 수 있는 프레임 수
+		double SleepMs = 0.0;                 // 다음 프레임의 입력을 읽기 전에 잠들 시간
+	};
+
+	/// <summary>
+	/// 프레임 측정값으로 진행 중인 프레임 수(깊이)와 프레임 시작 전에 잠들 시간을 정한다.
+	/// 시계를 읽지 않고 넘겨받은 표본만으로 결정하므로, 기록해 둔 측정값을 그대로 재생해서 검증할 수 있다.
+	///
+	/// - CPU와 GPU를 차례로 실행해도 목표 간격 안에 들어오면 한 프레임만 진행한다. (지연 최소)
+	/// - GPU가 병목이면 두 프레임을 겹쳐 실행하고, CPU가 남는 시간만큼 입력을 읽기 전에 잠든다.
+	/// - CPU 시간이 흔들려 GPU를 굶길 수 있으면 세 프레임까지 앞서간다.
+	/// </summary>
+	class FramePacer
+	{
+	public:
+		explicit FramePacer(const FramePacingSettings& settings = FramePacingSettings())
+			: mSettings(settings)
+		{
+			mDecision.FramesInFlight = ClampFrames(settings, 2);
+		}
+
+		/// <summary>
+		/// 프레임 측정값을 반영하고 다음 프레임에 사용할 결정을 반환
+		/// </summary>
+		const FramePacingDecision& AddSample(const FrameTimingSample& sample)
+		{
+			if (sample.CpuMs >= 0.0)
+			{
+				if (mAverages.CpuMs >= 0.0)
+					mAverages.CpuJitterMs = Blend(mAverages.CpuJitterMs, std::fabs(sample.CpuMs - mAverages.CpuMs));
+				mAverages.CpuMs = Blend(mAverages.CpuMs, sample.CpuMs);
+			}
+			mAverages.GpuMs = Blend(mAverages.GpuMs, sample.GpuMs);
+			mAverages.PresentIntervalMs = Blend(mAverages.PresentIntervalMs, sample.PresentIntervalMs);
+
+			// 평균이 자리 잡을 때까지는 처음 결정을 유지
+			if (++mSampleCount < mSettings.SwitchFrames)
+				return mDecision;
+
+			FramePacingDecision proposed = Decide(mSettings, mAverages);
+			if (proposed.FramesInFlight == mDecision.FramesInFlight)
+			{
+				mDecision.SleepMs = proposed.SleepMs;
+				mPendingCount = 0;
+				return mDecision;
+			}
+
+			// 깊이는 같은 결정이 이어질 때만 바꾸고, 바뀌기를 기다리는 동안에는 잠들지 않는다.
+			mDecision.SleepMs = 0.0;
+			if (proposed.FramesInFlight != mPendingFrames)
+			{
+				mPendingFrames = proposed.FramesInFlight;
+				mPendingCount = 0;
+			}
+			if (++mPendingCount >= mSettings.SwitchFrames)
+			{
+				mDecision = proposed;
+				mPendingCount = 0;
+			}
+			return mDecision;
+		}
+
+		/// <summary>
+		/// 평균값만으로 결정을 계산 (이력 없음)
+		/// </summary>
+		static FramePacingDecision Decide(const FramePacingSettings& settings, const FrameTimingAverages& averages)
+		{
+			FramePacingDecision decision;
+			decision.FramesInFlight = ClampFrames(settings, 2);
+
+			// GPU 시간을 모르면 겹쳐 실행만 하고 잠들지 않는다.
+			if (averages.CpuMs < 0.0 || averages.GpuMs < 0.0)
+				return decision;
+
+			double cpu = averages.CpuMs;
+			double cpuHigh = cpu + 2.0 * averages.CpuJitterMs;
+			double gpu = averages.GpuMs;
+			double margin = settings.SafetyMarginMs;
+
+			// 화면 갱신 간격. 지정하지 않았으면 Present 간격으로 추정한다.
+			// (제한이 없으면 Present 간격은 CPU와 GPU를 차례로 실행한 시간보다 길 수 없으므로 한 프레임 모드를 고르지 않는다)
+			double displayMs = settings.TargetFrameMs > 0.0 ? settings.TargetFrameMs : averages.PresentIntervalMs;
+			if (displayMs > 0.0 && cpuHigh + gpu + margin <= displayMs)
+			{
+				decision.FramesInFlight = ClampFrames(settings, 1);
+				return decision;
+			}
+
+			// CPU가 병목이면 GPU가 기다리는 쪽이므로 더 앞서가도, 잠들어도 얻는 것이 없다.
+			if (cpu + margin >= gpu)
+				return decision;
+
+			// 평균은 GPU보다 빠르지만 흔들림이 여유를 넘으면 한 프레임 더 쌓아 GPU가 쉬지 않게 한다.
+			if (cpuHigh + margin > gpu)
+			{
+				decision.FramesInFlight = ClampFrames(settings, 3);
+				return decision;
+			}
+
+			// GPU가 병목: CPU가 먼저 끝나 앞 프레임을 기다리는 만큼 입력이 오래된다.
+			// 그 시간만큼 프레임 시작 전에 잠들어 제출이 앞 프레임의 완료 직전에 도착하게 한다.
+			decision.SleepMs = gpu - cpuHigh - margin;
+			return decision;
+		}
+
+		const FramePacingDecision& GetDecision() const { return mDecision; }
+		const FrameTimingAverages& GetAverages() const { return mAverages; }
+		const FramePacingSettings& GetSettings() const { return mSettings; }
+
+	private:
+		static std::uint32_t ClampFrames(const FramePacingSettings& settings, std::uint32_t frames)
+		{
+			std::uint32_t minFrames = std::max<std::uint32_t>(settings.MinFramesInFlight, 1);
+			std::uint32_t maxFrames = std::max(settings.MaxFramesInFlight, minFrames);
+			return std::min(std::max(frames, minFrames), maxFrames);
+		}
+
+		double Blend(double average, double sample) const
+		{
+			if (sample < 0.0)
+				return average;
+			if (average < 0.0)
+				return sample;
+			return average + (sample - average) * mSettings.Smoothing;
+		}
+
+		FramePacingSettings mSettings;
+		FrameTimingAverages mAverages;
+		FramePacingDecision mDecision;
+
+		std::uint64_t mSampleCount = 0;
+		std::uint32_t mPendingFrames = 0;
+		std::uint32_t mPendingCount = 0;
+	};
+}
+#endif
@@ -71,7 +71,7 @@ namespace Engine
 		mCurrTime = currTime;
 		mDeltaTime = (mCurrTime - mPrevTime) * mSecondsPerCount;
 		mPrevTime = mCurrTime;
-		//   (μ   ,   ɼ )
+		// 음수 방지 (프로세서가 절전모드 등인 경우, 음수가 될 가능성이 있음)
 		if (mDeltaTime < 0.0)
 			mDeltaTime = 0.0;
 	}
@@ -10,24 +10,24 @@ namespace Engine
 	public:
 		GameTimer();
 
-		float TotalTime() const; // ø̼    ü ð()
-		float DeltaTime() const; //     ð()
+		float TotalTime() const; // 애플리케이션 시작 이후 경과된 전체 시간(초)
+		float DeltaTime() const; // 마지막 프레임 이후 경과된 시간(초)
 
-		void Reset();	// Ÿ̸ 
-		void Start();	// Ÿ̸ 
-		void Stop();	// Ÿ̸ 
-		void Tick();	//  Ӹ ȣǾ, ð 
+		void Reset();	// 타이머 리셋
+		void Start();	// 타이머 시작
+		void Stop();	// 타이머 정지
+		void Tick();	// 매 프레임마다 호출되어, 시간 갱신
 
 	private:
-		double mSecondsPerCount; // ī  
-		double mDeltaTime;       //     ð()
-		__int64 mBaseTime;       // Ÿ̸Ӱ ۵ 
-		__int64 mPausedTime;     // Ÿ̸Ӱ    ð
-		__int64 mStopTime;       // Ÿ̸Ӱ   
-		__int64 mPrevTime;       //  Tick Լ	ȣ 
-		__int64 mCurrTime;       //  Tick Լ ȣ 
-
-		bool mStopped;           // Ÿ̸  
+		double mSecondsPerCount; // 카운터 당 초
+		double mDeltaTime;       // 마지막 프레임 이후 경과된 시간(초)
+		__int64 mBaseTime;       // 타이머가 시작된 시점
+		__int64 mPausedTime;     // 타이머가 정지된 동안의 누적 시간
+		__int64 mStopTime;       // 타이머가 마지막으로 정지된 시점
+		__int64 mPrevTime;       // 직전 Tick 함수가	호출된 시점
+		__int64 mCurrTime;       // 현재 Tick 함수가 호출된 시점
+
+		bool mStopped;           // 타이머 정지 여부
 	};
 }
 #endif // GAMETIMER_H
@@ -1,9 +1,513 @@
 #include "GeometryGenerator.h"
+#include "JobSystem.h"
 #include <algorithm>
 
+// Defining GEOMETRYGENERATOR_NO_SIMD leaves only the scalar index loops (used by the tests as a reference build).
+#if !defined(GEOMETRYGENERATOR_NO_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GEOMETRYGENERATOR_AVX2
+#endif
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GEOMETRYGENERATOR_SSE2
+#endif
+#endif
+
 using namespace Engine;
 using namespace DirectX;
 
+namespace
+{
+	using uint32 = GeometryGenerator::uint32;
+	using uint64 = std::uint64_t;
+
+	// (min, max) with min < max can never produce this key.
+	const uint64 EmptyEdgeKey = ~0ull;
+
+	// Flat open-addressing hash table that maps an undirected edge to the index
+	// of its midpoint vertex. Keys are the (min, max) vertex index pair packed
+	// into 64 bits and collisions are resolved by linear probing.
+	class EdgeMidpointMap
+	{
+	public:
+		explicit EdgeMidpointMap(uint32 maxEdges)
+		{
+			// Keep the load factor at or below 0.5.
+			size_t capacity = 16;
+			while (capacity < (size_t)maxEdges * 2)
+				capacity <<= 1;
+
+			mMask = capacity - 1;
+			mKeys.assign(capacity, EmptyEdgeKey);
+			mValues.resize(capacity);
+		}
+
+		// Returns the value stored for edge (a, b), inserting newValue if the edge
+		// has not been seen yet.
+		uint32 FindOrInsert(uint32 a, uint32 b, uint32 newValue)
+		{
+			uint64 key = a < b ? ((uint64)a << 32) | b : ((uint64)b << 32) | a;
+
+			size_t slot = Hash(key) & mMask;
+			while (true)
+			{
+				if (mKeys[slot] == key)
+					return mValues[slot];
+
+				if (mKeys[slot] == EmptyEdgeKey)
+				{
+					mKeys[slot] = key;
+					mValues[slot] = newValue;
+					return newValue;
+				}
+
+				slot = (slot + 1) & mMask;
+			}
+		}
+
+	private:
+		static size_t Hash(uint64 key)
+		{
+			// 64-bit finalizer from MurmurHash3.
+			key ^= key >> 33;
+			key *= 0xff51afd7ed558ccdull;
+			key ^= key >> 33;
+			key *= 0xc4ceb9fe1a85ec53ull;
+			key ^= key >> 33;
+			return (size_t)key;
+		}
+
+		size_t mMask = 0;
+		std::vector<uint64> mKeys;
+		std::vector<uint32> mValues;
+	};
+
+	// Writes the part of a sphere owned by stack row r in [0, stackCount): ring r (the
+	// pole for the first and last rows) and the triangles between ring r and ring r + 1.
+	// Every row writes a disjoint range of the output, so rows can be generated in any
+	// order or concurrently and still produce the same buffers.
+	template<typename IndexT>
+	void WriteSphereRows(float radius, uint32 sliceCount, uint32 stackCount, uint32 rowBegin, uint32 rowEnd,
+		GeometryGenerator::Vertex* vertices, IndexT* indices)
+	{
+		using Vertex = GeometryGenerator::Vertex;
+
+		float phiStep = XM_PI / stackCount;
+		float thetaStep = 2.0f * XM_PI / sliceCount;
+
+		// Add one because we duplicate the first and last vertex per ring
+		// since the texture coordinates are different.
+		uint32 ringVertexCount = sliceCount + 1;
+
+		// The top pole comes first, followed by the rings and the bottom pole.
+		uint32 southPoleIndex = (stackCount - 1) * ringVertexCount + 1;
+
+		for (uint32 r = rowBegin; r < rowEnd; ++r)
+		{
+			//
+			// Compute the vertices stating at the top pole and moving down the stacks.
+			//
+
+			if (r == 0)
+			{
+				// Poles: note that there will be texture coordinate distortion as there is
+				// not a unique point on the texture map to assign to the pole when mapping
+				// a rectangular texture onto a sphere.
+				vertices[0] = Vertex(0.0f, +radius, 0.0f, 0.0f, +1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+			}
+			else
+			{
+				// Vertices of ring r (do not count the poles as rings).
+				float phi = r * phiStep;
+				Vertex* ring = vertices + 1 + (r - 1) * ringVertexCount;
+
+				for (uint32 j = 0; j <= sliceCount; ++j)
+				{
+					float theta = j * thetaStep;
+
+					Vertex v;
+
+					// spherical to cartesian
+					v.Position.x = radius * sinf(phi) * cosf(theta);
+					v.Position.y = radius * cosf(phi);
+					v.Position.z = radius * sinf(phi) * sinf(theta);
+
+					// Partial derivative of P with respect to theta
+					v.TangentU.x = -radius * sinf(phi) * sinf(theta);
+					v.TangentU.y = 0.0f;
+					v.TangentU.z = +radius * sinf(phi) * cosf(theta);
+
+					XMVECTOR T = XMLoadFloat3(&v.TangentU);
+					XMStoreFloat3(&v.TangentU, XMVector3Normalize(T));
+
+					XMVECTOR p = XMLoadFloat3(&v.Position);
+					XMStoreFloat3(&v.Normal, XMVector3Normalize(p));
+
+					v.TexC.x = theta / XM_2PI;
+					v.TexC.y = phi / XM_PI;
+
+					ring[j] = v;
+				}
+			}
+
+			if (r == stackCount - 1)
+				vertices[southPoleIndex] = Vertex(0.0f, -radius, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+
+			//
+			// Compute the indices of stack r.
+			//
+
+			IndexT* out = indices + r * sliceCount * 6 - (r > 0 ? sliceCount * 3 : 0);
+
+			if (r == 0)
+			{
+				// The top stack connects the top pole to the first ring.
+				for (uint32 i = 1; i <= sliceCount; ++i)
+				{
+					*out++ = (IndexT)0;
+					*out++ = (IndexT)(i + 1);
+					*out++ = (IndexT)i;
+				}
+			}
+			else if (r == stackCount - 1)
+			{
+				// The bottom stack connects the bottom pole to the bottom ring.
+				uint32 baseIndex = southPoleIndex - ringVertexCount;
+
+				for (uint32 i = 0; i < sliceCount; ++i)
+				{
+					*out++ = (IndexT)southPoleIndex;
+					*out++ = (IndexT)(baseIndex + i);
+					*out++ = (IndexT)(baseIndex + i + 1);
+				}
+			}
+			else
+			{
+				// Inner stacks (not connected to poles). Offset the indices to the index
+				// of the first vertex in the first ring. This is just skipping the top pole vertex.
+				uint32 baseIndex = 1;
+				uint32 i = r - 1;
+
+				for (uint32 j = 0; j < sliceCount; ++j)
+				{
+					*out++ = (IndexT)(baseIndex + i * ringVertexCount + j);
+					*out++ = (IndexT)(baseIndex + i * ringVertexCount + j + 1);
+					*out++ = (IndexT)(baseIndex + (i + 1) * ringVertexCount + j);
+
+					*out++ = (IndexT)(baseIndex + (i + 1) * ringVertexCount + j);
+					*out++ = (IndexT)(baseIndex + i * ringVertexCount + j + 1);
+					*out++ = (IndexT)(baseIndex + (i + 1) * ringVertexCount + j + 1);
+				}
+			}
+		}
+	}
+
+	template<typename IndexT>
+	void WriteSphere(float radius, uint32 sliceCount, uint32 stackCount, GeometryGenerator::Vertex* vertices, IndexT* indices)
+	{
+		WriteSphereRows(radius, sliceCount, stackCount, 0, stackCount, vertices, indices);
+	}
+
+	template<typename IndexT>
+	void WriteCylinder(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount,
+		GeometryGenerator::Vertex* vertices, IndexT* indices)
+	{
+		using Vertex = GeometryGenerator::Vertex;
+
+		//
+		// Build Stacks.
+		// 
+
+		float stackHeight = height / stackCount;
+
+		// Amount to increment radius as we move up each stack level from bottom to top.
+		float radiusStep = (topRadius - bottomRadius) / stackCount;
+
+		uint32 ringCount = stackCount + 1;
+		uint32 vertexCount = 0;
+
+		// Compute vertices for each stack ring starting at the bottom and moving up.
+		for (uint32 i = 0; i < ringCount; ++i)
+		{
+			float y = -0.5f * height + i * stackHeight;
+			float r = bottomRadius + i * radiusStep;
+
+			// vertices of ring
+			float dTheta = 2.0f * XM_PI / sliceCount;
+			for (uint32 j = 0; j <= sliceCount; ++j)
+			{
+				Vertex vertex;
+
+				float c = cosf(j * dTheta);
+				float s = sinf(j * dTheta);
+
+				vertex.Position = XMFLOAT3(r * c, y, r * s);
+
+				vertex.TexC.x = (float)j / sliceCount;
+				vertex.TexC.y = 1.0f - (float)i / stackCount;
+
+				// Cylinder can be parameterized as follows, where we introduce v
+				// parameter that goes in the same direction as the v tex-coord
+				// so that the bitangent goes in the same direction as the v tex-coord.
+				//   Let r0 be the bottom radius and let r1 be the top radius.
+				//   y(v) = h - hv for v in [0,1].
+				//   r(v) = r1 + (r0-r1)v
+				//
+				//   x(t, v) = r(v)*cos(t)
+				//   y(t, v) = h - hv
+				//   z(t, v) = r(v)*sin(t)
+				// 
+				//  dx/dt = -r(v)*sin(t)
+				//  dy/dt = 0
+				//  dz/dt = +r(v)*cos(t)
+				//
+				//  dx/dv = (r0-r1)*cos(t)
+				//  dy/dv = -h
+				//  dz/dv = (r0-r1)*sin(t)
+
+				// This is unit length.
+				vertex.TangentU = XMFLOAT3(-s, 0.0f, c);
+
+				float dr = bottomRadius - topRadius;
+				XMFLOAT3 bitangent(dr * c, -height, dr * s);
+
+				XMVECTOR T = XMLoadFloat3(&vertex.TangentU);
+				XMVECTOR B = XMLoadFloat3(&bitangent);
+				XMVECTOR N = XMVector3Normalize(XMVector3Cross(T, B));
+				XMStoreFloat3(&vertex.Normal, N);
+
+				vertices[vertexCount++] = vertex;
+			}
+		}
+
+		// Add one because we duplicate the first and last vertex per ring
+		// since the texture coordinates are different.
+		uint32 ringVertexCount = sliceCount + 1;
+
+		// Compute indices for each stack.
+		uint32 k = 0;
+		for (uint32 i = 0; i < stackCount; ++i)
+		{
+			for (uint32 j = 0; j < sliceCount; ++j)
+			{
+				indices[k++] = (IndexT)(i * ringVertexCount + j);
+				indices[k++] = (IndexT)((i + 1) * ringVertexCount + j);
+				indices[k++] = (IndexT)((i + 1) * ringVertexCount + j + 1);
+
+				indices[k++] = (IndexT)(i * ringVertexCount + j);
+				indices[k++] = (IndexT)((i + 1) * ringVertexCount + j + 1);
+				indices[k++] = (IndexT)(i * ringVertexCount + j + 1);
+			}
+		}
+
+		//
+		// Build top and bottom caps.
+		//
+
+		float dTheta = 2.0f * XM_PI / sliceCount;
+		for (int cap = 0; cap < 2; ++cap)
+		{
+			bool top = cap == 0;
+			float y = top ? 0.5f * height : -0.5f * height;
+			float radius = top ? topRadius : bottomRadius;
+			float ny = top ? 1.0f : -1.0f;
+
+			uint32 baseIndex = vertexCount;
+
+			// Duplicate cap ring vertices because the texture coordinates and normals differ.
+			for (uint32 i = 0; i <= sliceCount; ++i)
+			{
+				float x = radius * cosf(i * dTheta);
+				float z = radius * sinf(i * dTheta);
+
+				// Scale down by the height to try and make top cap texture coord area
+				// proportional to base.
+				float u = x / height + 0.5f;
+				float v = z / height + 0.5f;
+
+				vertices[vertexCount++] = Vertex(x, y, z, 0.0f, ny, 0.0f, 1.0f, 0.0f, 0.0f, u, v);
+			}
+
+			// Cap center vertex.
+			vertices[vertexCount++] = Vertex(0.0f, y, 0.0f, 0.0f, ny, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 0.5f);
+
+			// Index of center vertex.
+			uint32 centerIndex = vertexCount - 1;
+
+			// The caps face opposite directions, so their winding orders are mirrored.
+			for (uint32 i = 0; i < sliceCount; ++i)
+			{
+				indices[k++] = (IndexT)centerIndex;
+				indices[k++] = (IndexT)(top ? baseIndex + i + 1 : baseIndex + i);
+				indices[k++] = (IndexT)(top ? baseIndex + i : baseIndex + i + 1);
+			}
+		}
+	}
+
+	// Writes vertex rows [rowBegin, rowEnd) of a grid and the quads below each of those
+	// rows. Like WriteSphereRows, rows own disjoint ranges of the output.
+	template<typename IndexT>
+	void WriteGridRows(float width, float depth, uint32 m, uint32 n, uint32 rowBegin, uint32 rowEnd,
+		GeometryGenerator::Vertex* vertices, IndexT* indices)
+	{
+		//
+		// Create the vertices.
+		//
+
+		float halfWidth = 0.5f * width;
+		float halfDepth = 0.5f * depth;
+
+		float dx = width / (n - 1);
+		float dz = depth / (m - 1);
+
+		float du = 1.0f / (n - 1);
+		float dv = 1.0f / (m - 1);
+
+		for (uint32 i = rowBegin; i < rowEnd; ++i)
+		{
+			float z = halfDepth - i * dz;
+			for (uint32 j = 0; j < n; ++j)
+			{
+				float x = -halfWidth + j * dx;
+
+				vertices[i * n + j].Position = XMFLOAT3(x, 0.0f, z);
+				vertices[i * n + j].Normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
+				vertices[i * n + j].TangentU = XMFLOAT3(1.0f, 0.0f, 0.0f);
+
+				// Stretch texture over grid.
+				vertices[i * n + j].TexC.x = j * du;
+				vertices[i * n + j].TexC.y = i * dv;
+			}
+		}
+
+		//
+		// Create the indices.
+		//
+
+		// Iterate over each quad and compute indices.
+		uint32 quadRowEnd = std::min(rowEnd, m - 1);
+		for (uint32 i = rowBegin; i < quadRowEnd; ++i)
+		{
+			uint32 k = i * (n - 1) * 6;
+			for (uint32 j = 0; j < n - 1; ++j)
+			{
+				indices[k] = (IndexT)(i * n + j);
+				indices[k + 1] = (IndexT)(i * n + j + 1);
+				indices[k + 2] = (IndexT)((i + 1) * n + j);
+
+				indices[k + 3] = (IndexT)((i + 1) * n + j);
+				indices[k + 4] = (IndexT)(i * n + j + 1);
+				indices[k + 5] = (IndexT)((i + 1) * n + j + 1);
+
+				k += 6; // next quad
+			}
+		}
+	}
+
+	template<typename IndexT>
+	void WriteGrid(float width, float depth, uint32 m, uint32 n, GeometryGenerator::Vertex* vertices, IndexT* indices)
+	{
+		WriteGridRows(width, depth, m, n, 0, m, vertices, indices);
+	}
+
+	// Rows per job below which scheduling another job costs more than it saves.
+	const uint32 MinParallelRows = 64;
+
+	// Runs fn(begin, end) over [0, count) as MinParallelRows-sized jobs, or inline when
+	// there is no job system or too few rows to split.
+	template<typename Fn>
+	void ParallelRows(uint32 count, JobSystem* jobs, const Fn& fn)
+	{
+		if (jobs == nullptr || count <= MinParallelRows)
+		{
+			fn(0, count);
+			return;
+		}
+
+		jobs->ParallelFor(count, MinParallelRows, [&fn](size_t begin, size_t end)
+		{
+			fn((uint32)begin, (uint32)end);
+		});
+	}
+}
+
+bool GeometryGenerator::NarrowIndices(const uint32* src, uint16* dst, size_t count)
+{
+	size_t i = 0;
+	uint32 combined = 0;
+
+#if defined(GEOMETRYGENERATOR_AVX2)
+	// packus works within 128-bit lanes, so the 64-bit quarters are put back in order afterwards.
+	__m256i combined8 = _mm256_setzero_si256();
+	for (; i + 16 <= count; i += 16)
+	{
+		__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 8));
+		combined8 = _mm256_or_si256(combined8, _mm256_or_si256(a, b));
+
+		__m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+	}
+	if (!_mm256_testz_si256(combined8, _mm256_set1_epi32((int)0xFFFF0000)))
+		combined |= 0x10000;
+#endif
+
+#if defined(GEOMETRYGENERATOR_SSE2)
+	// SSE2 only has a signed saturating pack, so the values are biased into the
+	// signed range before packing and biased back afterwards.
+	const __m128i bias32 = _mm_set1_epi32(0x8000);
+	const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+	__m128i combined4 = _mm_setzero_si128();
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4));
+		combined4 = _mm_or_si128(combined4, _mm_or_si128(a, b));
+
+		__m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_add_epi16(packed, bias16));
+	}
+	__m128i high = _mm_srli_epi32(combined4, 16);
+	if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF)
+		combined |= 0x10000;
+#endif
+
+	for (; i < count; ++i)
+	{
+		combined |= src[i];
+		dst[i] = static_cast<uint16>(src[i]);
+	}
+
+	return (combined >> 16) == 0;
+}
+
+bool GeometryGenerator::FitsIn16Bits(const uint32* indices, size_t count)
+{
+	size_t i = 0;
+	uint32 combined = 0;
+
+#if defined(GEOMETRYGENERATOR_SSE2)
+	__m128i combined4 = _mm_setzero_si128();
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i + 4));
+		__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i + 8));
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i + 12));
+		combined4 = _mm_or_si128(combined4, _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)));
+	}
+	__m128i high = _mm_srli_epi32(combined4, 16);
+	if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF)
+		return false;
+#endif
+
+	for (; i < count; ++i)
+		combined |= indices[i];
+
+	return (combined >> 16) == 0;
+}
+
 GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float height, float depth, uint32 numSubdivisions)
 {
 	MeshData meshData;
@@ -101,111 +605,30 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
 {
 	MeshData meshData;
 
-	//
-	// Compute the vertices stating at the top pole and moving down the stacks.
-	//
+	MeshSize size = GetSphereSize(sliceCount, stackCount);
+	meshData.Vertices.resize(size.VertexCount);
+	meshData.Indices32.resize(size.IndexCount);
+	CreateSphere(radius, sliceCount, stackCount, meshData.Vertices.data(), meshData.Indices32.data());
 
-	// Poles: note that there will be texture coordinate distortion as there is
-	// not a unique point on the texture map to assign to the pole when mapping
-	// a rectangular texture onto a sphere.
-	Vertex topVertex(0.0f, +radius, 0.0f, 0.0f, +1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
-	Vertex bottomVertex(0.0f, -radius, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
-
-	meshData.Vertices.push_back(topVertex);
-
-	float phiStep = XM_PI / stackCount;
-	float thetaStep = 2.0f * XM_PI / sliceCount;
-
-	// Compute vertices for each stack ring (do not count the poles as rings).
-	for (uint32 i = 1; i <= stackCount - 1; ++i)
-	{
-		float phi = i * phiStep;
-
-		// Vertices of ring.
-		for (uint32 j = 0; j <= sliceCount; ++j)
-		{
-			float theta = j * thetaStep;
-
-			Vertex v;
-
-			// spherical to cartesian
-			v.Position.x = radius * sinf(phi) * cosf(theta);
-			v.Position.y = radius * cosf(phi);
-			v.Position.z = radius * sinf(phi) * sinf(theta);
-
-			// Partial derivative of P with respect to theta
-			v.TangentU.x = -radius * sinf(phi) * sinf(theta);
-			v.TangentU.y = 0.0f;
-			v.TangentU.z = +radius * sinf(phi) * cosf(theta);
-
-			XMVECTOR T = XMLoadFloat3(&v.TangentU);
-			XMStoreFloat3(&v.TangentU, XMVector3Normalize(T));
-
-			XMVECTOR p = XMLoadFloat3(&v.Position);
-			XMStoreFloat3(&v.Normal, XMVector3Normalize(p));
-
-			v.TexC.x = theta / XM_2PI;
-			v.TexC.y = phi / XM_PI;
-
-			meshData.Vertices.push_back(v);
-		}
-	}
-
-	meshData.Vertices.push_back(bottomVertex);
-
-	//
-	// Compute indices for top stack.  The top stack was written first to the vertex buffer
-	// and connects the top pole to the first ring.
-	//
-
-	for (uint32 i = 1; i <= sliceCount; ++i)
-	{
-		meshData.Indices32.push_back(0);
-		meshData.Indices32.push_back(i + 1);
-		meshData.Indices32.push_back(i);
-	}
-
-	//
-	// Compute indices for inner stacks (not connected to poles).
-	//
-
-	// Offset the indices to the index of the first vertex in the first ring.
-	// This is just skipping the top pole vertex.
-	uint32 baseIndex = 1;
-	uint32 ringVertexCount = sliceCount + 1;
-	for (uint32 i = 0; i < stackCount - 2; ++i)
-	{
-		for (uint32 j = 0; j < sliceCount; ++j)
-		{
-			meshData.Indices32.push_back(baseIndex + i * ringVertexCount + j);
-			meshData.Indices32.push_back(baseIndex + i * ringVertexCount + j + 1);
-			meshData.Indices32.push_back(baseIndex + (i + 1) * ringVertexCount + j);
-
-			meshData.Indices32.push_back(baseIndex + (i + 1) * ringVertexCount + j);
-			meshData.Indices32.push_back(baseIndex + i * ringVertexCount + j + 1);
-			meshData.Indices32.push_back(baseIndex + (i + 1) * ringVertexCount + j + 1);
-		}
-	}
-
-	//
-	// Compute indices for bottom stack.  The bottom stack was written last to the vertex buffer
-	// and connects the bottom pole to the bottom ring.
-	//
-
-	// South pole vertex was added last.
-	uint32 southPoleIndex = (uint32)meshData.Vertices.size() - 1;
+	return meshData;
+}
 
-	// Offset the indices to the index of the first vertex in the last ring.
-	baseIndex = southPoleIndex - ringVertexCount;
+void GeometryGenerator::CreateSphere(float radius, uint32 sliceCount, uint32 stackCount, Vertex* vertices, uint32* indices)
+{
+	WriteSphere(radius, sliceCount, stackCount, vertices, indices);
+}
 
-	for (uint32 i = 0; i < sliceCount; ++i)
-	{
-		meshData.Indices32.push_back(southPoleIndex);
-		meshData.Indices32.push_back(baseIndex + i);
-		meshData.Indices32.push_back(baseIndex + i + 1);
-	}
+void GeometryGenerator::CreateSphere(float radius, uint32 sliceCount, uint32 stackCount, Vertex* vertices, uint16* indices)
+{
+	WriteSphere(radius, sliceCount, stackCount, vertices, indices);
+}
 
-	return meshData;
+GeometryGenerator::MeshSize GeometryGenerator::GetSphereSize(uint32 sliceCount, uint32 stackCount)
+{
+	MeshSize size;
+	size.VertexCount = (stackCount - 1) * (sliceCount + 1) + 2;
+	size.IndexCount = (stackCount - 1) * sliceCount * 6;
+	return size;
 }
 
 GeometryGenerator::MeshData GeometryGenerator::CreateGeosphere(float radius, uint32 numSubdivisions)
@@ -287,161 +710,105 @@ GeometryGenerator::MeshData GeometryGenerator::CreateCylinder(float bottomRadius
 {
 	MeshData meshData;
 
-	//
-	// Build Stacks.
-	// 
-
-	float stackHeight = height / stackCount;
-
-	// Amount to increment radius as we move up each stack level from bottom to top.
-	float radiusStep = (topRadius - bottomRadius) / stackCount;
-
-	uint32 ringCount = stackCount + 1;
-
-	// Compute vertices for each stack ring starting at the bottom and moving up.
-	for (uint32 i = 0; i < ringCount; ++i)
-	{
-		float y = -0.5f * height + i * stackHeight;
-		float r = bottomRadius + i * radiusStep;
-
-		// vertices of ring
-		float dTheta = 2.0f * XM_PI / sliceCount;
-		for (uint32 j = 0; j <= sliceCount; ++j)
-		{
-			Vertex vertex;
-
-			float c = cosf(j * dTheta);
-			float s = sinf(j * dTheta);
-
-			vertex.Position = XMFLOAT3(r * c, y, r * s);
+	MeshSize size = GetCylinderSize(sliceCount, stackCount);
+	meshData.Vertices.resize(size.VertexCount);
+	meshData.Indices32.resize(size.IndexCount);
+	CreateCylinder(bottomRadius, topRadius, height, sliceCount, stackCount, meshData.Vertices.data(), meshData.Indices32.data());
 
-			vertex.TexC.x = (float)j / sliceCount;
-			vertex.TexC.y = 1.0f - (float)i / stackCount;
-
-			// Cylinder can be parameterized as follows, where we introduce v
-			// parameter that goes in the same direction as the v tex-coord
-			// so that the bitangent goes in the same direction as the v tex-coord.
-			//   Let r0 be the bottom radius and let r1 be the top radius.
-			//   y(v) = h - hv for v in [0,1].
-			//   r(v) = r1 + (r0-r1)v
-			//
-			//   x(t, v) = r(v)*cos(t)
-			//   y(t, v) = h - hv
-			//   z(t, v) = r(v)*sin(t)
-			// 
-			//  dx/dt = -r(v)*sin(t)
-			//  dy/dt = 0
-			//  dz/dt = +r(v)*cos(t)
-			//
-			//  dx/dv = (r0-r1)*cos(t)
-			//  dy/dv = -h
-			//  dz/dv = (r0-r1)*sin(t)
-
-			// This is unit length.
-			vertex.TangentU = XMFLOAT3(-s, 0.0f, c);
-
-			float dr = bottomRadius - topRadius;
-			XMFLOAT3 bitangent(dr * c, -height, dr * s);
-
-			XMVECTOR T = XMLoadFloat3(&vertex.TangentU);
-			XMVECTOR B = XMLoadFloat3(&bitangent);
-			XMVECTOR N = XMVector3Normalize(XMVector3Cross(T, B));
-			XMStoreFloat3(&vertex.Normal, N);
-
-			meshData.Vertices.push_back(vertex);
-		}
-	}
-
-	// Add one because we duplicate the first and last vertex per ring
-	// since the texture coordinates are different.
-	uint32 ringVertexCount = sliceCount + 1;
-
-	// Compute indices for each stack.
-	for (uint32 i = 0; i < stackCount; ++i)
-	{
-		for (uint32 j = 0; j < sliceCount; ++j)
-		{
-			meshData.Indices32.push_back(i * ringVertexCount + j);
-			meshData.Indices32.push_back((i + 1) * ringVertexCount + j);
-			meshData.Indices32.push_back((i + 1) * ringVertexCount + j + 1);
+	return meshData;
+}
 
-			meshData.Indices32.push_back(i * ringVertexCount + j);
-			meshData.Indices32.push_back((i + 1) * ringVertexCount + j + 1);
-			meshData.Indices32.push_back(i * ringVertexCount + j + 1);
-		}
-	}
+void GeometryGenerator::CreateCylinder(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, Vertex* vertices, uint32* indices)
+{
+	WriteCylinder(bottomRadius, topRadius, height, sliceCount, stackCount, vertices, indices);
+}
 
-	BuildCylinderTopCap(bottomRadius, topRadius, height, sliceCount, stackCount, meshData);
-	BuildCylinderBottomCap(bottomRadius, topRadius, height, sliceCount, stackCount, meshData);
+void GeometryGenerator::CreateCylinder(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, Vertex* vertices, uint16* indices)
+{
+	WriteCylinder(bottomRadius, topRadius, height, sliceCount, stackCount, vertices, indices);
+}
 
-	return meshData;
+GeometryGenerator::MeshSize GeometryGenerator::GetCylinderSize(uint32 sliceCount, uint32 stackCount)
+{
+	// Side rings plus a duplicated ring and a center vertex for each cap.
+	MeshSize size;
+	size.VertexCount = (stackCount + 1) * (sliceCount + 1) + 2 * (sliceCount + 2);
+	size.IndexCount = stackCount * sliceCount * 6 + 2 * sliceCount * 3;
+	return size;
 }
 
 GeometryGenerator::MeshData GeometryGenerator::CreateGrid(float width, float depth, uint32 m, uint32 n)
 {
 	MeshData meshData;
 
-	uint32 vertexCount = m * n;
-	uint32 faceCount = (m - 1) * (n - 1) * 2;
+	MeshSize size = GetGridSize(m, n);
+	meshData.Vertices.resize(size.VertexCount);
+	meshData.Indices32.resize(size.IndexCount); // 3 indices per face
+	CreateGrid(width, depth, m, n, meshData.Vertices.data(), meshData.Indices32.data());
 
-	//
-	// Create the vertices.
-	//
-
-	float halfWidth = 0.5f * width;
-	float halfDepth = 0.5f * depth;
+	return meshData;
+}
 
-	float dx = width / (n - 1);
-	float dz = depth / (m - 1);
+void GeometryGenerator::CreateGrid(float width, float depth, uint32 m, uint32 n, Vertex* vertices, uint32* indices)
+{
+	WriteGrid(width, depth, m, n, vertices, indices);
+}
 
-	float du = 1.0f / (n - 1);
-	float dv = 1.0f / (m - 1);
+void GeometryGenerator::CreateGrid(float width, float depth, uint32 m, uint32 n, Vertex* vertices, uint16* indices)
+{
+	WriteGrid(width, depth, m, n, vertices, indices);
+}
 
-	meshData.Vertices.resize(vertexCount);
-	for (uint32 i = 0; i < m; ++i)
-	{
-		float z = halfDepth - i * dz;
-		for (uint32 j = 0; j < n; ++j)
-		{
-			float x = -halfWidth + j * dx;
+GeometryGenerator::MeshSize GeometryGenerator::GetGridSize(uint32 m, uint32 n)
+{
+	uint32 faceCount = (m - 1) * (n - 1) * 2;
 
-			meshData.Vertices[i * n + j].Position = XMFLOAT3(x, 0.0f, z);
-			meshData.Vertices[i * n + j].Normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
-			meshData.Vertices[i * n + j].TangentU = XMFLOAT3(1.0f, 0.0f, 0.0f);
+	MeshSize size;
+	size.VertexCount = m * n;
+	size.IndexCount = faceCount * 3;
+	return size;
+}
 
-			// Stretch texture over grid.
-			meshData.Vertices[i * n + j].TexC.x = j * du;
-			meshData.Vertices[i * n + j].TexC.y = i * dv;
-		}
-	}
+GeometryGenerator::MeshData GeometryGenerator::CreateGridParallel(float width, float depth, uint32 m, uint32 n, JobSystem* jobs)
+{
+	MeshData meshData;
 
-	//
-	// Create the indices.
-	//
+	MeshSize size = GetGridSize(m, n);
+	meshData.Vertices.resize(size.VertexCount);
+	meshData.Indices32.resize(size.IndexCount);
+	CreateGridParallel(width, depth, m, n, meshData.Vertices.data(), meshData.Indices32.data(), jobs);
 
-	meshData.Indices32.resize(faceCount * 3); // 3 indices per face
+	return meshData;
+}
 
-	// Iterate over each quad and compute indices.
-	uint32 k = 0;
-	for (uint32 i = 0; i < m - 1; ++i)
+void GeometryGenerator::CreateGridParallel(float width, float depth, uint32 m, uint32 n, Vertex* vertices, uint32* indices, JobSystem* jobs)
+{
+	ParallelRows(m, jobs, [=](uint32 rowBegin, uint32 rowEnd)
 	{
-		for (uint32 j = 0; j < n - 1; ++j)
-		{
-			meshData.Indices32[k] = i * n + j;
-			meshData.Indices32[k + 1] = i * n + j + 1;
-			meshData.Indices32[k + 2] = (i + 1) * n + j;
+		WriteGridRows(width, depth, m, n, rowBegin, rowEnd, vertices, indices);
+	});
+}
 
-			meshData.Indices32[k + 3] = (i + 1) * n + j;
-			meshData.Indices32[k + 4] = i * n + j + 1;
-			meshData.Indices32[k + 5] = (i + 1) * n + j + 1;
+GeometryGenerator::MeshData GeometryGenerator::CreateSphereParallel(float radius, uint32 sliceCount, uint32 stackCount, JobSystem* jobs)
+{
+	MeshData meshData;
 
-			k += 6; // next quad
-		}
-	}
+	MeshSize size = GetSphereSize(sliceCount, stackCount);
+	meshData.Vertices.resize(size.VertexCount);
+	meshData.Indices32.resize(size.IndexCount);
+	CreateSphereParallel(radius, sliceCount, stackCount, meshData.Vertices.data(), meshData.Indices32.data(), jobs);
 
 	return meshData;
 }
 
+void GeometryGenerator::CreateSphereParallel(float radius, uint32 sliceCount, uint32 stackCount, Vertex* vertices, uint32* indices, JobSystem* jobs)
+{
+	ParallelRows(stackCount, jobs, [=](uint32 rowBegin, uint32 rowEnd)
+	{
+		WriteSphereRows(radius, sliceCount, stackCount, rowBegin, rowEnd, vertices, indices);
+	});
+}
+
 GeometryGenerator::MeshData GeometryGenerator::CreateQuad(float x, float y, float w, float h, float depth)
 {
 	MeshData meshData;
@@ -487,64 +854,85 @@ GeometryGenerator::MeshData GeometryGenerator::CreateQuad(float x, float y, floa
 
 void GeometryGenerator::Subdivide(MeshData& meshData)
 {
-	// Save a copy of the input geometry.
-	MeshData inputCopy = meshData;
-
-
-	meshData.Vertices.resize(0);
-	meshData.Indices32.resize(0);
-
-	//       v1
-	//       *
-	//      / \
-	//     /   \
-	//  m0*-----*m1
-	//   / \   / \
-	//  /   \ /   \
-	// *-----*-----*
-	// v0    m2     v2
+	/*
+	       v1
+	       *
+	      / \
+	     /   \
+	  m0*-----*m1
+	   / \   / \
+	  /   \ /   \
+	 *-----*-----*
+	 v0    m2     v2
+	*/
+
+	// Take the input indices; the input vertices are kept in place since every
+	// one of them survives subdivision.
+	std::vector<uint32> inputIndices;
+	inputIndices.swap(meshData.Indices32);
+
+	uint32 numTris = (uint32)inputIndices.size() / 3;
+	uint32 baseVertexCount = (uint32)meshData.Vertices.size();
+
+	// Each triangle is split into four, so the index count grows by exactly 4x.
+	// A triangle has three edges, so there are at most 3 * numTris new vertices.
+	meshData.Indices32.reserve(numTris * 12);
+
+	EdgeMidpointMap midpoints(numTris * 3);
+	std::vector<uint32> edgeEnds;
+	edgeEnds.reserve(numTris * 6);
+
+	// Shared edges get exactly one midpoint vertex, keyed on the (min, max) index pair.
+	auto getMidpoint = [&](uint32 a, uint32 b)
+	{
+		uint32 newIndex = baseVertexCount + (uint32)edgeEnds.size() / 2;
+		uint32 index = midpoints.FindOrInsert(a, b, newIndex);
+		if (index == newIndex)
+		{
+			edgeEnds.push_back(a);
+			edgeEnds.push_back(b);
+		}
+		return index;
+	};
 
-	uint32 numTris = (uint32)inputCopy.Indices32.size() / 3;
 	for (uint32 i = 0; i < numTris; ++i)
 	{
-		Vertex v0 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 0]];
-		Vertex v1 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 1]];
-		Vertex v2 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 2]];
+		uint32 v0 = inputIndices[i * 3 + 0];
+		uint32 v1 = inputIndices[i * 3 + 1];
+		uint32 v2 = inputIndices[i * 3 + 2];
 
-		//
-		// Generate the midpoints.
-		//
+		uint32 m0 = getMidpoint(v0, v1);
+		uint32 m1 = getMidpoint(v1, v2);
+		uint32 m2 = getMidpoint(v0, v2);
 
-		Vertex m0 = MidPoint(v0, v1);
-		Vertex m1 = MidPoint(v1, v2);
-		Vertex m2 = MidPoint(v0, v2);
+		meshData.Indices32.push_back(v0);
+		meshData.Indices32.push_back(m0);
+		meshData.Indices32.push_back(m2);
 
-		//
-		// Add new geometry.
-		//
+		meshData.Indices32.push_back(m0);
+		meshData.Indices32.push_back(m1);
+		meshData.Indices32.push_back(m2);
 
-		meshData.Vertices.push_back(v0); // 0
-		meshData.Vertices.push_back(v1); // 1
-		meshData.Vertices.push_back(v2); // 2
-		meshData.Vertices.push_back(m0); // 3
-		meshData.Vertices.push_back(m1); // 4
-		meshData.Vertices.push_back(m2); // 5
+		meshData.Indices32.push_back(m2);
+		meshData.Indices32.push_back(m1);
+		meshData.Indices32.push_back(v2);
 
-		meshData.Indices32.push_back(i * 6 + 0);
-		meshData.Indices32.push_back(i * 6 + 3);
-		meshData.Indices32.push_back(i * 6 + 5);
-
-		meshData.Indices32.push_back(i * 6 + 3);
-		meshData.Indices32.push_back(i * 6 + 4);
-		meshData.Indices32.push_back(i * 6 + 5);
+		meshData.Indices32.push_back(m0);
+		meshData.Indices32.push_back(v1);
+		meshData.Indices32.push_back(m1);
+	}
 
-		meshData.Indices32.push_back(i * 6 + 5);
-		meshData.Indices32.push_back(i * 6 + 4);
-		meshData.Indices32.push_back(i * 6 + 2);
+	//
+	// Generate the midpoints now that the exact number of unique edges is known.
+	//
 
-		meshData.Indices32.push_back(i * 6 + 3);
-		meshData.Indices32.push_back(i * 6 + 1);
-		meshData.Indices32.push_back(i * 6 + 4);
+	uint32 numEdges = (uint32)edgeEnds.size() / 2;
+	meshData.Vertices.resize(baseVertexCount + numEdges);
+	for (uint32 i = 0; i < numEdges; ++i)
+	{
+		meshData.Vertices[baseVertexCount + i] = MidPoint(
+			meshData.Vertices[edgeEnds[i * 2 + 0]],
+			meshData.Vertices[edgeEnds[i * 2 + 1]]);
 	}
 }
 
@@ -577,76 +965,3 @@ GeometryGenerator::Vertex GeometryGenerator::MidPoint(const Vertex& v0, const Ve
 
 	return v;
 }
-
-void GeometryGenerator::BuildCylinderTopCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, MeshData& meshData)
-{
-	uint32 baseIndex = (uint32)meshData.Vertices.size();
-
-	float y = 0.5f * height;
-	float dTheta = 2.0f * XM_PI / sliceCount;
-
-	// Duplicate cap ring vertices because the texture coordinates and normals differ.
-	for (uint32 i = 0; i <= sliceCount; ++i)
-	{
-		float x = topRadius * cosf(i * dTheta);
-		float z = topRadius * sinf(i * dTheta);
-
-		// Scale down by the height to try and make top cap texture coord area
-		// proportional to base.
-		float u = x / height + 0.5f;
-		float v = z / height + 0.5f;
-
-		meshData.Vertices.push_back(Vertex(x, y, z, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, u, v));
-	}
-
-	// Cap center vertex.
-	meshData.Vertices.push_back(Vertex(0.0f, y, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 0.5f));
-
-	// Index of center vertex.
-	uint32 centerIndex = (uint32)meshData.Vertices.size() - 1;
-
-	for (uint32 i = 0; i < sliceCount; ++i)
-	{
-		meshData.Indices32.push_back(centerIndex);
-		meshData.Indices32.push_back(baseIndex + i + 1);
-		meshData.Indices32.push_back(baseIndex + i);
-	}
-}
-
-void GeometryGenerator::BuildCylinderBottomCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, MeshData& meshData)
-{
-	// 
-	// Build bottom cap.
-	//
-
-	uint32 baseIndex = (uint32)meshData.Vertices.size();
-	float y = -0.5f * height;
-
-	// vertices of ring
-	float dTheta = 2.0f * XM_PI / sliceCount;
-	for (uint32 i = 0; i <= sliceCount; ++i)
-	{
-		float x = bottomRadius * cosf(i * dTheta);
-		float z = bottomRadius * sinf(i * dTheta);
-
-		// Scale down by the height to try and make top cap texture coord area
-		// proportional to base.
-		float u = x / height + 0.5f;
-		float v = z / height + 0.5f;
-
-		meshData.Vertices.push_back(Vertex(x, y, z, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, u, v));
-	}
-
-	// Cap center vertex.
-	meshData.Vertices.push_back(Vertex(0.0f, y, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 0.5f));
-
-	// Cache the index of center vertex.
-	uint32 centerIndex = (uint32)meshData.Vertices.size() - 1;
-
-	for (uint32 i = 0; i < sliceCount; ++i)
-	{
-		meshData.Indices32.push_back(centerIndex);
-		meshData.Indices32.push_back(baseIndex + i);
-		meshData.Indices32.push_back(baseIndex + i + 1);
-	}
-}
@@ -1,5 +1,6 @@
 #pragma once
 #include "EngineHeader.h"
+#include "MathHelper.h"
 #include <cstdint>
 #include <DirectXMath.h>
 #include <vector>
@@ -8,6 +9,8 @@
 #define GEOMETRYGENERATOR_H
 namespace Engine
 {
+	class JobSystem;
+
 	class D3D_API GeometryGenerator
 	{
 	public:
@@ -42,18 +45,59 @@ namespace Engine
 			std::vector<Vertex> Vertices;
 			std::vector<uint32> Indices32;
 
-			std::vector<uint16>& GetIndices16()
+			/// <summary>
+			/// Indices32의 16비트 복사본. 호출할 때마다 새로 변환하므로 Indices32가 바뀌어도 어긋나지 않는다.
+			/// </summary>
+			/// <param name="overflow">65535를 넘는 인덱스가 있었는지 여부 (이때 결과는 사용할 수 없다)</param>
+			std::vector<uint16> GetIndices16(bool* overflow = nullptr) const
 			{
-				if (mIndices16.empty())
-				{
-					mIndices16.resize(Indices32.size());
-					for (size_t i = 0; i < Indices32.size(); ++i)
-						mIndices16[i] = static_cast<uint16>(Indices32[i]);
-				}
-				return mIndices16;
+				std::vector<uint16> indices16(Indices32.size());
+				bool fits = NarrowIndices(Indices32.data(), indices16.data(), Indices32.size());
+				if (overflow != nullptr)
+					*overflow = !fits;
+				return indices16;
+			}
+
+			/// <summary>
+			/// 모든 인덱스가 16비트 인덱스 버퍼(R16_UINT)에 들어가는지 여부
+			/// </summary>
+			bool FitsIn16BitIndices() const
+			{
+				return FitsIn16Bits(Indices32.data(), Indices32.size());
+			}
+
+			/// <summary>
+			/// 모든 정점 위치의 경계 상자와 경계 구
+			/// </summary>
+			void ComputeBounds(DirectX::BoundingBox& box, DirectX::BoundingSphere& sphere) const
+			{
+				MathHelper::ComputeBounds(
+					Vertices.empty() ? nullptr : &Vertices[0].Position,
+					Vertices.size(),
+					sizeof(Vertex),
+					box,
+					sphere);
 			}
-		private:
-			std::vector<uint16> mIndices16;
+		};
+
+		/// <summary>
+		/// 32비트 인덱스를 16비트로 변환 (SSE2/AVX2)
+		/// </summary>
+		/// <returns>모든 인덱스가 65535 이하이면 true. false이면 dst의 내용은 사용할 수 없다.</returns>
+		static bool NarrowIndices(const uint32* src, uint16* dst, size_t count);
+
+		/// <summary>
+		/// 모든 인덱스가 65535 이하인지 검사 (SSE2/AVX2)
+		/// </summary>
+		static bool FitsIn16Bits(const uint32* indices, size_t count);
+
+		/// <summary>
+		/// 생성될 정점/인덱스 개수
+		/// </summary>
+		struct MeshSize
+		{
+			uint32 VertexCount = 0;
+			uint32 IndexCount = 0;
 		};
 
 		MeshData CreateBox(float width, float height, float depth, uint32 numSubdivisions);
@@ -63,11 +107,35 @@ namespace Engine
 		MeshData CreateGrid(float width, float depth, uint32 m, uint32 n);
 		MeshData CreateQuad(float x, float y, float w, float h, float depth);
 
+		//
+		// 호출자가 준비한 메모리(매핑된 업로드 힙 등)에 중간 복사 없이 직접 생성하는 함수들.
+		// vertices/indices는 Get*Size가 반환하는 개수만큼의 공간이 있어야 한다.
+		//
+
+		static MeshSize GetSphereSize(uint32 sliceCount, uint32 stackCount);
+		static MeshSize GetCylinderSize(uint32 sliceCount, uint32 stackCount);
+		static MeshSize GetGridSize(uint32 m, uint32 n);
+
+		void CreateSphere(float radius, uint32 sliceCount, uint32 stackCount, Vertex* vertices, uint32* indices);
+		void CreateSphere(float radius, uint32 sliceCount, uint32 stackCount, Vertex* vertices, uint16* indices);
+		void CreateCylinder(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, Vertex* vertices, uint32* indices);
+		void CreateCylinder(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, Vertex* vertices, uint16* indices);
+		void CreateGrid(float width, float depth, uint32 m, uint32 n, Vertex* vertices, uint32* indices);
+		void CreateGrid(float width, float depth, uint32 m, uint32 n, Vertex* vertices, uint16* indices);
+
+		//
+		// 행(스택) 단위로 나누어 JobSystem의 작업으로 생성하는 함수들. 결과는 단일 스레드 버전과 비트 단위로 같다.
+		// jobs가 nullptr이거나 행 수가 적은 메쉬는 호출한 스레드에서 그대로 생성한다.
+		//
+
+		MeshData CreateGridParallel(float width, float depth, uint32 m, uint32 n, JobSystem* jobs = nullptr);
+		MeshData CreateSphereParallel(float radius, uint32 sliceCount, uint32 stackCount, JobSystem* jobs = nullptr);
+		void CreateGridParallel(float width, float depth, uint32 m, uint32 n, Vertex* vertices, uint32* indices, JobSystem* jobs = nullptr);
+		void CreateSphereParallel(float radius, uint32 sliceCount, uint32 stackCount, Vertex* vertices, uint32* indices, JobSystem* jobs = nullptr);
+
 	private:
 		void Subdivide(MeshData& meshData);
 		Vertex MidPoint(const Vertex& v0, const Vertex& v1);
-		void BuildCylinderTopCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, MeshData& meshData);
-		void BuildCylinderBottomCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, MeshData& meshData);
 	};
 }
 #endif
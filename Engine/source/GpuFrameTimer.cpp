@@ -0,0 +1,85 @@
+#include "GpuFrameTimer.h"
+
+namespace Engine
+{
+	GpuFrameTimer::GpuFrameTimer(ID3D12Device* device, ID3D12CommandQueue* queue, UINT frameCount)
+		: mSlots(frameCount)
+	{
+		assert(frameCount > 0);
+
+		D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+		queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+		queryHeapDesc.Count = frameCount * 2;
+		ThrowIfFailed(device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&mQueryHeap)));
+
+		ThrowIfFailed(device->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK),
+			D3D12_HEAP_FLAG_NONE,
+			&CD3DX12_RESOURCE_DESC::Buffer(queryHeapDesc.Count * sizeof(UINT64)),
+			D3D12_RESOURCE_STATE_COPY_DEST,
+			nullptr,
+			IID_PPV_ARGS(&mReadbackBuffer)));
+
+		// 리드백 힙도 매핑한 채로 두고, 펜스가 지난 슬롯만 읽는다.
+		ThrowIfFailed(mReadbackBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mTimestamps)));
+
+		UINT64 frequency = 0;
+		ThrowIfFailed(queue->GetTimestampFrequency(&frequency));
+		mMsPerTick = 1000.0 / (double)frequency;
+	}
+
+	GpuFrameTimer::~GpuFrameTimer()
+	{
+		if (mReadbackBuffer != nullptr)
+			mReadbackBuffer->Unmap(0, nullptr);
+		mTimestamps = nullptr;
+	}
+
+	void GpuFrameTimer::Begin(ID3D12GraphicsCommandList* cmdList)
+	{
+		cmdList->EndQuery(mQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, mCurrentSlot * 2);
+		mBegun = true;
+	}
+
+	void GpuFrameTimer::End(ID3D12GraphicsCommandList* cmdList)
+	{
+		UINT first = mCurrentSlot * 2;
+		cmdList->EndQuery(mQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, first + 1);
+		cmdList->ResolveQueryData(mQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, first, 2,
+			mReadbackBuffer.Get(), first * sizeof(UINT64));
+		mEnded = true;
+	}
+
+	void GpuFrameTimer::EndFrame(UINT64 fenceValue)
+	{
+		Slot& slot = mSlots[mCurrentSlot];
+		slot.Fence = fenceValue;
+		slot.Pending = mBegun && mEnded;
+
+		mBegun = false;
+		mEnded = false;
+		mCurrentSlot = (mCurrentSlot + 1) % (UINT)mSlots.size();
+	}
+
+	double GpuFrameTimer::Collect(UINT64 completedFence)
+	{
+		double frameMs = -1.0;
+		UINT64 latestFence = 0;
+		for (UINT i = 0; i < (UINT)mSlots.size(); ++i)
+		{
+			Slot& slot = mSlots[i];
+			if (!slot.Pending || slot.Fence > completedFence)
+				continue;
+
+			slot.Pending = false;
+			UINT64 begin = mTimestamps[i * 2];
+			UINT64 end = mTimestamps[i * 2 + 1];
+			if (slot.Fence >= latestFence && end >= begin)
+			{
+				latestFence = slot.Fence;
+				frameMs = (double)(end - begin) * mMsPerTick;
+			}
+		}
+		return frameMs;
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Util.h"
+#include <vector>
+
+#ifndef GPUFRAMETIMER_H
+#define GPUFRAMETIMER_H
+namespace Engine
+{
+	/// <summary>
+	/// 타임스탬프 쿼리로 프레임마다 GPU가 명령을 처리한 시간을 잰다.
+	/// 진행 중인 프레임 수만큼 슬롯을 두고, 결과는 계속 매핑해 둔 리드백 버퍼에서 펜스가 지난 뒤에 읽는다.
+	/// Begin과 End는 같은 프레임의 서로 다른 명령 목록(다른 스레드)에 기록해도 된다.
+	/// </summary>
+	class D3D_API GpuFrameTimer
+	{
+	public:
+		/// <param name="queue">측정할 명령 목록을 실행하는 큐 (타임스탬프 주기를 읽는다)</param>
+		/// <param name="frameCount">동시에 진행될 수 있는 최대 프레임 수</param>
+		GpuFrameTimer(ID3D12Device* device, ID3D12CommandQueue* queue, UINT frameCount);
+		GpuFrameTimer(const GpuFrameTimer& rhs) = delete;
+		GpuFrameTimer& operator=(const GpuFrameTimer& rhs) = delete;
+		~GpuFrameTimer();
+
+		/// <summary>
+		/// 이번 프레임의 첫 명령 목록 맨 앞에 기록
+		/// </summary>
+		void Begin(ID3D12GraphicsCommandList* cmdList);
+		/// <summary>
+		/// 이번 프레임의 마지막 명령 목록 맨 뒤에 기록
+		/// </summary>
+		void End(ID3D12GraphicsCommandList* cmdList);
+
+		/// <summary>
+		/// 이번 프레임을 fenceValue로 표시하고 다음 슬롯으로 넘어간다. Begin/End를 기록하지 않은 프레임은 측정하지 않는다.
+		/// 다음 슬롯의 이전 프레임은 끝나 있어야 한다. (frameCount보다 많이 앞서가지 않는다)
+		/// </summary>
+		void EndFrame(UINT64 fenceValue);
+
+		/// <summary>
+		/// completedFence까지 끝난 프레임 중 가장 최근 프레임의 GPU 시간(밀리초). 새로 끝난 프레임이 없으면 음수.
+		/// </summary>
+		double Collect(UINT64 completedFence);
+
+	private:
+		struct Slot
+		{
+			UINT64 Fence = 0;
+			bool Pending = false;
+		};
+
+		Microsoft::WRL::ComPtr<ID3D12QueryHeap> mQueryHeap;
+		Microsoft::WRL::ComPtr<ID3D12Resource> mReadbackBuffer;
+		UINT64* mTimestamps = nullptr;
+		double mMsPerTick = 0.0;
+
+		std::vector<Slot> mSlots;
+		UINT mCurrentSlot = 0;
+		// Begin과 End가 모두 기록되었는지 (작업 스레드에서 기록해도 EndFrame 전에 기록이 끝나 있어야 한다)
+		bool mBegun = false;
+		bool mEnded = false;
+	};
+}
+#endif
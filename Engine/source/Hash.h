@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#ifndef HASH_H
+#define HASH_H
+namespace Engine
+{
+	// 64비트 FNV-1a. 캐시 키와 자원 이름처럼 실행이 바뀌어도 같은 값이 나와야 하는 곳에 쓴다.
+	constexpr std::uint64_t Fnv1aOffsetBasis = 14695981039346656037ull;
+	constexpr std::uint64_t Fnv1aPrime = 1099511628211ull;
+
+	/// <summary>
+	/// hash에 바이트 하나를 이어서 해시
+	/// </summary>
+	constexpr std::uint64_t Fnv1aByte(std::uint64_t hash, std::uint8_t byte)
+	{
+		return (hash ^ byte) * Fnv1aPrime;
+	}
+
+	/// <summary>
+	/// 바이트 배열의 해시. seed에 이전 결과를 넘겨 여러 값을 이어서 해시할 수 있다.
+	/// </summary>
+	inline std::uint64_t Fnv1aBytes(const void* data, size_t byteSize, std::uint64_t seed = Fnv1aOffsetBasis)
+	{
+		const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+		std::uint64_t hash = seed;
+		for (size_t i = 0; i < byteSize; ++i)
+			hash = Fnv1aByte(hash, bytes[i]);
+		return hash;
+	}
+
+	/// <summary>
+	/// 종료 문자 앞까지의 해시. 문자열 상수에 쓰면 컴파일 시간에 계산된다.
+	/// </summary>
+	constexpr std::uint64_t Fnv1aString(const char* text, std::uint64_t seed = Fnv1aOffsetBasis)
+	{
+		std::uint64_t hash = seed;
+		while (*text != 0)
+			hash = Fnv1aByte(hash, (std::uint8_t)*text++);
+		return hash;
+	}
+}
+#endif
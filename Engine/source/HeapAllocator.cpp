@@ -0,0 +1,307 @@
+#include "HeapAllocator.h"
+#include <algorithm>
+#include <cassert>
+
+namespace Engine
+{
+	namespace
+	{
+		// assert에서만 쓰이므로 NDEBUG 빌드에서 사용되지 않는 함수 경고가 나지 않도록 inline으로 둔다.
+		inline bool IsPowerOfTwo(std::uint64_t value)
+		{
+			return value > 0 && (value & (value - 1)) == 0;
+		}
+
+		std::uint32_t Log2(std::uint64_t value)
+		{
+			std::uint32_t result = 0;
+			while ((1ull << result) < value)
+				++result;
+			return result;
+		}
+	}
+
+	BuddyHeapAllocator::BuddyHeapAllocator(HeapBlockBackend* backend, uint64 blockSize, uint64 minBlockSize)
+		: mBackend(backend), mBlockSize(blockSize), mMinBlockSize(minBlockSize)
+	{
+		assert(IsPowerOfTwo(blockSize) && IsPowerOfTwo(minBlockSize) && minBlockSize <= blockSize);
+		mOrderCount = Log2(blockSize / minBlockSize) + 1;
+	}
+
+	BuddyHeapAllocator::~BuddyHeapAllocator()
+	{
+		for (uint32 i = 0; i < (uint32)mBlocks.size(); ++i)
+		{
+			if (mBlocks[i].Created)
+				DestroyBlock(i);
+		}
+	}
+
+	BuddyHeapAllocator::uint32 BuddyHeapAllocator::Allocate(uint64 byteSize, uint64 alignment)
+	{
+		assert(byteSize > 0 && IsPowerOfTwo(alignment));
+
+		if (byteSize > mBlockSize || alignment > mBlockSize)
+		{
+			++mStats.FailedAllocations;
+			return InvalidAllocation;
+		}
+
+		uint32 order = GetOrder(byteSize, alignment);
+
+		// 이미 만들어진 블록에서 먼저 찾고, 없으면 빈 자리에 새 블록을 만든다.
+		uint32 blockIndex = 0;
+		uint64 offset = 0;
+		bool found = false;
+		for (; blockIndex < (uint32)mBlocks.size(); ++blockIndex)
+		{
+			if (mBlocks[blockIndex].Created && AllocateInBlock(blockIndex, order, offset))
+			{
+				found = true;
+				break;
+			}
+		}
+
+		if (!found)
+		{
+			blockIndex = 0;
+			while (blockIndex < (uint32)mBlocks.size() && mBlocks[blockIndex].Created)
+				++blockIndex;
+
+			if (!CreateBlock(blockIndex) || !AllocateInBlock(blockIndex, order, offset))
+			{
+				++mStats.FailedAllocations;
+				return InvalidAllocation;
+			}
+		}
+
+		uint32 id;
+		if (!mFreeAllocationIds.empty())
+		{
+			id = mFreeAllocationIds.back();
+			mFreeAllocationIds.pop_back();
+		}
+		else
+		{
+			id = (uint32)mAllocations.size();
+			mAllocations.emplace_back();
+		}
+
+		Allocation& allocation = mAllocations[id];
+		allocation.Location.Block = blockIndex;
+		allocation.Location.Offset = offset;
+		allocation.Location.Size = mMinBlockSize << order;
+		allocation.RequestedSize = byteSize;
+		allocation.Order = order;
+		allocation.Live = true;
+
+		++mStats.AllocationCount;
+		++mStats.TotalAllocations;
+		mStats.UsedBytes += allocation.Location.Size;
+		mStats.RequestedBytes += byteSize;
+		return id;
+	}
+
+	void BuddyHeapAllocator::Free(uint32 id)
+	{
+		assert(id < mAllocations.size() && mAllocations[id].Live);
+
+		Allocation& allocation = mAllocations[id];
+		FreeInBlock(allocation.Location.Block, allocation.Order, allocation.Location.Offset);
+
+		--mStats.AllocationCount;
+		++mStats.TotalFrees;
+		mStats.UsedBytes -= allocation.Location.Size;
+		mStats.RequestedBytes -= allocation.RequestedSize;
+
+		allocation.Live = false;
+		mFreeAllocationIds.push_back(id);
+
+		// 할당/해제가 반복될 때 블록을 계속 만들고 해제하지 않도록 빈 블록 하나는 남겨 둔다.
+		if (mBlocks[allocation.Location.Block].UsedBytes == 0)
+			ReleaseEmptyBlocks(1);
+	}
+
+	size_t BuddyHeapAllocator::Defragment(const MoveCallback& move, size_t maxMoves)
+	{
+		// 사용량이 적은 블록부터 비운다.
+		std::vector<uint32> blocks;
+		for (uint32 i = 0; i < (uint32)mBlocks.size(); ++i)
+		{
+			if (mBlocks[i].Created && mBlocks[i].UsedBytes > 0)
+				blocks.push_back(i);
+		}
+		std::stable_sort(blocks.begin(), blocks.end(),
+			[this](uint32 a, uint32 b) { return mBlocks[a].UsedBytes < mBlocks[b].UsedBytes; });
+
+		size_t moves = 0;
+		for (size_t s = 0; s < blocks.size() && moves < maxMoves; ++s)
+		{
+			uint32 source = blocks[s];
+
+			for (uint32 id = 0; id < (uint32)mAllocations.size() && moves < maxMoves; ++id)
+			{
+				Allocation& allocation = mAllocations[id];
+				if (!allocation.Live || allocation.Location.Block != source)
+					continue;
+
+				// 옮길 곳은 자신보다 사용량이 많은 블록에서만 찾고, 가장 많은 블록부터 채운다.
+				// 덜 찬 블록에 넣으면 그 블록을 비울 때 같은 할당을 다시 옮기게 된다.
+				for (size_t d = blocks.size() - 1; d > s; --d)
+				{
+					uint32 destination = blocks[d];
+					uint64 offset = 0;
+					if (!AllocateInBlock(destination, allocation.Order, offset))
+						continue;
+
+					HeapLocation to = allocation.Location;
+					to.Block = destination;
+					to.Offset = offset;
+
+					if (!move(id, allocation.Location, to))
+					{
+						FreeInBlock(destination, allocation.Order, offset);
+						break;
+					}
+
+					FreeInBlock(source, allocation.Order, allocation.Location.Offset);
+					allocation.Location = to;
+					++moves;
+					++mStats.Moves;
+					break;
+				}
+			}
+		}
+
+		ReleaseEmptyBlocks(1);
+		return moves;
+	}
+
+	void BuddyHeapAllocator::ReleaseEmptyBlocks()
+	{
+		ReleaseEmptyBlocks(0);
+	}
+
+	HeapAllocatorStats BuddyHeapAllocator::GetStats() const
+	{
+		HeapAllocatorStats stats = mStats;
+		stats.LargestFreeBytes = 0;
+		for (const Block& block : mBlocks)
+		{
+			if (!block.Created)
+				continue;
+
+			for (uint32 order = mOrderCount; order-- > 0;)
+			{
+				if (!block.FreeLists[order].empty())
+				{
+					stats.LargestFreeBytes = std::max(stats.LargestFreeBytes, mMinBlockSize << order);
+					break;
+				}
+			}
+		}
+		return stats;
+	}
+
+	bool BuddyHeapAllocator::CreateBlock(uint32 blockIndex)
+	{
+		if (blockIndex == mBlocks.size())
+			mBlocks.emplace_back();
+
+		if (!mBackend->CreateBlock(blockIndex, mBlockSize))
+			return false;
+
+		Block& block = mBlocks[blockIndex];
+		block.Created = true;
+		block.UsedBytes = 0;
+		block.FreeLists.assign(mOrderCount, std::set<uint64>());
+		block.FreeLists[mOrderCount - 1].insert(0);
+
+		++mStats.BlockCount;
+		++mStats.BlocksCreated;
+		mStats.ReservedBytes += mBlockSize;
+		return true;
+	}
+
+	void BuddyHeapAllocator::DestroyBlock(uint32 blockIndex)
+	{
+		Block& block = mBlocks[blockIndex];
+		assert(block.Created && block.UsedBytes == 0);
+
+		mBackend->DestroyBlock(blockIndex);
+		block.Created = false;
+		block.FreeLists.clear();
+
+		--mStats.BlockCount;
+		++mStats.BlocksDestroyed;
+		mStats.ReservedBytes -= mBlockSize;
+	}
+
+	bool BuddyHeapAllocator::AllocateInBlock(uint32 blockIndex, uint32 order, uint64& offset)
+	{
+		Block& block = mBlocks[blockIndex];
+
+		// 들어갈 수 있는 가장 작은 빈 버디 블록을 찾는다.
+		uint32 k = order;
+		while (k < mOrderCount && block.FreeLists[k].empty())
+			++k;
+		if (k == mOrderCount)
+			return false;
+
+		// 같은 크기 안에서는 가장 앞쪽을 사용해 뒤쪽의 큰 빈 구간을 남긴다.
+		offset = *block.FreeLists[k].begin();
+		block.FreeLists[k].erase(block.FreeLists[k].begin());
+
+		// 필요한 크기가 될 때까지 반으로 나누고 뒤쪽 절반을 빈 목록에 넣는다.
+		while (k > order)
+		{
+			--k;
+			block.FreeLists[k].insert(offset + (mMinBlockSize << k));
+		}
+
+		block.UsedBytes += mMinBlockSize << order;
+		return true;
+	}
+
+	void BuddyHeapAllocator::FreeInBlock(uint32 blockIndex, uint32 order, uint64 offset)
+	{
+		Block& block = mBlocks[blockIndex];
+		block.UsedBytes -= mMinBlockSize << order;
+
+		// 버디가 비어 있는 동안 계속 합친다.
+		while (order + 1 < mOrderCount)
+		{
+			uint64 buddy = offset ^ (mMinBlockSize << order);
+			auto it = block.FreeLists[order].find(buddy);
+			if (it == block.FreeLists[order].end())
+				break;
+
+			block.FreeLists[order].erase(it);
+			offset = std::min(offset, buddy);
+			++order;
+		}
+
+		block.FreeLists[order].insert(offset);
+	}
+
+	void BuddyHeapAllocator::ReleaseEmptyBlocks(size_t keepCount)
+	{
+		size_t emptyCount = 0;
+		for (uint32 i = 0; i < (uint32)mBlocks.size(); ++i)
+		{
+			if (!mBlocks[i].Created || mBlocks[i].UsedBytes > 0)
+				continue;
+
+			if (emptyCount < keepCount)
+				++emptyCount;
+			else
+				DestroyBlock(i);
+		}
+	}
+
+	BuddyHeapAllocator::uint32 BuddyHeapAllocator::GetOrder(uint64 byteSize, uint64 alignment) const
+	{
+		uint64 size = std::max(std::max(byteSize, alignment), mMinBlockSize);
+		return Log2(size) - Log2(mMinBlockSize);
+	}
+}
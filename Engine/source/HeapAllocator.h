@@ -0,0 +1,157 @@
+#pragma once
+#include "EngineHeader.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <vector>
+
+#ifndef HEAPALLOCATOR_H
+#define HEAPALLOCATOR_H
+namespace Engine
+{
+	/// <summary>
+	/// 힙 블록을 실제로 만들고 해제하는 쪽. D3D12에서는 ID3D12Heap을, 단독 검증에서는 가짜 힙을 사용한다.
+	/// </summary>
+	class HeapBlockBackend
+	{
+	public:
+		virtual ~HeapBlockBackend() = default;
+
+		/// <summary>
+		/// blockIndex 자리에 byteSize 크기의 힙 블록 생성
+		/// </summary>
+		/// <returns>실패하면 false (할당도 실패한다)</returns>
+		virtual bool CreateBlock(std::uint32_t blockIndex, std::uint64_t byteSize) = 0;
+		virtual void DestroyBlock(std::uint32_t blockIndex) = 0;
+	};
+
+	/// <summary>
+	/// 할당 위치 (블록 번호와 블록 안의 오프셋)
+	/// </summary>
+	struct HeapLocation
+	{
+		std::uint32_t Block = 0;
+		std::uint64_t Offset = 0;
+		std::uint64_t Size = 0; // 실제로 차지하는 버디 블록 크기
+	};
+
+	/// <summary>
+	/// 힙 할당기 통계. 점유율과 단편화는 GetStats를 호출한 시점의 값이다.
+	/// </summary>
+	struct HeapAllocatorStats
+	{
+		std::uint64_t BlockCount = 0;
+		std::uint64_t ReservedBytes = 0;    // 만들어진 블록 크기 합
+		std::uint64_t UsedBytes = 0;        // 할당된 버디 블록 크기 합
+		std::uint64_t RequestedBytes = 0;   // 요청된 크기 합
+		std::uint64_t LargestFreeBytes = 0; // 한 번에 할당할 수 있는 가장 큰 빈 구간
+		std::uint64_t AllocationCount = 0;  // 살아 있는 할당 수
+
+		std::uint64_t TotalAllocations = 0;
+		std::uint64_t TotalFrees = 0;
+		std::uint64_t FailedAllocations = 0;
+		std::uint64_t BlocksCreated = 0;
+		std::uint64_t BlocksDestroyed = 0;
+		std::uint64_t Moves = 0;            // Defragment로 옮겨진 할당 수
+
+		// 만들어진 블록 중 사용 중인 비율
+		double Occupancy() const { return ReservedBytes > 0 ? (double)UsedBytes / ReservedBytes : 0.0; }
+		// 2의 거듭제곱 올림과 정렬로 낭비된 비율
+		double InternalFragmentation() const { return UsedBytes > 0 ? 1.0 - (double)RequestedBytes / UsedBytes : 0.0; }
+		// 빈 공간 중 가장 큰 구간에 속하지 않는 비율
+		double ExternalFragmentation() const
+		{
+			std::uint64_t freeBytes = ReservedBytes - UsedBytes;
+			return freeBytes > 0 ? 1.0 - (double)LargestFreeBytes / freeBytes : 0.0;
+		}
+	};
+
+	/// <summary>
+	/// 고정 크기 힙 블록들을 버디 방식으로 나누어 주는 할당기. 오프셋만 관리하므로 플랫폼에 독립적이다.
+	/// 할당은 max(2의 거듭제곱으로 올린 크기, 정렬, 최소 블록 크기) 크기의 버디 블록을 차지하고,
+	/// 버디 블록은 자신의 크기로 정렬되므로 정렬 등급(4KB, 64KB, 4MB 등)이 자연스럽게 지켜진다.
+	/// 비어 있는 블록은 하나만 남기고 해제한다.
+	/// </summary>
+	class D3D_API BuddyHeapAllocator
+	{
+	public:
+		using uint32 = std::uint32_t;
+		using uint64 = std::uint64_t;
+
+		// 할당 실패를 나타내는 ID
+		static const uint32 InvalidAllocation = ~0u;
+
+		// Defragment가 할당을 옮길 때 호출. 데이터를 from에서 to로 옮겼으면 true, 옮길 수 없으면 false 반환.
+		using MoveCallback = std::function<bool(uint32 allocation, const HeapLocation& from, const HeapLocation& to)>;
+
+		/// <param name="backend">블록을 만들고 해제할 대상. 할당기보다 오래 살아 있어야 한다.</param>
+		/// <param name="blockSize">힙 블록 크기 (2의 거듭제곱)</param>
+		/// <param name="minBlockSize">가장 작은 버디 블록 크기 (2의 거듭제곱)</param>
+		BuddyHeapAllocator(HeapBlockBackend* backend, uint64 blockSize, uint64 minBlockSize);
+		BuddyHeapAllocator(const BuddyHeapAllocator& rhs) = delete;
+		BuddyHeapAllocator& operator=(const BuddyHeapAllocator& rhs) = delete;
+		~BuddyHeapAllocator();
+
+		/// <summary>
+		/// byteSize 바이트 할당. 필요하면 새 블록을 만든다.
+		/// </summary>
+		/// <param name="alignment">2의 거듭제곱</param>
+		/// <returns>블록 크기보다 크거나 블록을 만들 수 없으면 InvalidAllocation</returns>
+		uint32 Allocate(uint64 byteSize, uint64 alignment);
+		void Free(uint32 allocation);
+
+		const HeapLocation& GetLocation(uint32 allocation) const { return mAllocations[allocation].Location; }
+
+		/// <summary>
+		/// 사용량이 적은 블록의 할당을 더 많이 사용 중인 블록으로 옮겨 빈 블록을 만든다.
+		/// 실제 데이터 이동은 move가 담당하며, 옮긴 뒤 비게 된 블록은 해제된다.
+		/// </summary>
+		/// <returns>옮긴 할당 수</returns>
+		size_t Defragment(const MoveCallback& move, size_t maxMoves = SIZE_MAX);
+
+		/// <summary>
+		/// 비어 있는 블록을 모두 해제
+		/// </summary>
+		void ReleaseEmptyBlocks();
+
+		uint64 GetBlockSize() const { return mBlockSize; }
+		HeapAllocatorStats GetStats() const;
+
+	private:
+		struct Block
+		{
+			bool Created = false;
+			uint64 UsedBytes = 0;
+			// 차수별 빈 버디 블록의 오프셋 (0번은 최소 블록 크기)
+			std::vector<std::set<uint64>> FreeLists;
+		};
+
+		struct Allocation
+		{
+			HeapLocation Location;
+			uint64 RequestedSize = 0;
+			uint32 Order = 0;
+			bool Live = false;
+		};
+
+		bool CreateBlock(uint32 blockIndex);
+		void DestroyBlock(uint32 blockIndex);
+		bool AllocateInBlock(uint32 blockIndex, uint32 order, uint64& offset);
+		void FreeInBlock(uint32 blockIndex, uint32 order, uint64 offset);
+		void ReleaseEmptyBlocks(size_t keepCount);
+		uint32 GetOrder(uint64 byteSize, uint64 alignment) const;
+
+		HeapBlockBackend* mBackend = nullptr;
+		uint64 mBlockSize = 0;
+		uint64 mMinBlockSize = 0;
+		uint32 mOrderCount = 0;
+
+		std::vector<Block> mBlocks;
+		std::vector<Allocation> mAllocations;
+		std::vector<uint32> mFreeAllocationIds;
+
+		HeapAllocatorStats mStats;
+	};
+}
+#endif
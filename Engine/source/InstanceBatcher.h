@@ -0,0 +1,139 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#ifndef INSTANCEBATCHER_H
+#define INSTANCEBATCHER_H
+namespace Engine
+{
+	/// <summary>
+	/// 같은 키(지오메트리, 서브메쉬, PSO, 토폴로지 등)를 가진 그리기를 묶어 인스턴스 그리기 한 번으로 만든다.
+	/// Add로 (키, 인스턴스 id)를 넣고 Build하면, 묶음마다 인스턴스 id가 연속으로 모인 배열과
+	/// 묶음 목록(배열 안의 시작 위치와 개수)이 만들어진다. 인스턴스 버퍼에는 이 배열을 그대로 복사하면 된다.
+	///
+	/// 묶음은 키가 처음 추가된 순서를 따르고, 묶음 안의 인스턴스는 추가된 순서를 유지한다.
+	/// 해시 테이블과 배열은 프레임 사이에 재사용되므로 개수가 안정되면 할당이 없다.
+	/// TKey는 복사 가능하고 operator==를 지원해야 한다.
+	/// </summary>
+	template<typename TKey, typename THash = std::hash<TKey>>
+	class InstanceBatcher
+	{
+	public:
+		struct Batch
+		{
+			TKey Key;
+			std::uint32_t FirstInstance = 0;   // GetInstances() 안의 시작 위치
+			std::uint32_t InstanceCount = 0;
+		};
+
+		/// <summary>
+		/// 이전 프레임의 묶음을 비운다.
+		/// </summary>
+		void Reset()
+		{
+			mBatches.clear();
+			mItemBatches.clear();
+			mItemIds.clear();
+			mInstances.clear();
+			std::fill(mTable.begin(), mTable.end(), EmptySlot);
+		}
+
+		/// <summary>
+		/// key로 그릴 인스턴스 하나를 추가
+		/// </summary>
+		/// <returns>인스턴스가 들어간 묶음 번호</returns>
+		std::uint32_t Add(const TKey& key, std::uint32_t instanceId)
+		{
+			std::uint32_t batch = FindOrAddBatch(key);
+			++mBatches[batch].InstanceCount;
+			mItemBatches.push_back(batch);
+			mItemIds.push_back(instanceId);
+			return batch;
+		}
+
+		/// <summary>
+		/// 묶음마다 시작 위치를 정하고 인스턴스 id를 묶음 순서대로 모은다. (계수 정렬)
+		/// </summary>
+		void Build()
+		{
+			std::uint32_t offset = 0;
+			mCursors.resize(mBatches.size());
+			for (size_t i = 0; i < mBatches.size(); ++i)
+			{
+				mBatches[i].FirstInstance = offset;
+				mCursors[i] = offset;
+				offset += mBatches[i].InstanceCount;
+			}
+
+			mInstances.resize(offset);
+			for (size_t i = 0; i < mItemIds.size(); ++i)
+				mInstances[mCursors[mItemBatches[i]]++] = mItemIds[i];
+		}
+
+		const std::vector<Batch>& GetBatches() const { return mBatches; }
+		/// <summary>
+		/// Build 이후 묶음 순서로 모은 인스턴스 id
+		/// </summary>
+		const std::vector<std::uint32_t>& GetInstances() const { return mInstances; }
+
+	private:
+		// 비어 있는 테이블 칸
+		enum : std::uint32_t { EmptySlot = 0xFFFFFFFF };
+
+		std::uint32_t FindOrAddBatch(const TKey& key)
+		{
+			// 채움률을 1/2 이하로 유지
+			if ((mBatches.size() + 1) * 2 > mTable.size())
+				Rehash(mTable.empty() ? 64 : mTable.size() * 2);
+
+			size_t mask = mTable.size() - 1;
+			size_t slot = mHash(key) & mask;
+			for (;;)
+			{
+				std::uint32_t batch = mTable[slot];
+				if (batch == EmptySlot)
+				{
+					batch = (std::uint32_t)mBatches.size();
+					mTable[slot] = batch;
+					Batch newBatch;
+					newBatch.Key = key;
+					mBatches.push_back(newBatch);
+					return batch;
+				}
+				if (mBatches[batch].Key == key)
+					return batch;
+				slot = (slot + 1) & mask;
+			}
+		}
+
+		void Rehash(size_t capacity)
+		{
+			mTable.assign(capacity, EmptySlot);
+			size_t mask = capacity - 1;
+			for (std::uint32_t batch = 0; batch < (std::uint32_t)mBatches.size(); ++batch)
+			{
+				size_t slot = mHash(mBatches[batch].Key) & mask;
+				while (mTable[slot] != EmptySlot)
+					slot = (slot + 1) & mask;
+				mTable[slot] = batch;
+			}
+		}
+
+		THash mHash;
+
+		// 키 -> 묶음 번호 (선형 탐사, 크기는 2의 거듭제곱)
+		std::vector<std::uint32_t> mTable;
+		std::vector<Batch> mBatches;
+
+		// 추가된 순서대로의 (묶음, 인스턴스 id)
+		std::vector<std::uint32_t> mItemBatches;
+		std::vector<std::uint32_t> mItemIds;
+
+		std::vector<std::uint32_t> mCursors;
+		std::vector<std::uint32_t> mInstances;
+	};
+}
+#endif
@@ -0,0 +1,345 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <exception>
+
+namespace Engine
+{
+	struct Job
+	{
+		std::function<void()> Function;
+		JobCounter* Counter;
+	};
+
+	struct JobSystem::WorkerQueue
+	{
+		WorkStealingDeque<Job> Deque;
+
+		// 이 덱의 소유 스레드만 증가시킨다.
+		std::atomic<std::uint64_t> Executed{ 0 };
+		std::atomic<std::uint64_t> Stolen{ 0 };
+		std::atomic<std::uint64_t> Inlined{ 0 };
+
+		// 훔칠 덱을 고르는 xorshift 상태
+		std::uint32_t RandomState = 0;
+	};
+
+	namespace
+	{
+		// 현재 스레드가 속한 작업 시스템과 덱 번호
+		thread_local const JobSystem* tJobSystem = nullptr;
+		thread_local int tQueueIndex = -1;
+
+		// 잠들기 전에 작업을 다시 찾아보는 횟수
+		const unsigned IdleSpinCount = 64;
+	}
+
+	JobSystem::JobSystem(unsigned workerCount)
+	{
+		if (workerCount == 0)
+		{
+			unsigned hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		// 0번 덱은 생성한 스레드가 사용한다.
+		for (unsigned i = 0; i < workerCount + 1; ++i)
+		{
+			mQueues.push_back(std::make_unique<WorkerQueue>());
+			mQueues.back()->RandomState = 0x9E3779B9u * (i + 1);
+		}
+
+		tJobSystem = this;
+		tQueueIndex = 0;
+
+		mThreads.reserve(workerCount);
+		for (unsigned i = 0; i < workerCount; ++i)
+			mThreads.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+	}
+
+	JobSystem::~JobSystem()
+	{
+		mQuit.store(true);
+		{
+			std::lock_guard<std::mutex> lock(mSleepMutex);
+			mWakeCondition.notify_all();
+		}
+
+		for (std::thread& thread : mThreads)
+			thread.join();
+
+		// 작업 스레드가 없거나 끝난 뒤에 남은 작업은 여기서 실행
+		bool stolen;
+		while (Job* job = FindJob(0, stolen))
+			Execute(job, stolen);
+
+		if (tJobSystem == this)
+		{
+			tJobSystem = nullptr;
+			tQueueIndex = -1;
+		}
+	}
+
+	void JobSystem::Run(std::function<void()> job, JobCounter* counter)
+	{
+		if (counter != nullptr)
+			counter->mPending.fetch_add(1, std::memory_order_relaxed);
+
+		Schedule(new Job{ std::move(job), counter });
+	}
+
+	void JobSystem::RunAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter)
+	{
+		if (counter != nullptr)
+			counter->mPending.fetch_add(1, std::memory_order_relaxed);
+
+		Job* continuation = new Job{ std::move(job), counter };
+		{
+			// Finish가 마지막 감소와 연속 작업 수거를 같은 잠금 안에서 하므로 놓치는 작업이 없다.
+			std::lock_guard<std::mutex> lock(dependency.mMutex);
+			if (dependency.mPending.load(std::memory_order_acquire) != 0)
+			{
+				dependency.mContinuations.push_back(continuation);
+				return;
+			}
+		}
+		Schedule(continuation);
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		int queueIndex = GetQueueIndex();
+		while (!counter.IsDone())
+		{
+			bool stolen;
+			if (Job* job = FindJob(queueIndex, stolen))
+				Execute(job, stolen);
+			else
+				std::this_thread::yield();
+		}
+
+		// 마지막 Finish가 카운터의 잠금을 놓을 때까지 기다린 뒤에야 호출자가 카운터를 해제할 수 있다.
+		std::lock_guard<std::mutex> lock(counter.mMutex);
+	}
+
+	void JobSystem::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& body)
+	{
+		if (count == 0)
+			return;
+
+		grainSize = std::max<size_t>(grainSize, 1);
+		size_t chunkCount = (count + grainSize - 1) / grainSize;
+		if (chunkCount == 1 || mThreads.empty())
+		{
+			body(0, count);
+			return;
+		}
+
+		JobCounter counter;
+		std::mutex exceptionMutex;
+		std::exception_ptr exception;
+		auto runChunk = [&](size_t chunk)
+		{
+			size_t begin = chunk * grainSize;
+			size_t end = std::min(count, begin + grainSize);
+			try
+			{
+				body(begin, end);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(exceptionMutex);
+				if (!exception)
+					exception = std::current_exception();
+			}
+		};
+
+		// 나머지 구간을 예약하고 첫 구간은 호출 스레드가 직접 실행한다.
+		for (size_t chunk = 1; chunk < chunkCount; ++chunk)
+			Run([&runChunk, chunk]() { runChunk(chunk); }, &counter);
+
+		runChunk(0);
+		Wait(counter);
+
+		if (exception)
+			std::rethrow_exception(exception);
+	}
+
+	JobSystemStats JobSystem::GetStats() const
+	{
+		JobSystemStats stats;
+		for (const std::unique_ptr<WorkerQueue>& queue : mQueues)
+		{
+			stats.Executed += queue->Executed.load(std::memory_order_relaxed);
+			stats.Stolen += queue->Stolen.load(std::memory_order_relaxed);
+			stats.Inlined += queue->Inlined.load(std::memory_order_relaxed);
+		}
+		return stats;
+	}
+
+	void JobSystem::WorkerMain(unsigned queueIndex)
+	{
+		tJobSystem = this;
+		tQueueIndex = (int)queueIndex;
+
+		unsigned idleSpins = 0;
+		for (;;)
+		{
+			// 작업을 찾기 전에 세대를 읽어 두면, 찾은 뒤에 들어온 작업은 세대 변화로 알 수 있다.
+			std::uint64_t generation = mWorkGeneration.load();
+
+			bool stolen;
+			if (Job* job = FindJob((int)queueIndex, stolen))
+			{
+				Execute(job, stolen);
+				idleSpins = 0;
+				continue;
+			}
+
+			if (mQuit.load())
+				break;
+
+			if (++idleSpins < IdleSpinCount)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(mSleepMutex);
+			mSleepingWorkers.fetch_add(1);
+			mWakeCondition.wait(lock, [&]() { return mQuit.load() || mWorkGeneration.load() != generation; });
+			mSleepingWorkers.fetch_sub(1);
+			idleSpins = 0;
+		}
+	}
+
+	void JobSystem::Schedule(Job* job)
+	{
+		int queueIndex = GetQueueIndex();
+		if (queueIndex >= 0)
+		{
+			WorkerQueue& queue = *mQueues[queueIndex];
+			if (!queue.Deque.Push(job))
+			{
+				// 덱이 가득 차면 바로 실행
+				queue.Inlined.fetch_add(1, std::memory_order_relaxed);
+				Execute(job, false);
+				return;
+			}
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(mSharedMutex);
+			mSharedJobs.push_back(job);
+			mSharedJobCount.fetch_add(1);
+		}
+
+		WakeWorkers();
+	}
+
+	Job* JobSystem::FindJob(int queueIndex, bool& stolen)
+	{
+		stolen = false;
+
+		int ownIndex = queueIndex;
+		if (ownIndex >= 0 && ownIndex < (int)mQueues.size())
+		{
+			if (Job* job = mQueues[ownIndex]->Deque.Pop())
+				return job;
+		}
+
+		if (mSharedJobCount.load() > 0)
+		{
+			std::lock_guard<std::mutex> lock(mSharedMutex);
+			if (!mSharedJobs.empty())
+			{
+				Job* job = mSharedJobs.back();
+				mSharedJobs.pop_back();
+				mSharedJobCount.fetch_sub(1);
+				return job;
+			}
+		}
+
+		// 임의의 덱부터 한 바퀴 돌며 훔친다.
+		unsigned queueCount = (unsigned)mQueues.size();
+		unsigned start = 0;
+		if (ownIndex >= 0 && ownIndex < (int)queueCount)
+		{
+			std::uint32_t& state = mQueues[ownIndex]->RandomState;
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			start = state % queueCount;
+		}
+
+		for (unsigned i = 0; i < queueCount; ++i)
+		{
+			unsigned victim = (start + i) % queueCount;
+			if ((int)victim == ownIndex)
+				continue;
+
+			if (Job* job = mQueues[victim]->Deque.Steal())
+			{
+				stolen = true;
+				return job;
+			}
+		}
+		return nullptr;
+	}
+
+	void JobSystem::Execute(Job* job, bool stolen)
+	{
+		job->Function();
+
+		int queueIndex = GetQueueIndex();
+		if (queueIndex >= 0)
+		{
+			WorkerQueue& queue = *mQueues[queueIndex];
+			queue.Executed.fetch_add(1, std::memory_order_relaxed);
+			if (stolen)
+				queue.Stolen.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Finish(job->Counter);
+		delete job;
+	}
+
+	void JobSystem::Finish(JobCounter* counter)
+	{
+		if (counter == nullptr)
+			return;
+
+		// 0이 되지 않는 감소는 잠금 없이 처리한다.
+		std::int32_t pending = counter->mPending.load(std::memory_order_relaxed);
+		while (pending > 1)
+		{
+			if (counter->mPending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+				return;
+		}
+
+		std::vector<Job*> continuations;
+		{
+			std::lock_guard<std::mutex> lock(counter->mMutex);
+			if (counter->mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				continuations.swap(counter->mContinuations);
+		}
+		// 잠금을 놓은 뒤에는 카운터가 해제되었을 수 있으므로 접근하지 않는다.
+
+		for (Job* continuation : continuations)
+			Schedule(continuation);
+	}
+
+	int JobSystem::GetQueueIndex() const
+	{
+		return tJobSystem == this ? tQueueIndex : -1;
+	}
+
+	void JobSystem::WakeWorkers()
+	{
+		mWorkGeneration.fetch_add(1);
+		if (mSleepingWorkers.load() > 0)
+		{
+			std::lock_guard<std::mutex> lock(mSleepMutex);
+			mWakeCondition.notify_one();
+		}
+	}
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include "EngineHeader.h"
+#include "WorkStealingDeque.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+namespace Engine
+{
+	class JobSystem;
+	struct Job;
+
+	/// <summary>
+	/// 작업 묶음의 남은 개수. JobSystem::Run에 넘긴 작업이 모두 끝나면 0이 된다.
+	/// Wait로 기다리거나 RunAfter의 선행 조건으로 사용한다. 기다리는 동안 옮기거나 해제하면 안 된다.
+	/// </summary>
+	class D3D_API JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter& rhs) = delete;
+		JobCounter& operator=(const JobCounter& rhs) = delete;
+
+		bool IsDone() const { return mPending.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<std::int32_t> mPending{ 0 };
+
+		// 이 카운터가 0이 되면 예약될 작업들
+		std::mutex mMutex;
+		std::vector<Job*> mContinuations;
+	};
+
+	/// <summary>
+	/// 작업 시스템 통계
+	/// </summary>
+	struct JobSystemStats
+	{
+		std::uint64_t Executed = 0;   // 실행된 작업 수
+		std::uint64_t Stolen = 0;     // 다른 스레드의 덱에서 훔쳐 실행한 작업 수
+		std::uint64_t Inlined = 0;    // 덱이 가득 차서 바로 실행한 작업 수
+	};
+
+	/// <summary>
+	/// 작업 훔치기(work-stealing) 스케줄러.
+	/// 생성한 스레드(메인 스레드)와 작업 스레드마다 Chase-Lev 덱을 두고, 자기 덱에서 최근 작업을 꺼내다가
+	/// 비면 다른 스레드의 덱에서 오래된 작업을 훔친다. 그 외의 스레드에서 넣은 작업은 공유 큐를 거친다.
+	///
+	/// Wait는 카운터가 0이 될 때까지 다른 작업을 대신 실행하므로 작업 안에서 다시 작업을 만들고 기다려도 된다.
+	/// 작업은 예외를 던지면 안 된다 (ParallelFor의 본문은 예외를 호출자에게 다시 던진다).
+	/// </summary>
+	class D3D_API JobSystem
+	{
+	public:
+		/// <param name="workerCount">생성한 스레드 외에 만들 작업 스레드 수 (0이면 하드웨어 스레드 수 - 1)</param>
+		explicit JobSystem(unsigned workerCount = 0);
+		JobSystem(const JobSystem& rhs) = delete;
+		JobSystem& operator=(const JobSystem& rhs) = delete;
+		/// <summary>
+		/// 남은 작업을 모두 실행한 뒤 작업 스레드를 종료
+		/// </summary>
+		~JobSystem();
+
+		/// <summary>
+		/// job을 예약. counter가 있으면 job이 끝날 때 1 감소한다.
+		/// </summary>
+		void Run(std::function<void()> job, JobCounter* counter = nullptr);
+
+		/// <summary>
+		/// dependency가 0이 된 뒤에 job을 예약. counter는 지금 증가하므로 바로 기다려도 된다.
+		/// </summary>
+		void RunAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter = nullptr);
+
+		/// <summary>
+		/// counter가 0이 될 때까지 다른 작업을 실행하며 대기
+		/// </summary>
+		void Wait(JobCounter& counter);
+
+		/// <summary>
+		/// [0, count)를 grainSize 크기의 구간으로 나누어 body(begin, end)를 병렬로 실행하고 끝날 때까지 기다린다.
+		/// body가 던진 첫 번째 예외는 모든 구간이 끝난 뒤 호출자에게 다시 던진다.
+		/// </summary>
+		void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& body);
+
+		// 생성한 스레드를 포함한 실행 스레드 수
+		unsigned GetThreadCount() const { return (unsigned)mQueues.size(); }
+
+		JobSystemStats GetStats() const;
+
+	private:
+		struct WorkerQueue;
+
+		void WorkerMain(unsigned queueIndex);
+		void Schedule(Job* job);
+		// queueIndex의 덱, 공유 큐, 다른 덱 순서로 작업을 찾는다. 훔친 작업이면 stolen이 true.
+		Job* FindJob(int queueIndex, bool& stolen);
+		void Execute(Job* job, bool stolen);
+		void Finish(JobCounter* counter);
+		// 이 스레드가 사용하는 덱 번호 (이 작업 시스템의 스레드가 아니면 -1)
+		int GetQueueIndex() const;
+		void WakeWorkers();
+
+		std::vector<std::unique_ptr<WorkerQueue>> mQueues;
+		std::vector<std::thread> mThreads;
+
+		// 작업 시스템 밖의 스레드가 넣은 작업
+		std::mutex mSharedMutex;
+		std::vector<Job*> mSharedJobs;
+		std::atomic<size_t> mSharedJobCount{ 0 };
+
+		// 잠든 작업 스레드를 깨우기 위한 상태
+		std::mutex mSleepMutex;
+		std::condition_variable mWakeCondition;
+		std::atomic<std::uint64_t> mWorkGeneration{ 0 };
+		std::atomic<unsigned> mSleepingWorkers{ 0 };
+		std::atomic<bool> mQuit{ false };
+	};
+}
+#endif
@@ -1,6 +1,7 @@
 #include "MathHelper.h"
 #include <float.h>
 #include <cmath>
+#include <cstdint>
 
 namespace Engine
 {
@@ -10,7 +11,7 @@ namespace Engine
 	const float MathHelper::Pi = 3.1415926535f;
 
 	/// <summary>
-	/// x, y ǥ [0, 2 * PI]  ǥ  ȯ
+	/// x, y 좌표를 [0, 2 * PI] 범위의 극좌표계의 각도로 변환
 	/// </summary>
 	/// <param name="x"></param>
 	/// <param name="y"></param>
@@ -19,20 +20,20 @@ namespace Engine
 	{
 		float theta = 0.0f;
 
-		// 1и Ǵ 4и
+		// 1사분면 또는 4사분면
 		if (x >= 0.0f)
 		{
 
-			//  x 0϶,
-			// y ̸, atanf(y/x) = Pi/2 (90)
-			// ̸, atanf(y/x) = -Pi/2 (270)̹Ƿ
+			// 만약 x가 0일때,
+			// y가 양수이면, atanf(y/x) = Pi/2 (90도)
+			// 음수이면, atanf(y/x) = -Pi/2 (270도)이므로
 			theta = atan2f(y, x);
 			if(theta < 0.0f)
-				theta += 2.0f * Pi; //  , 360(=2*Pi) ش.
+				theta += 2.0f * Pi; // 음수일 경우, 360도(=2*Pi)를 더해준다.
 		}
-		else // 2и Ǵ 3и
+		else // 2사분면 또는 3사분면
 		{
-			theta = atan2f(y, x) + Pi; // atan2f -Pi ~ Pi   ȯϹǷ, 180(=Pi) ش.
+			theta = atan2f(y, x) + Pi; // atan2f는 -Pi ~ Pi 범위의 값을 반환하므로, 180도(=Pi)를 더해준다.
 		}
 
 		return theta;
@@ -42,7 +43,7 @@ namespace Engine
 	{
 		XMVECTOR One = XMVectorSet(1.0f, 1.0f, 1.0f, 1.0f);
 
-		// ݱ     ݺ
+		// 반구 내의 지점을 얻을 때까지 반복
 		while (true)
 		{
 			XMVECTOR v = XMVectorSet(
@@ -50,8 +51,8 @@ namespace Engine
 				MathHelper::RandF(-1.0f, 1.0f),
 				MathHelper::RandF(-1.0f, 1.0f),
 				0.0f);
-			//   ܺο ִ Ȯ
-			if (XMVector3Greater(XMVector3LengthSq(v), One));
+			// 단위 구 외부에 있는지 확인
+			if (XMVector3Greater(XMVector3LengthSq(v), One))
 				continue;
 
 			return XMVector3Normalize(v);
@@ -63,7 +64,7 @@ namespace Engine
 		XMVECTOR One = XMVectorSet(1.0f, 1.0f, 1.0f, 1.0f);
 		XMVECTOR Zero = XMVectorZero();
 
-		// ݱ     ݺ
+		// 반구 내의 지점을 얻을 때까지 반복
 		while (true)
 		{
 			XMVECTOR v = XMVectorSet(
@@ -71,15 +72,92 @@ namespace Engine
 				MathHelper::RandF(-1.0f, 1.0f),
 				MathHelper::RandF(-1.0f, 1.0f),
 				0.0f);
-			//   ܺο ִ Ȯ
-			if (XMVector3Greater(XMVector3LengthSq(v), One));
+			// 단위 구 외부에 있는지 확인
+			if (XMVector3Greater(XMVector3LengthSq(v), One))
 				continue;
 
-			//  Ϳ ٸ ݱ ִ Ȯ
-			if (XMVector3Less(XMVector3Dot(n, v), Zero));
+			// 법선 벡터와 다른 반구에 있는지 확인
+			if (XMVector3Less(XMVector3Dot(n, v), Zero))
 				continue;
 
 			return XMVector3Normalize(v);
 		}
 	}
+
+	void MathHelper::ComputeBounds(
+		const void* positions,
+		size_t count,
+		size_t stride,
+		BoundingBox& box,
+		BoundingSphere& sphere)
+	{
+		if (count == 0)
+		{
+			box = BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+			sphere = BoundingSphere(XMFLOAT3(0.0f, 0.0f, 0.0f), 0.0f);
+			return;
+		}
+
+		const std::uint8_t* bytes = static_cast<const std::uint8_t*>(positions);
+		auto load = [bytes, stride](size_t i)
+		{
+			return XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(bytes + i * stride));
+		};
+
+		// 누산기를 4개로 나누어 min/max 사이의 의존성을 끊는다.
+		XMVECTOR min0 = load(0);
+		XMVECTOR max0 = min0;
+		XMVECTOR min1 = min0, max1 = min0;
+		XMVECTOR min2 = min0, max2 = min0;
+		XMVECTOR min3 = min0, max3 = min0;
+
+		size_t i = 1;
+		for (; i + 4 <= count; i += 4)
+		{
+			XMVECTOR p0 = load(i);
+			XMVECTOR p1 = load(i + 1);
+			XMVECTOR p2 = load(i + 2);
+			XMVECTOR p3 = load(i + 3);
+			min0 = XMVectorMin(min0, p0);
+			max0 = XMVectorMax(max0, p0);
+			min1 = XMVectorMin(min1, p1);
+			max1 = XMVectorMax(max1, p1);
+			min2 = XMVectorMin(min2, p2);
+			max2 = XMVectorMax(max2, p2);
+			min3 = XMVectorMin(min3, p3);
+			max3 = XMVectorMax(max3, p3);
+		}
+		for (; i < count; ++i)
+		{
+			XMVECTOR p = load(i);
+			min0 = XMVectorMin(min0, p);
+			max0 = XMVectorMax(max0, p);
+		}
+
+		XMVECTOR vMin = XMVectorMin(XMVectorMin(min0, min1), XMVectorMin(min2, min3));
+		XMVECTOR vMax = XMVectorMax(XMVectorMax(max0, max1), XMVectorMax(max2, max3));
+		BoundingBox::CreateFromPoints(box, vMin, vMax);
+
+		// 경계 상자 중심에서 가장 먼 위치까지의 거리 제곱
+		XMVECTOR center = XMLoadFloat3(&box.Center);
+		XMVECTOR dist0 = XMVectorZero();
+		XMVECTOR dist1 = XMVectorZero();
+		XMVECTOR dist2 = XMVectorZero();
+		XMVECTOR dist3 = XMVectorZero();
+
+		i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			dist0 = XMVectorMax(dist0, XMVector3LengthSq(load(i) - center));
+			dist1 = XMVectorMax(dist1, XMVector3LengthSq(load(i + 1) - center));
+			dist2 = XMVectorMax(dist2, XMVector3LengthSq(load(i + 2) - center));
+			dist3 = XMVectorMax(dist3, XMVector3LengthSq(load(i + 3) - center));
+		}
+		for (; i < count; ++i)
+			dist0 = XMVectorMax(dist0, XMVector3LengthSq(load(i) - center));
+
+		XMVECTOR maxDist = XMVectorMax(XMVectorMax(dist0, dist1), XMVectorMax(dist2, dist3));
+		sphere.Center = box.Center;
+		sphere.Radius = XMVectorGetX(XMVectorSqrt(maxDist));
+	}
 }
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 #include "EngineHeader.h"
+#if defined(_WIN32)
 #include <Windows.h>
+#endif
 #include <DirectXMath.h>
+#include <DirectXCollision.h>
 #include <cstdint>
+#include <cstdlib>
 
 namespace Engine
 {
@@ -10,7 +14,7 @@ namespace Engine
 	{
 	public:
 		/// <summary>
-		/// 0.0f ~ 1.0f   Ǽ ȯ
+		/// 0.0f ~ 1.0f 사이의 랜덤 실수 반환
 		/// </summary>
 		/// <returns></returns>
 		inline static float RandF()
@@ -19,7 +23,7 @@ namespace Engine
 		}
 
 		/// <summary>
-		/// [a, b)   Ǽ ȯ
+		/// [a, b) 사이의 랜덤 실수 반환
 		/// </summary>
 		inline static float RandF(float a, float b)
 		{
@@ -27,7 +31,7 @@ namespace Engine
 		}
 
 		/// <summary>
-		/// [a, b]    ȯ
+		/// [a, b] 사이의 랜덤 정수 반환
 		/// </summary>
 		inline int Rand(int a, int b)
 		{
@@ -47,7 +51,7 @@ namespace Engine
 		}
 
 		/// <summary>
-		/// a b ̸ t ŭ  
+		/// a와 b 사이를 t 비율만큼 선형 보간
 		/// </summary>
 		template<typename T>
 		inline static T Lerp(const T& a, const T& b, float t)
@@ -56,7 +60,7 @@ namespace Engine
 		}
 
 		/// <summary>
-		/// x low high ̷ Ŭ
+		/// x를 low와 high 사이로 클램핑
 		/// </summary>
 		/// <typeparam name="T"></typeparam>
 		/// <param name="x"></param>
@@ -70,12 +74,12 @@ namespace Engine
 		}
 
 		/// <summary>
-		/// (x, y) ǥ [0, 2 * PI]  ǥ  ȯ
+		/// (x, y) 좌표를 [0, 2 * PI] 범위의 극좌표계의 각도로 변환
 		/// </summary>
 		static float AngleFromXY(float x, float y);
 
 		/// <summary>
-		/// 	ǥ踦  ǥ ȯ
+		/// 구면	좌표계를 직교 좌표계로 변환
 		/// </summary>
 		inline static DirectX::XMVECTOR SphericalToCartesian(float radius, float theta, float phi)
 		{
@@ -87,13 +91,13 @@ namespace Engine
 		}
 
 		/// <summary>
-		/// 	M ġ  ȯ
+		/// 행렬	M의 역전치 행렬을 반환
 		/// </summary>
 		static DirectX::XMMATRIX InverseTranspose(DirectX::CXMMATRIX M)
 		{
-			// InverseTranspose ַ  ͸ ȯϴ  ȴ.
-			//   ̵  Ϳ  ġ Ƿ,
-			//  ġ    ȯ   ̵  ؾ Ѵ.
+			// InverseTranspose는 주로 법선 벡터를 변환하는 데 사용된다.
+			// 행렬의 평행 이동 성분은 벡터에 영향을 미치지 않으므로,
+			// 따라서 역전치 행렬을 계산할 때 변환 행렬의 평행 이동 성분은 무시해야 한다.
 			DirectX::XMMATRIX A = M;
 			A.r[3] = DirectX::XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
 			DirectX::XMVECTOR det = DirectX::XMMatrixDeterminant(A);
@@ -110,18 +114,32 @@ namespace Engine
 			return I;
 		}
 		/// <summary>
-		/// ũⰡ 1   ȯ ( )
+		/// 크기가 1인 랜덤 벡터 반환 (구면 내)
 		/// </summary>
 		/// <returns></returns>
 		static DirectX::XMVECTOR RandUnitVec3();
 
 		/// <summary>
-		///    ȯ (ݱ )
+		/// 랜덤 단위 벡터 반환 (반구 내)
 		/// </summary>
 		/// <param name="n"></param>
 		/// <returns></returns>
 		static DirectX::XMVECTOR RandHemisphereUnitVec3(DirectX::FXMVECTOR n);
 
+		/// <summary>
+		/// 위치 스트림의 경계 상자(AABB)와 경계 구를 SIMD min/max 축소로 계산.
+		/// 경계 구의 중심은 경계 상자의 중심이고, 반지름은 중심에서 가장 먼 위치까지의 거리이다.
+		/// </summary>
+		/// <param name="positions">첫 번째 위치(XMFLOAT3)의 주소. 정렬되지 않아도 된다.</param>
+		/// <param name="count">위치 개수. 0이면 원점에 크기 0인 경계를 반환한다.</param>
+		/// <param name="stride">연속한 위치 사이의 바이트 간격 (정점 구조체 크기 등)</param>
+		static void ComputeBounds(
+			const void* positions,
+			size_t count,
+			size_t stride,
+			DirectX::BoundingBox& box,
+			DirectX::BoundingSphere& sphere);
+
 		static const float Infinity;
 		static const float Pi;
 	};
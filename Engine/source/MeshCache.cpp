@@ -0,0 +1,193 @@
+#include "MeshCache.h"
+#include <algorithm>
+
+namespace Engine
+{
+	namespace
+	{
+		typedef MeshCacheFormat::Header MeshCacheHeader;
+		typedef MeshCacheFormat::Submesh MeshCacheSubmesh;
+		const size_t MaxSubmeshName = MeshCacheFormat::MaxSubmeshName;
+	}
+
+	MeshCacheFile::~MeshCacheFile()
+	{
+		Close();
+	}
+
+	bool MeshCacheFile::Open(const std::wstring& filename, std::uint64_t paramHash)
+	{
+		Close();
+
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (!GetFileAttributesExW(filename.c_str(), GetFileExInfoStandard, &attributes))
+			return false;
+
+		std::uint64_t fileSize = ((std::uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+		if (fileSize < sizeof(MeshCacheHeader) || !Map(filename, fileSize, false))
+			return false;
+
+		if (!MeshCacheFormat::Validate(mBase, fileSize, paramHash))
+		{
+			Close();
+			return false;
+		}
+
+		const MeshCacheHeader* header = reinterpret_cast<const MeshCacheHeader*>(mBase);
+		mVertexDataOffset = header->VertexDataOffset;
+		mIndexDataOffset = header->IndexDataOffset;
+		return true;
+	}
+
+	bool MeshCacheFile::Create(const std::wstring& filename, std::uint64_t paramHash, const MeshGeometry& layout)
+	{
+		Close();
+
+		// 이름 순으로 기록해야 같은 입력에서 항상 같은 파일이 나온다.
+		std::vector<const std::pair<const std::string, SubmeshGeometry>*> submeshes;
+		for (const auto& e : layout.DrawArgs)
+			submeshes.push_back(&e);
+		std::sort(submeshes.begin(), submeshes.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+		// 매직 값은 Close에서 기록한다.
+		MeshCacheHeader header = MeshCacheFormat::MakeHeader(
+			paramHash,
+			layout.VertexByteStride,
+			layout.VertexBufferByteSize,
+			(std::uint32_t)layout.IndexFormat,
+			layout.IndexBufferByteSize,
+			(std::uint32_t)submeshes.size());
+
+		bool persisted = Map(filename, header.FileSize, true);
+		if (!persisted)
+		{
+			mFallback.assign((size_t)header.FileSize, 0);
+			mBase = mFallback.data();
+			mByteSize = header.FileSize;
+		}
+
+		memcpy(mBase, &header, sizeof(header));
+
+		MeshCacheSubmesh* table = MeshCacheFormat::GetSubmeshTable(mBase);
+		for (size_t i = 0; i < submeshes.size(); ++i)
+		{
+			const std::string& name = submeshes[i]->first;
+			const SubmeshGeometry& submesh = submeshes[i]->second;
+			assert(name.size() < MaxSubmeshName);
+
+			MeshCacheSubmesh entry = {};
+			memcpy(entry.Name, name.c_str(), std::min(name.size(), MaxSubmeshName - 1));
+			entry.IndexCount = submesh.IndexCount;
+			entry.StartIndexLocation = submesh.StartIndexLocation;
+			entry.BaseVertexLocation = submesh.BaseVertexLocation;
+			entry.BoundsCenter = submesh.Bounds.Center;
+			entry.BoundsExtents = submesh.Bounds.Extents;
+			entry.SphereCenter = submesh.SphereBounds.Center;
+			entry.SphereRadius = submesh.SphereBounds.Radius;
+			entry.PositionScale = submesh.PositionScale;
+			entry.PositionOffset = submesh.PositionOffset;
+			memcpy(&table[i], &entry, sizeof(entry));
+		}
+
+		mVertexDataOffset = header.VertexDataOffset;
+		mIndexDataOffset = header.IndexDataOffset;
+		mWritable = true;
+		return persisted;
+	}
+
+	void MeshCacheFile::Close()
+	{
+		if (mBase != nullptr && mWritable)
+			reinterpret_cast<MeshCacheHeader*>(mBase)->Magic = MeshCacheFormat::Magic;
+
+		if (mBase != nullptr && mFallback.empty())
+			UnmapViewOfFile(mBase);
+		if (mMapping != nullptr)
+			CloseHandle(mMapping);
+		if (mFile != INVALID_HANDLE_VALUE)
+			CloseHandle(mFile);
+
+		mFile = INVALID_HANDLE_VALUE;
+		mMapping = nullptr;
+		mBase = nullptr;
+		mByteSize = 0;
+		mWritable = false;
+		mFallback.clear();
+		mVertexDataOffset = 0;
+		mIndexDataOffset = 0;
+	}
+
+	void MeshCacheFile::GetLayout(MeshGeometry& geo) const
+	{
+		assert(mBase != nullptr);
+
+		const MeshCacheHeader* header = reinterpret_cast<const MeshCacheHeader*>(mBase);
+		geo.VertexByteStride = header->VertexByteStride;
+		geo.VertexBufferByteSize = header->VertexBufferByteSize;
+		geo.IndexFormat = (DXGI_FORMAT)header->IndexFormat;
+		geo.IndexBufferByteSize = header->IndexBufferByteSize;
+
+		const MeshCacheSubmesh* table = MeshCacheFormat::GetSubmeshTable(static_cast<const void*>(mBase));
+		for (std::uint32_t i = 0; i < header->SubmeshCount; ++i)
+		{
+			const MeshCacheSubmesh& entry = table[i];
+
+			SubmeshGeometry submesh;
+			submesh.IndexCount = entry.IndexCount;
+			submesh.StartIndexLocation = entry.StartIndexLocation;
+			submesh.BaseVertexLocation = entry.BaseVertexLocation;
+			submesh.Bounds.Center = entry.BoundsCenter;
+			submesh.Bounds.Extents = entry.BoundsExtents;
+			submesh.SphereBounds.Center = entry.SphereCenter;
+			submesh.SphereBounds.Radius = entry.SphereRadius;
+			submesh.PositionScale = entry.PositionScale;
+			submesh.PositionOffset = entry.PositionOffset;
+
+			std::string name(entry.Name, strnlen(entry.Name, MaxSubmeshName));
+			geo.DrawArgs[name] = submesh;
+		}
+	}
+
+	std::uint64_t MeshCacheFile::HashBytes(const void* data, size_t byteSize, std::uint64_t seed)
+	{
+		return Fnv1aBytes(data, byteSize, seed);
+	}
+
+	bool MeshCacheFile::Map(const std::wstring& filename, std::uint64_t byteSize, bool writable)
+	{
+		mFile = CreateFileW(
+			filename.c_str(),
+			writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+			writable ? 0 : FILE_SHARE_READ,
+			nullptr,
+			writable ? CREATE_ALWAYS : OPEN_EXISTING,
+			writable ? FILE_ATTRIBUTE_NORMAL : FILE_FLAG_SEQUENTIAL_SCAN,
+			nullptr);
+		if (mFile == INVALID_HANDLE_VALUE)
+			return false;
+
+		// 쓰기용 매핑은 byteSize만큼 파일을 늘린다.
+		mMapping = CreateFileMappingW(
+			mFile,
+			nullptr,
+			writable ? PAGE_READWRITE : PAGE_READONLY,
+			(DWORD)(byteSize >> 32),
+			(DWORD)(byteSize & 0xFFFFFFFF),
+			nullptr);
+		if (mMapping == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		mBase = static_cast<std::uint8_t*>(MapViewOfFile(mMapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, (SIZE_T)byteSize));
+		if (mBase == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		mByteSize = byteSize;
+		return true;
+	}
+}
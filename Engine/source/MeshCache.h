@@ -0,0 +1,76 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Hash.h"
+#include "MeshCacheFormat.h"
+#include "Util.h"
+
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+namespace Engine
+{
+	/// <summary>
+	/// 미리 구운(baked) 메쉬를 저장하는 바이너리 캐시 파일. 파일 형식은 MeshCacheFormat.
+	/// [헤더][서브메쉬 표][정점 데이터][인덱스 데이터] 순서로 저장되며, 정점/인덱스 데이터는
+	/// 정점 버퍼/인덱스 버퍼에 올라갈 바이트 그대로이므로 메모리 매핑 후 파싱 없이 업로드할 수 있다.
+	/// </summary>
+	class D3D_API MeshCacheFile
+	{
+	public:
+		static const std::uint32_t Version = MeshCacheFormat::Version;
+
+		MeshCacheFile() = default;
+		MeshCacheFile(const MeshCacheFile& rhs) = delete;
+		MeshCacheFile& operator=(const MeshCacheFile& rhs) = delete;
+		~MeshCacheFile();
+
+		/// <summary>
+		/// 캐시 파일을 읽기 전용으로 매핑
+		/// </summary>
+		/// <param name="paramHash">메쉬를 생성한 매개변수의 해시</param>
+		/// <returns>파일이 없거나 손상되었거나 버전/해시가 다르면 false</returns>
+		bool Open(const std::wstring& filename, std::uint64_t paramHash);
+
+		/// <summary>
+		/// 새 캐시 파일을 만들고 쓰기 가능하게 매핑. 헤더와 서브메쉬 표는 layout의 버퍼 정보와 DrawArgs로 기록되고,
+		/// 정점/인덱스 데이터는 호출자가 GetVertexData/GetIndexData에 직접 기록한다.
+		/// </summary>
+		/// <returns>파일을 만들지 못하면 메모리에만 기록하고 false 반환 (데이터 포인터는 유효)</returns>
+		bool Create(const std::wstring& filename, std::uint64_t paramHash, const MeshGeometry& layout);
+
+		/// <summary>
+		/// 매핑 해제. Create로 만든 파일은 이때 완성 표시가 기록되므로, 기록 도중 중단된 파일은 다시 열리지 않는다.
+		/// </summary>
+		void Close();
+
+		void* GetVertexData() { return mBase + mVertexDataOffset; }
+		const void* GetVertexData() const { return mBase + mVertexDataOffset; }
+		void* GetIndexData() { return mBase + mIndexDataOffset; }
+		const void* GetIndexData() const { return mBase + mIndexDataOffset; }
+
+		/// <summary>
+		/// 캐시에 저장된 버퍼 정보(보폭, 크기, 인덱스 형식)와 서브메쉬 표를 geo에 설정. GPU 버퍼는 만들지 않는다.
+		/// </summary>
+		void GetLayout(MeshGeometry& geo) const;
+
+		/// <summary>
+		/// 캐시 무효화용 64비트 FNV-1a 해시. seed에 이전 결과를 넘겨 여러 값을 이어서 해시할 수 있다.
+		/// </summary>
+		static std::uint64_t HashBytes(const void* data, size_t byteSize, std::uint64_t seed = Fnv1aOffsetBasis);
+
+	private:
+		bool Map(const std::wstring& filename, std::uint64_t byteSize, bool writable);
+
+		HANDLE mFile = INVALID_HANDLE_VALUE;
+		HANDLE mMapping = nullptr;
+		std::uint8_t* mBase = nullptr;
+		std::uint64_t mByteSize = 0;
+		bool mWritable = false;
+
+		// 파일을 만들지 못했을 때 사용하는 메모리
+		std::vector<std::uint8_t> mFallback;
+
+		std::uint64_t mVertexDataOffset = 0;
+		std::uint64_t mIndexDataOffset = 0;
+	};
+}
+#endif
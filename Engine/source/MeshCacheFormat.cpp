@@ -0,0 +1,50 @@
+#include "MeshCacheFormat.h"
+#include <cstring>
+
+namespace Engine
+{
+	MeshCacheFormat::Header MeshCacheFormat::MakeHeader(
+		std::uint64_t paramHash,
+		std::uint32_t vertexByteStride,
+		std::uint32_t vertexBufferByteSize,
+		std::uint32_t indexFormat,
+		std::uint32_t indexBufferByteSize,
+		std::uint32_t submeshCount)
+	{
+		Header header = {};
+		header.Magic = 0;
+		header.Version = Version;
+		header.ParamHash = paramHash;
+		header.VertexByteStride = vertexByteStride;
+		header.VertexBufferByteSize = vertexBufferByteSize;
+		header.IndexFormat = indexFormat;
+		header.IndexBufferByteSize = indexBufferByteSize;
+		header.SubmeshCount = submeshCount;
+		header.VertexDataOffset = AlignUp(sizeof(Header) + (std::uint64_t)submeshCount * sizeof(Submesh), DataAlignment);
+		header.IndexDataOffset = AlignUp(header.VertexDataOffset + vertexBufferByteSize, DataAlignment);
+		header.FileSize = header.IndexDataOffset + indexBufferByteSize;
+		return header;
+	}
+
+	bool MeshCacheFormat::Validate(const void* data, std::uint64_t byteSize, std::uint64_t paramHash)
+	{
+		if (data == nullptr || byteSize < sizeof(Header))
+			return false;
+
+		Header header;
+		memcpy(&header, data, sizeof(header));
+
+		// 헤더가 가리키는 구간이 모두 파일 안에 있어야 한다. 오프셋을 먼저 파일 크기와 비교해 덧셈이 넘치지 않게 한다.
+		return
+			header.Magic == Magic &&
+			header.Version == Version &&
+			header.ParamHash == paramHash &&
+			header.FileSize == byteSize &&
+			header.SubmeshCount <= byteSize / sizeof(Submesh) &&
+			header.VertexDataOffset <= byteSize &&
+			header.IndexDataOffset <= byteSize &&
+			sizeof(Header) + (std::uint64_t)header.SubmeshCount * sizeof(Submesh) <= header.VertexDataOffset &&
+			header.VertexDataOffset + header.VertexBufferByteSize <= header.IndexDataOffset &&
+			header.IndexDataOffset + header.IndexBufferByteSize <= byteSize;
+	}
+}
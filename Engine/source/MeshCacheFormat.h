@@ -0,0 +1,93 @@
+#pragma once
+#include "EngineHeader.h"
+#include <cstddef>
+#include <cstdint>
+#include <DirectXMath.h>
+
+#ifndef MESHCACHEFORMAT_H
+#define MESHCACHEFORMAT_H
+namespace Engine
+{
+	/// <summary>
+	/// MeshCacheFile의 파일 형식. [헤더][서브메쉬 표][정점 데이터][인덱스 데이터]
+	/// 파일 입출력과 D3D12 형식에 의존하지 않으므로 헤더 생성과 검사는 장치 없이 검증할 수 있다.
+	/// </summary>
+	class D3D_API MeshCacheFormat
+	{
+	public:
+		// 파일 구조가 바뀌면 올린다. 버전이 다른 캐시는 열리지 않는다.
+		enum : std::uint32_t { Version = 2 };
+		enum : std::uint32_t { Magic = 0x4348534D }; // "MSHC"
+		enum : std::uint64_t { DataAlignment = 16 };
+		enum : size_t { MaxSubmeshName = 64 };
+
+		struct Header
+		{
+			// 기록이 끝나기 전에는 0. 기록 도중 중단된 파일은 이 값으로 걸러진다.
+			std::uint32_t Magic;
+			std::uint32_t Version;
+			std::uint64_t ParamHash;
+			std::uint64_t FileSize;
+
+			std::uint32_t VertexByteStride;
+			std::uint32_t VertexBufferByteSize;
+			std::uint32_t IndexFormat;
+			std::uint32_t IndexBufferByteSize;
+
+			std::uint32_t SubmeshCount;
+			std::uint32_t Reserved;
+			std::uint64_t VertexDataOffset;
+			std::uint64_t IndexDataOffset;
+		};
+
+		struct Submesh
+		{
+			char Name[MaxSubmeshName];
+			std::uint32_t IndexCount;
+			std::uint32_t StartIndexLocation;
+			std::int32_t BaseVertexLocation;
+			DirectX::XMFLOAT3 BoundsCenter;
+			DirectX::XMFLOAT3 BoundsExtents;
+			DirectX::XMFLOAT3 SphereCenter;
+			float SphereRadius;
+			DirectX::XMFLOAT3 PositionScale;
+			DirectX::XMFLOAT3 PositionOffset;
+		};
+
+		/// <summary>
+		/// 서브메쉬 표와 정점/인덱스 데이터의 위치, 파일 크기를 정한 헤더. Magic은 0으로 둔다.
+		/// </summary>
+		/// <param name="indexFormat">DXGI_FORMAT 값</param>
+		static Header MakeHeader(
+			std::uint64_t paramHash,
+			std::uint32_t vertexByteStride,
+			std::uint32_t vertexBufferByteSize,
+			std::uint32_t indexFormat,
+			std::uint32_t indexBufferByteSize,
+			std::uint32_t submeshCount);
+
+		/// <summary>
+		/// 파일 내용을 검사. 헤더가 가리키는 구간이 모두 파일 안에 있어야 한다.
+		/// </summary>
+		/// <returns>너무 짧거나, 완성되지 않았거나, 버전/매개변수 해시/파일 크기가 다르면 false</returns>
+		static bool Validate(const void* data, std::uint64_t byteSize, std::uint64_t paramHash);
+
+		/// <summary>
+		/// 헤더 바로 뒤의 서브메쉬 표. data는 Validate를 통과했거나 MakeHeader로 만든 헤더로 시작해야 한다.
+		/// </summary>
+		static const Submesh* GetSubmeshTable(const void* data)
+		{
+			return reinterpret_cast<const Submesh*>(static_cast<const std::uint8_t*>(data) + sizeof(Header));
+		}
+		static Submesh* GetSubmeshTable(void* data)
+		{
+			return reinterpret_cast<Submesh*>(static_cast<std::uint8_t*>(data) + sizeof(Header));
+		}
+
+		static std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+	};
+}
+#endif
@@ -0,0 +1,382 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Engine
+{
+	using namespace DirectX;
+	using uint32 = GeometryGenerator::uint32;
+
+	namespace
+	{
+		// Forsyth 알고리즘이 가정하는 LRU 캐시 크기와 점수 상수
+		const int ForsythCacheSize = 32;
+		const float CacheDecayPower = 1.5f;
+		const float LastTriangleScore = 0.75f;
+		const float ValenceBoostScale = 2.0f;
+		const float ValenceBoostPower = 0.5f;
+
+		const uint32 InvalidIndex = ~0u;
+
+		float ForsythVertexScore(int cachePosition, uint32 liveTriangles)
+		{
+			// 남은 삼각형이 없는 정점은 다시 선택될 일이 없음
+			if (liveTriangles == 0)
+				return -1.0f;
+
+			float score = 0.0f;
+			if (cachePosition >= 0)
+			{
+				// 직전 삼각형의 정점들은 같은 점수를 주어 특정 방향으로 치우치지 않게 함
+				if (cachePosition < 3)
+				{
+					score = LastTriangleScore;
+				}
+				else
+				{
+					const float scaler = 1.0f / (ForsythCacheSize - 3);
+					score = powf(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+				}
+			}
+
+			// 남은 삼각형이 적은 정점을 우선 처리하여 고립된 삼각형이 생기지 않게 함
+			score += ValenceBoostScale * powf(static_cast<float>(liveTriangles), -ValenceBoostPower);
+			return score;
+		}
+
+		// 타임스탬프 기반 FIFO 캐시 시뮬레이터.
+		// 마지막 cacheSize번의 삽입 안에 들어온 정점만 캐시에 남아 있는 것으로 본다.
+		class FifoCacheSimulator
+		{
+		public:
+			FifoCacheSimulator(uint32 vertexCount, uint32 cacheSize)
+				: mTimestamps(vertexCount, 0), mCacheSize(cacheSize), mTime(cacheSize + 1) {}
+
+			// 캐시 미스이면 true
+			bool Access(uint32 index)
+			{
+				if (mTime - mTimestamps[index] > mCacheSize)
+				{
+					mTimestamps[index] = mTime++;
+					return true;
+				}
+				return false;
+			}
+
+			// 캐시 비우기
+			void Flush()
+			{
+				mTime += mCacheSize + 1;
+			}
+
+		private:
+			std::vector<uint32> mTimestamps;
+			uint32 mCacheSize;
+			uint32 mTime;
+		};
+	}
+
+	void MeshOptimizer::Optimize(GeometryGenerator::MeshData& meshData, float threshold)
+	{
+		OptimizeVertexCache(meshData.Indices32, (uint32)meshData.Vertices.size());
+		OptimizeOverdraw(meshData.Indices32, meshData.Vertices, threshold);
+		OptimizeVertexFetch(meshData);
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(std::vector<uint32>& indices, uint32 vertexCount)
+	{
+		uint32 numTris = (uint32)indices.size() / 3;
+		if (numTris == 0)
+			return;
+
+		// 정점 -> 삼각형 인접 리스트 (각 정점의 구간 앞쪽 liveCount개가 아직 출력되지 않은 삼각형)
+		std::vector<uint32> liveCount(vertexCount, 0);
+		for (uint32 index : indices)
+			liveCount[index]++;
+
+		std::vector<uint32> offsets(vertexCount + 1, 0);
+		for (uint32 v = 0; v < vertexCount; ++v)
+			offsets[v + 1] = offsets[v] + liveCount[v];
+
+		std::vector<uint32> adjacency(indices.size());
+		{
+			std::vector<uint32> cursor(offsets.begin(), offsets.end() - 1);
+			for (uint32 i = 0; i < (uint32)indices.size(); ++i)
+				adjacency[cursor[indices[i]]++] = i / 3;
+		}
+
+		std::vector<int> cachePosition(vertexCount, -1);
+		std::vector<float> vertexScore(vertexCount);
+		for (uint32 v = 0; v < vertexCount; ++v)
+			vertexScore[v] = ForsythVertexScore(-1, liveCount[v]);
+
+		std::vector<char> emitted(numTris, 0);
+		std::vector<uint32> output;
+		output.reserve(indices.size());
+
+		// 새 삼각형의 정점 3개가 앞에 추가되므로 캐시 크기 + 3 만큼의 공간이 필요
+		uint32 cache[ForsythCacheSize + 3];
+		uint32 newCache[ForsythCacheSize + 3];
+		uint32 cacheCount = 0;
+
+		uint32 nextCandidate = 0;
+		uint32 bestTriangle = InvalidIndex;
+
+		for (uint32 emittedCount = 0; emittedCount < numTris; ++emittedCount)
+		{
+			// 캐시 안의 정점과 연결된 삼각형이 없다면 아직 출력되지 않은 다음 삼각형에서 다시 시작
+			if (bestTriangle == InvalidIndex)
+			{
+				while (emitted[nextCandidate])
+					++nextCandidate;
+				bestTriangle = nextCandidate;
+			}
+
+			const uint32* tri = &indices[bestTriangle * 3];
+			output.push_back(tri[0]);
+			output.push_back(tri[1]);
+			output.push_back(tri[2]);
+			emitted[bestTriangle] = 1;
+
+			// 출력된 삼각형을 각 정점의 인접 리스트에서 제거
+			for (int k = 0; k < 3; ++k)
+			{
+				uint32 v = tri[k];
+				uint32* begin = &adjacency[offsets[v]];
+				uint32* end = begin + liveCount[v];
+				uint32* it = std::find(begin, end, bestTriangle);
+				*it = *(end - 1);
+				liveCount[v]--;
+			}
+
+			// 출력된 삼각형의 정점을 캐시 맨 앞으로 이동
+			uint32 newCacheCount = 0;
+			for (int k = 0; k < 3; ++k)
+			{
+				if (std::find(newCache, newCache + newCacheCount, tri[k]) == newCache + newCacheCount)
+					newCache[newCacheCount++] = tri[k];
+			}
+			for (uint32 i = 0; i < cacheCount; ++i)
+			{
+				if (cache[i] != tri[0] && cache[i] != tri[1] && cache[i] != tri[2])
+					newCache[newCacheCount++] = cache[i];
+			}
+
+			// 캐시에서 밀려난 정점을 포함하여 위치가 바뀐 정점들의 점수 갱신
+			for (uint32 i = 0; i < newCacheCount; ++i)
+			{
+				uint32 v = newCache[i];
+				cachePosition[v] = i < (uint32)ForsythCacheSize ? (int)i : -1;
+				vertexScore[v] = ForsythVertexScore(cachePosition[v], liveCount[v]);
+			}
+
+			// 점수가 바뀐 정점과 연결된 삼각형 중 가장 점수가 높은 삼각형을 다음 후보로 선택
+			bestTriangle = InvalidIndex;
+			float bestScore = -1.0f;
+			for (uint32 i = 0; i < newCacheCount; ++i)
+			{
+				uint32 v = newCache[i];
+				for (uint32 a = offsets[v]; a < offsets[v] + liveCount[v]; ++a)
+				{
+					uint32 t = adjacency[a];
+					float score =
+						vertexScore[indices[t * 3 + 0]] +
+						vertexScore[indices[t * 3 + 1]] +
+						vertexScore[indices[t * 3 + 2]];
+
+					if (score > bestScore)
+					{
+						bestScore = score;
+						bestTriangle = t;
+					}
+				}
+			}
+
+			cacheCount = std::min(newCacheCount, (uint32)ForsythCacheSize);
+			std::copy(newCache, newCache + cacheCount, cache);
+		}
+
+		indices.swap(output);
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(
+		std::vector<uint32>& indices,
+		const std::vector<GeometryGenerator::Vertex>& vertices,
+		float threshold,
+		uint32 cacheSize)
+	{
+		uint32 numTris = (uint32)indices.size() / 3;
+		if (numTris == 0)
+			return;
+
+		uint32 vertexCount = (uint32)vertices.size();
+		float meshACMR = AnalyzeVertexCache(indices, vertexCount, cacheSize).ACMR;
+
+		//
+		// 클러스터 나누기
+		//
+
+		// 정점 3개가 모두 캐시 미스인 삼각형은 캐시 최적화가 새로 시작된 지점(하드 경계)이다.
+		// 하드 경계 안에서도 클러스터의 ACMR이 전체 ACMR * threshold 이하로 떨어지면
+		// 차가운 캐시로 다시 시작해도 손해가 크지 않으므로 소프트 경계로 나눈다.
+		std::vector<uint32> clusterStarts;
+		{
+			FifoCacheSimulator hardCache(vertexCount, cacheSize);
+			FifoCacheSimulator softCache(vertexCount, cacheSize);
+
+			uint32 clusterStart = 0;
+			uint32 clusterMisses = 0;
+			for (uint32 t = 0; t < numTris; ++t)
+			{
+				uint32 hardMisses = 0;
+				for (int k = 0; k < 3; ++k)
+					hardMisses += hardCache.Access(indices[t * 3 + k]) ? 1 : 0;
+
+				if (t == 0 || hardMisses == 3)
+				{
+					clusterStarts.push_back(t);
+					clusterStart = t;
+					clusterMisses = 0;
+					softCache.Flush();
+				}
+
+				for (int k = 0; k < 3; ++k)
+					clusterMisses += softCache.Access(indices[t * 3 + k]) ? 1 : 0;
+
+				uint32 clusterTris = t - clusterStart + 1;
+				if (t + 1 < numTris && clusterMisses <= threshold * meshACMR * clusterTris)
+				{
+					clusterStarts.push_back(t + 1);
+					clusterStart = t + 1;
+					clusterMisses = 0;
+					softCache.Flush();
+				}
+			}
+
+			// 소프트 경계 바로 다음 삼각형이 하드 경계인 경우 중복 제거
+			clusterStarts.erase(std::unique(clusterStarts.begin(), clusterStarts.end()), clusterStarts.end());
+		}
+		uint32 clusterCount = (uint32)clusterStarts.size();
+		clusterStarts.push_back(numTris);
+
+		//
+		// 클러스터 정렬
+		//
+
+		// 메쉬 중심에서 바깥을 향하는 클러스터일수록 다른 클러스터를 가릴 가능성이 크므로 먼저 그린다.
+		std::vector<XMFLOAT3> clusterCentroids(clusterCount);
+		std::vector<XMFLOAT3> clusterNormals(clusterCount);
+		XMVECTOR meshCentroid = XMVectorZero();
+		float meshArea = 0.0f;
+
+		for (uint32 c = 0; c < clusterCount; ++c)
+		{
+			XMVECTOR centroid = XMVectorZero();
+			XMVECTOR normal = XMVectorZero();
+			float area = 0.0f;
+
+			for (uint32 t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t)
+			{
+				XMVECTOR p0 = XMLoadFloat3(&vertices[indices[t * 3 + 0]].Position);
+				XMVECTOR p1 = XMLoadFloat3(&vertices[indices[t * 3 + 1]].Position);
+				XMVECTOR p2 = XMLoadFloat3(&vertices[indices[t * 3 + 2]].Position);
+
+				// 외적의 길이는 삼각형 넓이의 2배
+				XMVECTOR n = XMVector3Cross(p1 - p0, p2 - p0);
+				float triArea = 0.5f * XMVectorGetX(XMVector3Length(n));
+
+				centroid = centroid + (triArea / 3.0f) * (p0 + p1 + p2);
+				normal = normal + n;
+				area += triArea;
+			}
+
+			meshCentroid = meshCentroid + centroid;
+			meshArea += area;
+
+			if (area > 0.0f)
+				centroid = (1.0f / area) * centroid;
+
+			XMStoreFloat3(&clusterCentroids[c], centroid);
+			XMStoreFloat3(&clusterNormals[c], XMVector3Normalize(normal));
+		}
+
+		if (meshArea > 0.0f)
+			meshCentroid = (1.0f / meshArea) * meshCentroid;
+
+		std::vector<float> sortKeys(clusterCount);
+		std::vector<uint32> clusterOrder(clusterCount);
+		for (uint32 c = 0; c < clusterCount; ++c)
+		{
+			XMVECTOR toCluster = XMLoadFloat3(&clusterCentroids[c]) - meshCentroid;
+			sortKeys[c] = XMVectorGetX(XMVector3Dot(toCluster, XMLoadFloat3(&clusterNormals[c])));
+			clusterOrder[c] = c;
+		}
+
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+			[&sortKeys](uint32 a, uint32 b) { return sortKeys[a] > sortKeys[b]; });
+
+		std::vector<uint32> output;
+		output.reserve(indices.size());
+		for (uint32 c : clusterOrder)
+		{
+			output.insert(output.end(),
+				indices.begin() + clusterStarts[c] * 3,
+				indices.begin() + clusterStarts[c + 1] * 3);
+		}
+
+		indices.swap(output);
+	}
+
+	uint32 MeshOptimizer::OptimizeVertexFetch(GeometryGenerator::MeshData& meshData)
+	{
+		std::vector<uint32> remap(meshData.Vertices.size(), InvalidIndex);
+
+		uint32 nextVertex = 0;
+		for (uint32& index : meshData.Indices32)
+		{
+			if (remap[index] == InvalidIndex)
+				remap[index] = nextVertex++;
+			index = remap[index];
+		}
+
+		std::vector<GeometryGenerator::Vertex> vertices(nextVertex);
+		for (size_t i = 0; i < remap.size(); ++i)
+		{
+			if (remap[i] != InvalidIndex)
+				vertices[remap[i]] = meshData.Vertices[i];
+		}
+
+		meshData.Vertices.swap(vertices);
+		return nextVertex;
+	}
+
+	VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(
+		const std::vector<uint32>& indices,
+		uint32 vertexCount,
+		uint32 cacheSize)
+	{
+		VertexCacheStatistics stats;
+
+		FifoCacheSimulator cache(vertexCount, cacheSize);
+		std::vector<char> referenced(vertexCount, 0);
+		uint32 uniqueVertices = 0;
+
+		for (uint32 index : indices)
+		{
+			if (cache.Access(index))
+				stats.VerticesTransformed++;
+
+			if (!referenced[index])
+			{
+				referenced[index] = 1;
+				uniqueVertices++;
+			}
+		}
+
+		uint32 numTris = (uint32)indices.size() / 3;
+		stats.ACMR = numTris == 0 ? 0.0f : (float)stats.VerticesTransformed / numTris;
+		stats.ATVR = uniqueVertices == 0 ? 0.0f : (float)stats.VerticesTransformed / uniqueVertices;
+
+		return stats;
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "EngineHeader.h"
+#include "GeometryGenerator.h"
+
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+namespace Engine
+{
+	/// <summary>
+	/// 정점 캐시 시뮬레이션 결과
+	/// </summary>
+	struct VertexCacheStatistics
+	{
+		GeometryGenerator::uint32 VerticesTransformed = 0; // 캐시 미스로 인해 변환된 정점 수
+		float ACMR = 0.0f; // 삼각형당 평균 캐시 미스 수 (최적: 0.5, 최악: 3.0)
+		float ATVR = 0.0f; // 참조된 정점당 평균 변환 횟수 (최적: 1.0)
+	};
+
+	/// <summary>
+	/// MeshData의 인덱스/정점 순서를 GPU 친화적으로 재배치하는 CPU 전용 최적화기.
+	/// 기하 구조는 바꾸지 않고 순서만 바꾸므로 오프라인 처리에도 사용할 수 있다.
+	/// </summary>
+	class D3D_API MeshOptimizer
+	{
+	public:
+		using uint32 = GeometryGenerator::uint32;
+
+		// 캐시 시뮬레이션에 사용하는 기본 FIFO 캐시 크기
+		static const uint32 DefaultCacheSize = 16;
+
+		/// <summary>
+		/// 정점 캐시 → 오버드로우 → 정점 페치 순서로 전체 최적화를 수행
+		/// </summary>
+		/// <param name="threshold">오버드로우 정렬이 허용하는 ACMR 악화 비율 (1.0 이상)</param>
+		static void Optimize(GeometryGenerator::MeshData& meshData, float threshold = 1.05f);
+
+		/// <summary>
+		/// Forsyth 알고리즘으로 정점 캐시 지역성이 높아지도록 삼각형 순서를 재배치
+		/// </summary>
+		static void OptimizeVertexCache(std::vector<uint32>& indices, uint32 vertexCount);
+
+		/// <summary>
+		/// Tipsify 방식으로 삼각형을 클러스터로 나누고, 바깥을 향하는 클러스터가 먼저 그려지도록 정렬.
+		/// 클러스터 경계는 캐시 효율(ACMR)이 threshold 비율 이상 나빠지지 않는 곳에서만 나눈다.
+		/// </summary>
+		static void OptimizeOverdraw(
+			std::vector<uint32>& indices,
+			const std::vector<GeometryGenerator::Vertex>& vertices,
+			float threshold,
+			uint32 cacheSize = DefaultCacheSize);
+
+		/// <summary>
+		/// 인덱스 버퍼에서 처음 참조되는 순서로 정점을 재배치하고, 참조되지 않는 정점을 제거
+		/// </summary>
+		/// <returns>재배치 후 정점 개수</returns>
+		static uint32 OptimizeVertexFetch(GeometryGenerator::MeshData& meshData);
+
+		/// <summary>
+		/// FIFO 정점 캐시를 시뮬레이션하여 ACMR/ATVR 통계 계산
+		/// </summary>
+		static VertexCacheStatistics AnalyzeVertexCache(
+			const std::vector<uint32>& indices,
+			uint32 vertexCount,
+			uint32 cacheSize = DefaultCacheSize);
+	};
+}
+#endif
@@ -0,0 +1,447 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+
+namespace Engine
+{
+	using namespace DirectX;
+	using uint32 = GeometryGenerator::uint32;
+
+	namespace
+	{
+		// 대칭 4x4 행렬로 표현되는 평면 거리 제곱합. Weight는 누적된 삼각형 넓이.
+		struct Quadric
+		{
+			double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+			double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+			double a22 = 0.0, a23 = 0.0;
+			double a33 = 0.0;
+			double Weight = 0.0;
+
+			void AddPlane(double nx, double ny, double nz, double d, double w)
+			{
+				a00 += w * nx * nx; a01 += w * nx * ny; a02 += w * nx * nz; a03 += w * nx * d;
+				a11 += w * ny * ny; a12 += w * ny * nz; a13 += w * ny * d;
+				a22 += w * nz * nz; a23 += w * nz * d;
+				a33 += w * d * d;
+				Weight += w;
+			}
+
+			void Add(const Quadric& q)
+			{
+				a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+				a11 += q.a11; a12 += q.a12; a13 += q.a13;
+				a22 += q.a22; a23 += q.a23;
+				a33 += q.a33;
+				Weight += q.Weight;
+			}
+
+			// 넓이로 가중 평균한 평면 거리 제곱
+			double Error(const XMFLOAT3& p) const
+			{
+				double x = p.x, y = p.y, z = p.z;
+				double e =
+					x * x * a00 + y * y * a11 + z * z * a22 + a33 +
+					2.0 * (x * y * a01 + x * z * a02 + y * z * a12 + x * a03 + y * a13 + z * a23);
+				return Weight > 0.0 ? std::max(e, 0.0) / Weight : 0.0;
+			}
+		};
+
+		struct Collapse
+		{
+			float Cost;
+			uint32 From;
+			uint32 To;
+			uint32 FromVersion;
+			uint32 ToVersion;
+
+			bool operator>(const Collapse& rhs) const { return Cost > rhs.Cost; }
+		};
+
+		bool PositionLess(const XMFLOAT3& a, const XMFLOAT3& b)
+		{
+			if (a.x != b.x) return a.x < b.x;
+			if (a.y != b.y) return a.y < b.y;
+			return a.z < b.z;
+		}
+
+		bool PositionEqual(const XMFLOAT3& a, const XMFLOAT3& b)
+		{
+			return a.x == b.x && a.y == b.y && a.z == b.z;
+		}
+
+		XMVECTOR TriangleNormal(const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2)
+		{
+			XMVECTOR v0 = XMLoadFloat3(&p0);
+			return XMVector3Cross(XMLoadFloat3(&p1) - v0, XMLoadFloat3(&p2) - v0);
+		}
+	}
+
+	std::vector<uint32> MeshSimplifier::Simplify(
+		const GeometryGenerator::MeshData& meshData,
+		const std::vector<uint32>& indices,
+		uint32 targetTriangleCount,
+		float maxError,
+		float* resultError)
+	{
+		if (resultError != nullptr)
+			*resultError = 0.0f;
+
+		const std::vector<GeometryGenerator::Vertex>& vertices = meshData.Vertices;
+		uint32 vertexCount = (uint32)vertices.size();
+		uint32 numTris = (uint32)indices.size() / 3;
+
+		if (numTris <= targetTriangleCount)
+			return indices;
+
+		//
+		// 같은 위치의 정점들을 하나의 위치 정점(canon)으로 묶기
+		//
+
+		std::vector<char> referenced(vertexCount, 0);
+		for (uint32 index : indices)
+			referenced[index] = 1;
+
+		std::vector<uint32> canon(vertexCount);
+		{
+			std::vector<uint32> order(vertexCount);
+			std::iota(order.begin(), order.end(), 0u);
+			std::sort(order.begin(), order.end(), [&vertices](uint32 a, uint32 b)
+			{
+				return PositionLess(vertices[a].Position, vertices[b].Position);
+			});
+
+			for (uint32 i = 0; i < vertexCount; ++i)
+			{
+				bool sameAsPrev = i > 0 && PositionEqual(vertices[order[i]].Position, vertices[order[i - 1]].Position);
+				canon[order[i]] = sameAsPrev ? canon[order[i - 1]] : order[i];
+			}
+		}
+
+		//
+		// 움직이면 안 되는 정점 찾기
+		//
+
+		// 한 위치에 속성이 다른 정점이 두 개 이상 있으면 UV/법선 이음매
+		std::vector<char> locked(vertexCount, 0);
+		{
+			std::vector<uint32> wedgeCount(vertexCount, 0);
+			for (uint32 v = 0; v < vertexCount; ++v)
+			{
+				if (referenced[v])
+					wedgeCount[canon[v]]++;
+			}
+			for (uint32 c = 0; c < vertexCount; ++c)
+				locked[c] = wedgeCount[c] > 1 ? 1 : 0;
+		}
+
+		// 반대 방향 간선이 없거나 같은 방향 간선이 여러 번 나오면 열린 경계 또는 비다양체
+		{
+			std::unordered_map<std::uint64_t, uint32> edgeCount;
+			edgeCount.reserve(indices.size());
+
+			auto edgeKey = [](uint32 a, uint32 b) { return ((std::uint64_t)a << 32) | b; };
+
+			for (uint32 t = 0; t < numTris; ++t)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					uint32 a = canon[indices[t * 3 + k]];
+					uint32 b = canon[indices[t * 3 + (k + 1) % 3]];
+					edgeCount[edgeKey(a, b)]++;
+				}
+			}
+
+			for (const auto& e : edgeCount)
+			{
+				uint32 a = (uint32)(e.first >> 32);
+				uint32 b = (uint32)(e.first & 0xFFFFFFFF);
+				if (e.second > 1 || edgeCount.find(edgeKey(b, a)) == edgeCount.end())
+				{
+					locked[a] = 1;
+					locked[b] = 1;
+				}
+			}
+		}
+
+		//
+		// 위치 정점마다 주변 삼각형 평면의 이차 오차 누적
+		//
+
+		std::vector<uint32> tris(indices);
+		std::vector<char> triAlive(numTris, 1);
+		std::vector<std::vector<uint32>> canonTris(vertexCount);
+		std::vector<Quadric> quadrics(vertexCount);
+
+		XMVECTOR vMin = XMVectorSet(+FLT_MAX, +FLT_MAX, +FLT_MAX, 0.0f);
+		XMVECTOR vMax = XMVectorSet(-FLT_MAX, -FLT_MAX, -FLT_MAX, 0.0f);
+
+		for (uint32 t = 0; t < numTris; ++t)
+		{
+			const XMFLOAT3& p0 = vertices[tris[t * 3 + 0]].Position;
+			const XMFLOAT3& p1 = vertices[tris[t * 3 + 1]].Position;
+			const XMFLOAT3& p2 = vertices[tris[t * 3 + 2]].Position;
+
+			for (int k = 0; k < 3; ++k)
+			{
+				uint32 c = canon[tris[t * 3 + k]];
+				if (std::find(canonTris[c].begin(), canonTris[c].end(), t) == canonTris[c].end())
+					canonTris[c].push_back(t);
+
+				XMVECTOR p = XMLoadFloat3(&vertices[c].Position);
+				vMin = XMVectorMin(vMin, p);
+				vMax = XMVectorMax(vMax, p);
+			}
+
+			XMVECTOR n = TriangleNormal(p0, p1, p2);
+			float length = XMVectorGetX(XMVector3Length(n));
+			if (length <= 0.0f)
+				continue;
+
+			XMFLOAT3 unitNormal;
+			XMStoreFloat3(&unitNormal, (1.0f / length) * n);
+			double d = -((double)unitNormal.x * p0.x + (double)unitNormal.y * p0.y + (double)unitNormal.z * p0.z);
+			double area = 0.5 * length;
+
+			for (int k = 0; k < 3; ++k)
+				quadrics[canon[tris[t * 3 + k]]].AddPlane(unitNormal.x, unitNormal.y, unitNormal.z, d, area);
+		}
+
+		XMFLOAT3 extents;
+		XMStoreFloat3(&extents, vMax - vMin);
+		float meshExtent = std::max(extents.x, std::max(extents.y, extents.z));
+		if (meshExtent <= 0.0f)
+			return indices;
+
+		double maxCost = (double)maxError * meshExtent * maxError * meshExtent;
+
+		//
+		// 축약 후보를 비용 순으로 처리
+		//
+
+		std::vector<uint32> version(vertexCount, 0);
+		std::vector<char> removed(vertexCount, 0);
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+
+		auto pushCollapse = [&](uint32 from, uint32 to)
+		{
+			uint32 cf = canon[from];
+			uint32 ct = canon[to];
+			if (locked[cf] || cf == ct)
+				return;
+
+			Quadric q = quadrics[cf];
+			q.Add(quadrics[ct]);
+
+			Collapse c;
+			c.Cost = (float)q.Error(vertices[to].Position);
+			c.From = from;
+			c.To = to;
+			c.FromVersion = version[cf];
+			c.ToVersion = version[ct];
+			heap.push(c);
+		};
+
+		auto pushCandidates = [&](uint32 c)
+		{
+			for (uint32 t : canonTris[c])
+			{
+				if (!triAlive[t])
+					continue;
+
+				for (int k = 0; k < 3; ++k)
+				{
+					uint32 a = tris[t * 3 + k];
+					uint32 b = tris[t * 3 + (k + 1) % 3];
+					if (canon[a] != c && canon[b] != c)
+						continue;
+
+					pushCollapse(a, b);
+					pushCollapse(b, a);
+				}
+			}
+		};
+
+		auto containsCanon = [&](uint32 t, uint32 c)
+		{
+			return canon[tris[t * 3 + 0]] == c || canon[tris[t * 3 + 1]] == c || canon[tris[t * 3 + 2]] == c;
+		};
+
+		auto gatherNeighbors = [&](uint32 c, std::vector<uint32>& neighbors)
+		{
+			neighbors.clear();
+			for (uint32 t : canonTris[c])
+			{
+				if (!triAlive[t])
+					continue;
+				for (int k = 0; k < 3; ++k)
+				{
+					uint32 n = canon[tris[t * 3 + k]];
+					if (n != c && std::find(neighbors.begin(), neighbors.end(), n) == neighbors.end())
+						neighbors.push_back(n);
+				}
+			}
+		};
+
+		std::vector<uint32> fromNeighbors;
+		std::vector<uint32> toNeighbors;
+
+		auto canCollapse = [&](uint32 from, uint32 to)
+		{
+			uint32 cf = canon[from];
+			uint32 ct = canon[to];
+
+			// 링크 조건: 두 정점의 공통 이웃은 축약 간선을 공유하는 삼각형의 맞은편 정점뿐이어야 한다.
+			uint32 sharedTris = 0;
+			for (uint32 t : canonTris[cf])
+			{
+				if (triAlive[t] && containsCanon(t, ct))
+					sharedTris++;
+			}
+			if (sharedTris == 0)
+				return false;
+
+			gatherNeighbors(cf, fromNeighbors);
+			gatherNeighbors(ct, toNeighbors);
+
+			uint32 commonNeighbors = 0;
+			for (uint32 n : fromNeighbors)
+			{
+				if (std::find(toNeighbors.begin(), toNeighbors.end(), n) != toNeighbors.end())
+					commonNeighbors++;
+			}
+			if (commonNeighbors > sharedTris)
+				return false;
+
+			// 남는 삼각형이 뒤집히거나 넓이가 0이 되면 안 된다.
+			for (uint32 t : canonTris[cf])
+			{
+				if (!triAlive[t] || containsCanon(t, ct))
+					continue;
+
+				XMFLOAT3 p[3];
+				XMFLOAT3 q[3];
+				for (int k = 0; k < 3; ++k)
+				{
+					uint32 v = tris[t * 3 + k];
+					p[k] = vertices[v].Position;
+					q[k] = canon[v] == cf ? vertices[to].Position : p[k];
+				}
+
+				XMVECTOR before = TriangleNormal(p[0], p[1], p[2]);
+				XMVECTOR after = TriangleNormal(q[0], q[1], q[2]);
+				if (XMVectorGetX(XMVector3Dot(before, after)) <= 0.0f)
+					return false;
+			}
+
+			return true;
+		};
+
+		for (uint32 c = 0; c < vertexCount; ++c)
+		{
+			if (canon[c] == c && !locked[c])
+				pushCandidates(c);
+		}
+
+		uint32 liveTris = numTris;
+		double worstCost = 0.0;
+
+		while (liveTris > targetTriangleCount && !heap.empty())
+		{
+			Collapse c = heap.top();
+			heap.pop();
+
+			uint32 cf = canon[c.From];
+			uint32 ct = canon[c.To];
+
+			// 이후 축약으로 오차가 바뀐 후보는 버린다.
+			if (removed[cf] || removed[ct] || c.FromVersion != version[cf] || c.ToVersion != version[ct])
+				continue;
+
+			// 가장 비용이 적은 후보가 한도를 넘으면 더 이상 단순화할 수 없다.
+			if (c.Cost > maxCost)
+				break;
+
+			if (!canCollapse(c.From, c.To))
+				continue;
+
+			for (uint32 t : canonTris[cf])
+			{
+				if (!triAlive[t])
+					continue;
+
+				if (containsCanon(t, ct))
+				{
+					triAlive[t] = 0;
+					liveTris--;
+					continue;
+				}
+
+				for (int k = 0; k < 3; ++k)
+				{
+					if (canon[tris[t * 3 + k]] == cf)
+						tris[t * 3 + k] = c.To;
+				}
+				canonTris[ct].push_back(t);
+			}
+
+			canonTris[cf].clear();
+			removed[cf] = 1;
+			quadrics[ct].Add(quadrics[cf]);
+			version[ct]++;
+			worstCost = std::max(worstCost, (double)c.Cost);
+
+			// 축약된 정점의 삼각형 목록을 정리하고 주변 후보 갱신
+			std::vector<uint32>& toTris = canonTris[ct];
+			toTris.erase(std::remove_if(toTris.begin(), toTris.end(),
+				[&triAlive](uint32 t) { return !triAlive[t]; }), toTris.end());
+			pushCandidates(ct);
+		}
+
+		std::vector<uint32> result;
+		result.reserve(liveTris * 3);
+		for (uint32 t = 0; t < numTris; ++t)
+		{
+			if (triAlive[t])
+				result.insert(result.end(), tris.begin() + t * 3, tris.begin() + t * 3 + 3);
+		}
+
+		if (resultError != nullptr)
+			*resultError = (float)(std::sqrt(worstCost) / meshExtent);
+
+		return result;
+	}
+
+	std::vector<MeshLod> MeshSimplifier::BuildLodChain(
+		const GeometryGenerator::MeshData& meshData,
+		const std::vector<float>& triangleRatios,
+		float maxError)
+	{
+		std::vector<MeshLod> lods;
+
+		uint32 numTris = (uint32)meshData.Indices32.size() / 3;
+		uint32 prevTris = numTris;
+
+		for (float ratio : triangleRatios)
+		{
+			// 모든 단계를 원본에서 단순화하여 단계마다 원본 대비 오차가 maxError 이내가 되도록 한다.
+			MeshLod lod;
+			uint32 target = (uint32)(numTris * ratio);
+			lod.Indices32 = Simplify(meshData, meshData.Indices32, target, maxError, &lod.Error);
+
+			// 오차 한도에 걸려 이전 단계보다 줄지 않았다면 이후 단계도 의미가 없다.
+			uint32 lodTris = (uint32)lod.Indices32.size() / 3;
+			if (lodTris >= prevTris)
+				break;
+
+			prevTris = lodTris;
+			lods.push_back(std::move(lod));
+		}
+
+		return lods;
+	}
+}
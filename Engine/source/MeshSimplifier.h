@@ -0,0 +1,53 @@
+#pragma once
+#include "EngineHeader.h"
+#include "GeometryGenerator.h"
+
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+namespace Engine
+{
+	/// <summary>
+	/// 단순화된 LOD 한 단계. 인덱스는 원본 MeshData의 정점 배열을 그대로 참조한다.
+	/// </summary>
+	struct MeshLod
+	{
+		std::vector<GeometryGenerator::uint32> Indices32;
+		float Error = 0.0f; // 메쉬 크기 대비 상대 오차
+	};
+
+	/// <summary>
+	/// 이차 오차 행렬(QEM)을 이용한 간선 축약 단순화기.
+	/// 정점을 기존 정점 위치로만 축약하므로 모든 LOD가 하나의 정점 버퍼를 공유할 수 있고,
+	/// UV/법선 이음매와 열린 경계의 정점은 움직이지 않는다.
+	/// </summary>
+	class D3D_API MeshSimplifier
+	{
+	public:
+		using uint32 = GeometryGenerator::uint32;
+
+		/// <summary>
+		/// 삼각형 수가 targetTriangleCount 이하가 되거나, 다음 축약의 오차가 maxError를 넘을 때까지 단순화
+		/// </summary>
+		/// <param name="indices">단순화할 인덱스 (meshData.Indices32 또는 이전 LOD)</param>
+		/// <param name="maxError">메쉬 크기(AABB의 가장 긴 변) 대비 허용 오차</param>
+		/// <param name="resultError">실제로 발생한 상대 오차</param>
+		/// <returns>meshData.Vertices를 참조하는 단순화된 인덱스</returns>
+		static std::vector<uint32> Simplify(
+			const GeometryGenerator::MeshData& meshData,
+			const std::vector<uint32>& indices,
+			uint32 targetTriangleCount,
+			float maxError,
+			float* resultError = nullptr);
+
+		/// <summary>
+		/// 원본 삼각형 수 대비 triangleRatios 비율을 목표로 LOD 체인 생성.
+		/// 각 단계는 원본에서 단순화하며, 오차 한도 때문에 목표에 도달하지 못하면 체인이 짧아진다.
+		/// </summary>
+		/// <returns>LOD1부터의 단계들 (LOD0은 원본)</returns>
+		static std::vector<MeshLod> BuildLodChain(
+			const GeometryGenerator::MeshData& meshData,
+			const std::vector<float>& triangleRatios,
+			float maxError);
+	};
+}
+#endif
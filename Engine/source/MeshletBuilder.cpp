@@ -0,0 +1,299 @@
+#include "MeshletBuilder.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+namespace Engine
+{
+	using namespace DirectX;
+	using uint32 = GeometryGenerator::uint32;
+
+	namespace
+	{
+		const uint32 InvalidIndex = ~0u;
+
+		int QuantizeSnorm8(float v)
+		{
+			int q = static_cast<int>(v * 127.0f + (v >= 0.0f ? 0.5f : -0.5f));
+			return std::max(-127, std::min(127, q));
+		}
+
+		float DequantizeSnorm8(uint32 packed, int shift)
+		{
+			return static_cast<float>(static_cast<signed char>((packed >> shift) & 0xFF)) / 127.0f;
+		}
+
+		uint32 PackSnorm8x4(int x, int y, int z, int w)
+		{
+			return (uint32)(x & 0xFF) | ((uint32)(y & 0xFF) << 8) | ((uint32)(z & 0xFF) << 16) | ((uint32)(w & 0xFF) << 24);
+		}
+	}
+
+	MeshletData MeshletBuilder::Build(
+		const GeometryGenerator::MeshData& meshData,
+		uint32 maxVertices,
+		uint32 maxTriangles)
+	{
+		// 로컬 인덱스는 10비트에 압축하고, 메쉬 셰이더 출력 한도를 넘지 않도록 제한
+		maxVertices = std::max(3u, std::min(maxVertices, (uint32)MaxVertices));
+		maxTriangles = std::max(1u, std::min(maxTriangles, (uint32)MaxTriangles));
+
+		const std::vector<uint32>& indices = meshData.Indices32;
+		uint32 vertexCount = (uint32)meshData.Vertices.size();
+		uint32 numTris = (uint32)indices.size() / 3;
+
+		MeshletData result;
+		result.Meshlets.reserve(numTris / maxTriangles + 1);
+		result.PrimitiveIndices.reserve(numTris);
+		result.UniqueVertexIndices.reserve(vertexCount + vertexCount / 2);
+
+		// 정점 -> 삼각형 인접 리스트 (각 정점의 구간 앞쪽 liveCount개가 아직 배정되지 않은 삼각형)
+		std::vector<uint32> liveCount(vertexCount, 0);
+		for (uint32 index : indices)
+			liveCount[index]++;
+
+		std::vector<uint32> offsets(vertexCount + 1, 0);
+		for (uint32 v = 0; v < vertexCount; ++v)
+			offsets[v + 1] = offsets[v] + liveCount[v];
+
+		std::vector<uint32> adjacency(indices.size());
+		{
+			std::vector<uint32> cursor(offsets.begin(), offsets.end() - 1);
+			for (uint32 i = 0; i < (uint32)indices.size(); ++i)
+				adjacency[cursor[indices[i]]++] = i / 3;
+		}
+
+		std::vector<char> emitted(numTris, 0);
+		// 현재 메쉬렛 안에서의 로컬 정점 번호
+		std::vector<uint32> localIndex(vertexCount, InvalidIndex);
+
+		Meshlet current;
+
+		auto countNewVertices = [&](uint32 t)
+		{
+			uint32 i0 = indices[t * 3 + 0];
+			uint32 i1 = indices[t * 3 + 1];
+			uint32 i2 = indices[t * 3 + 2];
+
+			uint32 count = 0;
+			count += localIndex[i0] == InvalidIndex ? 1 : 0;
+			count += localIndex[i1] == InvalidIndex && i1 != i0 ? 1 : 0;
+			count += localIndex[i2] == InvalidIndex && i2 != i0 && i2 != i1 ? 1 : 0;
+			return count;
+		};
+
+		auto flush = [&]()
+		{
+			if (current.TriangleCount == 0)
+				return;
+
+			for (uint32 i = 0; i < current.VertexCount; ++i)
+				localIndex[result.UniqueVertexIndices[current.VertexOffset + i]] = InvalidIndex;
+
+			result.Meshlets.push_back(current);
+
+			current.VertexOffset = (uint32)result.UniqueVertexIndices.size();
+			current.TriangleOffset = (uint32)result.PrimitiveIndices.size();
+			current.VertexCount = 0;
+			current.TriangleCount = 0;
+		};
+
+		uint32 nextCandidate = 0;
+		for (uint32 emittedCount = 0; emittedCount < numTris; ++emittedCount)
+		{
+			// 현재 메쉬렛의 정점과 연결된 삼각형 중 새 정점이 가장 적게 필요한 삼각형을 선택하고,
+			// 같다면 남은 이웃이 적은(경계에 있는) 삼각형을 먼저 골라 고립된 삼각형이 남지 않게 한다.
+			uint32 best = InvalidIndex;
+			uint32 bestNewVertices = 4;
+			uint32 bestLiveCount = ~0u;
+
+			for (uint32 i = 0; i < current.VertexCount; ++i)
+			{
+				uint32 v = result.UniqueVertexIndices[current.VertexOffset + i];
+				for (uint32 a = offsets[v]; a < offsets[v] + liveCount[v]; ++a)
+				{
+					uint32 t = adjacency[a];
+					uint32 newVertices = countNewVertices(t);
+					uint32 live =
+						liveCount[indices[t * 3 + 0]] +
+						liveCount[indices[t * 3 + 1]] +
+						liveCount[indices[t * 3 + 2]];
+
+					if (newVertices < bestNewVertices || (newVertices == bestNewVertices && live < bestLiveCount))
+					{
+						best = t;
+						bestNewVertices = newVertices;
+						bestLiveCount = live;
+					}
+				}
+			}
+
+			// 연결된 삼각형이 없다면 아직 배정되지 않은 다음 삼각형에서 다시 시작
+			if (best == InvalidIndex)
+			{
+				while (emitted[nextCandidate])
+					++nextCandidate;
+				best = nextCandidate;
+				bestNewVertices = countNewVertices(best);
+			}
+
+			if (current.VertexCount + bestNewVertices > maxVertices || current.TriangleCount + 1u > maxTriangles)
+				flush();
+
+			uint32 local[3];
+			for (int k = 0; k < 3; ++k)
+			{
+				uint32 v = indices[best * 3 + k];
+				if (localIndex[v] == InvalidIndex)
+				{
+					localIndex[v] = current.VertexCount++;
+					result.UniqueVertexIndices.push_back(v);
+				}
+				local[k] = localIndex[v];
+
+				// 배정된 삼각형을 인접 리스트에서 제거
+				uint32* begin = &adjacency[offsets[v]];
+				uint32* end = begin + liveCount[v];
+				*std::find(begin, end, best) = *(end - 1);
+				liveCount[v]--;
+			}
+
+			result.PrimitiveIndices.push_back(PackTriangle(local[0], local[1], local[2]));
+			current.TriangleCount++;
+			emitted[best] = 1;
+		}
+		flush();
+
+		result.Bounds.reserve(result.Meshlets.size());
+		for (const Meshlet& meshlet : result.Meshlets)
+			result.Bounds.push_back(ComputeBounds(result, meshlet, meshData.Vertices));
+
+		return result;
+	}
+
+	MeshletBounds MeshletBuilder::ComputeBounds(
+		const MeshletData& meshlets,
+		const Meshlet& meshlet,
+		const std::vector<GeometryGenerator::Vertex>& vertices)
+	{
+		assert(meshlet.TriangleCount <= MaxTriangles);
+
+		MeshletBounds bounds;
+		if (meshlet.TriangleCount == 0)
+			return bounds;
+
+		const uint32* vertexIndices = &meshlets.UniqueVertexIndices[meshlet.VertexOffset];
+		const uint32* triangles = &meshlets.PrimitiveIndices[meshlet.TriangleOffset];
+
+		//
+		// 경계 구
+		//
+
+		XMVECTOR vMin = XMVectorSet(+FLT_MAX, +FLT_MAX, +FLT_MAX, 0.0f);
+		XMVECTOR vMax = XMVectorSet(-FLT_MAX, -FLT_MAX, -FLT_MAX, 0.0f);
+		for (uint32 i = 0; i < meshlet.VertexCount; ++i)
+		{
+			XMVECTOR p = XMLoadFloat3(&vertices[vertexIndices[i]].Position);
+			vMin = XMVectorMin(vMin, p);
+			vMax = XMVectorMax(vMax, p);
+		}
+
+		XMVECTOR center = 0.5f * (vMin + vMax);
+		float radius = 0.0f;
+		for (uint32 i = 0; i < meshlet.VertexCount; ++i)
+		{
+			XMVECTOR p = XMLoadFloat3(&vertices[vertexIndices[i]].Position);
+			radius = std::max(radius, XMVectorGetX(XMVector3Length(p - center)));
+		}
+
+		XMStoreFloat3(&bounds.Center, center);
+		bounds.Radius = radius;
+
+		//
+		// 법선 원뿔
+		//
+
+		XMVECTOR normals[MaxTriangles];
+		XMVECTOR corners[MaxTriangles];
+		uint32 normalCount = 0;
+		XMVECTOR axis = XMVectorZero();
+
+		for (uint32 t = 0; t < meshlet.TriangleCount; ++t)
+		{
+			uint32 i0, i1, i2;
+			UnpackTriangle(triangles[t], i0, i1, i2);
+
+			XMVECTOR p0 = XMLoadFloat3(&vertices[vertexIndices[i0]].Position);
+			XMVECTOR p1 = XMLoadFloat3(&vertices[vertexIndices[i1]].Position);
+			XMVECTOR p2 = XMLoadFloat3(&vertices[vertexIndices[i2]].Position);
+
+			// 시계 방향 감기(왼손 좌표계)의 앞면 법선
+			XMVECTOR n = XMVector3Cross(p1 - p0, p2 - p0);
+			float length = XMVectorGetX(XMVector3Length(n));
+
+			// 넓이가 0인 삼각형은 화면에 그려지지 않으므로 원뿔 계산에서 제외
+			if (length <= 0.0f)
+				continue;
+
+			normals[normalCount] = (1.0f / length) * n;
+			corners[normalCount] = p0;
+			axis = axis + normals[normalCount];
+			normalCount++;
+		}
+
+		// 원뿔이 반구보다 넓으면 컬링할 수 없으므로 항상 통과하도록 설정
+		XMStoreFloat3(&bounds.ConeApex, center);
+		bounds.NormalCone = PackSnorm8x4(0, 0, 0, 127);
+
+		if (normalCount == 0 || XMVectorGetX(XMVector3LengthSq(axis)) <= 0.0f)
+			return bounds;
+
+		// 실제 컬링에 사용되는 양자화된 축을 기준으로 원뿔을 계산해야 보수적인 결과가 나온다.
+		XMFLOAT3 unitAxis;
+		XMStoreFloat3(&unitAxis, XMVector3Normalize(axis));
+		int qx = QuantizeSnorm8(unitAxis.x);
+		int qy = QuantizeSnorm8(unitAxis.y);
+		int qz = QuantizeSnorm8(unitAxis.z);
+
+		XMFLOAT3 quantizedAxis;
+		float unusedCutoff;
+		UnpackNormalCone(PackSnorm8x4(qx, qy, qz, 0), quantizedAxis, unusedCutoff);
+		axis = XMLoadFloat3(&quantizedAxis);
+
+		float minDot = 1.0f;
+		for (uint32 i = 0; i < normalCount; ++i)
+			minDot = std::min(minDot, XMVectorGetX(XMVector3Dot(axis, normals[i])));
+
+		if (minDot <= 0.1f)
+			return bounds;
+
+		// 모든 삼각형 평면의 뒤쪽에 오도록 원뿔 꼭짓점을 축 반대 방향으로 이동
+		float maxT = 0.0f;
+		for (uint32 i = 0; i < normalCount; ++i)
+		{
+			float dc = XMVectorGetX(XMVector3Dot(center - corners[i], normals[i]));
+			float dn = XMVectorGetX(XMVector3Dot(axis, normals[i]));
+			maxT = std::max(maxT, dc / dn);
+		}
+		XMStoreFloat3(&bounds.ConeApex, center - maxT * axis);
+
+		// cutoff = sin(원뿔 반각) 를 올림하여 양자화
+		float cutoff = sqrtf(1.0f - minDot * minDot);
+		int qCutoff = std::min(127, static_cast<int>(ceilf(cutoff * 127.0f)));
+		bounds.NormalCone = PackSnorm8x4(qx, qy, qz, qCutoff);
+
+		return bounds;
+	}
+
+	void MeshletBuilder::UnpackNormalCone(uint32 normalCone, XMFLOAT3& axis, float& cutoff)
+	{
+		XMVECTOR a = XMVectorSet(
+			DequantizeSnorm8(normalCone, 0),
+			DequantizeSnorm8(normalCone, 8),
+			DequantizeSnorm8(normalCone, 16),
+			0.0f);
+		XMStoreFloat3(&axis, XMVector3Normalize(a));
+		cutoff = DequantizeSnorm8(normalCone, 24);
+	}
+}
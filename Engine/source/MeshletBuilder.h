@@ -0,0 +1,96 @@
+#pragma once
+#include "EngineHeader.h"
+#include "GeometryGenerator.h"
+
+#ifndef MESHLETBUILDER_H
+#define MESHLETBUILDER_H
+namespace Engine
+{
+	/// <summary>
+	/// 메쉬렛 하나가 참조하는 정점/삼각형 구간 (12 바이트)
+	/// </summary>
+	struct Meshlet
+	{
+		GeometryGenerator::uint32 VertexOffset = 0;   // MeshletData::UniqueVertexIndices 시작 위치
+		GeometryGenerator::uint32 TriangleOffset = 0; // MeshletData::PrimitiveIndices 시작 위치
+		GeometryGenerator::uint16 VertexCount = 0;
+		GeometryGenerator::uint16 TriangleCount = 0;
+	};
+
+	/// <summary>
+	/// 메쉬렛 컬링용 경계 정보 (32 바이트)
+	/// </summary>
+	struct MeshletBounds
+	{
+		// 경계 구
+		DirectX::XMFLOAT3 Center = { 0.0f, 0.0f, 0.0f };
+		float Radius = 0.0f;
+
+		// 법선 원뿔. 아래 조건을 만족하면 메쉬렛의 모든 삼각형이 카메라를 등지고 있다.
+		// dot(normalize(ConeApex - cameraPos), ConeAxis) >= ConeCutoff
+		DirectX::XMFLOAT3 ConeApex = { 0.0f, 0.0f, 0.0f };
+		GeometryGenerator::uint32 NormalCone = 0; // x, y, z: 원뿔 축(snorm8), w: ConeCutoff(snorm8)
+	};
+
+	/// <summary>
+	/// MeshletBuilder의 출력
+	/// </summary>
+	struct MeshletData
+	{
+		std::vector<Meshlet> Meshlets;
+		std::vector<MeshletBounds> Bounds; // Meshlets와 같은 순서
+
+		// 메쉬렛 로컬 정점 번호 -> MeshData 정점 번호
+		std::vector<GeometryGenerator::uint32> UniqueVertexIndices;
+		// 메쉬렛 로컬 정점 번호 3개를 10:10:10 비트로 압축한 삼각형
+		std::vector<GeometryGenerator::uint32> PrimitiveIndices;
+	};
+
+	/// <summary>
+	/// 임의의 MeshData를 클러스터 컬링용 메쉬렛으로 분할하는 CPU 전용 빌더
+	/// </summary>
+	class D3D_API MeshletBuilder
+	{
+	public:
+		using uint32 = GeometryGenerator::uint32;
+
+		static const uint32 MaxVertices = 64;
+		static const uint32 MaxTriangles = 124;
+
+		/// <summary>
+		/// 인접한 삼각형을 우선적으로 묶어 메쉬렛을 생성하고 경계 정보를 계산
+		/// </summary>
+		/// <param name="maxVertices">메쉬렛당 최대 정점 수 (MaxVertices 이하)</param>
+		/// <param name="maxTriangles">메쉬렛당 최대 삼각형 수 (MaxTriangles 이하)</param>
+		static MeshletData Build(
+			const GeometryGenerator::MeshData& meshData,
+			uint32 maxVertices = MaxVertices,
+			uint32 maxTriangles = MaxTriangles);
+
+		/// <summary>
+		/// 메쉬렛 하나의 경계 구와 법선 원뿔 계산
+		/// </summary>
+		static MeshletBounds ComputeBounds(
+			const MeshletData& meshlets,
+			const Meshlet& meshlet,
+			const std::vector<GeometryGenerator::Vertex>& vertices);
+
+		inline static uint32 PackTriangle(uint32 i0, uint32 i1, uint32 i2)
+		{
+			return (i0 & 0x3FF) | ((i1 & 0x3FF) << 10) | ((i2 & 0x3FF) << 20);
+		}
+
+		inline static void UnpackTriangle(uint32 packed, uint32& i0, uint32& i1, uint32& i2)
+		{
+			i0 = packed & 0x3FF;
+			i1 = (packed >> 10) & 0x3FF;
+			i2 = (packed >> 20) & 0x3FF;
+		}
+
+		/// <summary>
+		/// NormalCone에서 원뿔 축과 ConeCutoff 복원
+		/// </summary>
+		static void UnpackNormalCone(uint32 normalCone, DirectX::XMFLOAT3& axis, float& cutoff);
+	};
+}
+#endif
@@ -0,0 +1,67 @@
+#include "ObjectBinding.h"
+
+namespace Engine
+{
+	void ObjectBinding::InitRootParameter(ObjectBindingMode mode, CD3DX12_ROOT_PARAMETER& parameter, CD3DX12_DESCRIPTOR_RANGE& range,
+		UINT shaderRegister, UINT registerSpace)
+	{
+		switch (mode)
+		{
+		case ObjectBindingMode::DescriptorTable:
+			range.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, shaderRegister, registerSpace);
+			parameter.InitAsDescriptorTable(1, &range);
+			break;
+		case ObjectBindingMode::RootConstantBuffer:
+			parameter.InitAsConstantBufferView(shaderRegister, registerSpace);
+			break;
+		case ObjectBindingMode::RootConstantIndex:
+			parameter.InitAsConstants(1, shaderRegister, registerSpace);
+			break;
+		}
+	}
+
+	void ObjectBinding::InitBufferRootParameter(CD3DX12_ROOT_PARAMETER& parameter, UINT shaderRegister, UINT registerSpace)
+	{
+		parameter.InitAsShaderResourceView(shaderRegister, registerSpace);
+	}
+
+	void ObjectBinding::CreateDescriptors(ID3D12Device* device, D3D12_CPU_DESCRIPTOR_HANDLE heapStart, UINT descriptorSize,
+		std::uint32_t frame, D3D12_GPU_VIRTUAL_ADDRESS bufferAddress) const
+	{
+		mLayout.ForEachDescriptor(frame, bufferAddress, [&](std::uint32_t index, std::uint64_t address, std::uint32_t byteSize)
+		{
+			D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
+			cbvDesc.BufferLocation = address;
+			cbvDesc.SizeInBytes = byteSize;
+			device->CreateConstantBufferView(&cbvDesc, CD3DX12_CPU_DESCRIPTOR_HANDLE(heapStart, index, descriptorSize));
+		});
+	}
+
+	void ObjectBinding::Bind(ID3D12GraphicsCommandList* cmdList, UINT rootParameterIndex, std::uint32_t frame, std::uint32_t object,
+		D3D12_GPU_VIRTUAL_ADDRESS bufferAddress, D3D12_GPU_DESCRIPTOR_HANDLE heapStart, UINT descriptorSize) const
+	{
+		ObjectRootArgument argument = mLayout.GetRootArgument(frame, object, bufferAddress, heapStart.ptr, descriptorSize);
+		switch (argument.Mode)
+		{
+		case ObjectBindingMode::DescriptorTable:
+		{
+			D3D12_GPU_DESCRIPTOR_HANDLE handle;
+			handle.ptr = argument.Value;
+			cmdList->SetGraphicsRootDescriptorTable(rootParameterIndex, handle);
+			break;
+		}
+		case ObjectBindingMode::RootConstantBuffer:
+			cmdList->SetGraphicsRootConstantBufferView(rootParameterIndex, argument.Value);
+			break;
+		case ObjectBindingMode::RootConstantIndex:
+			cmdList->SetGraphicsRoot32BitConstant(rootParameterIndex, (UINT)argument.Value, 0);
+			break;
+		}
+	}
+
+	void ObjectBinding::BindInstanceBase(ID3D12GraphicsCommandList* cmdList, UINT rootParameterIndex, std::uint32_t instanceBase) const
+	{
+		ObjectRootArgument argument = mLayout.GetInstanceBaseArgument(instanceBase);
+		cmdList->SetGraphicsRoot32BitConstant(rootParameterIndex, (UINT)argument.Value, 0);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "EngineHeader.h"
+#include "ObjectBindingLayout.h"
+#include "Util.h"
+
+#ifndef OBJECTBINDING_H
+#define OBJECTBINDING_H
+namespace Engine
+{
+	/// <summary>
+	/// ObjectBindingLayout의 방식대로 루트 매개변수를 만들고 그리기마다 객체 인자를 설정한다.
+	/// 루트 CBV와 루트 상수 방식은 서술자를 만들지 않으므로 객체 수가 늘어도 준비 비용과 힙 크기가 그대로다.
+	/// </summary>
+	class D3D_API ObjectBinding
+	{
+	public:
+		ObjectBinding() = default;
+		explicit ObjectBinding(const ObjectBindingLayout& layout) : mLayout(layout) {}
+
+		/// <summary>
+		/// 그리기마다 바뀌는 객체 인자를 받을 루트 매개변수를 채운다.
+		/// DescriptorTable은 CBV 하나짜리 테이블(range가 저장소), RootConstantBuffer는 루트 CBV,
+		/// RootConstantIndex는 32비트 루트 상수 하나다. RootConstantIndex의 객체 버퍼는 InitBufferRootParameter로 따로 추가한다.
+		/// 루트 시그니처는 객체 수를 알기 전에 만들 수 있으므로 방식만 받는다.
+		/// </summary>
+		static void InitRootParameter(ObjectBindingMode mode, CD3DX12_ROOT_PARAMETER& parameter, CD3DX12_DESCRIPTOR_RANGE& range,
+			UINT shaderRegister, UINT registerSpace = 0);
+
+		/// <summary>
+		/// RootConstantIndex 방식에서 객체 구조적 버퍼를 읽을 루트 SRV
+		/// </summary>
+		static void InitBufferRootParameter(CD3DX12_ROOT_PARAMETER& parameter, UINT shaderRegister, UINT registerSpace = 0);
+
+		/// <summary>
+		/// DescriptorTable 방식에서 frame의 객체 CBV를 heapStart 기준 위치에 만든다. 다른 방식은 아무것도 하지 않는다.
+		/// </summary>
+		void CreateDescriptors(ID3D12Device* device, D3D12_CPU_DESCRIPTOR_HANDLE heapStart, UINT descriptorSize,
+			std::uint32_t frame, D3D12_GPU_VIRTUAL_ADDRESS bufferAddress) const;
+
+		/// <summary>
+		/// object의 인자를 rootParameterIndex에 설정
+		/// </summary>
+		/// <param name="bufferAddress">frame의 객체 버퍼 주소 (RootConstantBuffer)</param>
+		/// <param name="heapStart">객체 CBV가 들어 있는 셰이더 가시 힙의 시작 (DescriptorTable)</param>
+		void Bind(ID3D12GraphicsCommandList* cmdList, UINT rootParameterIndex, std::uint32_t frame, std::uint32_t object,
+			D3D12_GPU_VIRTUAL_ADDRESS bufferAddress, D3D12_GPU_DESCRIPTOR_HANDLE heapStart = {}, UINT descriptorSize = 0) const;
+
+		/// <summary>
+		/// 인스턴싱 묶음의 시작 위치를 rootParameterIndex의 루트 상수에 설정 (RootConstantIndex 방식만).
+		/// 셰이더는 객체 인덱스 대신 이 값에 SV_InstanceID를 더한다. (ObjectBindingLayout::GetInstanceBaseArgument)
+		/// </summary>
+		void BindInstanceBase(ID3D12GraphicsCommandList* cmdList, UINT rootParameterIndex, std::uint32_t instanceBase) const;
+
+		const ObjectBindingLayout& GetLayout() const { return mLayout; }
+
+	private:
+		ObjectBindingLayout mLayout;
+	};
+}
+#endif
@@ -0,0 +1,134 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+
+#ifndef OBJECTBINDINGLAYOUT_H
+#define OBJECTBINDINGLAYOUT_H
+namespace Engine
+{
+	/// <summary>
+	/// 객체별 상수를 셰이더에 연결하는 방식
+	/// </summary>
+	enum class ObjectBindingMode : std::uint32_t
+	{
+		DescriptorTable,     // 객체마다 CBV 서술자를 만들고 그리기마다 서술자 테이블 설정 (서술자 수 = 객체 수 x 프레임 수)
+		RootConstantBuffer,  // 그리기마다 객체 상수의 GPU 주소를 루트 CBV로 설정 (서술자 없음)
+		RootConstantIndex,   // 객체 상수를 구조적 버퍼에 두고 그리기마다 객체 인덱스를 루트 상수로 설정 (서술자 없음)
+	};
+
+	/// <summary>
+	/// 그리기 하나에 설정하는 객체 루트 인자. Value의 의미는 Mode에 따라 다르다.
+	/// DescriptorTable은 GPU 서술자 핸들(ptr), RootConstantBuffer는 객체 상수의 GPU 주소, RootConstantIndex는 객체 인덱스(32비트)다.
+	/// </summary>
+	struct ObjectRootArgument
+	{
+		ObjectBindingMode Mode = ObjectBindingMode::RootConstantIndex;
+		std::uint64_t Value = 0;
+	};
+
+	/// <summary>
+	/// 방식과 객체 수로 정해지는 객체 버퍼의 배치와 필요한 서술자 수.
+	/// 장치 없이 계산되므로 방식마다의 준비 비용(서술자 수, 버퍼 크기)을 비교할 수 있다.
+	/// </summary>
+	struct ObjectBindingLayout
+	{
+		ObjectBindingMode Mode = ObjectBindingMode::RootConstantIndex;
+		std::uint32_t ObjectCount = 0;
+		std::uint32_t FrameCount = 1;
+		std::uint32_t ElementByteSize = 0;  // 객체 하나가 버퍼에서 차지하는 크기 (CBV로 읽는 방식은 256 바이트 정렬)
+		std::uint64_t BufferByteSize = 0;   // 프레임 리소스 하나의 객체 버퍼 크기
+		std::uint32_t DescriptorCount = 0;  // 모든 프레임에 필요한 객체 CBV 서술자 수
+
+		/// <param name="objectByteSize">객체 상수 구조체 크기</param>
+		/// <param name="frameCount">객체 버퍼를 따로 가지는 프레임 리소스 수</param>
+		static ObjectBindingLayout Create(ObjectBindingMode mode, std::uint32_t objectCount, std::uint32_t objectByteSize, std::uint32_t frameCount)
+		{
+			ObjectBindingLayout layout;
+			layout.Mode = mode;
+			layout.ObjectCount = objectCount;
+			layout.FrameCount = frameCount;
+			layout.ElementByteSize = UsesConstantBufferView(mode) ? (objectByteSize + 255) & ~255u : objectByteSize;
+			layout.BufferByteSize = (std::uint64_t)layout.ElementByteSize * objectCount;
+			layout.DescriptorCount = mode == ObjectBindingMode::DescriptorTable ? objectCount * frameCount : 0;
+			return layout;
+		}
+
+		/// <summary>
+		/// 셰이더가 객체 상수를 상수 버퍼로 읽는지 (아니면 구조적 버퍼)
+		/// </summary>
+		static bool UsesConstantBufferView(ObjectBindingMode mode)
+		{
+			return mode != ObjectBindingMode::RootConstantIndex;
+		}
+		bool UsesConstantBufferView() const { return UsesConstantBufferView(Mode); }
+
+		/// <summary>
+		/// DescriptorTable 방식에서 frame의 object CBV가 놓이는 서술자 위치
+		/// </summary>
+		std::uint32_t GetDescriptorIndex(std::uint32_t frame, std::uint32_t object) const
+		{
+			return frame * ObjectCount + object;
+		}
+
+		/// <summary>
+		/// 객체 버퍼 시작 주소가 bufferAddress일 때 object 상수의 주소 (RootConstantBuffer 방식의 루트 CBV)
+		/// </summary>
+		std::uint64_t GetObjectAddress(std::uint64_t bufferAddress, std::uint32_t object) const
+		{
+			return bufferAddress + (std::uint64_t)object * ElementByteSize;
+		}
+
+		/// <summary>
+		/// frame의 object를 그릴 때 설정할 루트 인자
+		/// </summary>
+		/// <param name="bufferAddress">frame의 객체 버퍼 주소 (RootConstantBuffer)</param>
+		/// <param name="heapStart">객체 CBV가 들어 있는 셰이더 가시 힙 시작의 GPU 핸들 값 (DescriptorTable)</param>
+		ObjectRootArgument GetRootArgument(std::uint32_t frame, std::uint32_t object, std::uint64_t bufferAddress,
+			std::uint64_t heapStart, std::uint32_t descriptorSize) const
+		{
+			ObjectRootArgument argument;
+			argument.Mode = Mode;
+			switch (Mode)
+			{
+			case ObjectBindingMode::DescriptorTable:
+				argument.Value = heapStart + (std::uint64_t)GetDescriptorIndex(frame, object) * descriptorSize;
+				break;
+			case ObjectBindingMode::RootConstantBuffer:
+				argument.Value = GetObjectAddress(bufferAddress, object);
+				break;
+			case ObjectBindingMode::RootConstantIndex:
+				argument.Value = object;
+				break;
+			}
+			return argument;
+		}
+
+		/// <summary>
+		/// 인스턴싱 묶음을 그릴 때 설정할 루트 인자. RootConstantIndex 방식에서 객체 인덱스 대신 묶음의 시작 위치를
+		/// 같은 루트 상수로 넘기고, 셰이더는 여기에 SV_InstanceID를 더해 인스턴스별 객체 인덱스 표를 읽는다.
+		/// 다른 방식은 그리기마다 객체 하나를 가리키므로 인스턴싱에 쓸 수 없다.
+		/// </summary>
+		ObjectRootArgument GetInstanceBaseArgument(std::uint32_t instanceBase) const
+		{
+			assert(Mode == ObjectBindingMode::RootConstantIndex);
+			ObjectRootArgument argument;
+			argument.Mode = ObjectBindingMode::RootConstantIndex;
+			argument.Value = instanceBase;
+			return argument;
+		}
+
+		/// <summary>
+		/// frame의 객체 버퍼에 대해 만들어야 하는 서술자마다 func(descriptorIndex, objectAddress, byteSize) 호출.
+		/// DescriptorTable 방식이 아니면 호출하지 않는다.
+		/// </summary>
+		template<typename TFunc>
+		void ForEachDescriptor(std::uint32_t frame, std::uint64_t bufferAddress, TFunc func) const
+		{
+			if (Mode != ObjectBindingMode::DescriptorTable)
+				return;
+			for (std::uint32_t object = 0; object < ObjectCount; ++object)
+				func(GetDescriptorIndex(frame, object), GetObjectAddress(bufferAddress, object), ElementByteSize);
+		}
+	};
+}
+#endif
@@ -0,0 +1,79 @@
+#include "ParallelCommandRecorder.h"
+
+namespace Engine
+{
+	using Microsoft::WRL::ComPtr;
+
+	ParallelCommandRecorder::ParallelCommandRecorder(ID3D12Device* device, JobSystem* jobs, D3D12_COMMAND_LIST_TYPE type)
+		: mDevice(device), mJobs(jobs), mType(type)
+	{
+	}
+
+	ParallelCommandRecorder::~ParallelCommandRecorder()
+	{
+	}
+
+	void ParallelCommandRecorder::Record(
+		std::uint64_t completedFenceValue,
+		const std::vector<RecordRange>& ranges,
+		ID3D12PipelineState* initialState,
+		const RecordFunction& record)
+	{
+		// 할당자 풀과 목록 생성은 이 스레드에서만 다루고, 기록만 작업 스레드에 나눈다.
+		mRecordedLists.clear();
+		for (size_t i = 0; i < ranges.size(); ++i)
+		{
+			ComPtr<ID3D12CommandAllocator> allocator;
+			if (mAllocatorPool.TryAcquire(completedFenceValue, allocator))
+			{
+				ThrowIfFailed(allocator->Reset());
+			}
+			else
+			{
+				ThrowIfFailed(mDevice->CreateCommandAllocator(mType, IID_PPV_ARGS(&allocator)));
+			}
+
+			if (i >= mCommandLists.size())
+			{
+				ComPtr<ID3D12GraphicsCommandList> cmdList;
+				ThrowIfFailed(mDevice->CreateCommandList(
+					0,
+					mType,
+					allocator.Get(),
+					initialState,
+					IID_PPV_ARGS(cmdList.GetAddressOf())));
+				mCommandLists.push_back(cmdList);
+			}
+			else
+			{
+				ThrowIfFailed(mCommandLists[i]->Reset(allocator.Get(), initialState));
+			}
+
+			mFrameAllocators.push_back(allocator);
+			mRecordedLists.push_back(mCommandLists[i].Get());
+		}
+
+		mJobs->ParallelFor(ranges.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t partIndex = begin; partIndex < end; ++partIndex)
+			{
+				ID3D12GraphicsCommandList* cmdList = mCommandLists[partIndex].Get();
+				record(cmdList, ranges[partIndex], partIndex);
+				ThrowIfFailed(cmdList->Close());
+			}
+		});
+	}
+
+	void ParallelCommandRecorder::Execute(ID3D12CommandQueue* queue)
+	{
+		if (!mRecordedLists.empty())
+			queue->ExecuteCommandLists((UINT)mRecordedLists.size(), mRecordedLists.data());
+	}
+
+	void ParallelCommandRecorder::EndFrame(std::uint64_t fenceValue)
+	{
+		for (ComPtr<ID3D12CommandAllocator>& allocator : mFrameAllocators)
+			mAllocatorPool.Release(std::move(allocator), fenceValue);
+		mFrameAllocators.clear();
+	}
+}
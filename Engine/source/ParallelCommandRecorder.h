@@ -0,0 +1,64 @@
+#pragma once
+#include "EngineHeader.h"
+#include "ParallelRecording.h"
+#include "JobSystem.h"
+#include "Util.h"
+#include <vector>
+
+#ifndef PARALLELCOMMANDRECORDER_H
+#define PARALLELCOMMANDRECORDER_H
+namespace Engine
+{
+	/// <summary>
+	/// 렌더 아이템 구간마다 별도의 명령 목록을 두고 JobSystem의 스레드들이 동시에 기록한다.
+	/// 명령 할당자는 풀에서 구간(스레드)마다 하나씩 꺼내 쓰고, 프레임의 펜스가 통과하면 다시 재사용된다.
+	/// 기록된 목록들은 구간 순서대로 하나의 ExecuteCommandLists로 제출된다.
+	/// </summary>
+	class D3D_API ParallelCommandRecorder
+	{
+	public:
+		using RecordFunction = std::function<void(ID3D12GraphicsCommandList* cmdList, const RecordRange& range, size_t partIndex)>;
+
+		ParallelCommandRecorder(ID3D12Device* device, JobSystem* jobs, D3D12_COMMAND_LIST_TYPE type = D3D12_COMMAND_LIST_TYPE_DIRECT);
+		ParallelCommandRecorder(const ParallelCommandRecorder& rhs) = delete;
+		ParallelCommandRecorder& operator=(const ParallelCommandRecorder& rhs) = delete;
+		~ParallelCommandRecorder();
+
+		/// <summary>
+		/// ranges마다 명령 목록을 initialState로 Reset한 뒤 record를 병렬로 호출하고 목록을 닫는다.
+		/// </summary>
+		/// <param name="completedFenceValue">재사용할 할당자를 고르기 위한 현재 완료된 펜스 값</param>
+		void Record(
+			std::uint64_t completedFenceValue,
+			const std::vector<RecordRange>& ranges,
+			ID3D12PipelineState* initialState,
+			const RecordFunction& record);
+
+		/// <summary>
+		/// 마지막 Record로 기록한 목록들을 한 번에 제출
+		/// </summary>
+		void Execute(ID3D12CommandQueue* queue);
+
+		/// <summary>
+		/// 이번 프레임에 사용한 할당자를 풀에 반환. fenceValue가 완료된 뒤에 다시 꺼내진다.
+		/// </summary>
+		void EndFrame(std::uint64_t fenceValue);
+
+		size_t GetRecordedListCount() const { return mRecordedLists.size(); }
+		size_t GetPooledAllocatorCount() const { return mAllocatorPool.GetPooledCount(); }
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device> mDevice;
+		JobSystem* mJobs;
+		D3D12_COMMAND_LIST_TYPE mType;
+
+		FencedPool<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> mAllocatorPool;
+		// 이번 프레임에 구간별로 꺼낸 할당자 (EndFrame에서 풀로 반환)
+		std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> mFrameAllocators;
+
+		// 명령 목록은 제출 직후 Reset할 수 있으므로 구간 번호별로 계속 재사용한다.
+		std::vector<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>> mCommandLists;
+		std::vector<ID3D12CommandList*> mRecordedLists;
+	};
+}
+#endif
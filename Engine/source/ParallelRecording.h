@@ -0,0 +1,106 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#ifndef PARALLELRECORDING_H
+#define PARALLELRECORDING_H
+namespace Engine
+{
+	/// <summary>
+	/// 한 명령 목록에 기록할 렌더 아이템 구간 [Begin, End)
+	/// </summary>
+	struct RecordRange
+	{
+		size_t Begin = 0;
+		size_t End = 0;
+	};
+
+	/// <summary>
+	/// 아이템들을 비용 합이 비슷한 연속 구간으로 나눈다.
+	/// 구간을 순서대로 제출하면 한 스레드에서 기록한 것과 그리기 순서가 같다.
+	/// </summary>
+	/// <param name="costs">아이템별 기록 비용 (예: 그리기 호출 수나 인덱스 수)</param>
+	/// <param name="maxParts">최대 구간 수 (보통 기록 스레드 수)</param>
+	/// <param name="minPartCost">구간 하나가 가져야 할 최소 비용. 작업이 적으면 명령 목록을 늘리지 않는다.</param>
+	inline std::vector<RecordRange> PartitionRecordRanges(
+		const std::vector<std::uint64_t>& costs,
+		size_t maxParts,
+		std::uint64_t minPartCost = 1)
+	{
+		std::vector<RecordRange> ranges;
+		if (costs.empty())
+			return ranges;
+
+		std::uint64_t totalCost = 0;
+		for (std::uint64_t cost : costs)
+			totalCost += cost;
+
+		size_t partCount = std::min(std::max<size_t>(maxParts, 1), costs.size());
+		if (minPartCost > 0)
+			partCount = std::min<size_t>(partCount, std::max<std::uint64_t>(totalCost / minPartCost, 1));
+
+		ranges.reserve(partCount);
+		RecordRange range;
+		std::uint64_t accumulated = 0;
+		for (size_t i = 0; i < costs.size(); ++i)
+		{
+			accumulated += costs[i];
+
+			size_t partsLeft = partCount - ranges.size();
+			size_t itemsLeft = costs.size() - (i + 1);
+			// k번째 구간은 누적 비용이 전체의 (k + 1) / partCount에 도달하면 끝낸다.
+			// 남은 구간마다 아이템이 하나 이상 남도록 한다.
+			bool reachedTarget = accumulated * partCount >= totalCost * (ranges.size() + 1);
+			if (partsLeft > 1 && (itemsLeft < partsLeft || reachedTarget) && itemsLeft >= partsLeft - 1)
+			{
+				range.End = i + 1;
+				ranges.push_back(range);
+				range.Begin = i + 1;
+			}
+		}
+		range.End = costs.size();
+		ranges.push_back(range);
+		return ranges;
+	}
+
+	/// <summary>
+	/// 펜스가 통과해야 재사용할 수 있는 객체(명령 할당자 등)의 풀.
+	/// 반환된 순서대로 재사용하며, 펜스 값만 다루므로 플랫폼에 독립적이다.
+	/// </summary>
+	template<typename T>
+	class FencedPool
+	{
+	public:
+		/// <summary>
+		/// completedFenceValue까지 완료되어 재사용할 수 있는 객체를 꺼낸다.
+		/// </summary>
+		/// <returns>꺼낼 객체가 없으면 false (호출자가 새로 만든다)</returns>
+		bool TryAcquire(std::uint64_t completedFenceValue, T& item)
+		{
+			if (mFree.empty() || mFree.front().first > completedFenceValue)
+				return false;
+
+			item = std::move(mFree.front().second);
+			mFree.pop_front();
+			return true;
+		}
+
+		/// <summary>
+		/// fenceValue가 완료되면 다시 꺼낼 수 있도록 반환
+		/// </summary>
+		void Release(T item, std::uint64_t fenceValue)
+		{
+			mFree.push_back(std::make_pair(fenceValue, std::move(item)));
+		}
+
+		size_t GetPooledCount() const { return mFree.size(); }
+
+	private:
+		// 펜스 값 순서대로 반환되므로 맨 앞이 가장 먼저 재사용 가능해진다.
+		std::deque<std::pair<std::uint64_t, T>> mFree;
+	};
+}
+#endif
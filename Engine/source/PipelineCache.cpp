@@ -0,0 +1,121 @@
+#include "PipelineCache.h"
+#include <chrono>
+
+namespace Engine
+{
+	PipelineCache::PipelineCache(ID3D12Device* device, const std::wstring& filename)
+		: mDevice(device), mFilename(filename)
+	{
+		OpenLibrary();
+	}
+
+	PipelineCache::~PipelineCache()
+	{
+		// 소멸자에서는 예외를 던지지 않는다. 저장하지 못하면 다음 실행에서 다시 컴파일할 뿐이다.
+		Save();
+	}
+
+	void PipelineCache::OpenLibrary()
+	{
+		Microsoft::WRL::ComPtr<ID3D12Device1> device1;
+		if (FAILED(mDevice.As(&device1)))
+			return;
+
+		HANDLE file = CreateFileW(mFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			LARGE_INTEGER fileSize;
+			DWORD read = 0;
+			if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0 && fileSize.QuadPart < MAXDWORD)
+			{
+				mFileData.resize((size_t)fileSize.QuadPart);
+				if (!ReadFile(file, mFileData.data(), (DWORD)mFileData.size(), &read, nullptr) || read != mFileData.size())
+					mFileData.clear();
+			}
+			CloseHandle(file);
+		}
+
+		const void* library = nullptr;
+		size_t libraryByteSize = 0;
+		if (PipelineCacheFile::Unpack(mFileData.data(), mFileData.size(), library, libraryByteSize) &&
+			SUCCEEDED(device1->CreatePipelineLibrary(library, libraryByteSize, IID_PPV_ARGS(&mLibrary))))
+		{
+			mStats.LibraryLoaded = true;
+			mStats.LibraryByteSize = libraryByteSize;
+			return;
+		}
+
+		// 파일이 없거나 손상되었거나, 드라이버/어댑터가 바뀌어 거부되면 빈 라이브러리로 시작한다.
+		mLibrary.Reset();
+		mFileData.clear();
+		if (FAILED(device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&mLibrary))))
+			mLibrary.Reset();
+	}
+
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> PipelineCache::GetGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash)
+	{
+		auto start = std::chrono::steady_clock::now();
+		++mStats.Requests;
+
+		std::uint64_t key = HashGraphicsPipelineDesc(desc, rootSignatureHash);
+		Microsoft::WRL::ComPtr<ID3D12PipelineState>& pso = mPipelines[key];
+		if (pso != nullptr)
+		{
+			++mStats.MemoryHits;
+		}
+		else
+		{
+			wchar_t name[17];
+			swprintf_s(name, L"%016llx", (unsigned long long)key);
+
+			if (mLibrary != nullptr && SUCCEEDED(mLibrary->LoadGraphicsPipeline(name, &desc, IID_PPV_ARGS(&pso))))
+			{
+				++mStats.LibraryHits;
+			}
+			else
+			{
+				pso.Reset();
+				ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pso)));
+				++mStats.Compiled;
+
+				// 같은 이름이 이미 있으면(해시 충돌) 저장하지 않고 이번 실행에서만 사용한다.
+				if (mLibrary != nullptr && SUCCEEDED(mLibrary->StorePipeline(name, pso.Get())))
+					mDirty = true;
+			}
+		}
+
+		mStats.CreateMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		return pso;
+	}
+
+	bool PipelineCache::Save()
+	{
+		if (!mDirty || mLibrary == nullptr)
+			return true;
+
+		std::vector<std::uint8_t> library(mLibrary->GetSerializedSize());
+		if (FAILED(mLibrary->Serialize(library.data(), library.size())))
+			return false;
+		std::vector<std::uint8_t> data = PipelineCacheFile::Pack(library.data(), library.size());
+
+		std::wstring tempFilename = mFilename + L".tmp";
+		HANDLE file = CreateFileW(tempFilename.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		DWORD written = 0;
+		bool complete = WriteFile(file, data.data(), (DWORD)data.size(), &written, nullptr) && written == data.size();
+		CloseHandle(file);
+
+		if (!complete || !MoveFileExW(tempFilename.c_str(), mFilename.c_str(), MOVEFILE_REPLACE_EXISTING))
+		{
+			DeleteFileW(tempFilename.c_str());
+			return false;
+		}
+
+		mDirty = false;
+		mStats.LibraryByteSize = library.size();
+		return true;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "EngineHeader.h"
+#include "PipelineCacheFile.h"
+#include "Util.h"
+#include <unordered_map>
+
+#ifndef PIPELINECACHE_H
+#define PIPELINECACHE_H
+namespace Engine
+{
+	/// <summary>
+	/// PSO 캐시 통계. 시작할 때 PSO 생성 시간을 보고하는 데 사용한다.
+	/// </summary>
+	struct PipelineCacheStats
+	{
+		std::uint64_t Requests = 0;
+		std::uint64_t MemoryHits = 0;   // 이번 실행에서 이미 만든 PSO
+		std::uint64_t LibraryHits = 0;  // 디스크의 파이프라인 라이브러리에서 불러온 PSO (드라이버 컴파일 없음)
+		std::uint64_t Compiled = 0;     // 드라이버가 새로 컴파일한 PSO
+		double CreateMs = 0.0;          // GetGraphicsPipeline에서 보낸 시간 합
+		bool LibraryLoaded = false;     // 시작할 때 캐시 파일을 받아들였는지
+		std::uint64_t LibraryByteSize = 0; // 불러오거나 마지막으로 저장한 라이브러리 크기
+	};
+
+	/// <summary>
+	/// 디스크에 저장되는 PSO 캐시. 키는 PSO 서술 전체의 해시(HashGraphicsPipelineDesc)이고,
+	/// ID3D12PipelineLibrary에 키 이름으로 저장해 두었다가 다음 실행에서 컴파일 없이 불러온다.
+	/// 4x MSAA처럼 샘플 설정만 다른 PSO도 키가 달라 따로 저장된다.
+	/// 파이프라인 라이브러리를 지원하지 않는 장치에서는 메모리 캐시로만 동작한다. 메인 스레드에서만 사용한다.
+	/// </summary>
+	class D3D_API PipelineCache
+	{
+	public:
+		/// <param name="filename">캐시 파일. 없거나 맞지 않으면 빈 라이브러리로 시작한다.</param>
+		PipelineCache(ID3D12Device* device, const std::wstring& filename);
+		PipelineCache(const PipelineCache& rhs) = delete;
+		PipelineCache& operator=(const PipelineCache& rhs) = delete;
+		/// <summary>
+		/// 저장하지 않은 PSO가 있으면 저장한다.
+		/// </summary>
+		~PipelineCache();
+
+		/// <summary>
+		/// desc에 맞는 PSO. 메모리, 라이브러리 순으로 찾고 없으면 컴파일해서 라이브러리에 넣는다.
+		/// </summary>
+		/// <param name="rootSignatureHash">desc.pRootSignature를 만든 직렬화된 루트 시그니처의 해시</param>
+		Microsoft::WRL::ComPtr<ID3D12PipelineState> GetGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash);
+
+		/// <summary>
+		/// 라이브러리에 새 PSO가 들어왔으면 캐시 파일에 기록한다. 임시 파일에 쓴 뒤 교체하므로 중간에 끊겨도 이전 파일이 남는다.
+		/// </summary>
+		/// <returns>기록할 것이 없거나 기록에 성공하면 true</returns>
+		bool Save();
+
+		const PipelineCacheStats& GetStats() const { return mStats; }
+
+	private:
+		void OpenLibrary();
+
+		Microsoft::WRL::ComPtr<ID3D12Device> mDevice;
+		std::wstring mFilename;
+
+		// CreatePipelineLibrary는 데이터를 복사하지 않으므로 라이브러리가 살아 있는 동안 유지한다.
+		// 멤버는 선언의 역순으로 소멸하므로 mLibrary보다 먼저 선언해야 라이브러리가 먼저 해제된다.
+		std::vector<std::uint8_t> mFileData;
+		Microsoft::WRL::ComPtr<ID3D12PipelineLibrary> mLibrary;
+		bool mDirty = false;
+
+		std::unordered_map<std::uint64_t, Microsoft::WRL::ComPtr<ID3D12PipelineState>> mPipelines;
+
+		PipelineCacheStats mStats;
+	};
+}
+#endif
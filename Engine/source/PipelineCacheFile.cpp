@@ -0,0 +1,57 @@
+#include "PipelineCacheFile.h"
+#include <cstring>
+
+namespace Engine
+{
+	namespace
+	{
+		const std::uint32_t PipelineCacheMagic = 0x434F5350; // "PSOC"
+
+		struct PipelineCacheHeader
+		{
+			std::uint32_t Magic;
+			std::uint32_t Version;
+			std::uint64_t LibraryByteSize;
+			std::uint64_t LibraryHash;
+		};
+	}
+
+	std::vector<std::uint8_t> PipelineCacheFile::Pack(const void* library, size_t byteSize)
+	{
+		PipelineCacheHeader header = {};
+		header.Magic = PipelineCacheMagic;
+		header.Version = Version;
+		header.LibraryByteSize = byteSize;
+		header.LibraryHash = PipelineStateHasher::HashBytes(library, byteSize);
+
+		std::vector<std::uint8_t> data(sizeof(header) + byteSize);
+		memcpy(data.data(), &header, sizeof(header));
+		if (byteSize > 0)
+			memcpy(data.data() + sizeof(header), library, byteSize);
+		return data;
+	}
+
+	bool PipelineCacheFile::Unpack(const void* data, size_t byteSize, const void*& library, size_t& libraryByteSize)
+	{
+		library = nullptr;
+		libraryByteSize = 0;
+		if (data == nullptr || byteSize < sizeof(PipelineCacheHeader))
+			return false;
+
+		PipelineCacheHeader header;
+		memcpy(&header, data, sizeof(header));
+
+		const std::uint8_t* payload = static_cast<const std::uint8_t*>(data) + sizeof(header);
+		bool valid =
+			header.Magic == PipelineCacheMagic &&
+			header.Version == Version &&
+			header.LibraryByteSize == byteSize - sizeof(header) &&
+			header.LibraryHash == PipelineStateHasher::HashBytes(payload, (size_t)header.LibraryByteSize);
+		if (!valid)
+			return false;
+
+		library = payload;
+		libraryByteSize = (size_t)header.LibraryByteSize;
+		return true;
+	}
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include "EngineHeader.h"
+#include "Hash.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#ifndef PIPELINECACHEFILE_H
+#define PIPELINECACHEFILE_H
+namespace Engine
+{
+	/// <summary>
+	/// PSO 캐시 키를 만드는 64비트 FNV-1a 해시 (Hash.h). 같은 입력이면 실행이 바뀌어도 같은 값이 나온다.
+	/// 구조체는 채움(padding) 바이트가 섞이지 않도록 필드 하나씩 넣는다.
+	/// </summary>
+	class PipelineStateHasher
+	{
+	public:
+		explicit PipelineStateHasher(std::uint64_t seed = Fnv1aOffsetBasis) : mHash(seed) {}
+
+		void AddBytes(const void* data, size_t byteSize)
+		{
+			mHash = Fnv1aBytes(data, byteSize, mHash);
+		}
+
+		/// <summary>
+		/// 정수, 실수, 열거형 값 하나
+		/// </summary>
+		template<typename T>
+		void Add(T value)
+		{
+			static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "필드 하나씩 넣는다");
+			AddBytes(&value, sizeof(value));
+		}
+
+		/// <summary>
+		/// 종료 문자까지 넣는다. nullptr은 빈 문자열과 구분된다.
+		/// </summary>
+		void AddString(const char* text)
+		{
+			if (text == nullptr)
+			{
+				Add(std::uint8_t(0xFF));
+				return;
+			}
+			for (; *text != 0; ++text)
+				Add(*text);
+			Add(char(0));
+		}
+
+		std::uint64_t GetHash() const { return mHash; }
+
+		static std::uint64_t HashBytes(const void* data, size_t byteSize)
+		{
+			return Fnv1aBytes(data, byteSize);
+		}
+
+	private:
+		std::uint64_t mHash;
+	};
+
+	/// <summary>
+	/// 그래픽 PSO 서술의 캐시 키. 포인터는 실행마다 달라지므로 가리키는 내용을 해시한다.
+	/// 셰이더는 바이트코드 해시, 입력 배치와 스트림 출력은 의미 이름까지 넣고,
+	/// 루트 시그니처는 직렬화된 루트 시그니처의 해시(rootSignatureHash)로 대신한다. CachedPSO는 넣지 않는다.
+	/// TDesc는 D3D12_GRAPHICS_PIPELINE_STATE_DESC (같은 필드를 가진 형식이면 장치 없이 검증할 수 있다)
+	/// </summary>
+	template<typename TDesc>
+	std::uint64_t HashGraphicsPipelineDesc(const TDesc& desc, std::uint64_t rootSignatureHash)
+	{
+		PipelineStateHasher hasher;
+		hasher.Add(rootSignatureHash);
+
+		auto addShader = [&hasher](const auto& shader)
+		{
+			hasher.Add((std::uint64_t)shader.BytecodeLength);
+			hasher.Add(PipelineStateHasher::HashBytes(shader.pShaderBytecode, shader.BytecodeLength));
+		};
+		addShader(desc.VS);
+		addShader(desc.PS);
+		addShader(desc.DS);
+		addShader(desc.HS);
+		addShader(desc.GS);
+
+		const auto& streamOutput = desc.StreamOutput;
+		hasher.Add(streamOutput.NumEntries);
+		for (std::uint32_t i = 0; i < streamOutput.NumEntries; ++i)
+		{
+			const auto& entry = streamOutput.pSODeclaration[i];
+			hasher.Add(entry.Stream);
+			hasher.AddString(entry.SemanticName);
+			hasher.Add(entry.SemanticIndex);
+			hasher.Add(entry.StartComponent);
+			hasher.Add(entry.ComponentCount);
+			hasher.Add(entry.OutputSlot);
+		}
+		hasher.Add(streamOutput.NumStrides);
+		for (std::uint32_t i = 0; i < streamOutput.NumStrides; ++i)
+			hasher.Add(streamOutput.pBufferStrides[i]);
+		hasher.Add(streamOutput.RasterizedStream);
+
+		const auto& blend = desc.BlendState;
+		hasher.Add(blend.AlphaToCoverageEnable);
+		hasher.Add(blend.IndependentBlendEnable);
+		for (const auto& target : blend.RenderTarget)
+		{
+			hasher.Add(target.BlendEnable);
+			hasher.Add(target.LogicOpEnable);
+			hasher.Add(target.SrcBlend);
+			hasher.Add(target.DestBlend);
+			hasher.Add(target.BlendOp);
+			hasher.Add(target.SrcBlendAlpha);
+			hasher.Add(target.DestBlendAlpha);
+			hasher.Add(target.BlendOpAlpha);
+			hasher.Add(target.LogicOp);
+			hasher.Add(target.RenderTargetWriteMask);
+		}
+		hasher.Add(desc.SampleMask);
+
+		const auto& rasterizer = desc.RasterizerState;
+		hasher.Add(rasterizer.FillMode);
+		hasher.Add(rasterizer.CullMode);
+		hasher.Add(rasterizer.FrontCounterClockwise);
+		hasher.Add(rasterizer.DepthBias);
+		hasher.Add(rasterizer.DepthBiasClamp);
+		hasher.Add(rasterizer.SlopeScaledDepthBias);
+		hasher.Add(rasterizer.DepthClipEnable);
+		hasher.Add(rasterizer.MultisampleEnable);
+		hasher.Add(rasterizer.AntialiasedLineEnable);
+		hasher.Add(rasterizer.ForcedSampleCount);
+		hasher.Add(rasterizer.ConservativeRaster);
+
+		const auto& depthStencil = desc.DepthStencilState;
+		auto addStencilOp = [&hasher](const auto& face)
+		{
+			hasher.Add(face.StencilFailOp);
+			hasher.Add(face.StencilDepthFailOp);
+			hasher.Add(face.StencilPassOp);
+			hasher.Add(face.StencilFunc);
+		};
+		hasher.Add(depthStencil.DepthEnable);
+		hasher.Add(depthStencil.DepthWriteMask);
+		hasher.Add(depthStencil.DepthFunc);
+		hasher.Add(depthStencil.StencilEnable);
+		hasher.Add(depthStencil.StencilReadMask);
+		hasher.Add(depthStencil.StencilWriteMask);
+		addStencilOp(depthStencil.FrontFace);
+		addStencilOp(depthStencil.BackFace);
+
+		const auto& inputLayout = desc.InputLayout;
+		hasher.Add(inputLayout.NumElements);
+		for (std::uint32_t i = 0; i < inputLayout.NumElements; ++i)
+		{
+			const auto& element = inputLayout.pInputElementDescs[i];
+			hasher.AddString(element.SemanticName);
+			hasher.Add(element.SemanticIndex);
+			hasher.Add(element.Format);
+			hasher.Add(element.InputSlot);
+			hasher.Add(element.AlignedByteOffset);
+			hasher.Add(element.InputSlotClass);
+			hasher.Add(element.InstanceDataStepRate);
+		}
+
+		hasher.Add(desc.IBStripCutValue);
+		hasher.Add(desc.PrimitiveTopologyType);
+		hasher.Add(desc.NumRenderTargets);
+		for (auto format : desc.RTVFormats)
+			hasher.Add(format);
+		hasher.Add(desc.DSVFormat);
+		hasher.Add(desc.SampleDesc.Count);
+		hasher.Add(desc.SampleDesc.Quality);
+		hasher.Add(desc.NodeMask);
+		hasher.Add(desc.Flags);
+
+		return hasher.GetHash();
+	}
+
+	/// <summary>
+	/// 파이프라인 라이브러리를 디스크에 저장하는 파일 형식. [헤더][라이브러리 직렬화 데이터]
+	/// 헤더에는 데이터 크기와 해시가 있어, 기록 도중 중단되었거나 손상된 파일은 드라이버에 넘기기 전에 걸러진다.
+	/// (드라이버나 어댑터가 바뀐 경우는 CreatePipelineLibrary가 거부한다)
+	/// </summary>
+	class D3D_API PipelineCacheFile
+	{
+	public:
+		// 파일 구조가 바뀌면 올린다. 버전이 다른 파일은 읽지 않는다.
+		enum : std::uint32_t { Version = 1 };
+
+		/// <summary>
+		/// 직렬화된 라이브러리에 헤더를 붙인 파일 내용
+		/// </summary>
+		static std::vector<std::uint8_t> Pack(const void* library, size_t byteSize);
+
+		/// <summary>
+		/// 파일 내용에서 라이브러리 데이터 구간을 찾는다. library는 data 안을 가리킨다.
+		/// </summary>
+		/// <returns>마법 값, 버전, 크기, 해시 중 하나라도 맞지 않으면 false</returns>
+		static bool Unpack(const void* data, size_t byteSize, const void*& library, size_t& libraryByteSize);
+	};
+}
+#endif
@@ -0,0 +1,191 @@
+#include "PlacedBufferAllocator.h"
+#include <atomic>
+
+namespace Engine
+{
+	using Microsoft::WRL::ComPtr;
+
+	struct PlacedBufferAllocator::Pool : public HeapBlockBackend
+	{
+		Pool(ID3D12Device* device, D3D12_HEAP_TYPE type, UINT64 blockSize)
+			: Device(device), Type(type),
+			Allocator(this, blockSize, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)
+		{
+		}
+
+		bool CreateBlock(std::uint32_t blockIndex, std::uint64_t byteSize) override
+		{
+			if (blockIndex >= Heaps.size())
+				Heaps.resize(blockIndex + 1);
+
+			D3D12_HEAP_DESC heapDesc = {};
+			heapDesc.SizeInBytes = byteSize;
+			heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(Type);
+			heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+			// 리소스 힙 티어 1에서도 사용할 수 있도록 버퍼 전용으로 만든다.
+			heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+			return SUCCEEDED(Device->CreateHeap(&heapDesc, IID_PPV_ARGS(&Heaps[blockIndex])));
+		}
+
+		void DestroyBlock(std::uint32_t blockIndex) override
+		{
+			Heaps[blockIndex].Reset();
+		}
+
+		ID3D12Device* Device;
+		D3D12_HEAP_TYPE Type;
+		std::vector<ComPtr<ID3D12Heap>> Heaps;
+		BuddyHeapAllocator Allocator;
+	};
+
+	struct PlacedBufferAllocator::State
+	{
+		State(ID3D12Device* device, UINT64 blockSize)
+			: Device(device),
+			DefaultPool(device, D3D12_HEAP_TYPE_DEFAULT, blockSize),
+			UploadPool(device, D3D12_HEAP_TYPE_UPLOAD, blockSize)
+		{
+		}
+
+		Pool& GetPool(D3D12_HEAP_TYPE heapType)
+		{
+			assert(heapType == D3D12_HEAP_TYPE_DEFAULT || heapType == D3D12_HEAP_TYPE_UPLOAD);
+			return heapType == D3D12_HEAP_TYPE_UPLOAD ? UploadPool : DefaultPool;
+		}
+
+		std::mutex Mutex;
+		ComPtr<ID3D12Device> Device;
+		Pool DefaultPool;
+		Pool UploadPool;
+	};
+
+	namespace
+	{
+		// {8D5E1F0A-3C2B-4E7D-9A61-2F4B7C0D15E3}
+		const GUID PlacedAllocationGuid = { 0x8d5e1f0a, 0x3c2b, 0x4e7d, { 0x9a, 0x61, 0x2f, 0x4b, 0x7c, 0x0d, 0x15, 0xe3 } };
+
+		/// <summary>
+		/// 배치된 자원의 개인 데이터로 붙어 있다가, 자원이 소멸될 때 해제되면서 힙 구간을 반환한다.
+		/// </summary>
+		template<typename TState, typename TPool>
+		class AllocationReleaser : public IUnknown
+		{
+		public:
+			AllocationReleaser(const std::shared_ptr<TState>& state, TPool* pool, std::uint32_t allocation)
+				: mState(state), mPool(pool), mAllocation(allocation)
+			{
+			}
+
+			HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+			{
+				if (riid == __uuidof(IUnknown))
+				{
+					*object = static_cast<IUnknown*>(this);
+					AddRef();
+					return S_OK;
+				}
+				*object = nullptr;
+				return E_NOINTERFACE;
+			}
+
+			ULONG STDMETHODCALLTYPE AddRef() override
+			{
+				return ++mRefCount;
+			}
+
+			ULONG STDMETHODCALLTYPE Release() override
+			{
+				ULONG refCount = --mRefCount;
+				if (refCount == 0)
+					delete this;
+				return refCount;
+			}
+
+		private:
+			~AllocationReleaser()
+			{
+				std::lock_guard<std::mutex> lock(mState->Mutex);
+				mPool->Allocator.Free(mAllocation);
+			}
+
+			std::atomic<ULONG> mRefCount{ 1 };
+			std::shared_ptr<TState> mState;
+			TPool* mPool;
+			std::uint32_t mAllocation;
+		};
+	}
+
+	PlacedBufferAllocator::PlacedBufferAllocator(ID3D12Device* device, UINT64 blockSize)
+		: mState(std::make_shared<State>(device, blockSize))
+	{
+	}
+
+	PlacedBufferAllocator::~PlacedBufferAllocator()
+	{
+	}
+
+	ComPtr<ID3D12Resource> PlacedBufferAllocator::CreateBuffer(
+		D3D12_HEAP_TYPE heapType,
+		UINT64 byteSize,
+		D3D12_RESOURCE_STATES initialState)
+	{
+		ID3D12Device* device = mState->Device.Get();
+		Pool& pool = mState->GetPool(heapType);
+
+		CD3DX12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(byteSize);
+		D3D12_RESOURCE_ALLOCATION_INFO info = device->GetResourceAllocationInfo(0, 1, &desc);
+
+		std::uint32_t allocation;
+		ID3D12Heap* heap = nullptr;
+		UINT64 heapOffset = 0;
+		{
+			std::lock_guard<std::mutex> lock(mState->Mutex);
+			allocation = pool.Allocator.Allocate(info.SizeInBytes, info.Alignment);
+			if (allocation != BuddyHeapAllocator::InvalidAllocation)
+			{
+				const HeapLocation& location = pool.Allocator.GetLocation(allocation);
+				heap = pool.Heaps[location.Block].Get();
+				heapOffset = location.Offset;
+			}
+		}
+
+		ComPtr<ID3D12Resource> resource;
+
+		// 블록보다 크거나 힙을 만들 수 없으면 커밋 자원으로 만든다.
+		if (allocation == BuddyHeapAllocator::InvalidAllocation)
+		{
+			ThrowIfFailed(device->CreateCommittedResource(
+				&CD3DX12_HEAP_PROPERTIES(heapType),
+				D3D12_HEAP_FLAG_NONE,
+				&desc,
+				initialState,
+				nullptr,
+				IID_PPV_ARGS(resource.GetAddressOf())));
+			return resource;
+		}
+
+		HRESULT hr = device->CreatePlacedResource(heap, heapOffset, &desc, initialState, nullptr, IID_PPV_ARGS(resource.GetAddressOf()));
+		if (FAILED(hr))
+		{
+			std::lock_guard<std::mutex> lock(mState->Mutex);
+			pool.Allocator.Free(allocation);
+			ThrowIfFailed(hr);
+		}
+
+		// 자원이 소멸될 때 구간이 반환되도록 연결
+		auto releaser = new AllocationReleaser<State, Pool>(mState, &pool, allocation);
+		hr = resource->SetPrivateDataInterface(PlacedAllocationGuid, releaser);
+		if (FAILED(hr))
+			resource.Reset();
+		releaser->Release();
+		ThrowIfFailed(hr);
+
+		return resource;
+	}
+
+	HeapAllocatorStats PlacedBufferAllocator::GetStats(D3D12_HEAP_TYPE heapType) const
+	{
+		std::lock_guard<std::mutex> lock(mState->Mutex);
+		return mState->GetPool(heapType).Allocator.GetStats();
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "EngineHeader.h"
+#include "HeapAllocator.h"
+#include "Util.h"
+#include <memory>
+#include <mutex>
+
+#ifndef PLACEDBUFFERALLOCATOR_H
+#define PLACEDBUFFERALLOCATOR_H
+namespace Engine
+{
+	/// <summary>
+	/// 버퍼를 큰 ID3D12Heap 블록 안에 배치(placed resource)해서 만드는 할당기.
+	/// 기본 힙과 업로드 힙을 각각 BuddyHeapAllocator로 나누어 쓰며, 블록보다 큰 버퍼는 커밋 자원으로 만든다.
+	///
+	/// 반환된 자원이 해제되면 그 구간도 자동으로 해제되므로 호출자는 ComPtr만 관리하면 된다.
+	/// 자원이 남아 있는 동안에는 할당기가 소멸되어도 힙 블록은 유지된다.
+	/// 여러 스레드에서 자원을 만들고 해제해도 된다.
+	/// </summary>
+	class D3D_API PlacedBufferAllocator
+	{
+	public:
+		/// <param name="blockSize">ID3D12Heap 블록 크기 (2의 거듭제곱)</param>
+		PlacedBufferAllocator(ID3D12Device* device, UINT64 blockSize = 32ull * 1024 * 1024);
+		PlacedBufferAllocator(const PlacedBufferAllocator& rhs) = delete;
+		PlacedBufferAllocator& operator=(const PlacedBufferAllocator& rhs) = delete;
+		~PlacedBufferAllocator();
+
+		/// <summary>
+		/// heapType 힙에 byteSize 크기의 버퍼 생성
+		/// </summary>
+		/// <param name="heapType">D3D12_HEAP_TYPE_DEFAULT 또는 D3D12_HEAP_TYPE_UPLOAD</param>
+		Microsoft::WRL::ComPtr<ID3D12Resource> CreateBuffer(
+			D3D12_HEAP_TYPE heapType,
+			UINT64 byteSize,
+			D3D12_RESOURCE_STATES initialState);
+
+		/// <summary>
+		/// heapType 힙 할당기의 점유율/단편화 통계
+		/// </summary>
+		HeapAllocatorStats GetStats(D3D12_HEAP_TYPE heapType) const;
+
+	private:
+		struct Pool;
+		struct State;
+
+		std::shared_ptr<State> mState;
+	};
+}
+#endif
@@ -0,0 +1,198 @@
+#pragma once
+#include "Hash.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef RESOURCEREGISTRY_H
+#define RESOURCEREGISTRY_H
+namespace Engine
+{
+	using NameHash = std::uint64_t;
+
+	/// <summary>
+	/// 자원 이름의 64비트 FNV-1a 해시. 문자열 상수에 쓰면 컴파일 시간에 계산된다.
+	/// (constexpr NameHash gOpaque = HashName("opaque");)
+	/// </summary>
+	constexpr NameHash HashName(const char* name)
+	{
+		return Fnv1aString(name);
+	}
+
+	/// <summary>
+	/// ResourceRegistry 안의 항목을 가리키는 핸들. 항목이 지워지면 세대가 바뀌어 이전 핸들은 무효가 된다.
+	/// T는 형식 검사용이며, 다른 레지스트리의 핸들과 섞어 쓸 수 없다.
+	/// </summary>
+	template<typename T>
+	struct Handle
+	{
+		enum : std::uint32_t { InvalidIndex = 0xFFFFFFFF };
+
+		std::uint32_t Index = InvalidIndex;
+		std::uint32_t Generation = 0;
+
+		bool IsValid() const { return Index != InvalidIndex; }
+		bool operator==(const Handle& rhs) const { return Index == rhs.Index && Generation == rhs.Generation; }
+		bool operator!=(const Handle& rhs) const { return !(*this == rhs); }
+	};
+
+	/// <summary>
+	/// 값을 조밀한 배열에 저장하고 세대 핸들로 접근하는 레지스트리.
+	/// 이름(해시)은 로드 시점에 핸들을 찾을 때만 사용하고, 프레임 중에는 핸들로 배열을 바로 색인한다.
+	/// 지운 칸은 재사용하며, 칸의 세대를 올려서 남아 있는 핸들이 새 항목을 가리키지 않게 한다.
+	/// 값은 배열에 들어 있으므로 Add로 배열이 커지면 이전에 얻은 참조/포인터는 무효가 된다.
+	/// </summary>
+	template<typename T>
+	class ResourceRegistry
+	{
+	public:
+		using HandleType = Handle<T>;
+
+		/// <summary>
+		/// name으로 value를 등록. 같은 이름(또는 해시 충돌)이 이미 있으면 assert 후 무효 핸들을 반환한다.
+		/// </summary>
+		HandleType Add(NameHash name, T value)
+		{
+			if (mNames.find(name) != mNames.end())
+			{
+				assert(false && "resource name already registered (or hash collision)");
+				return HandleType();
+			}
+
+			std::uint32_t index;
+			if (!mFreeSlots.empty())
+			{
+				index = mFreeSlots.back();
+				mFreeSlots.pop_back();
+				mValues[index] = std::move(value);
+			}
+			else
+			{
+				index = (std::uint32_t)mValues.size();
+				mValues.push_back(std::move(value));
+				mGenerations.push_back(0);
+				mSlotNames.push_back(0);
+				mAlive.push_back(0);
+			}
+
+			mAlive[index] = 1;
+			mSlotNames[index] = name;
+			mNames[name] = index;
+			++mCount;
+
+			HandleType handle;
+			handle.Index = index;
+			handle.Generation = mGenerations[index];
+			return handle;
+		}
+
+		/// <summary>
+		/// 이름으로 핸들을 찾는다. 없으면 무효 핸들 (로드 시점 전용)
+		/// </summary>
+		HandleType Find(NameHash name) const
+		{
+			HandleType handle;
+			auto it = mNames.find(name);
+			if (it != mNames.end())
+			{
+				handle.Index = it->second;
+				handle.Generation = mGenerations[it->second];
+			}
+			return handle;
+		}
+
+		/// <summary>
+		/// 항목을 지우고 칸의 세대를 올린다. 이미 무효인 핸들은 무시한다.
+		/// </summary>
+		void Remove(HandleType handle)
+		{
+			if (!IsValid(handle))
+				return;
+
+			std::uint32_t index = handle.Index;
+			mNames.erase(mSlotNames[index]);
+			mValues[index] = T();
+			mAlive[index] = 0;
+			++mGenerations[index];
+			mFreeSlots.push_back(index);
+			--mCount;
+		}
+
+		bool IsValid(HandleType handle) const
+		{
+			return handle.Index < mValues.size() && mAlive[handle.Index] && mGenerations[handle.Index] == handle.Generation;
+		}
+
+		T& operator[](HandleType handle)
+		{
+			assert(IsValid(handle));
+			return mValues[handle.Index];
+		}
+		const T& operator[](HandleType handle) const
+		{
+			assert(IsValid(handle));
+			return mValues[handle.Index];
+		}
+
+		/// <summary>
+		/// 유효하면 값, 아니면 nullptr
+		/// </summary>
+		T* TryGet(HandleType handle) { return IsValid(handle) ? &mValues[handle.Index] : nullptr; }
+		const T* TryGet(HandleType handle) const { return IsValid(handle) ? &mValues[handle.Index] : nullptr; }
+
+		/// <summary>
+		/// 칸 번호로 접근 (정렬 키처럼 세대 없이 Index만 저장한 곳에서 사용). 세대는 확인하지 않는다.
+		/// </summary>
+		T& GetAt(std::uint32_t index)
+		{
+			assert(index < mValues.size() && mAlive[index]);
+			return mValues[index];
+		}
+		const T& GetAt(std::uint32_t index) const
+		{
+			assert(index < mValues.size() && mAlive[index]);
+			return mValues[index];
+		}
+
+		/// <summary>
+		/// 살아 있는 항목 수
+		/// </summary>
+		size_t GetCount() const { return mCount; }
+		/// <summary>
+		/// 칸 수 (지운 칸 포함). Index로 색인하는 보조 배열의 크기로 사용
+		/// </summary>
+		size_t GetSlotCount() const { return mValues.size(); }
+
+		/// <summary>
+		/// 살아 있는 항목마다 func(handle, value) 호출
+		/// </summary>
+		template<typename TFunc>
+		void ForEach(TFunc func)
+		{
+			for (std::uint32_t i = 0; i < (std::uint32_t)mValues.size(); ++i)
+			{
+				if (!mAlive[i])
+					continue;
+				HandleType handle;
+				handle.Index = i;
+				handle.Generation = mGenerations[i];
+				func(handle, mValues[i]);
+			}
+		}
+
+	private:
+		std::vector<T> mValues;
+		std::vector<std::uint32_t> mGenerations;
+		std::vector<NameHash> mSlotNames;
+		std::vector<std::uint8_t> mAlive;
+		std::vector<std::uint32_t> mFreeSlots;
+		size_t mCount = 0;
+
+		// 로드 시점에만 사용하는 이름 -> 칸 번호
+		std::unordered_map<NameHash, std::uint32_t> mNames;
+	};
+}
+#endif
@@ -0,0 +1,119 @@
+#include "RingAllocator.h"
+#include <algorithm>
+#include <cassert>
+
+namespace Engine
+{
+	namespace
+	{
+		std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
+	RingAllocator::RingAllocator(uint64 capacity) : mCapacity(capacity)
+	{
+	}
+
+	RingAllocator::uint64 RingAllocator::TryAllocate(uint64 byteSize, uint64 alignment)
+	{
+		assert(byteSize > 0);
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+		// 비어 있으면 처음부터 다시 사용해 랩어라운드를 줄인다.
+		if (mUsedBytes == 0)
+		{
+			mHead = 0;
+			mTail = 0;
+		}
+
+		uint64 offset = AlignUp(mHead, alignment);
+		uint64 padding = 0;
+
+		if (mHead > mTail || mUsedBytes == 0)
+		{
+			// 사용 가능한 공간: [mHead, mCapacity) 와 [0, mTail)
+			if (offset + byteSize <= mCapacity)
+			{
+				padding = offset - mHead;
+			}
+			else if (byteSize <= mTail)
+			{
+				// 끝에 남은 공간은 버리고 처음으로 돌아간다.
+				padding = mCapacity - mHead;
+				offset = 0;
+				++mStats.WrapCount;
+			}
+			else
+			{
+				return InvalidOffset;
+			}
+		}
+		else if (mHead < mTail)
+		{
+			// 사용 가능한 공간: [mHead, mTail)
+			if (offset + byteSize > mTail)
+				return InvalidOffset;
+			padding = offset - mHead;
+		}
+		else
+		{
+			// mHead == mTail 이고 비어 있지 않으면 가득 찬 상태
+			return InvalidOffset;
+		}
+
+		mHead = offset + byteSize;
+		mUsedBytes += padding + byteSize;
+		mFrameBytes += padding + byteSize;
+
+		++mStats.AllocationCount;
+		mStats.AllocatedBytes += byteSize;
+		mStats.PaddingBytes += padding;
+		mStats.PeakUsedBytes = std::max(mStats.PeakUsedBytes, mUsedBytes);
+
+		return offset;
+	}
+
+	RingAllocator::uint64 RingAllocator::Allocate(uint64 byteSize, uint64 alignment, const WaitForFence& waitForFence)
+	{
+		for (;;)
+		{
+			uint64 offset = TryAllocate(byteSize, alignment);
+			if (offset != InvalidOffset)
+				return offset;
+
+			// 더 기다려도 회수될 공간이 없다.
+			if (mFrames.empty())
+				return InvalidOffset;
+
+			++mStats.StallCount;
+			uint64 fenceValue = mFrames.front().FenceValue;
+			uint64 completedValue = waitForFence(fenceValue);
+			assert(completedValue >= fenceValue);
+			Retire(completedValue);
+		}
+	}
+
+	void RingAllocator::EndFrame(uint64 fenceValue)
+	{
+		assert(fenceValue >= mLastFenceValue);
+		mLastFenceValue = fenceValue;
+
+		if (mFrameBytes == 0)
+			return;
+
+		mFrames.push_back({ fenceValue, mHead, mFrameBytes });
+		mFrameBytes = 0;
+	}
+
+	void RingAllocator::Retire(uint64 completedFenceValue)
+	{
+		while (!mFrames.empty() && mFrames.front().FenceValue <= completedFenceValue)
+		{
+			mTail = mFrames.front().EndOffset;
+			mUsedBytes -= mFrames.front().ByteSize;
+			mFrames.pop_front();
+		}
+	}
+}
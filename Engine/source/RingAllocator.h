@@ -0,0 +1,97 @@
+#pragma once
+#include "EngineHeader.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+#ifndef RINGALLOCATOR_H
+#define RINGALLOCATOR_H
+namespace Engine
+{
+	/// <summary>
+	/// 링 할당기 통계. ResetStats로 초기화할 수 있다.
+	/// </summary>
+	struct RingAllocatorStats
+	{
+		std::uint64_t AllocationCount = 0;
+		std::uint64_t AllocatedBytes = 0;  // 요청된 바이트 합
+		std::uint64_t PaddingBytes = 0;    // 정렬과 랩어라운드로 버려진 바이트 합
+		std::uint64_t WrapCount = 0;       // 끝에 공간이 없어 처음으로 돌아간 횟수
+		std::uint64_t StallCount = 0;      // 공간이 없어 펜스를 기다린 횟수
+		std::uint64_t PeakUsedBytes = 0;   // 동시에 사용 중이었던 최대 바이트
+	};
+
+	/// <summary>
+	/// 펜스 값으로 공간을 회수하는 선형 링 할당기. 실제 메모리 없이 오프셋만 관리하므로
+	/// 플랫폼에 독립적이며, 펜스 대신 정수 값을 넘겨 단독으로 검증할 수 있다.
+	///
+	/// 한 프레임 동안 Allocate로 받은 구간은 EndFrame(fenceValue)로 묶이고,
+	/// Retire(completedValue)에서 completedValue >= fenceValue가 되면 한꺼번에 회수된다.
+	/// </summary>
+	class D3D_API RingAllocator
+	{
+	public:
+		using uint64 = std::uint64_t;
+
+		// 할당 실패를 나타내는 오프셋
+		static const uint64 InvalidOffset = ~0ull;
+
+		// fenceValue가 완료될 때까지 기다린 뒤 완료된 펜스 값을 반환하는 함수
+		using WaitForFence = std::function<uint64(uint64 fenceValue)>;
+
+		explicit RingAllocator(uint64 capacity);
+
+		/// <summary>
+		/// 공간이 있으면 할당하고, 없으면 기다리지 않고 InvalidOffset 반환
+		/// </summary>
+		/// <param name="alignment">2의 거듭제곱</param>
+		uint64 TryAllocate(uint64 byteSize, uint64 alignment);
+
+		/// <summary>
+		/// 공간이 생길 때까지 가장 오래된 프레임의 펜스를 기다리며 할당 (기다릴 때마다 StallCount 증가).
+		/// 진행 중인 프레임이 모두 회수되어도 들어가지 않으면 InvalidOffset 반환.
+		/// </summary>
+		uint64 Allocate(uint64 byteSize, uint64 alignment, const WaitForFence& waitForFence);
+
+		/// <summary>
+		/// 지난 EndFrame 이후의 할당들을 fenceValue가 완료되면 회수되도록 표시.
+		/// fenceValue는 이전 호출보다 작아서는 안 된다.
+		/// </summary>
+		void EndFrame(uint64 fenceValue);
+
+		/// <summary>
+		/// completedFenceValue까지 완료된 프레임의 공간 회수
+		/// </summary>
+		void Retire(uint64 completedFenceValue);
+
+		bool HasPendingFrames() const { return !mFrames.empty(); }
+		// 회수를 기다리는 가장 오래된 프레임의 펜스 값 (HasPendingFrames일 때만 유효)
+		uint64 GetOldestPendingFence() const { return mFrames.front().FenceValue; }
+
+		uint64 GetCapacity() const { return mCapacity; }
+		// 회수되지 않은 바이트 (정렬/랩어라운드로 버려진 공간 포함)
+		uint64 GetUsedBytes() const { return mUsedBytes; }
+
+		const RingAllocatorStats& GetStats() const { return mStats; }
+		void ResetStats() { mStats = RingAllocatorStats(); }
+
+	private:
+		struct Frame
+		{
+			uint64 FenceValue;
+			uint64 EndOffset; // 이 프레임이 회수되면 mTail이 이동할 위치
+			uint64 ByteSize;  // 이 프레임이 차지한 바이트 (버려진 공간 포함)
+		};
+
+		uint64 mCapacity = 0;
+		uint64 mHead = 0;      // 다음 할당 위치
+		uint64 mTail = 0;      // 회수되지 않은 가장 오래된 위치
+		uint64 mUsedBytes = 0;
+		uint64 mFrameBytes = 0; // 아직 EndFrame되지 않은 현재 프레임의 바이트
+		uint64 mLastFenceValue = 0;
+
+		std::deque<Frame> mFrames;
+		RingAllocatorStats mStats;
+	};
+}
+#endif
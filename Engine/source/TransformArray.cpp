@@ -0,0 +1,241 @@
+#include "TransformArray.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define TRANSFORMARRAY_SSE
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Engine
+{
+	namespace
+	{
+		// 한 작업이 처리할 비트셋 워드 수 (워드당 64개 항목)
+		const size_t FlushWordsPerJob = 64;
+
+		inline unsigned CountTrailingZeros(std::uint64_t value)
+		{
+			assert(value != 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+			unsigned long index;
+			_BitScanForward64(&index, value);
+			return (unsigned)index;
+#elif defined(_MSC_VER)
+			unsigned long index;
+			if (_BitScanForward(&index, (unsigned long)value))
+				return (unsigned)index;
+			_BitScanForward(&index, (unsigned long)(value >> 32));
+			return (unsigned)index + 32;
+#else
+			return (unsigned)__builtin_ctzll(value);
+#endif
+		}
+	}
+
+	TransformArray::TransformArray(std::uint32_t slotCount)
+		: mDirty(std::max<std::uint32_t>(slotCount, 1))
+	{
+	}
+
+	void TransformArray::Resize(size_t count)
+	{
+		size_t oldCount = mCount;
+		mCount = count;
+		mBlocks.resize((count + 3) / 4);
+
+		static const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+		for (size_t i = oldCount; i < count; ++i)
+			Set(i, identity);
+
+		// 줄어든 경우 범위 밖 비트를 지운다.
+		size_t wordCount = (count + 63) / 64;
+		for (std::vector<std::uint64_t>& dirty : mDirty)
+		{
+			dirty.resize(wordCount, 0);
+			if (count % 64 != 0)
+				dirty.back() &= (std::uint64_t(1) << (count % 64)) - 1;
+		}
+	}
+
+	void TransformArray::Set(size_t index, const float* matrix)
+	{
+		assert(index < mCount);
+
+		Block& block = mBlocks[index / 4];
+		size_t lane = index % 4;
+		for (int i = 0; i < 16; ++i)
+			block.Components[i][lane] = matrix[i];
+
+		size_t wordCount = (mCount + 63) / 64;
+		std::uint64_t bit = std::uint64_t(1) << (index % 64);
+		for (std::vector<std::uint64_t>& dirty : mDirty)
+		{
+			if (dirty.size() < wordCount)
+				dirty.resize(wordCount, 0);
+			dirty[index / 64] |= bit;
+		}
+	}
+
+	void TransformArray::Get(size_t index, float* matrix) const
+	{
+		assert(index < mCount);
+
+		const Block& block = mBlocks[index / 4];
+		size_t lane = index % 4;
+		for (int i = 0; i < 16; ++i)
+			matrix[i] = block.Components[i][lane];
+	}
+
+	void TransformArray::MarkAllDirty()
+	{
+		for (std::vector<std::uint64_t>& dirty : mDirty)
+		{
+			std::fill(dirty.begin(), dirty.end(), ~std::uint64_t(0));
+			if (mCount % 64 != 0)
+				dirty.back() = (std::uint64_t(1) << (mCount % 64)) - 1;
+		}
+	}
+
+	bool TransformArray::IsDirty(std::uint32_t slot, size_t index) const
+	{
+		assert(slot < mDirty.size() && index < mCount);
+		return (mDirty[slot][index / 64] >> (index % 64)) & 1;
+	}
+
+	size_t TransformArray::Flush(std::uint32_t slot, void* dst, size_t stride, JobSystem* jobs)
+	{
+		assert(slot < mDirty.size());
+		assert(stride >= sizeof(float) * 16);
+
+		std::vector<std::uint64_t>& dirty = mDirty[slot];
+		std::uint8_t* bytes = static_cast<std::uint8_t*>(dst);
+
+		size_t written = 0;
+		if (jobs == nullptr || dirty.size() <= FlushWordsPerJob)
+		{
+			written = FlushWords(dirty, 0, dirty.size(), bytes, stride);
+		}
+		else
+		{
+			// 워드 구간마다 다른 항목을 쓰므로 작업끼리 겹치지 않는다.
+			std::atomic<size_t> total(0);
+			jobs->ParallelFor(dirty.size(), FlushWordsPerJob, [&](size_t begin, size_t end)
+			{
+				total.fetch_add(FlushWords(dirty, begin, end, bytes, stride), std::memory_order_relaxed);
+			});
+			written = total.load();
+		}
+
+#if defined(TRANSFORMARRAY_SSE)
+		// 흘려 쓴 데이터가 GPU에 제출되기 전에 보이도록 한다.
+		_mm_sfence();
+#endif
+		return written;
+	}
+
+	size_t TransformArray::FlushWords(std::vector<std::uint64_t>& dirty, size_t wordBegin, size_t wordEnd, std::uint8_t* dst, size_t stride) const
+	{
+		size_t written = 0;
+
+		// 워드 경계를 넘어 이어지는 구간은 합쳐서 한 번에 쓴다.
+		size_t runBegin = 0;
+		size_t runEnd = 0;
+		for (size_t w = wordBegin; w < wordEnd; ++w)
+		{
+			std::uint64_t bits = dirty[w];
+			if (bits == 0)
+				continue;
+			dirty[w] = 0;
+
+			while (bits != 0)
+			{
+				unsigned first = CountTrailingZeros(bits);
+				std::uint64_t shifted = bits >> first;
+				unsigned length = ~shifted == 0 ? 64 - first : CountTrailingZeros(~shifted);
+
+				size_t begin = w * 64 + first;
+				if (begin != runEnd || runEnd == runBegin)
+				{
+					if (runEnd != runBegin)
+					{
+						WriteRun(runBegin, runEnd, dst, stride);
+						written += runEnd - runBegin;
+					}
+					runBegin = begin;
+				}
+				runEnd = begin + length;
+
+				bits = length == 64 ? 0 : bits & ~(((std::uint64_t(1) << length) - 1) << first);
+			}
+		}
+
+		if (runEnd != runBegin)
+		{
+			WriteRun(runBegin, runEnd, dst, stride);
+			written += runEnd - runBegin;
+		}
+		return written;
+	}
+
+	void TransformArray::WriteRun(size_t begin, size_t end, std::uint8_t* dst, size_t stride) const
+	{
+		// 한 항목씩 전치해서 기록 (블록 경계에 맞지 않는 앞뒤 부분)
+		auto writeOne = [&](size_t index)
+		{
+			const Block& block = mBlocks[index / 4];
+			size_t lane = index % 4;
+			float transposed[16];
+			for (int r = 0; r < 4; ++r)
+			{
+				for (int c = 0; c < 4; ++c)
+					transposed[r * 4 + c] = block.Components[c * 4 + r][lane];
+			}
+			std::memcpy(dst + index * stride, transposed, sizeof(transposed));
+		};
+
+		size_t i = begin;
+#if defined(TRANSFORMARRAY_SSE)
+		// 흘려 쓰기는 16 바이트 정렬이 필요하다. (상수 버퍼는 256 바이트 정렬이므로 보통 만족한다)
+		bool aligned = (reinterpret_cast<std::uintptr_t>(dst) % 16) == 0 && stride % 16 == 0;
+		if (aligned)
+		{
+			for (; i < end && i % 4 != 0; ++i)
+				writeOne(i);
+
+			for (; i + 4 <= end; i += 4)
+			{
+				const Block& block = mBlocks[i / 4];
+				std::uint8_t* out0 = dst + i * stride;
+				std::uint8_t* out1 = out0 + stride;
+				std::uint8_t* out2 = out1 + stride;
+				std::uint8_t* out3 = out2 + stride;
+
+				// 전치 행렬의 r행 = 원래 행렬의 r열. 네 객체의 r열 성분을 모아 4x4 전치하면 객체마다 r행이 나온다.
+				for (int r = 0; r < 4; ++r)
+				{
+					__m128 row0 = _mm_load_ps(block.Components[0 * 4 + r]);
+					__m128 row1 = _mm_load_ps(block.Components[1 * 4 + r]);
+					__m128 row2 = _mm_load_ps(block.Components[2 * 4 + r]);
+					__m128 row3 = _mm_load_ps(block.Components[3 * 4 + r]);
+					_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+					_mm_stream_ps(reinterpret_cast<float*>(out0 + r * 16), row0);
+					_mm_stream_ps(reinterpret_cast<float*>(out1 + r * 16), row1);
+					_mm_stream_ps(reinterpret_cast<float*>(out2 + r * 16), row2);
+					_mm_stream_ps(reinterpret_cast<float*>(out3 + r * 16), row3);
+				}
+			}
+		}
+#endif
+		for (; i < end; ++i)
+			writeOne(i);
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "EngineHeader.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifndef TRANSFORMARRAY_H
+#define TRANSFORMARRAY_H
+namespace Engine
+{
+	class JobSystem;
+
+	/// <summary>
+	/// 객체 변환 행렬을 4개씩 묶은 구조체 배열(SoA) 블록에 연속으로 저장한다.
+	/// 블록 안에서는 같은 성분(_11, _12, ...)이 4개 객체분 나란히 놓이므로 SIMD 전치 한 번으로 4개 행렬을 셰이더 형식으로 바꿀 수 있다.
+	///
+	/// 변경 여부는 슬롯(보통 프레임 리소스)마다 비트셋으로 추적한다. Set은 모든 슬롯에 더티 표시를 하고,
+	/// Flush는 한 슬롯의 더티 구간만 상수 버퍼에 기록한 뒤 그 슬롯의 표시를 지운다.
+	/// Set/Resize와 Flush는 동시에 호출하지 않는다.
+	/// </summary>
+	class D3D_API TransformArray
+	{
+	public:
+		/// <param name="slotCount">더티 상태를 따로 추적할 대상 수 (프레임 리소스 수)</param>
+		explicit TransformArray(std::uint32_t slotCount = 1);
+
+		/// <summary>
+		/// 항목 수를 바꾼다. 새 항목은 단위 행렬이며 모든 슬롯에서 더티로 표시된다.
+		/// </summary>
+		void Resize(size_t count);
+
+		/// <summary>
+		/// 행 우선 4x4 행렬(16개 float)을 저장하고 모든 슬롯에 더티 표시
+		/// </summary>
+		void Set(size_t index, const float* matrix);
+		/// <summary>
+		/// 저장된 행렬을 행 우선 16개 float로 읽는다.
+		/// </summary>
+		void Get(size_t index, float* matrix) const;
+
+		void MarkAllDirty();
+		bool IsDirty(std::uint32_t slot, size_t index) const;
+
+		/// <summary>
+		/// slot에서 더티인 항목의 전치 행렬(64 바이트)을 dst + index * stride에 기록하고 더티 표시를 지운다.
+		/// 연속된 더티 구간은 블록 단위로 전치해서 그대로 흘려 쓴다. (쓰기 결합 메모리인 업로드 힙에 적합)
+		/// jobs가 있으면 구간을 나누어 병렬로 기록한다.
+		/// </summary>
+		/// <returns>기록한 항목 수</returns>
+		size_t Flush(std::uint32_t slot, void* dst, size_t stride, JobSystem* jobs = nullptr);
+
+		size_t GetCount() const { return mCount; }
+		std::uint32_t GetSlotCount() const { return (std::uint32_t)mDirty.size(); }
+
+	private:
+		// Components[r * 4 + c][lane] = lane번째 객체 행렬의 (r, c) 성분
+		struct alignas(16) Block
+		{
+			float Components[16][4];
+		};
+
+		// [begin, end) 항목을 전치해서 기록
+		void WriteRun(size_t begin, size_t end, std::uint8_t* dst, size_t stride) const;
+		// 더티 비트셋의 [wordBegin, wordEnd) 워드를 처리
+		size_t FlushWords(std::vector<std::uint64_t>& dirty, size_t wordBegin, size_t wordEnd, std::uint8_t* dst, size_t stride) const;
+
+		std::vector<Block> mBlocks;
+		std::vector<std::vector<std::uint64_t>> mDirty;
+		size_t mCount = 0;
+	};
+}
+#endif
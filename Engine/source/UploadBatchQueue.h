@@ -0,0 +1,145 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+#ifndef UPLOADBATCHQUEUE_H
+#define UPLOADBATCHQUEUE_H
+namespace Engine
+{
+	/// <summary>
+	/// 업로드 완료를 기다리기 위한 티켓. 복사 큐 펜스가 FenceValue에 도달하면 업로드가 끝난 것이다.
+	/// FenceValue가 0이면 기다릴 것이 없다.
+	/// </summary>
+	struct UploadTicket
+	{
+		std::uint64_t FenceValue = 0;
+	};
+
+	/// <summary>
+	/// 업로드 배치 통계
+	/// </summary>
+	struct UploadBatchStats
+	{
+		std::uint64_t Batches = 0;           // 제출된 배치 수
+		std::uint64_t Copies = 0;            // 제출된 복사 수
+		std::uint64_t Bytes = 0;             // 제출된 바이트 수
+		std::uint64_t FullBatches = 0;       // 크기/개수 한도에 도달해 닫힌 배치 수
+		std::uint64_t MaxCopiesPerBatch = 0;
+	};
+
+	/// <summary>
+	/// 여러 복사를 하나의 배치로 묶고, 배치마다 펜스 값을 붙여 티켓과 배치별 데이터(TPayload)의 수명을 관리한다.
+	/// 펜스 값만 다루므로 플랫폼에 독립적이며, 정수 펜스로 단독 검증할 수 있다.
+	///
+	/// 열린 배치에 추가된 복사의 티켓은 그 배치가 닫힐 때 Signal될 펜스 값을 미리 가리킨다.
+	/// 닫힌 배치의 TPayload(스테이징 버퍼, 명령 할당자 등)는 Retire에서 펜스가 통과하면 돌려준다.
+	/// </summary>
+	template<typename TPayload>
+	class UploadBatchQueue
+	{
+	public:
+		/// <param name="maxBatchBytes">열린 배치가 이 크기 이상이면 IsBatchFull</param>
+		/// <param name="maxBatchCopies">열린 배치의 복사가 이 개수 이상이면 IsBatchFull</param>
+		/// <param name="firstFenceValue">첫 번째 배치가 Signal할 펜스 값</param>
+		UploadBatchQueue(std::uint64_t maxBatchBytes, std::uint32_t maxBatchCopies, std::uint64_t firstFenceValue = 1)
+			: mMaxBatchBytes(maxBatchBytes), mMaxBatchCopies(maxBatchCopies), mNextFenceValue(firstFenceValue)
+		{
+		}
+
+		/// <summary>
+		/// 열린 배치에 복사 하나를 추가
+		/// </summary>
+		/// <returns>이 배치가 완료되면 통과하는 티켓</returns>
+		UploadTicket AddCopy(std::uint64_t byteSize)
+		{
+			++mOpenCopies;
+			mOpenBytes += byteSize;
+			return UploadTicket{ mNextFenceValue };
+		}
+
+		/// <summary>
+		/// 열린 배치의 데이터. 배치에 묶어 둘 자원을 여기에 추가한다.
+		/// </summary>
+		TPayload& GetOpenPayload() { return mOpenPayload; }
+
+		bool HasOpenBatch() const { return mOpenCopies > 0; }
+		bool IsBatchFull() const { return mOpenBytes >= mMaxBatchBytes || mOpenCopies >= mMaxBatchCopies; }
+
+		/// <summary>
+		/// 아직 제출되지 않은 열린 배치에 속한 티켓인지 여부. 이런 티켓을 기다리려면 먼저 CloseBatch해야 한다.
+		/// </summary>
+		bool IsOpen(UploadTicket ticket) const { return HasOpenBatch() && ticket.FenceValue == mNextFenceValue; }
+
+		/// <summary>
+		/// 열린 배치를 닫는다. 호출자는 배치를 제출한 뒤 반환된 값을 Signal해야 한다.
+		/// </summary>
+		/// <returns>이 배치의 펜스 값</returns>
+		std::uint64_t CloseBatch()
+		{
+			assert(HasOpenBatch());
+
+			++mStats.Batches;
+			mStats.Copies += mOpenCopies;
+			mStats.Bytes += mOpenBytes;
+			mStats.MaxCopiesPerBatch = std::max<std::uint64_t>(mStats.MaxCopiesPerBatch, mOpenCopies);
+			if (IsBatchFull())
+				++mStats.FullBatches;
+
+			std::uint64_t fenceValue = mNextFenceValue++;
+			mInFlight.push_back(std::make_pair(fenceValue, std::move(mOpenPayload)));
+			mOpenPayload = TPayload();
+			mOpenCopies = 0;
+			mOpenBytes = 0;
+			return fenceValue;
+		}
+
+		/// <summary>
+		/// completedFenceValue까지 완료된 배치의 데이터를 제출 순서대로 onRetire에 넘긴 뒤 해제
+		/// </summary>
+		/// <returns>회수된 배치 수</returns>
+		template<typename TRetire>
+		size_t Retire(std::uint64_t completedFenceValue, TRetire&& onRetire)
+		{
+			size_t count = 0;
+			while (!mInFlight.empty() && mInFlight.front().first <= completedFenceValue)
+			{
+				onRetire(mInFlight.front().second);
+				mInFlight.pop_front();
+				++count;
+			}
+			return count;
+		}
+
+		size_t Retire(std::uint64_t completedFenceValue)
+		{
+			return Retire(completedFenceValue, [](TPayload&) {});
+		}
+
+		static bool IsComplete(UploadTicket ticket, std::uint64_t completedFenceValue)
+		{
+			return ticket.FenceValue <= completedFenceValue;
+		}
+
+		bool HasBatchesInFlight() const { return !mInFlight.empty(); }
+		// 마지막으로 닫힌 배치의 펜스 값 (없으면 firstFenceValue - 1)
+		std::uint64_t GetLastClosedFenceValue() const { return mNextFenceValue - 1; }
+
+		const UploadBatchStats& GetStats() const { return mStats; }
+
+	private:
+		std::uint64_t mMaxBatchBytes;
+		std::uint32_t mMaxBatchCopies;
+		std::uint64_t mNextFenceValue;
+
+		TPayload mOpenPayload;
+		std::uint32_t mOpenCopies = 0;
+		std::uint64_t mOpenBytes = 0;
+
+		std::deque<std::pair<std::uint64_t, TPayload>> mInFlight;
+		UploadBatchStats mStats;
+	};
+}
+#endif
@@ -0,0 +1,152 @@
+#include "UploadBatcher.h"
+
+namespace Engine
+{
+	using Microsoft::WRL::ComPtr;
+
+	UploadBatcher::UploadBatcher(ID3D12Device* device, UINT64 maxBatchBytes, UINT maxBatchCopies)
+		: mDevice(device), mFence(device), mBatches(maxBatchBytes, maxBatchCopies)
+	{
+		D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+		queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+		queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+		ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCopyQueue)));
+	}
+
+	UploadBatcher::~UploadBatcher()
+	{
+		if (mBatches.HasOpenBatch())
+			Flush();
+
+		// 복사 중인 스테이징 버퍼를 해제하지 않도록 마지막 배치를 기다린다.
+		WaitCPU(UploadTicket{ mBatches.GetLastClosedFenceValue() });
+		Retire();
+	}
+
+	ComPtr<ID3D12Resource> UploadBatcher::CreateBuffer(
+		UINT64 byteSize,
+		const std::function<void(void* mappedData)>& writeData,
+		UploadTicket& ticket)
+	{
+		ComPtr<ID3D12Resource> buffer = Util::CreateBuffer(
+			mDevice.Get(), D3D12_HEAP_TYPE_DEFAULT, byteSize, D3D12_RESOURCE_STATE_COMMON);
+
+		ticket = Upload(buffer.Get(), 0, byteSize, writeData);
+		return buffer;
+	}
+
+	ComPtr<ID3D12Resource> UploadBatcher::CreateBuffer(
+		const void* initData,
+		UINT64 byteSize,
+		UploadTicket& ticket)
+	{
+		return CreateBuffer(byteSize,
+			[initData, byteSize](void* mappedData) { memcpy(mappedData, initData, (size_t)byteSize); },
+			ticket);
+	}
+
+	UploadTicket UploadBatcher::Upload(
+		ID3D12Resource* dest,
+		UINT64 destOffset,
+		UINT64 byteSize,
+		const std::function<void(void* mappedData)>& writeData)
+	{
+		ComPtr<ID3D12Resource> staging = Util::CreateBuffer(
+			mDevice.Get(), D3D12_HEAP_TYPE_UPLOAD, byteSize, D3D12_RESOURCE_STATE_GENERIC_READ);
+
+		void* mappedData = nullptr;
+		CD3DX12_RANGE readRange(0, 0);
+		ThrowIfFailed(staging->Map(0, &readRange, &mappedData));
+		writeData(mappedData);
+		staging->Unmap(0, nullptr);
+
+		if (!mBatches.HasOpenBatch())
+			BeginBatch();
+
+		mCommandList->CopyBufferRegion(dest, destOffset, staging.Get(), 0, byteSize);
+
+		// 스테이징 버퍼는 이 배치가 끝날 때까지 유지된다.
+		mBatches.GetOpenPayload().StagingBuffers.push_back(staging);
+		UploadTicket ticket = mBatches.AddCopy(byteSize);
+
+		if (mBatches.IsBatchFull())
+			Flush();
+
+		return ticket;
+	}
+
+	UploadTicket UploadBatcher::Flush()
+	{
+		if (!mBatches.HasOpenBatch())
+			return UploadTicket{ mBatches.GetLastClosedFenceValue() };
+
+		ThrowIfFailed(mCommandList->Close());
+		ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
+		mCopyQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+
+		UINT64 fenceValue = mBatches.CloseBatch();
+		mFence.Signal(mCopyQueue.Get(), fenceValue);
+
+		return UploadTicket{ fenceValue };
+	}
+
+	void UploadBatcher::WaitGPU(ID3D12CommandQueue* queue, UploadTicket ticket)
+	{
+		if (mBatches.IsOpen(ticket))
+			Flush();
+
+		mFence.WaitGPU(queue, ticket.FenceValue);
+	}
+
+	void UploadBatcher::WaitCPU(UploadTicket ticket)
+	{
+		if (mBatches.IsOpen(ticket))
+			Flush();
+
+		mFence.WaitCPU(ticket.FenceValue);
+	}
+
+	bool UploadBatcher::IsComplete(UploadTicket ticket)
+	{
+		return mFence.IsComplete(ticket.FenceValue);
+	}
+
+	void UploadBatcher::Retire()
+	{
+		mBatches.Retire(mFence.GetCompletedValue(), [this](Batch& batch)
+		{
+			mFreeAllocators.push_back(batch.Allocator);
+		});
+	}
+
+	void UploadBatcher::BeginBatch()
+	{
+		ComPtr<ID3D12CommandAllocator> allocator;
+		if (!mFreeAllocators.empty())
+		{
+			allocator = mFreeAllocators.back();
+			mFreeAllocators.pop_back();
+			ThrowIfFailed(allocator->Reset());
+		}
+		else
+		{
+			ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&allocator)));
+		}
+
+		if (mCommandList == nullptr)
+		{
+			ThrowIfFailed(mDevice->CreateCommandList(
+				0,
+				D3D12_COMMAND_LIST_TYPE_COPY,
+				allocator.Get(),
+				nullptr,
+				IID_PPV_ARGS(mCommandList.GetAddressOf())));
+		}
+		else
+		{
+			ThrowIfFailed(mCommandList->Reset(allocator.Get(), nullptr));
+		}
+
+		mBatches.GetOpenPayload().Allocator = allocator;
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "EngineHeader.h"
+#include "UploadBatchQueue.h"
+#include "Fence.h"
+#include "Util.h"
+#include <vector>
+
+#ifndef UPLOADBATCHER_H
+#define UPLOADBATCHER_H
+namespace Engine
+{
+	/// <summary>
+	/// 전용 복사 큐(D3D12_COMMAND_LIST_TYPE_COPY)로 버퍼 업로드를 모아서 제출한다.
+	/// 여러 CopyBufferRegion이 하나의 명령 목록에 기록되고, 배치마다 복사 큐 펜스를 Signal한다.
+	/// 업로드 결과를 사용하는 큐는 WaitGPU로 티켓을 기다리며, 스테이징 버퍼는 펜스가 통과한 뒤 Retire에서 자동으로 해제된다.
+	///
+	/// 버퍼는 COMMON 상태로 만들어지고 복사 큐에서 암시적으로 COPY_DEST로 승격되었다가 다시 COMMON으로 돌아오므로,
+	/// 그래픽 큐에서는 배리어 없이 정점/인덱스 버퍼로 사용할 수 있다.
+	/// </summary>
+	class D3D_API UploadBatcher
+	{
+	public:
+		/// <param name="maxBatchBytes">열린 배치가 이 크기를 넘으면 자동으로 제출</param>
+		/// <param name="maxBatchCopies">열린 배치의 복사가 이 개수를 넘으면 자동으로 제출</param>
+		UploadBatcher(ID3D12Device* device, UINT64 maxBatchBytes = 64ull * 1024 * 1024, UINT maxBatchCopies = 256);
+		UploadBatcher(const UploadBatcher& rhs) = delete;
+		UploadBatcher& operator=(const UploadBatcher& rhs) = delete;
+		/// <summary>
+		/// 제출된 배치가 모두 끝날 때까지 기다린 뒤 해제
+		/// </summary>
+		~UploadBatcher();
+
+		/// <summary>
+		/// 기본 힙 버퍼를 만들고, writeData가 스테이징 버퍼에 기록한 데이터를 복사하도록 예약
+		/// </summary>
+		/// <param name="writeData">매핑된 스테이징 버퍼 포인터를 받아 byteSize 만큼 기록하는 함수</param>
+		/// <param name="ticket">복사가 끝났는지 확인할 티켓</param>
+		Microsoft::WRL::ComPtr<ID3D12Resource> CreateBuffer(
+			UINT64 byteSize,
+			const std::function<void(void* mappedData)>& writeData,
+			UploadTicket& ticket);
+
+		Microsoft::WRL::ComPtr<ID3D12Resource> CreateBuffer(
+			const void* initData,
+			UINT64 byteSize,
+			UploadTicket& ticket);
+
+		/// <summary>
+		/// COMMON 상태인 기존 버퍼의 destOffset 위치로 복사를 예약
+		/// </summary>
+		UploadTicket Upload(
+			ID3D12Resource* dest,
+			UINT64 destOffset,
+			UINT64 byteSize,
+			const std::function<void(void* mappedData)>& writeData);
+
+		/// <summary>
+		/// 열린 배치를 제출
+		/// </summary>
+		/// <returns>지금까지 예약된 모든 업로드를 포함하는 티켓</returns>
+		UploadTicket Flush();
+
+		/// <summary>
+		/// queue가 ticket의 업로드 완료를 GPU에서 기다리도록 한다. 아직 제출되지 않은 배치라면 먼저 제출한다.
+		/// </summary>
+		void WaitGPU(ID3D12CommandQueue* queue, UploadTicket ticket);
+
+		/// <summary>
+		/// ticket의 업로드가 끝날 때까지 CPU에서 기다린다. 아직 제출되지 않은 배치라면 먼저 제출한다.
+		/// </summary>
+		void WaitCPU(UploadTicket ticket);
+
+		bool IsComplete(UploadTicket ticket);
+
+		/// <summary>
+		/// 완료된 배치의 스테이징 버퍼를 해제하고 명령 할당자를 재사용 목록으로 돌려준다. 매 프레임 호출한다.
+		/// </summary>
+		void Retire();
+
+		ID3D12CommandQueue* GetQueue() const { return mCopyQueue.Get(); }
+		const UploadBatchStats& GetStats() const { return mBatches.GetStats(); }
+
+	private:
+		struct Batch
+		{
+			Microsoft::WRL::ComPtr<ID3D12CommandAllocator> Allocator;
+			std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> StagingBuffers;
+		};
+
+		void BeginBatch();
+
+		Microsoft::WRL::ComPtr<ID3D12Device> mDevice;
+		Microsoft::WRL::ComPtr<ID3D12CommandQueue> mCopyQueue;
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> mCommandList;
+		Fence mFence;
+
+		// 완료된 배치에서 돌려받은 명령 할당자
+		std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> mFreeAllocators;
+
+		UploadBatchQueue<Batch> mBatches;
+	};
+}
+#endif
@@ -0,0 +1,57 @@
+#include "UploadRing.h"
+
+namespace Engine
+{
+	UploadRing::UploadRing(ID3D12Device* device, UINT64 byteSize, Fence* fence)
+		: mFence(fence), mAllocator(byteSize)
+	{
+		ThrowIfFailed(device->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+			D3D12_HEAP_FLAG_NONE,
+			&CD3DX12_RESOURCE_DESC::Buffer(byteSize),
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(&mUploadBuffer)));
+
+		// 업로드 힙은 매핑한 채로 사용해도 된다.
+		ThrowIfFailed(mUploadBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mMappedData)));
+		mGPUAddress = mUploadBuffer->GetGPUVirtualAddress();
+	}
+
+	UploadRing::~UploadRing()
+	{
+		if (mUploadBuffer != nullptr)
+			mUploadBuffer->Unmap(0, nullptr);
+		mMappedData = nullptr;
+	}
+
+	UploadAllocation UploadRing::Allocate(UINT64 byteSize, UINT64 alignment)
+	{
+		UINT64 offset = mAllocator.Allocate(byteSize, alignment,
+			[this](UINT64 fenceValue)
+		{
+			mFence->WaitCPU(fenceValue);
+			return mFence->GetCompletedValue();
+		});
+		if (offset == RingAllocator::InvalidOffset)
+			ThrowIfFailed(E_OUTOFMEMORY);
+
+		UploadAllocation allocation;
+		allocation.CPU = mMappedData + offset;
+		allocation.GPU = mGPUAddress + offset;
+		allocation.Resource = mUploadBuffer.Get();
+		allocation.Offset = offset;
+		allocation.ByteSize = byteSize;
+		return allocation;
+	}
+
+	void UploadRing::EndFrame(UINT64 fenceValue)
+	{
+		mAllocator.EndFrame(fenceValue);
+	}
+
+	void UploadRing::Retire()
+	{
+		mAllocator.Retire(mFence->GetCompletedValue());
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "EngineHeader.h"
+#include "RingAllocator.h"
+#include "Fence.h"
+#include "Util.h"
+
+#ifndef UPLOADRING_H
+#define UPLOADRING_H
+namespace Engine
+{
+	/// <summary>
+	/// 업로드 링에서 받은 구간. 다음 Retire에서 회수될 수 있으므로 프레임이 끝난 뒤에는 사용하지 않는다.
+	/// </summary>
+	struct UploadAllocation
+	{
+		BYTE* CPU = nullptr;                       // 매핑된 CPU 주소
+		D3D12_GPU_VIRTUAL_ADDRESS GPU = 0;          // 상수 버퍼 뷰, 루트 CBV, 정점 버퍼 뷰 등에 사용
+		ID3D12Resource* Resource = nullptr;          // CopyBufferRegion의 원본으로 사용
+		UINT64 Offset = 0;                           // Resource 안에서의 오프셋
+		UINT64 ByteSize = 0;
+	};
+
+	/// <summary>
+	/// 하나의 큰 업로드 힙을 계속 매핑해 두고 프레임마다 구간을 나누어 주는 링 버퍼.
+	/// 프레임별 상수, 동적 정점, 복사용 스테이징 데이터가 모두 같은 자원을 공유한다.
+	/// 할당/회수 규칙은 RingAllocator가 담당하고, 이 클래스는 자원과 펜스 대기만 처리한다.
+	/// </summary>
+	class D3D_API UploadRing
+	{
+	public:
+		/// <param name="byteSize">업로드 힙 크기. 진행 중인 모든 프레임의 할당이 들어갈 수 있어야 한다.</param>
+		/// <param name="fence">EndFrame에 넘기는 값을 Signal하는 펜스</param>
+		UploadRing(ID3D12Device* device, UINT64 byteSize, Fence* fence);
+		UploadRing(const UploadRing& rhs) = delete;
+		UploadRing& operator=(const UploadRing& rhs) = delete;
+		~UploadRing();
+
+		/// <summary>
+		/// byteSize 바이트 할당. 공간이 없으면 GPU가 이전 프레임을 끝낼 때까지 기다리고,
+		/// 진행 중인 프레임을 모두 기다려도 부족하면 E_OUTOFMEMORY로 DxException을 던진다.
+		/// </summary>
+		/// <param name="alignment">기본값은 상수 버퍼 정렬(256 바이트)</param>
+		UploadAllocation Allocate(UINT64 byteSize, UINT64 alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+		/// <summary>
+		/// 상수 버퍼 하나를 할당하고 data를 복사
+		/// </summary>
+		template<typename T>
+		UploadAllocation AllocateConstants(const T& data)
+		{
+			UploadAllocation allocation = Allocate(Util::CalcConstantBufferByteSize(sizeof(T)));
+			memcpy(allocation.CPU, &data, sizeof(T));
+			return allocation;
+		}
+
+		/// <summary>
+		/// 이번 프레임의 할당을 fenceValue에 묶는다. 커맨드 큐에 fenceValue를 Signal한 뒤 호출한다.
+		/// </summary>
+		void EndFrame(UINT64 fenceValue);
+
+		/// <summary>
+		/// GPU가 완료한 프레임의 공간 회수
+		/// </summary>
+		void Retire();
+
+		ID3D12Resource* Resource() const { return mUploadBuffer.Get(); }
+		const RingAllocator& GetAllocator() const { return mAllocator; }
+		const RingAllocatorStats& GetStats() const { return mAllocator.GetStats(); }
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Resource> mUploadBuffer;
+		BYTE* mMappedData = nullptr;
+		D3D12_GPU_VIRTUAL_ADDRESS mGPUAddress = 0;
+
+		Fence* mFence = nullptr;
+
+		RingAllocator mAllocator;
+	};
+}
+#endif
@@ -1,9 +1,16 @@
 #include "Util.h"
+#include "GeometryGenerator.h"
+#include "PlacedBufferAllocator.h"
 
 namespace Engine
 {
 	using Microsoft::WRL::ComPtr;
 
+	namespace
+	{
+		PlacedBufferAllocator* gBufferAllocator = nullptr;
+	}
+
 	DxException::DxException(HRESULT hr, const std::wstring& functionName, const std::wstring& filename, int lineNumber)
 		: ErrorCode(hr),
 		FunctionName(functionName),
@@ -36,52 +43,115 @@ namespace Engine
 		return blob;
 	}
 
-	ComPtr<ID3D12Resource> Util::CreateDefaultBuffer(
+	void Util::SetBufferAllocator(PlacedBufferAllocator* allocator)
+	{
+		gBufferAllocator = allocator;
+	}
+
+	ComPtr<ID3D12Resource> Util::CreateBuffer(
 		ID3D12Device* device,
-		ID3D12GraphicsCommandList* cmdList,
-		const void* initData,
+		D3D12_HEAP_TYPE heapType,
 		UINT64 byteSize,
-		Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer)
+		D3D12_RESOURCE_STATES initialState)
 	{
-		ComPtr<ID3D12Resource> defaultBuffer;
+		if (gBufferAllocator != nullptr)
+			return gBufferAllocator->CreateBuffer(heapType, byteSize, initialState);
 
-		// ⺻  
+		ComPtr<ID3D12Resource> buffer;
 		ThrowIfFailed(device->CreateCommittedResource(
-			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+			&CD3DX12_HEAP_PROPERTIES(heapType),
 			D3D12_HEAP_FLAG_NONE,
 			&CD3DX12_RESOURCE_DESC::Buffer(byteSize),
-			D3D12_RESOURCE_STATE_COMMON,
+			initialState,
 			nullptr,
-			IID_PPV_ARGS(defaultBuffer.GetAddressOf())));
-
-		// ⺻ CPU ޸𸮸 ϱ  ε  
-		ThrowIfFailed(device->CreateCommittedResource(
-			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-			D3D12_HEAP_FLAG_NONE,
-			&CD3DX12_RESOURCE_DESC::Buffer(byteSize),
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-			nullptr,
-			IID_PPV_ARGS(uploadBuffer.GetAddressOf())));
+			IID_PPV_ARGS(buffer.GetAddressOf())));
+		return buffer;
+	}
 
-		// ⺻  ϰ ϴ ͸ 
-		D3D12_SUBRESOURCE_DATA subResourceData = {};
-		subResourceData.pData = initData;
-		subResourceData.RowPitch = byteSize;
-		subResourceData.SlicePitch = subResourceData.RowPitch;
+	ComPtr<ID3D12Resource> Util::CreateDefaultBuffer(
+		ID3D12Device* device,
+		ID3D12GraphicsCommandList* cmdList,
+		const void* initData,
+		UINT64 byteSize,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer)
+	{
+		return CreateDefaultBuffer(device, cmdList, byteSize,
+			[initData, byteSize](void* mappedData) { memcpy(mappedData, initData, (size_t)byteSize); },
+			uploadBuffer);
+	}
 
-		// ͸ ⺻  ϵ .
-		// UpdateSubresource Լ CPU ޸𸮸 ε  ϰ,  Ŀ CopySubresourceRegionԼ Ͽ, ε  ͸ mBuffer Ѵ.
+	ComPtr<ID3D12Resource> Util::CreateDefaultBuffer(
+		ID3D12Device* device,
+		ID3D12GraphicsCommandList* cmdList,
+		UINT64 byteSize,
+		const std::function<void(void* mappedData)>& writeData,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer)
+	{
+		// 기본 힙 생성
+		ComPtr<ID3D12Resource> defaultBuffer = CreateBuffer(
+			device, D3D12_HEAP_TYPE_DEFAULT, byteSize, D3D12_RESOURCE_STATE_COMMON);
+
+		// 기본힙으로 CPU 메모리를 복사하기 위한 업로드 힙 생성
+		uploadBuffer = CreateBuffer(
+			device, D3D12_HEAP_TYPE_UPLOAD, byteSize, D3D12_RESOURCE_STATE_GENERIC_READ);
+
+		// 업로드 힙에 직접 데이터를 기록. CPU는 읽지 않으므로 읽기 범위는 비워 둔다.
+		void* mappedData = nullptr;
+		CD3DX12_RANGE readRange(0, 0);
+		ThrowIfFailed(uploadBuffer->Map(0, &readRange, &mappedData));
+		writeData(mappedData);
+		uploadBuffer->Unmap(0, nullptr);
+
+		// 업로드 힙의 데이터를 기본 힙으로 복사하도록 예약.
 		cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(defaultBuffer.Get(), 
 			D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST));
-		UpdateSubresources<1>(cmdList, defaultBuffer.Get(), uploadBuffer.Get(),
-			0, 0, 1, &subResourceData);
+		cmdList->CopyBufferRegion(defaultBuffer.Get(), 0, uploadBuffer.Get(), 0, byteSize);
 		cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(defaultBuffer.Get(),
 			D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
 
-		//  Ŀ uploadBuffer  縦 ϴ   Ǳ  Ǿ ȵȴ.  
+		// 이 이후에도 uploadBuffer는 실제 복사를 수행하는 명령이 실행이 되기 전까지는 해제되어선 안된다.  
 		return defaultBuffer;
 	}
 
+	DXGI_FORMAT Util::GetIndexFormat(
+		const std::vector<const std::vector<std::uint32_t>*>& indexArrays,
+		UINT& byteSize)
+	{
+		UINT indexCount = 0;
+		bool fitsIn16Bits = true;
+		for (const std::vector<std::uint32_t>* indices : indexArrays)
+		{
+			indexCount += (UINT)indices->size();
+			fitsIn16Bits = fitsIn16Bits && GeometryGenerator::FitsIn16Bits(indices->data(), indices->size());
+		}
+
+		byteSize = indexCount * (fitsIn16Bits ? sizeof(std::uint16_t) : sizeof(std::uint32_t));
+		return fitsIn16Bits ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	}
+
+	void Util::WriteIndices(
+		const std::vector<const std::vector<std::uint32_t>*>& indexArrays,
+		DXGI_FORMAT format,
+		void* dest)
+	{
+		std::uint8_t* out = static_cast<std::uint8_t*>(dest);
+		for (const std::vector<std::uint32_t>* indices : indexArrays)
+		{
+			if (format == DXGI_FORMAT_R16_UINT)
+			{
+				bool fits = GeometryGenerator::NarrowIndices(indices->data(), reinterpret_cast<std::uint16_t*>(out), indices->size());
+				assert(fits);
+				(void)fits;
+				out += indices->size() * sizeof(std::uint16_t);
+			}
+			else
+			{
+				memcpy(out, indices->data(), indices->size() * sizeof(std::uint32_t));
+				out += indices->size() * sizeof(std::uint32_t);
+			}
+		}
+	}
+
 	ComPtr<ID3DBlob> Util::CompileShader(
 		const std::wstring& filename,
 		const D3D_SHADER_MACRO* defines,
@@ -99,12 +169,12 @@ namespace Engine
 		hr = D3DCompileFromFile(filename.c_str(), defines, D3D_COMPILE_STANDARD_FILE_INCLUDE,
 			entrypoint.c_str(), target.c_str(), compileFlags, 0, &byteCode, &errors);
 
-		//  üũ 1
+		// 에러 체크 1
 		if (errors != nullptr)
 		{
 			OutputDebugStringA(static_cast<char*>(errors->GetBufferPointer()));
 		}
-		//  üũ 2
+		// 에러 체크 2
 		ThrowIfFailed(hr);
 
 		return byteCode;
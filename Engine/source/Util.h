@@ -1,25 +1,28 @@
 #pragma once
 #include "EngineHeader.h"
-//  ̺귯
+// 윈도우 라이브러리
 #include <Windows.h>
 #include <wrl.h>
 #include <comdef.h>
-// ̷ƮX ̺귯
+// 다이렉트X 라이브러리
 #include <dxgi1_4.h>
 #include "d3dx12.h"
 #include <D3Dcompiler.h>
 #include <DirectXPackedVector.h>
 #include <DirectXColors.h>
 #include <DirectXCollision.h>
-// std ̺귯
+// std 라이브러리
 #include <string>
 #include <array>
 #include <unordered_map>
 #include <fstream>
+#include <functional>
 #include <cassert>
 
 namespace Engine
 {
+    class PlacedBufferAllocator;
+
     inline std::wstring AnsiToWString(const std::string& str)
     {
 		WCHAR buffer[512];
@@ -36,18 +39,33 @@ namespace Engine
         }
 
         /// <summary>
-        /// ̳ʸ  б
+        /// 바이너리 파일 읽기
         /// </summary>
-        /// <param name="filename"> ̸</param>
-        /// <returns> </returns>
+        /// <param name="filename">파일 이름</param>
+        /// <returns>파일 데이터</returns>
         static Microsoft::WRL::ComPtr<ID3DBlob> LoadBinary(const std::wstring& filename);
 
         /// <summary>
-        /// ⺻   Լ
+        /// CreateDefaultBuffer가 기본 힙/업로드 힙 버퍼를 배치할 할당기 설정.
+        /// nullptr이면 버퍼마다 커밋 자원을 만든다. 할당기는 설정된 동안 살아 있어야 한다.
+        /// </summary>
+        static void SetBufferAllocator(PlacedBufferAllocator* allocator);
+
+        /// <summary>
+        /// heapType 힙에 버퍼 생성. SetBufferAllocator로 설정된 할당기가 있으면 그 힙 블록 안에 배치한다.
+        /// </summary>
+        static Microsoft::WRL::ComPtr<ID3D12Resource> CreateBuffer(
+            ID3D12Device* device,
+            D3D12_HEAP_TYPE heapType,
+            UINT64 byteSize,
+            D3D12_RESOURCE_STATES initialState);
+
+        /// <summary>
+        /// 기본 힙 생성 함수
         /// </summary>
-        /// <param name="initData">ʱ </param>
-        /// <param name="byteSize"> ũ</param>
-        /// <param name="uploadBuffer"> 縦  ε </param>
+        /// <param name="initData">초기 데이터</param>
+        /// <param name="byteSize">데이터 크기</param>
+        /// <param name="uploadBuffer">데이터 복사를 위한 업로드 힙</param>
         static Microsoft::WRL::ComPtr<ID3D12Resource> CreateDefaultBuffer(
             ID3D12Device* device,
             ID3D12GraphicsCommandList* cmdList,
@@ -56,13 +74,43 @@ namespace Engine
             Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer);
 
         /// <summary>
-        /// ̴  Լ
+        /// 기본 힙 생성 함수. 초기 데이터를 CPU 메모리에 따로 만들지 않고
+        /// writeData가 매핑된 업로드 힙에 직접 기록한다.
+        /// </summary>
+        /// <param name="byteSize">데이터 크기</param>
+        /// <param name="writeData">매핑된 업로드 힙 포인터를 받아 byteSize 만큼 기록하는 함수</param>
+        /// <param name="uploadBuffer">데이터 복사를 위한 업로드 힙</param>
+        static Microsoft::WRL::ComPtr<ID3D12Resource> CreateDefaultBuffer(
+            ID3D12Device* device,
+            ID3D12GraphicsCommandList* cmdList,
+            UINT64 byteSize,
+            const std::function<void(void* mappedData)>& writeData,
+            Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer);
+
+        /// <summary>
+        /// 32비트 인덱스 배열들을 이어 붙였을 때 사용할 인덱스 형식과 바이트 크기 계산.
+        /// 모든 인덱스가 65535 이하이면 R16_UINT, 아니면 R32_UINT.
+        /// </summary>
+        static DXGI_FORMAT GetIndexFormat(
+            const std::vector<const std::vector<std::uint32_t>*>& indexArrays,
+            UINT& byteSize);
+
+        /// <summary>
+        /// 32비트 인덱스 배열들을 format(R16_UINT 또는 R32_UINT)으로 변환하여 dest에 순서대로 기록
+        /// </summary>
+        static void WriteIndices(
+            const std::vector<const std::vector<std::uint32_t>*>& indexArrays,
+            DXGI_FORMAT format,
+            void* dest);
+
+        /// <summary>
+        /// 셰이더 컴파일 함수
         /// </summary>
-        /// <param name="filename">  ϸ</param>
-        /// <param name="defines"> ɼ</param>
-        /// <param name="entrypoint">̴  Լ ̸</param>
-        /// <param name="target"> ̴  </param>
-        /// <returns>̴ Ʈڵ </returns>
+        /// <param name="filename">컴파일 할 파일명</param>
+        /// <param name="defines">컴파일 옵션</param>
+        /// <param name="entrypoint">셰이더의 진입점 함수의 이름</param>
+        /// <param name="target">사용할 셰이더의 종류와 버전</param>
+        /// <returns>셰이더 바이트코드 포인터</returns>
         static Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(
             const std::wstring& filename,
             const D3D_SHADER_MACRO* defines,
@@ -84,21 +132,27 @@ namespace Engine
         int LineNumber = -1;
     };
 
-    // ϳ /ε ۿ  Geometry Ǵ  
+    // 하나의 정점/인덱스 버퍼에 여러개의 Geometry들이 저장되는 경우 사용됨
     struct SubmeshGeometry
     {
         UINT IndexCount = 0;
         UINT StartIndexLocation = 0;
         INT BaseVertexLocation = 0;
 
+		// 메쉬 공간(압축 해제된 위치 기준) 경계. 컬링에 사용된다.
 		DirectX::BoundingBox Bounds;
+		DirectX::BoundingSphere SphereBounds;
+
+		// 압축된 정점 위치의 복원 값 (메쉬 공간 위치 = 저장된 위치 * PositionScale + PositionOffset)
+		DirectX::XMFLOAT3 PositionScale = { 1.0f, 1.0f, 1.0f };
+		DirectX::XMFLOAT3 PositionOffset = { 0.0f, 0.0f, 0.0f };
 	};
 
     struct MeshGeometry
     {
         std::string Name;
 
-        // ý ޸ 纻. Ŭ̾Ʈ  ȯ ؾ .
+        // 시스템 메모리의 복사본. 클라이언트가 적절한 형변환을 해야 함.
         Microsoft::WRL::ComPtr<ID3DBlob> VertexBufferCPU = nullptr;
         Microsoft::WRL::ComPtr<ID3DBlob> IndexBufferCPU = nullptr;
 
@@ -108,14 +162,14 @@ namespace Engine
         Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferUploader = nullptr;
         Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferUploader = nullptr;
 
-        //  
+        // 버퍼 정보
         UINT VertexByteStride = 0;
         UINT VertexBufferByteSize = 0;
         DXGI_FORMAT IndexFormat = DXGI_FORMAT_R16_UINT;
         UINT IndexBufferByteSize = 0;
 
-        // ϳ ؽ/ε ۿ  Geometry Ǿ   ִ.
-        // SubmeshGeomtry ؼ  Submesh  ׸  ֵ.
+        // 하나의 버텍스/인덱스 버퍼에 복수개의 Geometry가 저장되어 있을 수 있다.
+        // SubmeshGeomtry를 사용해서 각 Submesh들을 개별적으로 그릴 수 있따.
         std::unordered_map<std::string, SubmeshGeometry> DrawArgs;
 
         D3D12_VERTEX_BUFFER_VIEW VertexBufferView() const
@@ -135,7 +189,8 @@ namespace Engine
             ibv.SizeInBytes = IndexBufferByteSize;
             return ibv;
         }
-        // GPU ε尡 ٸ, ޸𸮸 Ѵ.
+        // GPU에 업로드가 끝났다면, 메모리를 해제한다.
+        // (UploadBatcher로 업로드한 경우 Uploader는 비어 있고 스테이징 버퍼는 자동으로 해제된다)
         void DisposeUploaders()
         {
             VertexBufferUploader = nullptr;
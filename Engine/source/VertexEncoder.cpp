@@ -0,0 +1,330 @@
+#include "VertexEncoder.h"
+#include <DirectXPackedVector.h>
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace Engine
+{
+	using namespace DirectX;
+	using namespace DirectX::PackedVector;
+	using uint32 = GeometryGenerator::uint32;
+
+	namespace
+	{
+		uint32 GetPositionSize(PositionEncoding encoding)
+		{
+			return encoding == PositionEncoding::Float3 ? 12u : 8u;
+		}
+
+		float SignNotZero(float v)
+		{
+			return v >= 0.0f ? 1.0f : -1.0f;
+		}
+
+		std::int16_t QuantizeSnorm16(float v)
+		{
+			v = std::max(-1.0f, std::min(1.0f, v));
+			return static_cast<std::int16_t>(std::lround(v * 32767.0f));
+		}
+
+		std::uint16_t QuantizeUnorm16(float v)
+		{
+			v = std::max(0.0f, std::min(1.0f, v));
+			return static_cast<std::uint16_t>(std::lround(v * 65535.0f));
+		}
+
+		std::uint8_t QuantizeUnorm8(float v)
+		{
+			v = std::max(0.0f, std::min(1.0f, v));
+			return static_cast<std::uint8_t>(std::lround(v * 255.0f));
+		}
+
+		// 단위 벡터를 팔면체에 투영한 뒤 아래 반구를 접어 [-1, 1]^2 로 표현
+		void EncodeOctahedral(const XMFLOAT3& n, std::int16_t out[2])
+		{
+			float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+			if (l1 <= 0.0f)
+			{
+				out[0] = 0;
+				out[1] = 0;
+				return;
+			}
+
+			float x = n.x / l1;
+			float y = n.y / l1;
+			if (n.z < 0.0f)
+			{
+				float fx = (1.0f - std::fabs(y)) * SignNotZero(x);
+				float fy = (1.0f - std::fabs(x)) * SignNotZero(y);
+				x = fx;
+				y = fy;
+			}
+
+			out[0] = QuantizeSnorm16(x);
+			out[1] = QuantizeSnorm16(y);
+		}
+
+		XMFLOAT3 DecodeOctahedral(const std::int16_t in[2])
+		{
+			// SNORM 변환 규칙: -32768은 -1로 처리
+			float x = std::max(-1.0f, in[0] / 32767.0f);
+			float y = std::max(-1.0f, in[1] / 32767.0f);
+			float z = 1.0f - std::fabs(x) - std::fabs(y);
+			float t = std::max(-z, 0.0f);
+			x += x >= 0.0f ? -t : t;
+			y += y >= 0.0f ? -t : t;
+
+			XMFLOAT3 n;
+			XMStoreFloat3(&n, XMVector3Normalize(XMVectorSet(x, y, z, 0.0f)));
+			return n;
+		}
+	}
+
+	uint32 VertexEncoder::GetVertexStride(const VertexFormat& format)
+	{
+		uint32 stride = GetPositionSize(format.Position);
+		stride += format.Normal ? 4 : 0;
+		stride += format.Tangent ? 4 : 0;
+		stride += format.TexC ? 4 : 0;
+		stride += format.Color ? 4 : 0;
+		return stride;
+	}
+
+#if defined(_WIN32)
+	std::vector<D3D12_INPUT_ELEMENT_DESC> VertexEncoder::GetInputLayout(const VertexFormat& format, UINT inputSlot)
+	{
+		std::vector<D3D12_INPUT_ELEMENT_DESC> layout;
+		UINT offset = 0;
+
+		auto add = [&](LPCSTR semantic, DXGI_FORMAT dxgiFormat, UINT size)
+		{
+			layout.push_back({ semantic, 0, dxgiFormat, inputSlot, offset, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 });
+			offset += size;
+		};
+
+		switch (format.Position)
+		{
+		case PositionEncoding::Float3:
+			add("POSITION", DXGI_FORMAT_R32G32B32_FLOAT, 12);
+			break;
+		case PositionEncoding::Half4:
+			add("POSITION", DXGI_FORMAT_R16G16B16A16_FLOAT, 8);
+			break;
+		case PositionEncoding::Unorm16x4:
+			add("POSITION", DXGI_FORMAT_R16G16B16A16_UNORM, 8);
+			break;
+		}
+
+		if (format.Normal)
+			add("NORMAL", DXGI_FORMAT_R16G16_SNORM, 4);
+		if (format.Tangent)
+			add("TANGENT", DXGI_FORMAT_R16G16_SNORM, 4);
+		if (format.TexC)
+			add("TEXCOORD", DXGI_FORMAT_R16G16_FLOAT, 4);
+		if (format.Color)
+			add("COLOR", DXGI_FORMAT_R8G8B8A8_UNORM, 4);
+
+		return layout;
+	}
+#endif
+
+	EncodedVertices VertexEncoder::Encode(
+		const std::vector<GeometryGenerator::Vertex>& vertices,
+		const VertexFormat& format,
+		const XMFLOAT4& color)
+	{
+		EncodedVertices result;
+		result.VertexCount = (uint32)vertices.size();
+		result.VertexStride = GetVertexStride(format);
+		result.Data.resize((size_t)result.VertexCount * result.VertexStride);
+
+		// 위치 양자화 기준이 되는 경계 상자
+		XMVECTOR vMin = XMVectorSet(+FLT_MAX, +FLT_MAX, +FLT_MAX, 0.0f);
+		XMVECTOR vMax = XMVectorSet(-FLT_MAX, -FLT_MAX, -FLT_MAX, 0.0f);
+		for (const GeometryGenerator::Vertex& v : vertices)
+		{
+			XMVECTOR p = XMLoadFloat3(&v.Position);
+			vMin = XMVectorMin(vMin, p);
+			vMax = XMVectorMax(vMax, p);
+		}
+		if (vertices.empty())
+		{
+			vMin = XMVectorZero();
+			vMax = XMVectorZero();
+		}
+
+		XMFLOAT3 boundsMin;
+		XMFLOAT3 boundsSize;
+		XMStoreFloat3(&boundsMin, vMin);
+		XMStoreFloat3(&boundsSize, vMax - vMin);
+
+		XMFLOAT3 invSize(
+			boundsSize.x > 0.0f ? 1.0f / boundsSize.x : 0.0f,
+			boundsSize.y > 0.0f ? 1.0f / boundsSize.y : 0.0f,
+			boundsSize.z > 0.0f ? 1.0f / boundsSize.z : 0.0f);
+
+		switch (format.Position)
+		{
+		case PositionEncoding::Float3:
+			break;
+		case PositionEncoding::Half4:
+			// 중심 기준으로 저장해야 half의 정밀도를 가장 잘 활용할 수 있다.
+			XMStoreFloat3(&result.PositionOffset, 0.5f * (vMin + vMax));
+			break;
+		case PositionEncoding::Unorm16x4:
+			result.PositionScale = boundsSize;
+			result.PositionOffset = boundsMin;
+			break;
+		}
+
+		std::uint8_t packedColor[4] =
+		{
+			QuantizeUnorm8(color.x),
+			QuantizeUnorm8(color.y),
+			QuantizeUnorm8(color.z),
+			QuantizeUnorm8(color.w),
+		};
+
+		std::uint8_t* dest = result.Data.data();
+		for (const GeometryGenerator::Vertex& v : vertices)
+		{
+			const XMFLOAT3& p = v.Position;
+			const XMFLOAT3& o = result.PositionOffset;
+
+			switch (format.Position)
+			{
+			case PositionEncoding::Float3:
+				std::memcpy(dest, &p, 12);
+				dest += 12;
+				break;
+			case PositionEncoding::Half4:
+			{
+				HALF h[4] =
+				{
+					XMConvertFloatToHalf(p.x - o.x),
+					XMConvertFloatToHalf(p.y - o.y),
+					XMConvertFloatToHalf(p.z - o.z),
+					XMConvertFloatToHalf(1.0f),
+				};
+				std::memcpy(dest, h, 8);
+				dest += 8;
+				break;
+			}
+			case PositionEncoding::Unorm16x4:
+			{
+				std::uint16_t q[4] =
+				{
+					QuantizeUnorm16((p.x - o.x) * invSize.x),
+					QuantizeUnorm16((p.y - o.y) * invSize.y),
+					QuantizeUnorm16((p.z - o.z) * invSize.z),
+					65535,
+				};
+				std::memcpy(dest, q, 8);
+				dest += 8;
+				break;
+			}
+			}
+
+			if (format.Normal)
+			{
+				std::int16_t e[2];
+				EncodeOctahedral(v.Normal, e);
+				std::memcpy(dest, e, 4);
+				dest += 4;
+			}
+
+			if (format.Tangent)
+			{
+				std::int16_t e[2];
+				EncodeOctahedral(v.TangentU, e);
+				std::memcpy(dest, e, 4);
+				dest += 4;
+			}
+
+			if (format.TexC)
+			{
+				HALF h[2] = { XMConvertFloatToHalf(v.TexC.x), XMConvertFloatToHalf(v.TexC.y) };
+				std::memcpy(dest, h, 4);
+				dest += 4;
+			}
+
+			if (format.Color)
+			{
+				std::memcpy(dest, packedColor, 4);
+				dest += 4;
+			}
+		}
+
+		return result;
+	}
+
+	GeometryGenerator::Vertex VertexEncoder::Decode(const EncodedVertices& encoded, const VertexFormat& format, uint32 index)
+	{
+		assert(index < encoded.VertexCount);
+
+		GeometryGenerator::Vertex v(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+		const std::uint8_t* src = encoded.Data.data() + (size_t)index * encoded.VertexStride;
+
+		const XMFLOAT3& s = encoded.PositionScale;
+		const XMFLOAT3& o = encoded.PositionOffset;
+
+		switch (format.Position)
+		{
+		case PositionEncoding::Float3:
+			std::memcpy(&v.Position, src, 12);
+			src += 12;
+			break;
+		case PositionEncoding::Half4:
+		{
+			HALF h[4];
+			std::memcpy(h, src, 8);
+			v.Position = XMFLOAT3(
+				XMConvertHalfToFloat(h[0]) + o.x,
+				XMConvertHalfToFloat(h[1]) + o.y,
+				XMConvertHalfToFloat(h[2]) + o.z);
+			src += 8;
+			break;
+		}
+		case PositionEncoding::Unorm16x4:
+		{
+			std::uint16_t q[4];
+			std::memcpy(q, src, 8);
+			v.Position = XMFLOAT3(
+				q[0] / 65535.0f * s.x + o.x,
+				q[1] / 65535.0f * s.y + o.y,
+				q[2] / 65535.0f * s.z + o.z);
+			src += 8;
+			break;
+		}
+		}
+
+		if (format.Normal)
+		{
+			std::int16_t e[2];
+			std::memcpy(e, src, 4);
+			v.Normal = DecodeOctahedral(e);
+			src += 4;
+		}
+
+		if (format.Tangent)
+		{
+			std::int16_t e[2];
+			std::memcpy(e, src, 4);
+			v.TangentU = DecodeOctahedral(e);
+			src += 4;
+		}
+
+		if (format.TexC)
+		{
+			HALF h[2];
+			std::memcpy(h, src, 4);
+			v.TexC = XMFLOAT2(XMConvertHalfToFloat(h[0]), XMConvertHalfToFloat(h[1]));
+			src += 4;
+		}
+
+		return v;
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "EngineHeader.h"
+#include "GeometryGenerator.h"
+#if defined(_WIN32)
+#include "Util.h"
+#endif
+
+#ifndef VERTEXENCODER_H
+#define VERTEXENCODER_H
+namespace Engine
+{
+	/// <summary>
+	/// 정점 위치 저장 방식
+	/// </summary>
+	enum class PositionEncoding
+	{
+		Float3,    // R32G32B32_FLOAT (12 바이트)
+		Half4,     // R16G16B16A16_FLOAT (8 바이트), 경계 상자 중심 기준 상대 위치
+		Unorm16x4, // R16G16B16A16_UNORM (8 바이트), 경계 상자 안에서 정규화된 위치
+	};
+
+	/// <summary>
+	/// 압축 정점 레이아웃. 속성은 아래 순서대로 하나의 정점 안에 배치된다.
+	/// </summary>
+	struct VertexFormat
+	{
+		PositionEncoding Position = PositionEncoding::Unorm16x4;
+		bool Normal = true;  // NORMAL: 팔면체 인코딩 R16G16_SNORM (4 바이트)
+		bool Tangent = true; // TANGENT: 팔면체 인코딩 R16G16_SNORM (4 바이트)
+		bool TexC = true;    // TEXCOORD: R16G16_FLOAT (4 바이트)
+		bool Color = false;  // COLOR: R8G8B8A8_UNORM (4 바이트)
+	};
+
+	/// <summary>
+	/// 압축된 정점 데이터. 정점 버퍼에 그대로 복사할 수 있다.
+	/// </summary>
+	struct EncodedVertices
+	{
+		std::vector<std::uint8_t> Data;
+		GeometryGenerator::uint32 VertexCount = 0;
+		GeometryGenerator::uint32 VertexStride = 0;
+
+		// 메쉬 공간 위치 = 저장된 위치 * PositionScale + PositionOffset
+		DirectX::XMFLOAT3 PositionScale = { 1.0f, 1.0f, 1.0f };
+		DirectX::XMFLOAT3 PositionOffset = { 0.0f, 0.0f, 0.0f };
+	};
+
+	/// <summary>
+	/// GeometryGenerator::Vertex를 압축 정점 레이아웃으로 변환하고, 대응하는 입력 레이아웃을 생성한다.
+	/// 팔면체 인코딩된 법선/접선은 셰이더에서 아래와 같이 복원한다.
+	///   float3 n = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+	///   float t = saturate(-n.z);
+	///   n.xy += n.xy >= 0.0f ? -t : t;
+	///   n = normalize(n);
+	/// 길이가 0인 법선/접선은 보존되지 않는다.
+	/// </summary>
+	class D3D_API VertexEncoder
+	{
+	public:
+		using uint32 = GeometryGenerator::uint32;
+
+		/// <summary>
+		/// 압축 정점 하나의 바이트 크기
+		/// </summary>
+		static uint32 GetVertexStride(const VertexFormat& format);
+
+#if defined(_WIN32)
+		/// <summary>
+		/// 압축 정점 레이아웃에 대응하는 입력 레이아웃 생성. 시맨틱 이름은 정적 문자열을 가리킨다.
+		/// </summary>
+		static std::vector<D3D12_INPUT_ELEMENT_DESC> GetInputLayout(const VertexFormat& format, UINT inputSlot = 0);
+#endif
+
+		/// <summary>
+		/// 정점 배열 전체를 압축. 위치는 정점들의 경계 상자를 기준으로 양자화한다.
+		/// </summary>
+		/// <param name="color">MeshData에는 색상이 없으므로 format.Color일 때 모든 정점에 쓰일 색상</param>
+		static EncodedVertices Encode(
+			const std::vector<GeometryGenerator::Vertex>& vertices,
+			const VertexFormat& format,
+			const DirectX::XMFLOAT4& color = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f));
+
+		/// <summary>
+		/// 압축된 정점 하나를 복원 (CPU 검증용). 압축하지 않은 속성은 0으로 채워진다.
+		/// </summary>
+		static GeometryGenerator::Vertex Decode(const EncodedVertices& encoded, const VertexFormat& format, uint32 index);
+
+		/// <summary>
+		/// 저장된 위치를 메쉬 공간으로 복원하는 변환. 월드 행렬 앞에 곱하면 셰이더 수정 없이 그릴 수 있다.
+		/// </summary>
+		static DirectX::XMMATRIX GetPositionDecodeMatrix(const DirectX::XMFLOAT3& scale, const DirectX::XMFLOAT3& offset)
+		{
+			return DirectX::XMMatrixScaling(scale.x, scale.y, scale.z) *
+				DirectX::XMMatrixTranslation(offset.x, offset.y, offset.z);
+		}
+	};
+}
+#endif
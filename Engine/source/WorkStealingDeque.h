@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+#ifndef WORKSTEALINGDEQUE_H
+#define WORKSTEALINGDEQUE_H
+namespace Engine
+{
+	/// <summary>
+	/// Chase-Lev 작업 훔치기 덱 (Le et al. 2013, 약한 메모리 모델용 버전).
+	/// 소유 스레드만 Push/Pop으로 아래쪽(LIFO)을 사용하고, 다른 스레드들은 Steal로 위쪽(FIFO)에서 가져간다.
+	/// 용량은 고정이며, 가득 차면 Push가 false를 반환한다(호출자가 직접 실행).
+	/// </summary>
+	template<typename T>
+	class WorkStealingDeque
+	{
+	public:
+		/// <param name="capacity">2의 거듭제곱</param>
+		explicit WorkStealingDeque(std::int64_t capacity = 4096)
+			: mMask(capacity - 1), mBuffer(new std::atomic<T*>[(size_t)capacity])
+		{
+			assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+		}
+		WorkStealingDeque(const WorkStealingDeque& rhs) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque& rhs) = delete;
+
+		/// <summary>
+		/// 소유 스레드 전용
+		/// </summary>
+		bool Push(T* item)
+		{
+			std::int64_t bottom = mBottom.load(std::memory_order_relaxed);
+			std::int64_t top = mTop.load(std::memory_order_acquire);
+			if (bottom - top > mMask)
+				return false;
+
+			mBuffer[bottom & mMask].store(item, std::memory_order_relaxed);
+			// 항목 기록이 bottom 증가보다 먼저 보이도록 한다.
+			mBottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// <summary>
+		/// 소유 스레드 전용. 가장 최근에 넣은 항목을 꺼낸다.
+		/// </summary>
+		T* Pop()
+		{
+			std::int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+			mBottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::int64_t top = mTop.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				// 비어 있음
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T* item = mBuffer[bottom & mMask].load(std::memory_order_relaxed);
+			if (top == bottom)
+			{
+				// 마지막 항목은 훔치는 스레드와 경쟁한다.
+				if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					item = nullptr;
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			return item;
+		}
+
+		/// <summary>
+		/// 아무 스레드에서나 호출. 가장 오래된 항목을 가져가며, 비어 있거나 경쟁에서 지면 nullptr.
+		/// </summary>
+		T* Steal()
+		{
+			std::int64_t top = mTop.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::int64_t bottom = mBottom.load(std::memory_order_acquire);
+
+			if (top >= bottom)
+				return nullptr;
+
+			T* item = mBuffer[top & mMask].load(std::memory_order_relaxed);
+			if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+			return item;
+		}
+
+		// 대략적인 항목 수 (다른 스레드가 동시에 바꿀 수 있음)
+		std::int64_t GetApproximateSize() const
+		{
+			std::int64_t size = mBottom.load(std::memory_order_relaxed) - mTop.load(std::memory_order_relaxed);
+			return size > 0 ? size : 0;
+		}
+
+	private:
+		// 훔치는 스레드들이 쓰는 top과 소유 스레드가 쓰는 bottom이 같은 캐시 라인을 공유하지 않도록 떨어뜨린다.
+		// (C++14의 new는 alignas(64)를 보장하지 않으므로 채움 바이트를 사용)
+		std::atomic<std::int64_t> mTop{ 0 };
+		char mPadding[64 - sizeof(std::atomic<std::int64_t>)];
+		std::atomic<std::int64_t> mBottom{ 0 };
+		std::int64_t mMask;
+		std::unique_ptr<std::atomic<T*>[]> mBuffer;
+	};
+}
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+#include "DirectXMath.h"
+
+// DirectXMath.h와 같이 SDK가 없을 때만 쓰이는 대체 헤더. 엔진이 쓰는 경계 구조체만 있다.
+
+namespace DirectX
+{
+	struct BoundingSphere
+	{
+		XMFLOAT3 Center;
+		float Radius;
+
+		BoundingSphere() : Center(0.0f, 0.0f, 0.0f), Radius(1.0f) {}
+		constexpr BoundingSphere(const XMFLOAT3& center, float radius) : Center(center), Radius(radius) {}
+	};
+
+	struct BoundingBox
+	{
+		XMFLOAT3 Center;
+		XMFLOAT3 Extents;
+
+		BoundingBox() : Center(0.0f, 0.0f, 0.0f), Extents(1.0f, 1.0f, 1.0f) {}
+		constexpr BoundingBox(const XMFLOAT3& center, const XMFLOAT3& extents) : Center(center), Extents(extents) {}
+
+		static void CreateFromPoints(BoundingBox& Out, FXMVECTOR pt1, FXMVECTOR pt2)
+		{
+			XMVECTOR minExtents = XMVectorMin(pt1, pt2);
+			XMVECTOR maxExtents = XMVectorMax(pt1, pt2);
+			XMStoreFloat3(&Out.Center, XMVectorScale(XMVectorAdd(minExtents, maxExtents), 0.5f));
+			XMStoreFloat3(&Out.Extents, XMVectorScale(XMVectorSubtract(maxExtents, minExtents), 0.5f));
+		}
+	};
+}
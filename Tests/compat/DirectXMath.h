@@ -0,0 +1,266 @@
+#pragma once
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+// DirectXMath를 찾지 못한 환경(윈도우 SDK가 없는 리눅스 등)에서 테스트가 엔진의 메쉬/수학 코드를 빌드할 수 있도록
+// 엔진이 쓰는 부분만 같은 이름과 의미로 스칼라 구현한 대체 헤더. 윈도우에서는 SDK의 DirectXMath가 쓰인다.
+// 결과 값은 DirectXMath와 같지만 SIMD 명령을 쓰지 않으므로 벤치마크 수치는 SDK 빌드와 다를 수 있다.
+
+#define XM_CALLCONV
+
+namespace DirectX
+{
+	constexpr float XM_PI = 3.141592654f;
+	constexpr float XM_2PI = 6.283185307f;
+
+	struct XMFLOAT2
+	{
+		float x;
+		float y;
+
+		XMFLOAT2() = default;
+		constexpr XMFLOAT2(float _x, float _y) : x(_x), y(_y) {}
+	};
+
+	struct XMFLOAT3
+	{
+		float x;
+		float y;
+		float z;
+
+		XMFLOAT3() = default;
+		constexpr XMFLOAT3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+	};
+
+	struct XMFLOAT4
+	{
+		float x;
+		float y;
+		float z;
+		float w;
+
+		XMFLOAT4() = default;
+		constexpr XMFLOAT4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+	};
+
+	struct XMFLOAT4X4
+	{
+		float m[4][4];
+
+		XMFLOAT4X4() = default;
+		constexpr XMFLOAT4X4(
+			float m00, float m01, float m02, float m03,
+			float m10, float m11, float m12, float m13,
+			float m20, float m21, float m22, float m23,
+			float m30, float m31, float m32, float m33)
+			: m{ { m00, m01, m02, m03 }, { m10, m11, m12, m13 }, { m20, m21, m22, m23 }, { m30, m31, m32, m33 } } {}
+	};
+
+	struct alignas(16) XMVECTOR
+	{
+		float v[4];
+	};
+	typedef const XMVECTOR& FXMVECTOR;
+	typedef const XMVECTOR& GXMVECTOR;
+	typedef const XMVECTOR& HXMVECTOR;
+	typedef const XMVECTOR& CXMVECTOR;
+
+	struct XMMATRIX
+	{
+		XMVECTOR r[4];
+	};
+	typedef const XMMATRIX& FXMMATRIX;
+	typedef const XMMATRIX& CXMMATRIX;
+
+	inline XMVECTOR XMVectorSet(float x, float y, float z, float w) { return XMVECTOR{ { x, y, z, w } }; }
+	inline XMVECTOR XMVectorZero() { return XMVECTOR{ { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+	inline XMVECTOR XMVectorReplicate(float value) { return XMVECTOR{ { value, value, value, value } }; }
+	inline float XMVectorGetX(FXMVECTOR V) { return V.v[0]; }
+
+	inline XMVECTOR XMVectorAdd(FXMVECTOR V1, FXMVECTOR V2)
+	{
+		return XMVectorSet(V1.v[0] + V2.v[0], V1.v[1] + V2.v[1], V1.v[2] + V2.v[2], V1.v[3] + V2.v[3]);
+	}
+	inline XMVECTOR XMVectorSubtract(FXMVECTOR V1, FXMVECTOR V2)
+	{
+		return XMVectorSet(V1.v[0] - V2.v[0], V1.v[1] - V2.v[1], V1.v[2] - V2.v[2], V1.v[3] - V2.v[3]);
+	}
+	inline XMVECTOR XMVectorMultiply(FXMVECTOR V1, FXMVECTOR V2)
+	{
+		return XMVectorSet(V1.v[0] * V2.v[0], V1.v[1] * V2.v[1], V1.v[2] * V2.v[2], V1.v[3] * V2.v[3]);
+	}
+	inline XMVECTOR XMVectorScale(FXMVECTOR V, float s)
+	{
+		return XMVectorSet(V.v[0] * s, V.v[1] * s, V.v[2] * s, V.v[3] * s);
+	}
+	inline XMVECTOR XMVectorNegate(FXMVECTOR V)
+	{
+		return XMVectorSet(-V.v[0], -V.v[1], -V.v[2], -V.v[3]);
+	}
+
+	// minps/maxps와 같이 비교가 거짓이면(NaN 포함) 두 번째 값을 고른다.
+	inline XMVECTOR XMVectorMin(FXMVECTOR V1, FXMVECTOR V2)
+	{
+		return XMVectorSet(
+			V1.v[0] < V2.v[0] ? V1.v[0] : V2.v[0],
+			V1.v[1] < V2.v[1] ? V1.v[1] : V2.v[1],
+			V1.v[2] < V2.v[2] ? V1.v[2] : V2.v[2],
+			V1.v[3] < V2.v[3] ? V1.v[3] : V2.v[3]);
+	}
+	inline XMVECTOR XMVectorMax(FXMVECTOR V1, FXMVECTOR V2)
+	{
+		return XMVectorSet(
+			V1.v[0] > V2.v[0] ? V1.v[0] : V2.v[0],
+			V1.v[1] > V2.v[1] ? V1.v[1] : V2.v[1],
+			V1.v[2] > V2.v[2] ? V1.v[2] : V2.v[2],
+			V1.v[3] > V2.v[3] ? V1.v[3] : V2.v[3]);
+	}
+	inline XMVECTOR XMVectorSqrt(FXMVECTOR V)
+	{
+		return XMVectorSet(std::sqrt(V.v[0]), std::sqrt(V.v[1]), std::sqrt(V.v[2]), std::sqrt(V.v[3]));
+	}
+
+	inline XMVECTOR operator+(FXMVECTOR V1, FXMVECTOR V2) { return XMVectorAdd(V1, V2); }
+	inline XMVECTOR operator-(FXMVECTOR V1, FXMVECTOR V2) { return XMVectorSubtract(V1, V2); }
+	inline XMVECTOR operator-(FXMVECTOR V) { return XMVectorNegate(V); }
+	inline XMVECTOR operator*(FXMVECTOR V1, FXMVECTOR V2) { return XMVectorMultiply(V1, V2); }
+	inline XMVECTOR operator*(FXMVECTOR V, float s) { return XMVectorScale(V, s); }
+	inline XMVECTOR operator*(float s, FXMVECTOR V) { return XMVectorScale(V, s); }
+	inline XMVECTOR& operator+=(XMVECTOR& V1, FXMVECTOR V2) { V1 = V1 + V2; return V1; }
+	inline XMVECTOR& operator-=(XMVECTOR& V1, FXMVECTOR V2) { V1 = V1 - V2; return V1; }
+	inline XMVECTOR& operator*=(XMVECTOR& V, float s) { V = V * s; return V; }
+
+	inline XMVECTOR XMVector3Dot(FXMVECTOR V1, FXMVECTOR V2)
+	{
+		return XMVectorReplicate(V1.v[0] * V2.v[0] + V1.v[1] * V2.v[1] + V1.v[2] * V2.v[2]);
+	}
+	inline XMVECTOR XMVector3Cross(FXMVECTOR V1, FXMVECTOR V2)
+	{
+		return XMVectorSet(
+			V1.v[1] * V2.v[2] - V1.v[2] * V2.v[1],
+			V1.v[2] * V2.v[0] - V1.v[0] * V2.v[2],
+			V1.v[0] * V2.v[1] - V1.v[1] * V2.v[0],
+			0.0f);
+	}
+	inline XMVECTOR XMVector3LengthSq(FXMVECTOR V) { return XMVector3Dot(V, V); }
+	inline XMVECTOR XMVector3Length(FXMVECTOR V) { return XMVectorSqrt(XMVector3LengthSq(V)); }
+
+	// 길이가 0이면 0 벡터를 반환한다.
+	inline XMVECTOR XMVector3Normalize(FXMVECTOR V)
+	{
+		float length = XMVectorGetX(XMVector3Length(V));
+		return length > 0.0f ? XMVectorScale(V, 1.0f / length) : XMVectorZero();
+	}
+	inline bool XMVector3Greater(FXMVECTOR V1, FXMVECTOR V2)
+	{
+		return V1.v[0] > V2.v[0] && V1.v[1] > V2.v[1] && V1.v[2] > V2.v[2];
+	}
+	inline bool XMVector3Less(FXMVECTOR V1, FXMVECTOR V2)
+	{
+		return V1.v[0] < V2.v[0] && V1.v[1] < V2.v[1] && V1.v[2] < V2.v[2];
+	}
+
+	inline XMVECTOR XMLoadFloat2(const XMFLOAT2* pSource) { return XMVectorSet(pSource->x, pSource->y, 0.0f, 0.0f); }
+	inline XMVECTOR XMLoadFloat3(const XMFLOAT3* pSource) { return XMVectorSet(pSource->x, pSource->y, pSource->z, 0.0f); }
+	inline XMVECTOR XMLoadFloat4(const XMFLOAT4* pSource) { return XMVectorSet(pSource->x, pSource->y, pSource->z, pSource->w); }
+	inline void XMStoreFloat2(XMFLOAT2* pDestination, FXMVECTOR V) { *pDestination = XMFLOAT2(V.v[0], V.v[1]); }
+	inline void XMStoreFloat3(XMFLOAT3* pDestination, FXMVECTOR V) { *pDestination = XMFLOAT3(V.v[0], V.v[1], V.v[2]); }
+	inline void XMStoreFloat4(XMFLOAT4* pDestination, FXMVECTOR V) { *pDestination = XMFLOAT4(V.v[0], V.v[1], V.v[2], V.v[3]); }
+
+	inline XMMATRIX XMMatrixSet(
+		float m00, float m01, float m02, float m03,
+		float m10, float m11, float m12, float m13,
+		float m20, float m21, float m22, float m23,
+		float m30, float m31, float m32, float m33)
+	{
+		return XMMATRIX{ {
+			XMVectorSet(m00, m01, m02, m03),
+			XMVectorSet(m10, m11, m12, m13),
+			XMVectorSet(m20, m21, m22, m23),
+			XMVectorSet(m30, m31, m32, m33) } };
+	}
+	inline XMMATRIX XMMatrixScaling(float x, float y, float z)
+	{
+		return XMMatrixSet(x, 0, 0, 0, 0, y, 0, 0, 0, 0, z, 0, 0, 0, 0, 1);
+	}
+	inline XMMATRIX XMMatrixTranslation(float x, float y, float z)
+	{
+		return XMMatrixSet(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, x, y, z, 1);
+	}
+	inline XMMATRIX XMMatrixTranspose(FXMMATRIX M)
+	{
+		XMMATRIX result;
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int j = 0; j < 4; ++j)
+				result.r[i].v[j] = M.r[j].v[i];
+		}
+		return result;
+	}
+	inline XMMATRIX XMMatrixMultiply(FXMMATRIX M1, CXMMATRIX M2)
+	{
+		XMMATRIX result;
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int j = 0; j < 4; ++j)
+			{
+				result.r[i].v[j] =
+					M1.r[i].v[0] * M2.r[0].v[j] + M1.r[i].v[1] * M2.r[1].v[j] +
+					M1.r[i].v[2] * M2.r[2].v[j] + M1.r[i].v[3] * M2.r[3].v[j];
+			}
+		}
+		return result;
+	}
+	inline XMMATRIX operator*(FXMMATRIX M1, CXMMATRIX M2) { return XMMatrixMultiply(M1, M2); }
+
+	// (x, y, z, 1) 행 벡터에 M을 곱한다.
+	inline XMVECTOR XMVector3Transform(FXMVECTOR V, FXMMATRIX M)
+	{
+		XMVECTOR result;
+		for (int j = 0; j < 4; ++j)
+			result.v[j] = V.v[0] * M.r[0].v[j] + V.v[1] * M.r[1].v[j] + V.v[2] * M.r[2].v[j] + M.r[3].v[j];
+		return result;
+	}
+
+	/// <summary>
+	/// 여인수 전개로 구한 역행렬. 행렬식이 0이면 DirectXMath와 같이 무한대/NaN이 섞인 행렬이 된다.
+	/// </summary>
+	inline XMMATRIX XMMatrixInverse(XMVECTOR* pDeterminant, FXMMATRIX M)
+	{
+		const float* m = &M.r[0].v[0];
+		float inv[16];
+		inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+		inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+		inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+		inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+		inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+		inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+		inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+		inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+		inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+		inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+		inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+		inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+		inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+		inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+		inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+		inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+		float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+		if (pDeterminant != nullptr)
+			*pDeterminant = XMVectorReplicate(det);
+
+		float invDet = 1.0f / det;
+		XMMATRIX result;
+		for (int i = 0; i < 16; ++i)
+			result.r[i / 4].v[i % 4] = inv[i] * invDet;
+		return result;
+	}
+	inline XMVECTOR XMMatrixDeterminant(FXMMATRIX M)
+	{
+		XMVECTOR det;
+		XMMatrixInverse(&det, M);
+		return det;
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "DirectXMath.h"
+#include <cstring>
+
+// DirectXMath.h와 같이 SDK가 없을 때만 쓰이는 대체 헤더. 엔진이 쓰는 half 변환만 있으며,
+// 반올림과 범위 밖 값 처리는 DirectXMath의 스칼라 구현과 같다.
+
+namespace DirectX
+{
+	namespace PackedVector
+	{
+		typedef std::uint16_t HALF;
+
+		inline float XMConvertHalfToFloat(HALF Value)
+		{
+			std::uint32_t mantissa = Value & 0x03FFu;
+			std::uint32_t exponent = Value & 0x7C00u;
+			if (exponent == 0x7C00u)
+			{
+				// 무한대/NaN
+				exponent = 0x8Fu;
+			}
+			else if (exponent != 0)
+			{
+				exponent = (Value >> 10) & 0x1Fu;
+			}
+			else if (mantissa != 0)
+			{
+				// 비정규 half는 정규 float로 바꾼다.
+				exponent = 1;
+				do
+				{
+					exponent--;
+					mantissa <<= 1;
+				} while ((mantissa & 0x0400u) == 0);
+				mantissa &= 0x03FFu;
+			}
+			else
+			{
+				exponent = (std::uint32_t)-112;
+			}
+
+			std::uint32_t bits = ((Value & 0x8000u) << 16) | ((exponent + 112) << 23) | (mantissa << 13);
+			float result;
+			std::memcpy(&result, &bits, sizeof(result));
+			return result;
+		}
+
+		inline HALF XMConvertFloatToHalf(float Value)
+		{
+			std::uint32_t bits;
+			std::memcpy(&bits, &Value, sizeof(bits));
+			std::uint32_t sign = (bits & 0x80000000u) >> 16;
+			bits &= 0x7FFFFFFFu;
+
+			std::uint32_t result;
+			if (bits >= 0x47800000u)
+			{
+				// half로 표현할 수 없을 만큼 크면 무한대, NaN은 NaN
+				result = 0x7C00u | (bits > 0x7F800000u ? (0x200u | ((bits >> 13) & 0x3FFu)) : 0u);
+			}
+			else if (bits <= 0x33000000u)
+			{
+				result = 0;
+			}
+			else if (bits < 0x38800000u)
+			{
+				// 정규 half보다 작으면 비정규 half로 바꾼다. (짝수 쪽으로 반올림)
+				std::uint32_t shift = 125u - (bits >> 23);
+				bits = 0x800000u | (bits & 0x7FFFFFu);
+				result = bits >> (shift + 1);
+				std::uint32_t sticky = (bits & ((1u << shift) - 1)) != 0;
+				result += (result | sticky) & ((bits >> shift) & 1u);
+			}
+			else
+			{
+				// 지수 편향을 바꾸고 짝수 쪽으로 반올림
+				bits += 0xC8000000u;
+				result = ((bits + 0x0FFFu + ((bits >> 13) & 1u)) >> 13) & 0x7FFFu;
+			}
+			return (HALF)(result | sign);
+		}
+	}
+}
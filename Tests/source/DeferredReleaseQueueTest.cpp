@@ -0,0 +1,156 @@
+#include "TestCommon.h"
+#include "DeferredReleaseQueue.h"
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	// 소비자 스레드가 기록하는 해제 기록. 해제는 항상 Retire/ReleaseAll 안에서 일어난다.
+	struct ReleaseLog
+	{
+		std::uint64_t CompletedFence = 0;
+		std::vector<std::uint32_t> ReleaseCounts;
+	};
+
+	/// <summary>
+	/// GPU 자원 대신 넣는 객체. 소멸될 때 자신의 펜스가 완료되었는지 확인하고 해제 횟수를 남긴다.
+	/// </summary>
+	class ReleaseProbe
+	{
+	public:
+		ReleaseProbe(ReleaseLog* log, std::uint32_t id, std::uint64_t fenceValue) : mLog(log), mId(id), mFenceValue(fenceValue) {}
+		ReleaseProbe(ReleaseProbe&& rhs) : mLog(rhs.mLog), mId(rhs.mId), mFenceValue(rhs.mFenceValue) { rhs.mLog = nullptr; }
+		ReleaseProbe& operator=(ReleaseProbe&& rhs)
+		{
+			Release();
+			mLog = rhs.mLog;
+			mId = rhs.mId;
+			mFenceValue = rhs.mFenceValue;
+			rhs.mLog = nullptr;
+			return *this;
+		}
+		~ReleaseProbe() { Release(); }
+
+	private:
+		void Release()
+		{
+			if (mLog == nullptr)
+				return;
+			// GPU가 아직 사용 중일 수 있는 객체를 해제하면 안 된다.
+			CHECK(mFenceValue <= mLog->CompletedFence);
+			++mLog->ReleaseCounts[mId];
+			mLog = nullptr;
+		}
+
+		ReleaseLog* mLog;
+		std::uint32_t mId;
+		std::uint64_t mFenceValue;
+	};
+
+	// 여러 생산자 스레드가 "다음에 Signal될 펜스"로 객체를 넣는 동안 메인 스레드가 프레임을 진행하며
+	// GPU가 몇 프레임 늦게 따라오는 가짜 펜스로 회수한다. 모든 객체는 펜스가 지난 뒤 정확히 한 번 해제되어야 한다.
+	void TestConcurrentProducers(std::uint32_t producerCount, std::uint32_t objectsPerProducer)
+	{
+		ReleaseLog log;
+		log.ReleaseCounts.assign((size_t)producerCount * objectsPerProducer, 0);
+
+		std::atomic<std::uint64_t> submittedFence(0);
+		std::atomic<std::uint32_t> finishedProducers(0);
+
+		Test::Stopwatch stopwatch;
+		{
+			DeferredReleaseQueue<ReleaseProbe> queue;
+
+			std::vector<std::thread> producers;
+			for (std::uint32_t p = 0; p < producerCount; ++p)
+			{
+				producers.emplace_back([&, p]()
+				{
+					std::mt19937 random(140 + p);
+					for (std::uint32_t i = 0; i < objectsPerProducer; ++i)
+					{
+						// 이번 프레임(다음에 Signal될 값) 또는 그 다음 프레임에 마지막으로 쓰인 객체
+						std::uint64_t fenceValue = submittedFence.load(std::memory_order_acquire) + 1 + random() % 2;
+						std::uint32_t id = p * objectsPerProducer + i;
+						queue.Enqueue(fenceValue, ReleaseProbe(&log, id, fenceValue));
+						if (random() % 64 == 0)
+							std::this_thread::yield();
+					}
+					finishedProducers.fetch_add(1, std::memory_order_release);
+				});
+			}
+
+			std::mt19937 random(14);
+			std::uint64_t frames = 0;
+			while (finishedProducers.load(std::memory_order_acquire) < producerCount)
+			{
+				// 프레임을 하나 제출하고, GPU는 0 ~ 3 프레임 늦게 완료한다.
+				std::uint64_t submitted = submittedFence.fetch_add(1, std::memory_order_acq_rel) + 1;
+				std::uint64_t lag = random() % 4;
+				if (submitted > lag + log.CompletedFence)
+					log.CompletedFence = submitted - lag;
+
+				queue.Retire(log.CompletedFence);
+				CHECK(queue.GetPendingCount() == 0 || queue.GetOldestPendingFence() > log.CompletedFence);
+				++frames;
+				std::this_thread::yield();
+			}
+
+			for (std::thread& producer : producers)
+				producer.join();
+
+			// 생산자가 마지막으로 읽은 값 다음 프레임까지 넣을 수 있다.
+			log.CompletedFence = submittedFence.load() + 2;
+			queue.Retire(log.CompletedFence);
+			CHECK(queue.GetPendingCount() == 0);
+			CHECK(queue.GetEnqueuedCount() == log.ReleaseCounts.size());
+			CHECK(queue.GetReleasedCount() == log.ReleaseCounts.size());
+
+			std::printf("  %u producers x %u objects, %llu frames, %.1f ms\n",
+				producerCount, objectsPerProducer, (unsigned long long)frames, stopwatch.ElapsedMs());
+		}
+
+		for (std::uint32_t count : log.ReleaseCounts)
+			CHECK(count == 1);
+	}
+
+	void TestReleaseAll()
+	{
+		ReleaseLog log;
+		log.ReleaseCounts.assign(4, 0);
+		{
+			DeferredReleaseQueue<ReleaseProbe> queue;
+			queue.Enqueue(5, ReleaseProbe(&log, 0, 5));
+			queue.Enqueue(3, ReleaseProbe(&log, 1, 3));
+			queue.Enqueue(9, ReleaseProbe(&log, 2, 9));
+
+			// 넣은 순서와 관계없이 펜스 값 기준으로 해제한다.
+			log.CompletedFence = 4;
+			CHECK(queue.Retire(4) == 1);
+			CHECK(log.ReleaseCounts[1] == 1 && log.ReleaseCounts[0] == 0);
+			CHECK(queue.GetOldestPendingFence() == 5);
+
+			// 종료 시에는 GPU가 유휴 상태이므로 남은 객체를 모두 해제한다 (소멸자도 같다).
+			log.CompletedFence = ~0ull;
+			CHECK(queue.ReleaseAll() == 2);
+			queue.Enqueue(20, ReleaseProbe(&log, 3, 20));
+		}
+		for (std::uint32_t count : log.ReleaseCounts)
+			CHECK(count == 1);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestReleaseAll();
+	TestConcurrentProducers(4, quick ? 20000 : 500000);
+
+	return Test::Finish("DeferredReleaseQueueTest");
+}
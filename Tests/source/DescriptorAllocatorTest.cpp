@@ -0,0 +1,354 @@
+#include "TestCommon.h"
+#include "DescriptorAllocator.h"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	struct LiveBlock
+	{
+		std::uint32_t Offset;
+		std::uint32_t Count;
+	};
+
+	// 비트맵에서 가장 긴 빈 구간
+	std::uint32_t GetLargestFreeRun(const std::vector<bool>& used)
+	{
+		std::uint32_t largest = 0;
+		std::uint32_t run = 0;
+		for (bool slot : used)
+		{
+			run = slot ? 0 : run + 1;
+			largest = std::max(largest, run);
+		}
+		return largest;
+	}
+
+	void TestFreeList()
+	{
+		DescriptorFreeList freeList(100);
+		CHECK(freeList.Allocate(10) == 0);
+		CHECK(freeList.Allocate(20) == 10);
+		CHECK(freeList.Allocate(30) == 30);
+
+		// 가운데를 해제하면 뒤쪽의 빈 구간과 따로 남는다.
+		freeList.Free(10, 20);
+		CHECK(freeList.GetLargestFreeBlock() == 40);
+		// 앞과 합쳐져 [0, 30)이 된다.
+		freeList.Free(0, 10);
+		CHECK(freeList.GetLargestFreeBlock() == 40);
+		CHECK(freeList.Allocate(30) == 0);
+
+		freeList.Free(0, 30);
+		freeList.Free(30, 30);
+		CHECK(freeList.GetLargestFreeBlock() == 100);
+		CHECK(freeList.GetStats().UsedDescriptors == 0 && freeList.GetStats().PeakUsedDescriptors == 60);
+		CHECK(freeList.Allocate(101) == DescriptorFreeList::InvalidOffset);
+		CHECK(freeList.GetStats().FailedAllocations == 1);
+
+		// 펜스와 함께 해제한 블록은 완료될 때까지 재사용하지 않는다.
+		CHECK(freeList.Allocate(100) == 0);
+		freeList.Free(0, 50, 5);
+		freeList.Free(50, 50, 6);
+		CHECK(freeList.Allocate(1) == DescriptorFreeList::InvalidOffset);
+		freeList.Retire(4);
+		CHECK(freeList.GetLargestFreeBlock() == 0);
+		freeList.Retire(5);
+		CHECK(freeList.GetLargestFreeBlock() == 50);
+		freeList.Retire(6);
+		CHECK(freeList.GetLargestFreeBlock() == 100);
+
+		DescriptorFreeList empty;
+		CHECK(empty.GetCapacity() == 0 && empty.Allocate(1) == DescriptorFreeList::InvalidOffset);
+	}
+
+	// 무작위 할당/즉시 해제/펜스 해제를 비트맵 기준 상태와 비교한다.
+	// 할당된 구간이 겹치거나, 완료되지 않은 펜스의 블록이 다시 나가거나, 빈 구간이 합쳐지지 않으면 실패다.
+	void TestFreeListRandom(std::uint32_t operationCount)
+	{
+		const std::uint32_t capacity = 4096;
+		DescriptorFreeList freeList(capacity);
+		std::mt19937 random(24);
+		std::vector<bool> used(capacity, false);
+		std::vector<LiveBlock> live;
+		std::deque<std::pair<std::uint64_t, LiveBlock>> pending;
+		std::uint64_t submittedFence = 0;
+		std::uint64_t completedFence = 0;
+		std::uint32_t usedCount = 0;
+
+		for (std::uint32_t op = 0; op < operationCount; ++op)
+		{
+			std::uint32_t action = random() % 8;
+			if (live.empty() || action < 4)
+			{
+				std::uint32_t count = 1 + random() % 16;
+				std::uint32_t offset = freeList.Allocate(count);
+				if (offset == DescriptorFreeList::InvalidOffset)
+				{
+					// 처음 맞는 곳을 찾으므로 실패했다면 정말로 들어갈 구간이 없어야 한다.
+					CHECK(GetLargestFreeRun(used) < count);
+					continue;
+				}
+				if (!CHECK(offset + count <= capacity))
+					break;
+				for (std::uint32_t i = offset; i < offset + count; ++i)
+				{
+					if (!CHECK(!used[i]))
+						break;
+					used[i] = true;
+				}
+				usedCount += count;
+				live.push_back({ offset, count });
+			}
+			else
+			{
+				size_t pick = random() % live.size();
+				LiveBlock block = live[pick];
+				live[pick] = live.back();
+				live.pop_back();
+				if (action < 6)
+				{
+					freeList.Free(block.Offset, block.Count);
+					for (std::uint32_t i = block.Offset; i < block.Offset + block.Count; ++i)
+						used[i] = false;
+					usedCount -= block.Count;
+				}
+				else
+				{
+					// 이번 프레임에 쓰인 블록은 다음에 Signal될 펜스와 함께 해제한다.
+					freeList.Free(block.Offset, block.Count, submittedFence + 1);
+					pending.push_back(std::make_pair(submittedFence + 1, block));
+				}
+			}
+
+			// 가끔 프레임을 넘기고 GPU는 0 ~ 3 프레임 늦게 완료한다.
+			if (random() % 16 == 0)
+			{
+				++submittedFence;
+				std::uint64_t lag = random() % 4;
+				if (submittedFence > lag)
+					completedFence = std::max(completedFence, submittedFence - lag);
+				freeList.Retire(completedFence);
+				while (!pending.empty() && pending.front().first <= completedFence)
+				{
+					const LiveBlock& block = pending.front().second;
+					for (std::uint32_t i = block.Offset; i < block.Offset + block.Count; ++i)
+						used[i] = false;
+					usedCount -= block.Count;
+					pending.pop_front();
+				}
+
+				CHECK(freeList.GetStats().UsedDescriptors == usedCount);
+				if (!CHECK(freeList.GetLargestFreeBlock() == GetLargestFreeRun(used)))
+					break;
+			}
+		}
+
+		// 모두 돌려주면 빈 구간이 하나로 합쳐져야 한다.
+		for (const LiveBlock& block : live)
+			freeList.Free(block.Offset, block.Count);
+		// 마지막 프레임에 펜스와 함께 해제한 블록은 아직 Signal되지 않은 값에 묶여 있다.
+		freeList.Retire(submittedFence + 1);
+		CHECK(freeList.GetLargestFreeBlock() == capacity);
+		CHECK(freeList.GetStats().UsedDescriptors == 0);
+		CHECK(freeList.GetStats().AllocationCount == freeList.GetStats().FreeCount);
+	}
+
+	void TestSlotPool()
+	{
+		DescriptorSlotPool pool(4);
+		CHECK(pool.GetPageCount() == 0 && pool.GetFreeCount() == 0);
+
+		// 새 페이지의 칸은 낮은 번호부터 나간다.
+		std::uint32_t slots[6];
+		for (std::uint32_t i = 0; i < 6; ++i)
+		{
+			// 스테이징 힙은 빈 칸이 없을 때 칸을 꺼내기 전에 페이지를 만든다. 그때 페이지 수가 하나 늘어야 한다.
+			std::uint32_t pagesBefore = pool.GetPageCount();
+			bool grows = pool.GetFreeCount() == 0;
+			slots[i] = pool.Allocate();
+			CHECK(slots[i] == i);
+			CHECK(pool.GetPageCount() == pagesBefore + (grows ? 1 : 0));
+		}
+		CHECK(pool.GetPageCount() == 2 && pool.GetFreeCount() == 2);
+		CHECK(pool.GetPage(slots[5]) == 1 && pool.GetIndexInPage(slots[5]) == 1);
+
+		// 가장 최근에 반환된 칸부터 재사용하고 페이지는 늘지 않는다.
+		pool.Free(slots[2]);
+		pool.Free(slots[4]);
+		CHECK(pool.GetFreeCount() == 4);
+		CHECK(pool.Allocate() == slots[4]);
+		CHECK(pool.Allocate() == slots[2]);
+		CHECK(pool.GetPageCount() == 2);
+		CHECK(pool.GetStats().UsedDescriptors == 6 && pool.GetStats().PeakUsedDescriptors == 6);
+	}
+
+	// 무작위 할당/해제에서 같은 칸이 두 번 나가지 않고, 페이지는 동시에 쓰인 칸 수만큼만 늘어난다.
+	void TestSlotPoolRandom(std::uint32_t operationCount)
+	{
+		const std::uint32_t pageSize = 64;
+		DescriptorSlotPool pool(pageSize);
+		std::mt19937 random(240);
+		std::vector<bool> used;
+		std::vector<std::uint32_t> live;
+		size_t peak = 0;
+
+		for (std::uint32_t op = 0; op < operationCount; ++op)
+		{
+			if (live.empty() || random() % 5 < 3)
+			{
+				std::uint32_t slot = pool.Allocate();
+				if (slot >= used.size())
+					used.resize((size_t)pool.GetPageCount() * pageSize, false);
+				if (!CHECK(!used[slot]))
+					break;
+				used[slot] = true;
+				live.push_back(slot);
+				peak = std::max(peak, live.size());
+			}
+			else
+			{
+				size_t pick = random() % live.size();
+				used[live[pick]] = false;
+				pool.Free(live[pick]);
+				live[pick] = live.back();
+				live.pop_back();
+			}
+			CHECK(pool.GetFreeCount() + live.size() == (size_t)pool.GetPageCount() * pageSize);
+		}
+		CHECK(pool.GetPageCount() == (peak + pageSize - 1) / pageSize);
+		CHECK(pool.GetStats().UsedDescriptors == live.size() && pool.GetStats().PeakUsedDescriptors == peak);
+	}
+
+	// 영속 영역과 프레임 링을 가짜 펜스로 돌린다. 프레임 영역은 영속 영역 뒤에 있고,
+	// GPU가 아직 읽을 수 있는 프레임의 서술자와 겹치지 않아야 한다.
+	void TestFrameRing(std::uint32_t frameCount)
+	{
+		const std::uint32_t persistentCount = 100;
+		const std::uint32_t frameDescriptorCount = 64;
+		// 링에는 네 프레임분이 들어가므로 그보다 늦게 따라오면 가장 오래된 프레임을 기다린다.
+		const std::uint32_t maxFramesInFlight = 5;
+		ShaderVisibleDescriptorAllocator allocator(persistentCount, frameDescriptorCount);
+		CHECK(allocator.GetCapacity() == persistentCount + frameDescriptorCount);
+
+		std::mt19937 random(2400);
+		std::uint64_t submittedFence = 0;
+		std::uint64_t completedFence = 0;
+		std::uint64_t waits = 0;
+		// 프레임 영역의 서술자마다 마지막으로 쓴 프레임의 펜스 값 (0이면 사용한 적 없음)
+		std::vector<std::uint64_t> lastUse(frameDescriptorCount, 0);
+
+		RingAllocator::WaitForFence waitForFence = [&](std::uint64_t fenceValue)
+		{
+			CHECK(fenceValue <= submittedFence && fenceValue > completedFence);
+			completedFence = fenceValue;
+			++waits;
+			return completedFence;
+		};
+
+		// 텍스처 SRV처럼 수명이 긴 서술자
+		std::uint32_t persistent = allocator.AllocatePersistent(10);
+		CHECK(persistent == 0);
+
+		for (std::uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			// 한 프레임은 링의 1/4 안에서 할당한다. (패스 CBV, 임시 SRV 테이블 등)
+			std::uint32_t budget = frameDescriptorCount / 4;
+			while (budget > 0)
+			{
+				std::uint32_t count = std::min<std::uint32_t>(1 + random() % 4, budget);
+				budget -= count;
+				std::uint32_t offset = allocator.AllocateFrame(count, waitForFence);
+				if (!CHECK(offset != ShaderVisibleDescriptorAllocator::InvalidOffset))
+					continue;
+				if (!CHECK(offset >= persistentCount && offset + count <= allocator.GetCapacity()))
+					continue;
+				for (std::uint32_t i = offset - persistentCount; i < offset - persistentCount + count; ++i)
+				{
+					// 이전에 쓴 프레임은 이미 완료되었어야 한다.
+					CHECK(lastUse[i] <= completedFence);
+					lastUse[i] = submittedFence + 1;
+				}
+			}
+
+			// 가끔 영속 서술자를 바꾼다. 이전 것은 이번 프레임이 끝나면 돌려받는다.
+			if (frame % 50 == 49)
+			{
+				std::uint32_t replacement = allocator.AllocatePersistent(10);
+				CHECK(replacement != ShaderVisibleDescriptorAllocator::InvalidOffset && replacement + 10 <= persistentCount);
+				allocator.FreePersistent(persistent, 10, submittedFence + 1);
+				persistent = replacement;
+			}
+
+			allocator.EndFrame(++submittedFence);
+			std::uint64_t lag = random() % (maxFramesInFlight + 1);
+			if (submittedFence > lag)
+				completedFence = std::max(completedFence, submittedFence - lag);
+			allocator.Retire(completedFence);
+
+			// 교체된 영속 블록은 펜스가 지나면 돌아오므로 영속 영역 사용량은 최대 두 블록이다.
+			CHECK(allocator.GetPersistentAllocator().GetStats().UsedDescriptors <= 20);
+		}
+
+		// 한 프레임에 링보다 많이 요청하면 기다려도 실패한다.
+		CHECK(allocator.AllocateFrame(frameDescriptorCount + 1, waitForFence) == ShaderVisibleDescriptorAllocator::InvalidOffset);
+
+		allocator.Retire(submittedFence);
+		CHECK(allocator.GetPersistentAllocator().GetStats().UsedDescriptors == 10);
+		CHECK(!allocator.GetFrameAllocator().HasPendingFrames());
+		CHECK(waits > 0);
+		CHECK(allocator.GetFrameAllocator().GetStats().StallCount == waits);
+		std::printf("  %u frames, %llu waits, %llu wraps\n", frameCount, (unsigned long long)waits,
+			(unsigned long long)allocator.GetFrameAllocator().GetStats().WrapCount);
+	}
+
+	void Benchmark()
+	{
+		const std::uint32_t count = 100000;
+
+		Test::Stopwatch stopwatch;
+		DescriptorFreeList freeList(1000000);
+		std::vector<std::uint32_t> offsets;
+		for (std::uint32_t i = 0; i < count; ++i)
+			offsets.push_back(freeList.Allocate(1));
+		for (std::uint32_t i = 0; i < count; i += 2)
+			freeList.Free(offsets[i], 1);
+		for (std::uint32_t i = 0; i < count / 2; ++i)
+			freeList.Allocate(1);
+		double freeListMs = stopwatch.ElapsedMs();
+
+		stopwatch.Reset();
+		DescriptorSlotPool pool(256);
+		std::vector<std::uint32_t> slots;
+		for (std::uint32_t i = 0; i < count; ++i)
+			slots.push_back(pool.Allocate());
+		for (std::uint32_t slot : slots)
+			pool.Free(slot);
+		for (std::uint32_t i = 0; i < count; ++i)
+			pool.Allocate();
+		double poolMs = stopwatch.ElapsedMs();
+
+		std::printf("  free list: %u allocations, %u frees, %u refills in %.2f ms\n", count, count / 2, count / 2, freeListMs);
+		std::printf("  slot pool: %u allocations, %u frees, %u refills in %.2f ms\n", count, count, count, poolMs);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestFreeList();
+	TestFreeListRandom(quick ? 20000 : 500000);
+	TestSlotPool();
+	TestSlotPoolRandom(quick ? 20000 : 500000);
+	TestFrameRing(quick ? 500 : 20000);
+	if (!quick)
+		Benchmark();
+
+	return Test::Finish("DescriptorAllocatorTest");
+}
@@ -0,0 +1,266 @@
+#include "TestCommon.h"
+#include "DrawQueue.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	/// <summary>
+	/// 명령 목록 대신 호출을 문자열로 남기는 싱크. 그리기마다 그 시점의 상태가 항목과 같은지 확인한다.
+	/// </summary>
+	class RecordingSink
+	{
+	public:
+		void SetRootSignature(std::uint32_t id) { Log("RS", id); mRootSignature = id; }
+		void SetPipelineState(std::uint32_t id) { Log("PSO", id); mPipeline = id; }
+		void SetGeometry(std::uint32_t id) { Log("GEO", id); mGeometry = id; }
+		void SetPrimitiveTopology(std::uint32_t topology) { Log("TOPO", topology); mTopology = topology; }
+
+		void Draw(const DrawItem& item)
+		{
+			CHECK(mRootSignature == item.RootSignature);
+			CHECK(mPipeline == item.Pipeline);
+			CHECK(mGeometry == item.Geometry);
+			CHECK(mTopology == item.PrimitiveTopology);
+			mCalls += "DRAW ";
+			++mDrawCount;
+		}
+
+		const std::string& GetCalls() const { return mCalls; }
+		std::uint64_t GetDrawCount() const { return mDrawCount; }
+
+	private:
+		void Log(const char* name, std::uint32_t id)
+		{
+			mCalls += name;
+			mCalls += std::to_string(id);
+			mCalls += ' ';
+		}
+
+		std::string mCalls;
+		std::uint32_t mRootSignature = 0xFFFFFFFF;
+		std::uint32_t mPipeline = 0xFFFFFFFF;
+		std::uint32_t mGeometry = 0xFFFFFFFF;
+		std::uint32_t mTopology = 0xFFFFFFFF;
+		std::uint64_t mDrawCount = 0;
+	};
+
+	// 아무것도 기록하지 않는 싱크 (제출 비용만 잰다)
+	struct NullSink
+	{
+		void SetRootSignature(std::uint32_t) {}
+		void SetPipelineState(std::uint32_t) {}
+		void SetGeometry(std::uint32_t) {}
+		void SetPrimitiveTopology(std::uint32_t) {}
+		void Draw(const DrawItem&) {}
+	};
+
+	// 상태가 앞 항목과 다른 횟수. 처음 항목은 항상 설정한다.
+	template<typename TField>
+	std::uint64_t CountChanges(const std::vector<DrawItem>& items, size_t begin, size_t end, TField field)
+	{
+		std::uint64_t changes = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (i == begin || field(items[i]) != field(items[i - 1]))
+				++changes;
+		}
+		return changes;
+	}
+
+	void TestSortKey()
+	{
+		std::uint64_t key = DrawSortKey::Make(3, 1000, 42, 900, 12.5f);
+		CHECK(DrawSortKey::GetPass(key) == 3);
+		CHECK(DrawSortKey::GetPipeline(key) == 1000);
+		CHECK(DrawSortKey::GetRootSignature(key) == 42);
+		CHECK(DrawSortKey::GetGeometry(key) == 900);
+		CHECK(DrawSortKey::GetDepth(key) == DrawSortKey::QuantizeDepth(12.5f));
+
+		// 가까울수록 앞이고, 음수는 0이다.
+		CHECK(DrawSortKey::QuantizeDepth(1.0f) < DrawSortKey::QuantizeDepth(2.0f));
+		CHECK(DrawSortKey::QuantizeDepth(0.0f) < DrawSortKey::QuantizeDepth(1e-30f));
+		CHECK(DrawSortKey::Make(0, 0, 0, 0, -5.0f) == 0);
+
+		// 비싼 상태가 앞 필드를 차지한다. PSO가 다르면 깊이, 지오메트리와 관계없이 PSO 순서를 따른다.
+		CHECK(DrawSortKey::Make(0, 1, 0, 0, 0.0f) > DrawSortKey::Make(0, 0, 63, 1023, 1e30f));
+		CHECK(DrawSortKey::Make(1, 0, 0, 0, 0.0f) > DrawSortKey::Make(0, 4095, 63, 1023, 1e30f));
+	}
+
+	// 무작위 그리기를 정렬하고 std::stable_sort와 순서를 비교한 뒤, 싱크에 기록된 상태 설정 횟수를 확인한다.
+	void TestSortAndSubmit(std::uint32_t trialCount)
+	{
+		std::mt19937_64 random(21);
+		DrawQueue queue;
+		for (std::uint32_t trial = 0; trial < trialCount; ++trial)
+		{
+			queue.Reset();
+			size_t count = 1 + random() % 5000;
+			std::vector<DrawItem> reference;
+			for (size_t i = 0; i < count; ++i)
+			{
+				DrawItem item;
+				item.Pipeline = (std::uint32_t)(random() % 3);
+				item.RootSignature = (std::uint32_t)(random() % 2);
+				item.Geometry = (std::uint32_t)(random() % 4);
+				item.PrimitiveTopology = 4;
+				item.StartInstance = (std::uint32_t)i;
+				// 같은 키가 많아야 안정 정렬을 확인할 수 있다.
+				item.SortKey = DrawSortKey::Make(0, item.Pipeline, item.RootSignature, item.Geometry, (float)(random() % 8));
+				queue.Add(item);
+				reference.push_back(item);
+			}
+
+			queue.Sort();
+			std::stable_sort(reference.begin(), reference.end(), [](const DrawItem& a, const DrawItem& b) { return a.SortKey < b.SortKey; });
+			const std::vector<DrawItem>& items = queue.GetItems();
+			if (!CHECK(items.size() == count))
+				continue;
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (!CHECK(items[i].StartInstance == reference[i].StartInstance))
+					break;
+			}
+
+			RecordingSink sink;
+			DrawStateStats stats;
+			queue.Submit(sink, 0, count, stats);
+			CHECK(sink.GetDrawCount() == count && stats.Draws == count);
+
+			// 실제 설정 횟수는 정렬된 순서에서 값이 바뀐 횟수와 같고, 나머지는 모두 생략된다.
+			std::uint64_t pipelineChanges = CountChanges(items, 0, count, [](const DrawItem& item) { return item.Pipeline; });
+			std::uint64_t rootSignatureChanges = CountChanges(items, 0, count, [](const DrawItem& item) { return item.RootSignature; });
+			std::uint64_t geometryChanges = CountChanges(items, 0, count, [](const DrawItem& item) { return item.Geometry; });
+			CHECK(stats.PipelineSets == pipelineChanges && stats.PipelineElided == count - pipelineChanges);
+			CHECK(stats.RootSignatureSets == rootSignatureChanges && stats.RootSignatureElided == count - rootSignatureChanges);
+			CHECK(stats.GeometrySets == geometryChanges && stats.GeometryElided == count - geometryChanges);
+			CHECK(stats.TopologySets == 1 && stats.TopologyElided == count - 1);
+
+			// PSO가 가장 앞 필드이므로 PSO 설정은 PSO 종류 수를 넘지 않는다.
+			CHECK(stats.PipelineSets <= 3);
+			CHECK(stats.RootSignatureSets <= 3 * 2);
+			CHECK(stats.GeometrySets <= 3 * 2 * 4);
+
+			// 구간을 나누어 제출하면 구간마다 상태를 다시 설정하지만 그리기 순서와 수는 같다.
+			RecordingSink splitSink;
+			DrawStateStats splitStats;
+			size_t middle = count / 2;
+			queue.Submit(splitSink, 0, middle, splitStats);
+			queue.Submit(splitSink, middle, count, splitStats);
+			CHECK(splitStats.Draws == count);
+			CHECK(splitStats.GetSetCalls() + splitStats.GetElidedCalls() == 4 * count);
+			if (middle > 0 && middle < count)
+			{
+				std::uint64_t expectedPipelineSets = CountChanges(items, 0, middle, [](const DrawItem& item) { return item.Pipeline; }) +
+					CountChanges(items, middle, count, [](const DrawItem& item) { return item.Pipeline; });
+				CHECK(splitStats.PipelineSets == expectedPipelineSets);
+			}
+		}
+	}
+
+	// 작은 큐의 호출 순서를 그대로 비교한다.
+	void TestExactRecording()
+	{
+		DrawQueue queue;
+		auto add = [&](std::uint32_t pipeline, std::uint32_t geometry, std::uint32_t topology, float depth)
+		{
+			DrawItem item;
+			item.Pipeline = pipeline;
+			item.Geometry = geometry;
+			item.PrimitiveTopology = topology;
+			item.SortKey = DrawSortKey::Make(0, pipeline, 0, geometry, depth);
+			queue.Add(item);
+		};
+		add(1, 0, 4, 1.0f);
+		add(0, 0, 4, 5.0f);
+		add(0, 1, 4, 2.0f);
+		add(0, 0, 5, 3.0f);
+		queue.Sort();
+
+		RecordingSink sink;
+		DrawStateStats stats;
+		queue.Submit(sink, 0, queue.GetCount(), stats);
+		if (!CHECK(sink.GetCalls() == "RS0 PSO0 GEO0 TOPO5 DRAW TOPO4 DRAW GEO1 DRAW PSO1 GEO0 DRAW "))
+			std::printf("  recorded: %s\n", sink.GetCalls().c_str());
+		CHECK(stats.PipelineSets == 2 && stats.PipelineElided == 2);
+		CHECK(stats.RootSignatureSets == 1 && stats.RootSignatureElided == 3);
+		CHECK(stats.GeometrySets == 3 && stats.GeometryElided == 1);
+		CHECK(stats.TopologySets == 2 && stats.TopologyElided == 2);
+
+		// Reset 후 빈 큐는 아무것도 기록하지 않는다.
+		queue.Reset();
+		queue.Sort();
+		RecordingSink emptySink;
+		DrawStateStats emptyStats;
+		queue.Submit(emptySink, 0, queue.GetCount(), emptyStats);
+		CHECK(emptySink.GetCalls().empty() && emptyStats.Draws == 0);
+	}
+
+	// 기수 정렬과 std::stable_sort, 정렬 전후 상태 설정 수를 비교한다.
+	void BenchmarkSort(size_t count)
+	{
+		std::mt19937_64 random(210);
+		std::vector<DrawItem> items(count);
+		for (DrawItem& item : items)
+		{
+			item.Pipeline = (std::uint32_t)(random() % 8);
+			item.Geometry = (std::uint32_t)(random() % 64);
+			item.PrimitiveTopology = 4;
+			item.SortKey = DrawSortKey::Make(0, item.Pipeline, 0, item.Geometry, (float)(random() % 10000) * 0.01f);
+		}
+
+		DrawQueue queue;
+		NullSink sink;
+		DrawStateStats unsortedStats;
+		for (const DrawItem& item : items)
+			queue.Add(item);
+		queue.Submit(sink, 0, count, unsortedStats);
+
+		double radixMs = 1e9;
+		for (int repeat = 0; repeat < 5; ++repeat)
+		{
+			queue.Reset();
+			for (const DrawItem& item : items)
+				queue.Add(item);
+			Test::Stopwatch stopwatch;
+			queue.Sort();
+			radixMs = std::min(radixMs, stopwatch.ElapsedMs());
+		}
+
+		double stableSortMs = 1e9;
+		for (int repeat = 0; repeat < 5; ++repeat)
+		{
+			std::vector<DrawItem> copy = items;
+			Test::Stopwatch stopwatch;
+			std::stable_sort(copy.begin(), copy.end(), [](const DrawItem& a, const DrawItem& b) { return a.SortKey < b.SortKey; });
+			stableSortMs = std::min(stableSortMs, stopwatch.ElapsedMs());
+		}
+
+		DrawStateStats sortedStats;
+		queue.Submit(sink, 0, count, sortedStats);
+		CHECK(sortedStats.GetSetCalls() <= unsortedStats.GetSetCalls());
+		std::printf("  %zu draws: radix sort %.3f ms, std::stable_sort %.3f ms, state sets %llu -> %llu\n",
+			count, radixMs, stableSortMs, (unsigned long long)unsortedStats.GetSetCalls(), (unsigned long long)sortedStats.GetSetCalls());
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestSortKey();
+	TestExactRecording();
+	TestSortAndSubmit(quick ? 10 : 50);
+	if (!quick)
+	{
+		BenchmarkSort(1000);
+		BenchmarkSort(100000);
+	}
+
+	return Test::Finish("DrawQueueTest");
+}
@@ -0,0 +1,191 @@
+#include "TestCommon.h"
+#include "FenceTimeline.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+using namespace Engine;
+
+namespace
+{
+	void TestTimeline()
+	{
+		FenceTimeline timeline(10);
+		CHECK(timeline.GetLastSignaledValue() == 10 && timeline.GetLastCompletedValue() == 10);
+		CHECK(timeline.Advance() == 11);
+		timeline.Advance(20);
+		CHECK(timeline.GetLastSignaledValue() == 20);
+
+		// 늦게 읽은 작은 완료 값은 무시한다.
+		CHECK(timeline.UpdateCompleted(15) == 15);
+		CHECK(timeline.UpdateCompleted(12) == 15);
+		CHECK(timeline.IsKnownComplete(15) && !timeline.IsKnownComplete(16));
+	}
+
+	// poll과 block의 호출 결과를 정해 두고 스핀, 대기, 시간 초과가 통계에 정확히 한 번씩 잡히는지 확인한다.
+	void TestWaitPaths()
+	{
+		FenceTimeline timeline;
+		std::uint64_t value = timeline.Advance();
+		std::uint64_t completed = 0;
+		int pollCount = 0;
+		int blockCount = 0;
+		auto poll = [&]() { ++pollCount; return completed; };
+
+		// 이미 끝난 값은 대기로 세지 않는다.
+		completed = value;
+		CHECK(timeline.Wait(value, FenceTimeline::InfiniteTimeout, poll, [&](std::uint64_t, std::uint32_t) { ++blockCount; return true; }));
+		CHECK(timeline.GetStats().WaitCount == 0);
+		CHECK(timeline.Wait(value, 0, poll, [&](std::uint64_t, std::uint32_t) { ++blockCount; return true; }));
+		CHECK(pollCount == 1);
+
+		// 세 번째 조회에서 완료되면 스핀 중에 끝난다.
+		value = timeline.Advance();
+		pollCount = 0;
+		timeline.SetSpinTime(std::chrono::milliseconds(1000));
+		auto completesOnThirdPoll = [&]() { return ++pollCount >= 3 ? value : value - 1; };
+		CHECK(timeline.Wait(value, FenceTimeline::InfiniteTimeout, completesOnThirdPoll, [&](std::uint64_t, std::uint32_t) { ++blockCount; return true; }));
+		CHECK(pollCount == 3);
+		CHECK(blockCount == 0);
+		CHECK(timeline.GetStats().WaitCount == 1 && timeline.GetStats().SpinCompletions == 1 && timeline.GetStats().BlockCount == 0);
+		CHECK(timeline.GetLastCompletedValue() == value);
+
+		// 스핀 없이 바로 잠들고, 깨어나면 완료 값이 반영된다.
+		value = timeline.Advance();
+		completed = value - 1;
+		timeline.SetSpinTime(std::chrono::microseconds(0));
+		std::uint32_t passedTimeout = 0;
+		CHECK(timeline.Wait(value, FenceTimeline::InfiniteTimeout, poll, [&](std::uint64_t waited, std::uint32_t timeoutMs)
+		{
+			CHECK(waited == value);
+			passedTimeout = timeoutMs;
+			return true;
+		}));
+		CHECK(passedTimeout == FenceTimeline::InfiniteTimeout);
+		CHECK(timeline.GetStats().BlockCount == 1 && timeline.GetStats().TimeoutCount == 0);
+		CHECK(timeline.IsKnownComplete(value));
+
+		// 제한 시간 안에 끝나지 않으면 false이고 완료 값은 그대로다.
+		value = timeline.Advance();
+		CHECK(!timeline.Wait(value, 5, poll, [&](std::uint64_t, std::uint32_t timeoutMs) { passedTimeout = timeoutMs; return false; }));
+		CHECK(passedTimeout <= 5);
+		CHECK(timeline.GetStats().BlockCount == 2 && timeline.GetStats().TimeoutCount == 1);
+		CHECK(!timeline.IsKnownComplete(value));
+
+		// 스핀에 제한 시간을 다 쓰면 남은 시간 0으로 잠든다.
+		timeline.SetSpinTime(std::chrono::milliseconds(20));
+		CHECK(!timeline.Wait(value, 5, poll, [&](std::uint64_t, std::uint32_t timeoutMs) { passedTimeout = timeoutMs; return false; }));
+		CHECK(passedTimeout == 0);
+		CHECK(timeline.GetStats().TimeoutCount == 2);
+
+		const FenceWaitStats& stats = timeline.GetStats();
+		CHECK(stats.WaitCount == stats.SpinCompletions + stats.BlockCount);
+		CHECK(stats.MaxWaitMs >= 20.0 && stats.TotalWaitMs >= stats.MaxWaitMs);
+
+		timeline.ResetStats();
+		CHECK(timeline.GetStats().WaitCount == 0 && timeline.GetStats().TotalWaitMs == 0.0);
+	}
+
+	/// <summary>
+	/// GPU 대신 다른 스레드가 일정 간격으로 값을 완료하는 소프트웨어 펜스. block은 조건 변수로 잠든다.
+	/// </summary>
+	class SoftwareFence
+	{
+	public:
+		std::uint64_t GetCompletedValue() const { return mCompleted.load(std::memory_order_acquire); }
+
+		void Complete(std::uint64_t value)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mCompleted.store(value, std::memory_order_release);
+			}
+			mCondition.notify_all();
+		}
+
+		bool Block(std::uint64_t value, std::uint32_t timeoutMs)
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			auto done = [&]() { return mCompleted.load(std::memory_order_acquire) >= value; };
+			if (timeoutMs == FenceTimeline::InfiniteTimeout)
+			{
+				mCondition.wait(lock, done);
+				return true;
+			}
+			return mCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs), done);
+		}
+
+	private:
+		std::atomic<std::uint64_t> mCompleted{ 0 };
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+	};
+
+	// CPU가 프레임을 Signal하고 2 프레임 앞서 나가면 가장 오래된 프레임을 기다린다. GPU 프레임 시간은 0.2 ~ 2ms.
+	void TestSoftwareFence(std::uint32_t frameCount)
+	{
+		SoftwareFence fence;
+		FenceTimeline timeline;
+		std::atomic<std::uint64_t> signaled(0);
+		std::atomic<bool> quit(false);
+
+		std::thread gpu([&]()
+		{
+			std::uint64_t done = 0;
+			while (!quit.load())
+			{
+				if (done < signaled.load())
+				{
+					std::this_thread::sleep_for(std::chrono::microseconds(200 + (done * 7919) % 1800));
+					fence.Complete(++done);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		auto poll = [&]() { return fence.GetCompletedValue(); };
+		auto block = [&](std::uint64_t value, std::uint32_t timeoutMs) { return fence.Block(value, timeoutMs); };
+
+		std::uint32_t failures = 0;
+		for (std::uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			std::uint64_t value = timeline.Advance();
+			signaled.store(value);
+			if (value > 2 && !timeline.Wait(value - 2, FenceTimeline::InfiniteTimeout, poll, block))
+				++failures;
+		}
+		CHECK(timeline.Wait(timeline.GetLastSignaledValue(), 1000, poll, block));
+		CHECK(failures == 0);
+
+		quit.store(true);
+		gpu.join();
+
+		const FenceWaitStats& stats = timeline.GetStats();
+		CHECK(stats.WaitCount > 0);
+		CHECK(stats.WaitCount == stats.SpinCompletions + stats.BlockCount);
+		CHECK(stats.TimeoutCount == 0);
+		CHECK(stats.TotalWaitMs >= stats.MaxWaitMs && stats.MaxWaitMs > 0.0);
+		CHECK(timeline.GetLastCompletedValue() == timeline.GetLastSignaledValue());
+
+		std::printf("  %u frames: %llu waits, %llu finished while spinning, %llu blocked, avg %.3f ms, max %.3f ms\n",
+			frameCount, (unsigned long long)stats.WaitCount, (unsigned long long)stats.SpinCompletions,
+			(unsigned long long)stats.BlockCount, stats.TotalWaitMs / stats.WaitCount, stats.MaxWaitMs);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestTimeline();
+	TestWaitPaths();
+	TestSoftwareFence(quick ? 50 : 1000);
+
+	return Test::Finish("FenceTimelineTest");
+}
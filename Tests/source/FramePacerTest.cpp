@@ -0,0 +1,164 @@
+#include "TestCommon.h"
+#include "FramePacer.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	/// <summary>
+	/// 프레임 시간 기록의 한 구간. CPU 시간은 [CpuMs - CpuJitterMs, CpuMs + CpuJitterMs]에서 고르게 흔들린다.
+	/// </summary>
+	struct TracePhase
+	{
+		const char* Name;
+		std::uint32_t Frames;
+		double CpuMs;
+		double CpuJitterMs;
+		double GpuMs;             // 음수면 타임스탬프 쿼리를 지원하지 않는 경우
+		double PresentIntervalMs;
+		std::uint32_t ExpectedFramesInFlight; // 구간이 끝날 때의 깊이
+		bool ExpectSleep;                     // 구간이 끝날 때 잠드는지
+	};
+
+	struct TraceResult
+	{
+		std::uint32_t DepthChanges = 0;
+		double MaxSleepMs = 0.0;
+	};
+
+	// 기록을 처음부터 재생하며 구간마다 마지막 결정을 확인한다.
+	TraceResult ReplayTrace(const FramePacingSettings& settings, const std::vector<TracePhase>& trace, std::uint32_t seed)
+	{
+		FramePacer pacer(settings);
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<double> jitter(-1.0, 1.0);
+
+		TraceResult result;
+		std::uint32_t lastDepth = pacer.GetDecision().FramesInFlight;
+		for (const TracePhase& phase : trace)
+		{
+			FramePacingDecision decision;
+			for (std::uint32_t i = 0; i < phase.Frames; ++i)
+			{
+				FrameTimingSample sample;
+				sample.CpuMs = phase.CpuMs + phase.CpuJitterMs * jitter(random);
+				sample.GpuMs = phase.GpuMs;
+				sample.PresentIntervalMs = phase.PresentIntervalMs;
+				decision = pacer.AddSample(sample);
+
+				CHECK(decision.FramesInFlight >= settings.MinFramesInFlight && decision.FramesInFlight <= settings.MaxFramesInFlight);
+				CHECK(decision.SleepMs >= 0.0);
+				// 잠드는 시간은 GPU가 CPU보다 오래 걸리는 만큼을 넘지 않는다.
+				if (phase.GpuMs >= 0.0)
+					CHECK(decision.SleepMs <= std::max(phase.GpuMs - (phase.CpuMs - phase.CpuJitterMs), 0.0) + 0.01);
+
+				if (decision.FramesInFlight != lastDepth)
+				{
+					++result.DepthChanges;
+					lastDepth = decision.FramesInFlight;
+				}
+				result.MaxSleepMs = std::max(result.MaxSleepMs, decision.SleepMs);
+			}
+
+			if (!CHECK(decision.FramesInFlight == phase.ExpectedFramesInFlight) || !CHECK((decision.SleepMs > 0.0) == phase.ExpectSleep))
+			{
+				std::printf("  phase '%s': %u frames in flight, sleep %.2f ms\n", phase.Name, decision.FramesInFlight, decision.SleepMs);
+			}
+		}
+		return result;
+	}
+
+	void TestSessionTrace()
+	{
+		// 메뉴(수직 동기) -> GPU 병목 게임 화면 -> 스트리밍으로 CPU가 흔들림 -> 로딩(CPU 병목) -> 다시 게임 화면
+		std::vector<TracePhase> trace =
+		{
+			{ "menu, vsync 60Hz",     300,  3.0, 0.3,  4.0, 16.6, 1, false },
+			{ "gameplay, GPU bound",  300,  4.0, 0.2, 10.0, 10.0, 2, true },
+			{ "streaming, jittery",   300,  7.0, 4.0,  9.0,  9.0, 3, false },
+			{ "loading, CPU bound",   300, 12.0, 0.5,  5.0, 12.0, 2, false },
+			{ "gameplay again",       300,  4.0, 0.2, 10.0, 10.0, 2, true },
+		};
+
+		TraceResult result = ReplayTrace(FramePacingSettings(), trace, 18);
+		// 구간이 바뀔 때만 깊이가 바뀐다.
+		CHECK(result.DepthChanges <= 4);
+		// GPU 병목 구간에서 잠드는 시간은 GPU - CPU - 여유 = 5ms에서 흔들림만큼 줄어든다.
+		CHECK(result.MaxSleepMs > 4.0 && result.MaxSleepMs <= 5.0);
+		std::printf("  session trace: %u depth changes, max sleep %.2f ms\n", result.DepthChanges, result.MaxSleepMs);
+	}
+
+	void TestSettings()
+	{
+		// 목표 간격을 정하면 Present 간격과 관계없이 한 프레임 모드를 고른다.
+		FramePacingSettings vsync;
+		vsync.TargetFrameMs = 16.6;
+		ReplayTrace(vsync, { { "vsync target", 200, 3.0, 0.0, 5.0, 9.0, 1, false } }, 1);
+
+		// 최대 깊이가 2면 흔들려도 세 프레임까지 가지 않는다.
+		FramePacingSettings maxTwo;
+		maxTwo.MaxFramesInFlight = 2;
+		ReplayTrace(maxTwo, { { "jitter, max 2", 400, 7.0, 4.0, 9.0, 9.0, 2, false } }, 2);
+
+		// 최소 깊이가 2면 여유가 있어도 한 프레임 모드로 가지 않는다.
+		FramePacingSettings minTwo;
+		minTwo.MinFramesInFlight = 2;
+		ReplayTrace(minTwo, { { "vsync, min 2", 200, 3.0, 0.0, 4.0, 16.6, 2, false } }, 3);
+
+		// GPU 시간을 모르면 두 프레임을 겹쳐 실행하고 잠들지 않는다.
+		ReplayTrace(FramePacingSettings(), { { "no GPU timing", 200, 3.0, 0.5, -1.0, 16.6, 2, false } }, 4);
+	}
+
+	// 매 10 프레임마다 GPU 병목과 흔들림을 오가도 SwitchFrames 덕분에 깊이가 흔들리지 않는다.
+	void TestHysteresis()
+	{
+		FramePacer pacer;
+		std::uint32_t lastDepth = pacer.GetDecision().FramesInFlight;
+		std::uint32_t changes = 0;
+		for (std::uint32_t i = 0; i < 1000; ++i)
+		{
+			FrameTimingSample sample;
+			sample.CpuMs = (i / 10) % 2 ? 3.0 : 8.0;
+			sample.GpuMs = 9.0;
+			sample.PresentIntervalMs = 9.0;
+			std::uint32_t depth = pacer.AddSample(sample).FramesInFlight;
+			if (depth != lastDepth)
+			{
+				++changes;
+				lastDepth = depth;
+			}
+		}
+		CHECK(changes <= 2);
+	}
+
+	// 잠든 만큼 Present 간격이 늘어나는 닫힌 고리에서도 잠드는 시간이 계속 늘어나지 않는다.
+	void TestClosedLoop()
+	{
+		FramePacer pacer;
+		double sleepMs = 0.0;
+		for (std::uint32_t i = 0; i < 2000; ++i)
+		{
+			FrameTimingSample sample;
+			sample.CpuMs = 4.0;
+			sample.GpuMs = 10.0;
+			sample.PresentIntervalMs = std::max(10.0, sample.CpuMs + sleepMs + 1.5);
+			sleepMs = pacer.AddSample(sample).SleepMs;
+		}
+		CHECK(sleepMs > 0.0 && sleepMs < 6.0);
+		CHECK(pacer.GetDecision().FramesInFlight == 2);
+	}
+}
+
+int main(int, char**)
+{
+	TestSessionTrace();
+	TestSettings();
+	TestHysteresis();
+	TestClosedLoop();
+
+	return Test::Finish("FramePacerTest");
+}
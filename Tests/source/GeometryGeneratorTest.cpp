@@ -0,0 +1,451 @@
+#include "TestCommon.h"
+#include "GeometryGenerator.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+namespace
+{
+	typedef GeometryGenerator::Vertex Vertex;
+	typedef GeometryGenerator::MeshData MeshData;
+	typedef GeometryGenerator::uint16 uint16;
+	typedef GeometryGenerator::uint32 uint32;
+
+	Vertex MidPoint(const Vertex& v0, const Vertex& v1)
+	{
+		Vertex v;
+		XMStoreFloat3(&v.Position, 0.5f * (XMLoadFloat3(&v0.Position) + XMLoadFloat3(&v1.Position)));
+		XMStoreFloat3(&v.Normal, XMVector3Normalize(0.5f * (XMLoadFloat3(&v0.Normal) + XMLoadFloat3(&v1.Normal))));
+		XMStoreFloat3(&v.TangentU, XMVector3Normalize(0.5f * (XMLoadFloat3(&v0.TangentU) + XMLoadFloat3(&v1.TangentU))));
+		XMStoreFloat2(&v.TexC, 0.5f * (XMLoadFloat2(&v0.TexC) + XMLoadFloat2(&v1.TexC)));
+		return v;
+	}
+
+	/// <summary>
+	/// 이전 Subdivide. 메쉬 전체를 복사한 뒤 삼각형마다 정점 6개를 새로 넣어서 공유 변의 중점이 중복된다.
+	/// </summary>
+	void SubdivideUnwelded(MeshData& meshData)
+	{
+		MeshData inputCopy = meshData;
+		meshData.Vertices.resize(0);
+		meshData.Indices32.resize(0);
+
+		uint32 numTris = (uint32)inputCopy.Indices32.size() / 3;
+		for (uint32 i = 0; i < numTris; ++i)
+		{
+			Vertex v0 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 0]];
+			Vertex v1 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 1]];
+			Vertex v2 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 2]];
+
+			meshData.Vertices.push_back(v0);
+			meshData.Vertices.push_back(v1);
+			meshData.Vertices.push_back(v2);
+			meshData.Vertices.push_back(MidPoint(v0, v1));
+			meshData.Vertices.push_back(MidPoint(v1, v2));
+			meshData.Vertices.push_back(MidPoint(v0, v2));
+
+			const uint32 corners[12] = { 0, 3, 5, 3, 4, 5, 5, 4, 2, 3, 1, 4 };
+			for (uint32 corner : corners)
+				meshData.Indices32.push_back(i * 6 + corner);
+		}
+	}
+
+	// CreateGeosphere의 이전 경로: 정이십면체를 중복 정점으로 분할한 뒤 CreateGeosphere와 같이 정점마다
+	// 구에 투영하고 텍스처 좌표와 접선을 구한다.
+	MeshData CreateGeosphereUnwelded(GeometryGenerator& generator, float radius, uint32 numSubdivisions)
+	{
+		MeshData meshData = generator.CreateGeosphere(radius, 0);
+		for (uint32 i = 0; i < numSubdivisions; ++i)
+			SubdivideUnwelded(meshData);
+
+		for (Vertex& v : meshData.Vertices)
+		{
+			XMVECTOR n = XMVector3Normalize(XMLoadFloat3(&v.Position));
+			XMStoreFloat3(&v.Position, radius * n);
+			XMStoreFloat3(&v.Normal, n);
+
+			float theta = atan2f(v.Position.z, v.Position.x);
+			if (theta < 0.0f)
+				theta += XM_2PI;
+			float phi = acosf(v.Position.y / radius);
+			v.TexC.x = theta / XM_2PI;
+			v.TexC.y = phi / XM_PI;
+
+			v.TangentU = XMFLOAT3(-radius * sinf(phi) * sinf(theta), 0.0f, radius * sinf(phi) * cosf(theta));
+			XMStoreFloat3(&v.TangentU, XMVector3Normalize(XMLoadFloat3(&v.TangentU)));
+		}
+		return meshData;
+	}
+
+	uint32 Pow4(uint32 n)
+	{
+		return 1u << (2 * n);
+	}
+
+	bool SamePosition(const XMFLOAT3& a, const XMFLOAT3& b, float tolerance)
+	{
+		return std::fabs(a.x - b.x) <= tolerance && std::fabs(a.y - b.y) <= tolerance && std::fabs(a.z - b.z) <= tolerance;
+	}
+
+	// 위치가 같은 정점이 없으면 용접된 메쉬이다.
+	bool HasUniquePositions(const MeshData& meshData)
+	{
+		std::vector<std::pair<std::pair<float, float>, float>> positions;
+		for (const Vertex& v : meshData.Vertices)
+			positions.push_back(std::make_pair(std::make_pair(v.Position.x, v.Position.y), v.Position.z));
+		std::sort(positions.begin(), positions.end());
+		return std::adjacent_find(positions.begin(), positions.end()) == positions.end();
+	}
+
+	// 닫힌 메쉬에서 모든 변은 정확히 두 삼각형이 공유한다. 중점이 중복되면 변이 하나의 삼각형에만 속한다.
+	bool IsClosedManifold(const MeshData& meshData)
+	{
+		std::map<std::pair<uint32, uint32>, int> edgeUses;
+		for (size_t t = 0; t + 2 < meshData.Indices32.size(); t += 3)
+		{
+			for (int e = 0; e < 3; ++e)
+			{
+				uint32 a = meshData.Indices32[t + e];
+				uint32 b = meshData.Indices32[t + (e + 1) % 3];
+				++edgeUses[std::make_pair(std::min(a, b), std::max(a, b))];
+			}
+		}
+		for (const auto& e : edgeUses)
+		{
+			if (e.second != 2)
+				return false;
+		}
+		return edgeUses.size() * 2 == meshData.Indices32.size();
+	}
+
+	/// <summary>
+	/// 용접된 지오스피어는 V = 10 * 4^n + 2, 삼각형 20 * 4^n개이고 이전 경로와 삼각형마다 같은 위치를 만든다.
+	/// </summary>
+	void TestGeosphere(uint32 maxSubdivisions)
+	{
+		GeometryGenerator generator;
+		for (uint32 n = 0; n <= maxSubdivisions; ++n)
+		{
+			MeshData welded = generator.CreateGeosphere(2.0f, n);
+			if (!CHECK(welded.Vertices.size() == 10 * Pow4(n) + 2) || !CHECK(welded.Indices32.size() == 60 * Pow4(n)))
+			{
+				std::printf("  subdivisions %u: %zu vertices, %zu indices\n", n, welded.Vertices.size(), welded.Indices32.size());
+				continue;
+			}
+			CHECK(*std::max_element(welded.Indices32.begin(), welded.Indices32.end()) < welded.Vertices.size());
+			CHECK(HasUniquePositions(welded));
+			CHECK(IsClosedManifold(welded));
+
+			MeshData unwelded = CreateGeosphereUnwelded(generator, 2.0f, n);
+			if (!CHECK(unwelded.Indices32.size() == welded.Indices32.size()))
+				continue;
+			for (size_t i = 0; i < welded.Indices32.size(); ++i)
+			{
+				const XMFLOAT3& a = welded.Vertices[welded.Indices32[i]].Position;
+				const XMFLOAT3& b = unwelded.Vertices[unwelded.Indices32[i]].Position;
+				if (!CHECK(SamePosition(a, b, 1e-5f)))
+					break;
+			}
+			for (const Vertex& v : welded.Vertices)
+			{
+				if (!CHECK(std::fabs(XMVectorGetX(XMVector3Length(XMLoadFloat3(&v.Position))) - 2.0f) < 1e-5f))
+					break;
+			}
+		}
+	}
+
+	// 상자의 면은 법선과 텍스처 좌표가 달라 따로 분할되므로 면마다 (2^n + 1)^2개의 정점이 된다.
+	void TestBox(uint32 maxSubdivisions)
+	{
+		GeometryGenerator generator;
+		for (uint32 n = 0; n <= maxSubdivisions; ++n)
+		{
+			MeshData box = generator.CreateBox(1.0f, 2.0f, 3.0f, n);
+			uint32 side = (1u << n) + 1;
+			CHECK(box.Vertices.size() == 6 * side * side);
+			CHECK(box.Indices32.size() == 36 * Pow4(n));
+			CHECK(*std::max_element(box.Indices32.begin(), box.Indices32.end()) < box.Vertices.size());
+		}
+	}
+
+	/// <summary>
+	/// 분할 단계마다 용접된 경로와 이전 경로의 정점 수와 생성 시간을 비교한다.
+	/// </summary>
+	void BenchmarkGeosphere(uint32 maxSubdivisions, int repeatCount)
+	{
+		GeometryGenerator generator;
+		for (uint32 n = 1; n <= maxSubdivisions; ++n)
+		{
+			size_t weldedVertices = 0;
+			size_t unweldedVertices = 0;
+
+			Test::Stopwatch stopwatch;
+			for (int r = 0; r < repeatCount; ++r)
+				weldedVertices = generator.CreateGeosphere(1.0f, n).Vertices.size();
+			double weldedMs = stopwatch.ElapsedMs() / repeatCount;
+
+			stopwatch.Reset();
+			for (int r = 0; r < repeatCount; ++r)
+				unweldedVertices = CreateGeosphereUnwelded(generator, 1.0f, n).Vertices.size();
+			double unweldedMs = stopwatch.ElapsedMs() / repeatCount;
+
+			std::printf("  geosphere %u: welded %7zu vertices %8.3f ms, unwelded %7zu vertices %8.3f ms (%.1fx fewer vertices)\n",
+				n, weldedVertices, weldedMs, unweldedVertices, unweldedMs, (double)unweldedVertices / weldedVertices);
+		}
+	}
+
+	// 호출자 메모리에 쓰는 생성 함수를 MeshData 버전과 같은 인자로 부르기 위한 묶음
+	struct SpanShape
+	{
+		std::string Name;
+		GeometryGenerator::MeshSize Size;
+		std::function<MeshData(GeometryGenerator&)> CreateMesh;
+		std::function<void(GeometryGenerator&, Vertex*, uint32*)> Create32;
+		std::function<void(GeometryGenerator&, Vertex*, uint16*)> Create16;
+	};
+
+	std::vector<SpanShape> GetSpanShapes(uint32 slices, uint32 stacks)
+	{
+		std::vector<SpanShape> shapes;
+		shapes.push_back({ "sphere", GeometryGenerator::GetSphereSize(slices, stacks),
+			[=](GeometryGenerator& g) { return g.CreateSphere(0.5f, slices, stacks); },
+			[=](GeometryGenerator& g, Vertex* v, uint32* i) { g.CreateSphere(0.5f, slices, stacks, v, i); },
+			[=](GeometryGenerator& g, Vertex* v, uint16* i) { g.CreateSphere(0.5f, slices, stacks, v, i); } });
+		shapes.push_back({ "cylinder", GeometryGenerator::GetCylinderSize(slices, stacks),
+			[=](GeometryGenerator& g) { return g.CreateCylinder(0.5f, 0.3f, 3.0f, slices, stacks); },
+			[=](GeometryGenerator& g, Vertex* v, uint32* i) { g.CreateCylinder(0.5f, 0.3f, 3.0f, slices, stacks, v, i); },
+			[=](GeometryGenerator& g, Vertex* v, uint16* i) { g.CreateCylinder(0.5f, 0.3f, 3.0f, slices, stacks, v, i); } });
+		shapes.push_back({ "grid", GeometryGenerator::GetGridSize(slices, stacks),
+			[=](GeometryGenerator& g) { return g.CreateGrid(20.0f, 30.0f, slices, stacks); },
+			[=](GeometryGenerator& g, Vertex* v, uint32* i) { g.CreateGrid(20.0f, 30.0f, slices, stacks, v, i); },
+			[=](GeometryGenerator& g, Vertex* v, uint16* i) { g.CreateGrid(20.0f, 30.0f, slices, stacks, v, i); } });
+		return shapes;
+	}
+
+	/// <summary>
+	/// 호출자 메모리에 쓰는 버전은 Get*Size만큼 정확히 채우고, MeshData 버전과 바이트 단위로 같은 결과를 만든다.
+	/// 16비트 인덱스 버전은 32비트 인덱스를 줄인 것과 같다.
+	/// </summary>
+	void TestSpanOverloads()
+	{
+		// 버퍼 끝 너머에 쓰는지 알 수 있도록 여유 공간을 표시 값으로 채운다.
+		const size_t guard = 16;
+		const uint32 sizes[][2] = { { 3, 2 }, { 20, 20 }, { 61, 37 }, { 180, 180 } };
+		GeometryGenerator generator;
+		for (const auto& size : sizes)
+		{
+			for (const SpanShape& shape : GetSpanShapes(size[0], size[1]))
+			{
+				MeshData mesh = shape.CreateMesh(generator);
+				if (!CHECK(mesh.Vertices.size() == shape.Size.VertexCount) || !CHECK(mesh.Indices32.size() == shape.Size.IndexCount))
+				{
+					std::printf("  %s %ux%u: size mismatch\n", shape.Name.c_str(), size[0], size[1]);
+					continue;
+				}
+
+				std::vector<Vertex> vertices(shape.Size.VertexCount + guard);
+				std::memset(static_cast<void*>(vertices.data()), 0xCD, vertices.size() * sizeof(Vertex));
+				std::vector<uint32> indices32(shape.Size.IndexCount + guard, 0xCDCDCDCDu);
+				std::vector<uint16> indices16(shape.Size.IndexCount + guard, 0xCDCD);
+				std::vector<Vertex> vertices16 = vertices;
+
+				shape.Create32(generator, vertices.data(), indices32.data());
+				shape.Create16(generator, vertices16.data(), indices16.data());
+
+				size_t vertexBytes = mesh.Vertices.size() * sizeof(Vertex);
+				CHECK(std::memcmp(vertices.data(), mesh.Vertices.data(), vertexBytes) == 0);
+				CHECK(std::memcmp(vertices16.data(), mesh.Vertices.data(), vertexBytes) == 0);
+				CHECK(std::equal(mesh.Indices32.begin(), mesh.Indices32.end(), indices32.begin()));
+				CHECK(mesh.FitsIn16BitIndices() && mesh.GetIndices16() == std::vector<uint16>(indices16.begin(), indices16.end() - guard));
+
+				CHECK(std::all_of(indices32.end() - guard, indices32.end(), [](uint32 i) { return i == 0xCDCDCDCDu; }));
+				CHECK(std::all_of(indices16.end() - guard, indices16.end(), [](uint16 i) { return i == 0xCDCD; }));
+				const std::uint8_t* tail = reinterpret_cast<const std::uint8_t*>(vertices.data() + shape.Size.VertexCount);
+				CHECK(std::all_of(tail, tail + guard * sizeof(Vertex), [](std::uint8_t b) { return b == 0xCD; }));
+			}
+		}
+	}
+
+	/// <summary>
+	/// 업로드 힙에 기록하기까지의 CPU 복사량과 시간을 이전 경로와 비교한다.
+	/// 이전 경로: MeshData 생성 -> 정점을 이어 붙인 벡터 -> GetIndices16으로 줄인 인덱스 벡터
+	///           -> CPU 사본(ID3DBlob) -> 매핑된 업로드 힙으로 memcpy
+	/// 지금 경로: Get*Size로 크기를 구해 매핑된 업로드 힙에 16비트 인덱스로 바로 생성
+	/// 업로드 힙은 미리 할당한 메모리로 대신한다.
+	/// </summary>
+	void BenchmarkUploadCopies(int repeatCount)
+	{
+		GeometryGenerator generator;
+		std::vector<SpanShape> shapes = GetSpanShapes(250, 250);
+
+		size_t vertexBytes = 0;
+		size_t indexBytes = 0;
+		for (const SpanShape& shape : shapes)
+		{
+			vertexBytes += shape.Size.VertexCount * sizeof(Vertex);
+			indexBytes += shape.Size.IndexCount * sizeof(uint16);
+		}
+		std::vector<std::uint8_t> uploadVertices(vertexBytes);
+		std::vector<std::uint8_t> uploadIndices(indexBytes);
+
+		size_t beforeCopied = 0;
+		Test::Stopwatch stopwatch;
+		for (int r = 0; r < repeatCount; ++r)
+		{
+			std::vector<MeshData> meshes;
+			for (const SpanShape& shape : shapes)
+				meshes.push_back(shape.CreateMesh(generator));
+
+			beforeCopied = 0;
+			std::vector<Vertex> vertices;
+			std::vector<uint16> indices;
+			for (const MeshData& mesh : meshes)
+			{
+				vertices.insert(vertices.end(), mesh.Vertices.begin(), mesh.Vertices.end());
+				std::vector<uint16> indices16 = mesh.GetIndices16();
+				indices.insert(indices.end(), indices16.begin(), indices16.end());
+				beforeCopied += mesh.Vertices.size() * sizeof(Vertex) + 2 * indices16.size() * sizeof(uint16);
+			}
+
+			std::vector<std::uint8_t> vertexBlob(vertexBytes);
+			std::vector<std::uint8_t> indexBlob(indexBytes);
+			std::memcpy(vertexBlob.data(), vertices.data(), vertexBytes);
+			std::memcpy(indexBlob.data(), indices.data(), indexBytes);
+			std::memcpy(uploadVertices.data(), vertices.data(), vertexBytes);
+			std::memcpy(uploadIndices.data(), indices.data(), indexBytes);
+			beforeCopied += 2 * (vertexBytes + indexBytes);
+		}
+		double beforeMs = stopwatch.ElapsedMs() / repeatCount;
+		std::vector<std::uint8_t> beforeVertices = uploadVertices;
+		std::vector<std::uint8_t> beforeIndices = uploadIndices;
+
+		stopwatch.Reset();
+		for (int r = 0; r < repeatCount; ++r)
+		{
+			Vertex* vertices = reinterpret_cast<Vertex*>(uploadVertices.data());
+			uint16* indices = reinterpret_cast<uint16*>(uploadIndices.data());
+			for (const SpanShape& shape : shapes)
+			{
+				shape.Create16(generator, vertices, indices);
+				vertices += shape.Size.VertexCount;
+				indices += shape.Size.IndexCount;
+			}
+		}
+		double afterMs = stopwatch.ElapsedMs() / repeatCount;
+
+		// 두 경로가 업로드 힙에 남기는 내용은 같아야 한다.
+		CHECK(uploadVertices == beforeVertices);
+		CHECK(uploadIndices == beforeIndices);
+
+		std::printf("  upload %.1f MB: before %6.1f MB copied after generation %8.3f ms, written in place %8.3f ms (%.1fx faster)\n",
+			(vertexBytes + indexBytes) / 1048576.0, beforeCopied / 1048576.0, beforeMs, afterMs, beforeMs / afterMs);
+	}
+	bool SameMesh(const MeshData& a, const MeshData& b)
+	{
+		return a.Vertices.size() == b.Vertices.size() && a.Indices32.size() == b.Indices32.size() &&
+			std::memcmp(a.Vertices.data(), b.Vertices.data(), a.Vertices.size() * sizeof(Vertex)) == 0 &&
+			std::memcmp(a.Indices32.data(), b.Indices32.data(), a.Indices32.size() * sizeof(uint32)) == 0;
+	}
+
+	/// <summary>
+	/// 행 단위 병렬 생성은 스레드 수와 행 분할에 관계없이 단일 스레드 생성과 바이트 단위로 같아야 한다.
+	/// MinParallelRows(64) 경계 앞뒤와 작업 하나에 행이 몇 개 남는 크기를 고른다.
+	/// </summary>
+	void TestParallelDeterminism()
+	{
+		const uint32 gridSizes[][2] = { { 2, 2 }, { 64, 64 }, { 65, 3 }, { 129, 200 }, { 200, 130 }, { 513, 257 } };
+		const uint32 sphereSizes[][2] = { { 3, 2 }, { 8, 64 }, { 40, 65 }, { 97, 200 }, { 256, 513 } };
+
+		GeometryGenerator generator;
+		std::vector<MeshData> grids;
+		std::vector<MeshData> spheres;
+		for (const auto& size : gridSizes)
+			grids.push_back(generator.CreateGrid(30.0f, 20.0f, size[0], size[1]));
+		for (const auto& size : sphereSizes)
+			spheres.push_back(generator.CreateSphere(1.5f, size[0], size[1]));
+
+		// 0은 JobSystem 없이 호출한 스레드에서 생성한다.
+		for (unsigned workerCount : { 0u, 1u, 2u, 3u, 7u })
+		{
+			std::unique_ptr<JobSystem> jobs(workerCount > 0 ? new JobSystem(workerCount) : nullptr);
+			for (size_t i = 0; i < grids.size(); ++i)
+			{
+				MeshData parallel = generator.CreateGridParallel(30.0f, 20.0f, gridSizes[i][0], gridSizes[i][1], jobs.get());
+				if (!CHECK(SameMesh(parallel, grids[i])))
+					std::printf("  grid %ux%u, %u workers: differs from serial output\n", gridSizes[i][0], gridSizes[i][1], workerCount);
+			}
+			for (size_t i = 0; i < spheres.size(); ++i)
+			{
+				MeshData parallel = generator.CreateSphereParallel(1.5f, sphereSizes[i][0], sphereSizes[i][1], jobs.get());
+				if (!CHECK(SameMesh(parallel, spheres[i])))
+					std::printf("  sphere %ux%u, %u workers: differs from serial output\n", sphereSizes[i][0], sphereSizes[i][1], workerCount);
+			}
+		}
+	}
+
+	/// <summary>
+	/// 4096x4096 격자와 구를 1개부터 하드웨어 스레드 수까지 늘려 가며 생성해 확장성을 잰다.
+	/// 메모리 할당과 첫 접근 비용이 섞이지 않도록 미리 채운 버퍼에 생성한다.
+	/// </summary>
+	void BenchmarkParallelScaling(uint32 size, int repeatCount)
+	{
+		unsigned maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		GeometryGenerator::MeshSize gridSize = GeometryGenerator::GetGridSize(size, size);
+		GeometryGenerator::MeshSize sphereSize = GeometryGenerator::GetSphereSize(size, size);
+		std::vector<Vertex> vertices(std::max(gridSize.VertexCount, sphereSize.VertexCount));
+		std::vector<uint32> indices(std::max(gridSize.IndexCount, sphereSize.IndexCount));
+		GeometryGenerator generator;
+
+		double serialMs[2] = {};
+		for (unsigned threadCount = 1; threadCount <= maxThreads; ++threadCount)
+		{
+			// 한 스레드는 JobSystem 없이 생성하는 기준 시간이다.
+			std::unique_ptr<JobSystem> jobs(threadCount > 1 ? new JobSystem(threadCount - 1) : nullptr);
+
+			Test::Stopwatch stopwatch;
+			for (int r = 0; r < repeatCount; ++r)
+				generator.CreateGridParallel(100.0f, 100.0f, size, size, vertices.data(), indices.data(), jobs.get());
+			double gridMs = stopwatch.ElapsedMs() / repeatCount;
+
+			stopwatch.Reset();
+			for (int r = 0; r < repeatCount; ++r)
+				generator.CreateSphereParallel(1.0f, size, size, vertices.data(), indices.data(), jobs.get());
+			double sphereMs = stopwatch.ElapsedMs() / repeatCount;
+
+			if (threadCount == 1)
+			{
+				serialMs[0] = gridMs;
+				serialMs[1] = sphereMs;
+			}
+			std::printf("  %ux%u, %2u threads: grid %8.2f ms (x%.2f), sphere %8.2f ms (x%.2f)\n",
+				size, size, threadCount, gridMs, serialMs[0] / gridMs, sphereMs, serialMs[1] / sphereMs);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestGeosphere(quick ? 4 : 6);
+	TestBox(quick ? 4 : 6);
+	TestSpanOverloads();
+	TestParallelDeterminism();
+	BenchmarkGeosphere(quick ? 3 : 6, quick ? 1 : 5);
+	BenchmarkUploadCopies(quick ? 1 : 10);
+	if (!quick)
+		BenchmarkParallelScaling(4096, 3);
+
+	return Test::Finish("GeometryGeneratorTest");
+}
@@ -0,0 +1,296 @@
+#include "TestCommon.h"
+#include "HeapAllocator.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	// PlacedBufferAllocator와 같은 설정 (32MB 블록, 64KB 버퍼 정렬)
+	const std::uint64_t BlockSize = 32ull * 1024 * 1024;
+	const std::uint64_t MinBlockSize = 64 * 1024;
+
+	/// <summary>
+	/// ID3D12Heap 대신 블록 번호만 기록하는 가짜 힙. 같은 자리를 두 번 만들거나 없는 블록을 해제하면 실패한다.
+	/// </summary>
+	class MockHeapBackend : public HeapBlockBackend
+	{
+	public:
+		bool CreateBlock(std::uint32_t blockIndex, std::uint64_t byteSize) override
+		{
+			CHECK(byteSize == BlockSize);
+			if (mCreateLimit == 0)
+				return false;
+			--mCreateLimit;
+
+			CHECK(mBlocks.insert(blockIndex).second);
+			return true;
+		}
+
+		void DestroyBlock(std::uint32_t blockIndex) override
+		{
+			CHECK(mBlocks.erase(blockIndex) == 1);
+		}
+
+		bool IsCreated(std::uint32_t blockIndex) const { return mBlocks.count(blockIndex) > 0; }
+		size_t GetBlockCount() const { return mBlocks.size(); }
+
+		// 이후 만들 수 있는 블록 수. 장치 메모리 부족을 흉내 낸다.
+		void SetCreateLimit(size_t limit) { mCreateLimit = limit; }
+
+	private:
+		std::set<std::uint32_t> mBlocks;
+		size_t mCreateLimit = SIZE_MAX;
+	};
+
+	struct LiveAllocation
+	{
+		std::uint32_t Id;
+		std::uint64_t ByteSize;
+		std::uint64_t Alignment;
+	};
+
+	// 살아 있는 할당이 모두 만들어진 블록 안에 있고, 정렬과 크기를 지키며, 서로 겹치지 않는지 확인한다.
+	void CheckAllocations(const BuddyHeapAllocator& allocator, const MockHeapBackend& backend, const std::vector<LiveAllocation>& live)
+	{
+		std::vector<HeapLocation> locations;
+		locations.reserve(live.size());
+
+		std::uint64_t usedBytes = 0;
+		for (const LiveAllocation& allocation : live)
+		{
+			const HeapLocation& location = allocator.GetLocation(allocation.Id);
+			CHECK(backend.IsCreated(location.Block));
+			CHECK(location.Size >= allocation.ByteSize);
+			CHECK(location.Offset % allocation.Alignment == 0);
+			// 버디 블록은 자기 크기로 정렬된다.
+			CHECK(location.Offset % location.Size == 0);
+			CHECK(location.Offset + location.Size <= BlockSize);
+			usedBytes += location.Size;
+			locations.push_back(location);
+		}
+
+		std::sort(locations.begin(), locations.end(), [](const HeapLocation& a, const HeapLocation& b)
+		{
+			return a.Block != b.Block ? a.Block < b.Block : a.Offset < b.Offset;
+		});
+		for (size_t i = 1; i < locations.size(); ++i)
+		{
+			const HeapLocation& prev = locations[i - 1];
+			const HeapLocation& next = locations[i];
+			if (prev.Block == next.Block)
+				CHECK(prev.Offset + prev.Size <= next.Offset);
+		}
+
+		HeapAllocatorStats stats = allocator.GetStats();
+		CHECK(stats.AllocationCount == live.size());
+		CHECK(stats.UsedBytes == usedBytes);
+		CHECK(stats.BlockCount == backend.GetBlockCount());
+		CHECK(stats.UsedBytes <= stats.ReservedBytes);
+	}
+
+	LiveAllocation AllocateRandom(BuddyHeapAllocator& allocator, std::mt19937& random)
+	{
+		// 대부분은 정점/인덱스 버퍼 크기이고, 가끔 MSAA 텍스처 정렬(4MB)이나 큰 버퍼가 섞인다.
+		LiveAllocation allocation;
+		std::uint32_t kind = random() % 16;
+		allocation.ByteSize = kind == 0 ? 1 + random() % (8 * 1024 * 1024) : 1 + random() % (256 * 1024);
+		allocation.Alignment = kind == 1 ? 4 * 1024 * 1024 : MinBlockSize;
+		allocation.Id = allocator.Allocate(allocation.ByteSize, allocation.Alignment);
+		return allocation;
+	}
+
+	void TestRandomAllocations(std::uint32_t opCount, std::uint32_t checkInterval)
+	{
+		MockHeapBackend backend;
+		std::vector<LiveAllocation> live;
+		std::mt19937 random(12);
+		{
+			BuddyHeapAllocator allocator(&backend, BlockSize, MinBlockSize);
+
+			for (std::uint32_t op = 0; op < opCount; ++op)
+			{
+				// 살아 있는 할당이 약 2000개 근처에서 오르내리도록 한다.
+				bool allocate = live.empty() || (random() % 4000) >= live.size();
+				if (allocate)
+				{
+					LiveAllocation allocation = AllocateRandom(allocator, random);
+					if (CHECK(allocation.Id != BuddyHeapAllocator::InvalidAllocation))
+						live.push_back(allocation);
+				}
+				else
+				{
+					size_t index = random() % live.size();
+					allocator.Free(live[index].Id);
+					live[index] = live.back();
+					live.pop_back();
+				}
+
+				if (op % checkInterval == 0)
+					CheckAllocations(allocator, backend, live);
+			}
+			CheckAllocations(allocator, backend, live);
+
+			for (const LiveAllocation& allocation : live)
+				allocator.Free(allocation.Id);
+			live.clear();
+
+			// 빈 블록은 하나만 남는다.
+			CHECK(backend.GetBlockCount() <= 1);
+			HeapAllocatorStats stats = allocator.GetStats();
+			CHECK(stats.UsedBytes == 0 && stats.RequestedBytes == 0 && stats.AllocationCount == 0);
+			CHECK(stats.TotalAllocations == stats.TotalFrees);
+		}
+		// 할당기가 사라지면 남은 블록도 해제된다.
+		CHECK(backend.GetBlockCount() == 0);
+	}
+
+	void TestLimits()
+	{
+		MockHeapBackend backend;
+		BuddyHeapAllocator allocator(&backend, BlockSize, MinBlockSize);
+
+		// 블록보다 큰 요청은 블록을 만들지 않고 실패한다.
+		CHECK(allocator.Allocate(BlockSize + 1, MinBlockSize) == BuddyHeapAllocator::InvalidAllocation);
+		CHECK(backend.GetBlockCount() == 0);
+
+		// 블록 전체와 최소 크기 할당
+		std::uint32_t whole = allocator.Allocate(BlockSize, MinBlockSize);
+		std::uint32_t small = allocator.Allocate(1, 1);
+		CHECK(whole != BuddyHeapAllocator::InvalidAllocation && small != BuddyHeapAllocator::InvalidAllocation);
+		CHECK(allocator.GetLocation(small).Size == MinBlockSize);
+		CHECK(allocator.GetLocation(whole).Block != allocator.GetLocation(small).Block);
+
+		// 장치가 더 이상 힙을 만들지 못하면 할당이 실패하고 통계에 남는다.
+		backend.SetCreateLimit(0);
+		CHECK(allocator.Allocate(BlockSize, MinBlockSize) == BuddyHeapAllocator::InvalidAllocation);
+		CHECK(allocator.GetStats().FailedAllocations == 2);
+		// 이미 있는 블록의 빈 자리는 계속 쓸 수 있다.
+		CHECK(allocator.Allocate(MinBlockSize, MinBlockSize) != BuddyHeapAllocator::InvalidAllocation);
+	}
+
+	// 많이 할당한 뒤 대부분을 해제해 블록마다 몇 개씩만 남긴 상태에서 Defragment가 블록을 비우는지 확인한다.
+	void TestDefragment(std::uint32_t allocationCount, bool printStats)
+	{
+		MockHeapBackend backend;
+		BuddyHeapAllocator allocator(&backend, BlockSize, MinBlockSize);
+		std::mt19937 random(121);
+
+		std::vector<LiveAllocation> live;
+		for (std::uint32_t i = 0; i < allocationCount; ++i)
+		{
+			LiveAllocation allocation = AllocateRandom(allocator, random);
+			if (CHECK(allocation.Id != BuddyHeapAllocator::InvalidAllocation))
+				live.push_back(allocation);
+		}
+
+		// 90% 해제
+		std::shuffle(live.begin(), live.end(), random);
+		size_t keepCount = live.size() / 10;
+		for (size_t i = keepCount; i < live.size(); ++i)
+			allocator.Free(live[i].Id);
+		live.resize(keepCount);
+		CheckAllocations(allocator, backend, live);
+
+		HeapAllocatorStats before = allocator.GetStats();
+
+		// 옮기기를 거부하면 아무것도 바뀌지 않는다.
+		CHECK(allocator.Defragment([](std::uint32_t, const HeapLocation&, const HeapLocation&) { return false; }) == 0);
+		CHECK(allocator.GetStats().BlockCount == before.BlockCount);
+		CheckAllocations(allocator, backend, live);
+
+		// 옮기는 대상은 현재 위치에서 더 사용량이 많은 다른 블록이며, 크기는 그대로다.
+		size_t callbackMoves = 0;
+		size_t moves = allocator.Defragment([&](std::uint32_t id, const HeapLocation& from, const HeapLocation& to)
+		{
+			const HeapLocation& current = allocator.GetLocation(id);
+			CHECK(from.Block == current.Block && from.Offset == current.Offset);
+			CHECK(to.Block != from.Block);
+			CHECK(to.Size == from.Size);
+			CHECK(backend.IsCreated(to.Block));
+			++callbackMoves;
+			return true;
+		});
+		CHECK(moves == callbackMoves);
+		CHECK(moves > 0);
+		// 가장 많이 찬 블록부터 채우므로 같은 할당을 여러 번 옮기지 않는다.
+		CHECK(moves <= live.size());
+		CheckAllocations(allocator, backend, live);
+
+		HeapAllocatorStats after = allocator.GetStats();
+		CHECK(after.Moves == moves);
+		CHECK(after.UsedBytes == before.UsedBytes);
+		CHECK(after.BlockCount < before.BlockCount);
+		// 비워진 블록은 해제되고, 남은 블록은 하나를 빼면 모두 사용 중이다.
+		CHECK(after.BlocksDestroyed - before.BlocksDestroyed == before.BlockCount - after.BlockCount);
+		std::set<std::uint32_t> usedBlocks;
+		for (const LiveAllocation& allocation : live)
+			usedBlocks.insert(allocator.GetLocation(allocation.Id).Block);
+		CHECK(after.BlockCount <= usedBlocks.size() + 1);
+
+		if (printStats)
+		{
+			std::printf("  defragment: %zu live allocations, %zu moves, blocks %llu -> %llu, occupancy %.0f%% -> %.0f%%\n",
+				live.size(), moves, (unsigned long long)before.BlockCount, (unsigned long long)after.BlockCount,
+				before.Occupancy() * 100.0, after.Occupancy() * 100.0);
+		}
+	}
+
+	void BenchmarkAllocateFree(std::uint32_t opCount)
+	{
+		MockHeapBackend backend;
+		BuddyHeapAllocator allocator(&backend, BlockSize, MinBlockSize);
+		std::mt19937 random(1212);
+
+		// 할당 크기와 해제 순서는 미리 만들어 측정에서 뺀다.
+		std::vector<std::uint64_t> sizes(opCount);
+		std::vector<std::uint32_t> picks(opCount);
+		for (std::uint32_t i = 0; i < opCount; ++i)
+		{
+			sizes[i] = 1 + random() % (256 * 1024);
+			picks[i] = (std::uint32_t)random();
+		}
+
+		std::vector<std::uint32_t> live;
+		live.reserve(4096);
+
+		Test::Stopwatch stopwatch;
+		for (std::uint32_t op = 0; op < opCount; ++op)
+		{
+			if (live.empty() || picks[op] % 4000 >= live.size())
+			{
+				live.push_back(allocator.Allocate(sizes[op], MinBlockSize));
+			}
+			else
+			{
+				size_t index = picks[op] % live.size();
+				allocator.Free(live[index]);
+				live[index] = live.back();
+				live.pop_back();
+			}
+		}
+		double ms = stopwatch.ElapsedMs();
+
+		HeapAllocatorStats stats = allocator.GetStats();
+		std::printf("  %u alloc/free ops: %.1f ms (%.2fM ops/s), %zu live, %llu blocks, occupancy %.0f%%, internal %.0f%%, external %.0f%%\n",
+			opCount, ms, opCount / ms / 1000.0, live.size(), (unsigned long long)stats.BlockCount,
+			stats.Occupancy() * 100.0, stats.InternalFragmentation() * 100.0, stats.ExternalFragmentation() * 100.0);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestLimits();
+	TestRandomAllocations(quick ? 20000 : 200000, quick ? 97 : 997);
+	TestDefragment(quick ? 4000 : 20000, !quick);
+	if (!quick)
+		BenchmarkAllocateFree(200000);
+
+	return Test::Finish("HeapAllocatorTest");
+}
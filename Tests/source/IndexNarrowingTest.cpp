@@ -0,0 +1,195 @@
+#include "TestCommon.h"
+#include "GeometryGenerator.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace Engine;
+
+// 이 테스트는 GeometryGenerator.cpp와 같은 옵션으로 경로마다 따로 빌드된다. (CMakeLists.txt 참고)
+#if defined(GEOMETRYGENERATOR_NO_SIMD)
+#define INDEX_NARROWING_PATH "scalar"
+#elif defined(__AVX2__)
+#define INDEX_NARROWING_PATH "AVX2"
+#elif defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define INDEX_NARROWING_PATH "SSE2"
+#else
+#define INDEX_NARROWING_PATH "scalar"
+#endif
+
+namespace
+{
+	typedef GeometryGenerator::uint16 uint16;
+	typedef GeometryGenerator::uint32 uint32;
+
+	// 버퍼 끝 너머에 쓰지 않는지 확인하기 위한 여유 공간과 표시 값
+	const size_t GuardCount = 32;
+	const uint16 GuardValue = 0xCDCD;
+
+	bool ReferenceFitsIn16Bits(const uint32* indices, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (indices[i] > 0xFFFF)
+				return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// src[0, count)를 두 함수로 검사하고 스칼라 결과와 비교한다. 16비트에 들어가면 dst는 src와 같아야 한다.
+	/// </summary>
+	bool CheckNarrow(const std::vector<uint32>& src, size_t count)
+	{
+		bool expected = ReferenceFitsIn16Bits(src.data(), count);
+
+		std::vector<uint16> dst(count + GuardCount, GuardValue);
+		bool fits = GeometryGenerator::NarrowIndices(src.data(), dst.data(), count);
+		if (!CHECK(fits == expected) || !CHECK(GeometryGenerator::FitsIn16Bits(src.data(), count) == expected))
+			return false;
+		if (!CHECK(std::all_of(dst.begin() + count, dst.end(), [](uint16 v) { return v == GuardValue; })))
+			return false;
+		return !expected || CHECK(std::equal(src.begin(), src.begin() + count, dst.begin()));
+	}
+
+	/// <summary>
+	/// 블록 크기(SSE2 8/16개, AVX2 16개)의 나머지가 모두 나오도록 길이를 바꿔 가며, 65535와 65536을
+	/// 모든 위치(블록 안과 스칼라로 처리하는 꼬리)에 넣어 본다.
+	/// </summary>
+	void TestBoundary()
+	{
+		std::mt19937 random(8);
+		std::uniform_int_distribution<uint32> index(0, 0xFFFF);
+
+		std::vector<uint32> src;
+		for (size_t count = 0; count <= 96; ++count)
+		{
+			src.resize(count);
+			for (uint32& i : src)
+				i = index(random);
+			if (!CheckNarrow(src, count))
+			{
+				std::printf("  %zu indices: mismatch\n", count);
+				continue;
+			}
+
+			// 65535는 들어가고 65536부터는 들어가지 않는다. 부호 있는 팩과 바이어스 처리에서 틀리기 쉬운 값도 넣는다.
+			const uint32 values[] = { 0xFFFF, 0x10000, 0x8000, 0x7FFF, 0x18000, 0x80000000u, 0xFFFFFFFFu, 0xFFFF8000u };
+			for (size_t position = 0; position < count; ++position)
+			{
+				uint32 original = src[position];
+				for (uint32 value : values)
+				{
+					src[position] = value;
+					if (!CheckNarrow(src, count))
+						std::printf("  %zu indices, 0x%X at %zu: mismatch\n", count, value, position);
+				}
+				src[position] = original;
+			}
+		}
+	}
+
+	/// <summary>
+	/// 긴 배열에서 앞, 블록 경계, 마지막 꼬리에 65536을 넣어도 찾아낸다.
+	/// </summary>
+	void TestLong()
+	{
+		std::mt19937 random(16);
+		std::uniform_int_distribution<uint32> index(0, 0xFFFF);
+		for (size_t count : { 1000u, 1023u, 4096u, 4097u, 65551u })
+		{
+			std::vector<uint32> src(count);
+			for (uint32& i : src)
+				i = index(random);
+			CheckNarrow(src, count);
+
+			for (size_t position : { (size_t)0, (size_t)7, (size_t)8, (size_t)15, (size_t)16, count / 2, count - 17, count - 9, count - 1 })
+			{
+				uint32 original = src[position];
+				src[position] = 0x10000;
+				CheckNarrow(src, count);
+				src[position] = original;
+			}
+		}
+	}
+
+	/// <summary>
+	/// 수백만 개의 인덱스에서 변환/검사 처리량을 스칼라 반복문과 비교한다.
+	/// </summary>
+	void BenchmarkNarrow(size_t count, int repeatCount)
+	{
+		std::mt19937 random(32);
+		std::uniform_int_distribution<uint32> index(0, 0xFFFF);
+		std::vector<uint32> src(count);
+		for (uint32& i : src)
+			i = index(random);
+		std::vector<uint16> dst(count);
+		double megabytes = count * sizeof(uint32) / 1048576.0;
+
+		Test::Stopwatch stopwatch;
+		bool fits = true;
+		for (int r = 0; r < repeatCount; ++r)
+		{
+			uint32 combined = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				combined |= src[i];
+				dst[i] = (uint16)src[i];
+			}
+			fits = fits && (combined >> 16) == 0;
+		}
+		double scalarMs = stopwatch.ElapsedMs() / repeatCount;
+
+		stopwatch.Reset();
+		for (int r = 0; r < repeatCount; ++r)
+			fits = GeometryGenerator::NarrowIndices(src.data(), dst.data(), count) && fits;
+		double narrowMs = stopwatch.ElapsedMs() / repeatCount;
+
+		stopwatch.Reset();
+		for (int r = 0; r < repeatCount; ++r)
+			fits = GeometryGenerator::FitsIn16Bits(src.data(), count) && fits;
+		double fitsMs = stopwatch.ElapsedMs() / repeatCount;
+		CHECK(fits);
+
+		std::printf("  %s, %zu indices: scalar loop %7.3f ms (%5.1f GB/s), NarrowIndices %7.3f ms (%5.1f GB/s, x%.2f), FitsIn16Bits %7.3f ms (%5.1f GB/s)\n",
+			INDEX_NARROWING_PATH, count, scalarMs, megabytes / scalarMs * 1000.0 / 1024.0, narrowMs, megabytes / narrowMs * 1000.0 / 1024.0,
+			scalarMs / narrowMs, fitsMs, megabytes / fitsMs * 1000.0 / 1024.0);
+	}
+
+	bool CpuSupportsPath()
+	{
+#if defined(__AVX2__) && !defined(GEOMETRYGENERATOR_NO_SIMD)
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+#else
+		return true;
+#endif
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	if (!CpuSupportsPath())
+	{
+		std::printf("IndexNarrowingTest (%s): skipped, not supported by this CPU\n", INDEX_NARROWING_PATH);
+		return 77;
+	}
+
+	TestBoundary();
+	TestLong();
+	BenchmarkNarrow(quick ? (1 << 20) : (16 << 20), quick ? 3 : 20);
+
+	return Test::Finish("IndexNarrowingTest (" INDEX_NARROWING_PATH ")");
+}
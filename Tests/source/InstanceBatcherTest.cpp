@@ -0,0 +1,200 @@
+#include "TestCommon.h"
+#include "InstanceBatcher.h"
+#include <cstdint>
+#include <map>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	// ShapesApp의 DrawBatchKey와 같은 구성 (D3D12 형식 대신 정수)
+	struct DrawKey
+	{
+		std::uint32_t Geometry = 0;
+		std::uint32_t Pipeline = 0;
+		std::uint32_t PrimitiveType = 0;
+		std::uint32_t IndexCount = 0;
+		std::uint32_t StartIndexLocation = 0;
+		int BaseVertexLocation = 0;
+
+		bool operator==(const DrawKey& rhs) const
+		{
+			return Geometry == rhs.Geometry && Pipeline == rhs.Pipeline && PrimitiveType == rhs.PrimitiveType &&
+				IndexCount == rhs.IndexCount && StartIndexLocation == rhs.StartIndexLocation &&
+				BaseVertexLocation == rhs.BaseVertexLocation;
+		}
+		bool operator<(const DrawKey& rhs) const
+		{
+			return std::tie(Geometry, Pipeline, PrimitiveType, IndexCount, StartIndexLocation, BaseVertexLocation) <
+				std::tie(rhs.Geometry, rhs.Pipeline, rhs.PrimitiveType, rhs.IndexCount, rhs.StartIndexLocation, rhs.BaseVertexLocation);
+		}
+	};
+
+	struct DrawKeyHash
+	{
+		size_t operator()(const DrawKey& key) const
+		{
+			std::uint64_t h = key.Geometry;
+			auto mix = [&h](std::uint64_t value) { h = (h ^ value) * 0x9E3779B97F4A7C15ull; };
+			mix(key.Pipeline);
+			mix(key.PrimitiveType);
+			mix(key.IndexCount);
+			mix(key.StartIndexLocation);
+			mix((std::uint32_t)key.BaseVertexLocation);
+			return (size_t)(h ^ (h >> 29));
+		}
+	};
+
+	// 모든 키가 한 칸에 모이는 최악의 해시. 선형 탐사가 충돌을 제대로 처리하는지 본다.
+	struct CollidingHash
+	{
+		size_t operator()(const DrawKey&) const { return 7; }
+	};
+
+	DrawKey MakeKey(std::uint32_t k)
+	{
+		DrawKey key;
+		key.Geometry = k % 3;
+		key.Pipeline = k % 2;
+		key.PrimitiveType = 4;
+		key.IndexCount = 36 + k;
+		key.StartIndexLocation = k * 7;
+		key.BaseVertexLocation = (int)(k % 5);
+		return key;
+	}
+
+	typedef std::vector<std::pair<DrawKey, std::uint32_t>> ItemList;
+
+	ItemList MakeItems(std::mt19937& random, size_t itemCount, std::uint32_t keyCount)
+	{
+		ItemList items(itemCount);
+		for (size_t i = 0; i < itemCount; ++i)
+			items[i] = std::make_pair(MakeKey(random() % keyCount), (std::uint32_t)i);
+		return items;
+	}
+
+	// std::map으로 만든 기준 결과와 묶음 순서, 시작 위치, 인스턴스 순서를 비교한다.
+	template<typename THash>
+	void CheckBatches(const InstanceBatcher<DrawKey, THash>& batcher, const ItemList& items)
+	{
+		std::map<DrawKey, std::vector<std::uint32_t>> reference;
+		std::vector<DrawKey> order;
+		for (const auto& item : items)
+		{
+			std::vector<std::uint32_t>& ids = reference[item.first];
+			if (ids.empty())
+				order.push_back(item.first);
+			ids.push_back(item.second);
+		}
+
+		const auto& batches = batcher.GetBatches();
+		const std::vector<std::uint32_t>& instances = batcher.GetInstances();
+		if (!CHECK(batches.size() == order.size()) || !CHECK(instances.size() == items.size()))
+			return;
+
+		std::uint32_t offset = 0;
+		for (size_t b = 0; b < batches.size(); ++b)
+		{
+			const std::vector<std::uint32_t>& ids = reference[order[b]];
+			CHECK(batches[b].Key == order[b]);
+			CHECK(batches[b].FirstInstance == offset);
+			if (!CHECK(batches[b].InstanceCount == ids.size()))
+				return;
+			for (size_t j = 0; j < ids.size(); ++j)
+			{
+				if (!CHECK(instances[offset + j] == ids[j]))
+					return;
+			}
+			offset += (std::uint32_t)ids.size();
+		}
+		CHECK(offset == items.size());
+	}
+
+	// 100k 그리기를 키 수를 바꿔 가며 묶는다. 프레임마다 Reset 후 다시 묶어도 결과가 같아야 한다.
+	void TestBatching(size_t itemCount, std::uint32_t frameCount, bool printStats)
+	{
+		std::mt19937 random(20);
+		for (std::uint32_t keyCount : { 1u, 7u, 300u, 5000u })
+		{
+			InstanceBatcher<DrawKey, DrawKeyHash> batcher;
+			double totalMs = 0.0;
+			size_t batchCount = 0;
+			for (std::uint32_t frame = 0; frame < frameCount; ++frame)
+			{
+				ItemList items = MakeItems(random, itemCount, keyCount);
+
+				Test::Stopwatch stopwatch;
+				batcher.Reset();
+				for (const auto& item : items)
+					batcher.Add(item.first, item.second);
+				batcher.Build();
+				// 첫 프레임은 테이블과 배열을 할당하므로 재지 않는다.
+				if (frame > 0)
+					totalMs += stopwatch.ElapsedMs();
+
+				CheckBatches(batcher, items);
+				batchCount = batcher.GetBatches().size();
+			}
+
+			if (printStats)
+			{
+				// 같은 일을 std::map으로 할 때와 비교한다.
+				ItemList items = MakeItems(random, itemCount, keyCount);
+				Test::Stopwatch stopwatch;
+				std::map<DrawKey, std::vector<std::uint32_t>> grouped;
+				for (const auto& item : items)
+					grouped[item.first].push_back(item.second);
+				double mapMs = stopwatch.ElapsedMs();
+
+				std::printf("  %zu items, %5u keys: %5zu batches, %.3f ms per frame (std::map %.3f ms)\n",
+					itemCount, keyCount, batchCount, totalMs / (frameCount - 1), mapMs);
+			}
+		}
+	}
+
+	void TestCollisions()
+	{
+		std::mt19937 random(21);
+		InstanceBatcher<DrawKey, CollidingHash> batcher;
+		for (int frame = 0; frame < 2; ++frame)
+		{
+			ItemList items = MakeItems(random, 2000, 200);
+			batcher.Reset();
+			for (const auto& item : items)
+				batcher.Add(item.first, item.second);
+			batcher.Build();
+			CheckBatches(batcher, items);
+		}
+	}
+
+	void TestEmpty()
+	{
+		InstanceBatcher<DrawKey, DrawKeyHash> batcher;
+		batcher.Reset();
+		batcher.Build();
+		CHECK(batcher.GetBatches().empty() && batcher.GetInstances().empty());
+
+		CHECK(batcher.Add(MakeKey(1), 10) == 0);
+		CHECK(batcher.Add(MakeKey(2), 11) == 1);
+		CHECK(batcher.Add(MakeKey(1), 12) == 0);
+		batcher.Build();
+		batcher.Reset();
+		batcher.Build();
+		CHECK(batcher.GetBatches().empty() && batcher.GetInstances().empty());
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestEmpty();
+	TestCollisions();
+	TestBatching(100000, quick ? 2 : 10, !quick);
+
+	return Test::Finish("InstanceBatcherTest");
+}
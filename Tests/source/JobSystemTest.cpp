@@ -0,0 +1,373 @@
+#include "TestCommon.h"
+#include "JobSystem.h"
+#include "WorkStealingDeque.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	void TestDequeSemantics()
+	{
+		std::vector<int> items(8);
+		WorkStealingDeque<int> deque(4);
+
+		CHECK(deque.Pop() == nullptr);
+		CHECK(deque.Steal() == nullptr);
+
+		for (int i = 0; i < 4; ++i)
+			CHECK(deque.Push(&items[i]));
+		// 가득 차면 넣지 않는다.
+		CHECK(!deque.Push(&items[4]));
+		CHECK(deque.GetApproximateSize() == 4);
+
+		// 소유 스레드는 최근 항목부터(LIFO), 훔치는 쪽은 오래된 항목부터(FIFO) 가져간다.
+		CHECK(deque.Pop() == &items[3]);
+		CHECK(deque.Steal() == &items[0]);
+		CHECK(deque.Pop() == &items[2]);
+		CHECK(deque.Steal() == &items[1]);
+		CHECK(deque.Pop() == nullptr);
+		CHECK(deque.Steal() == nullptr);
+
+		// 인덱스가 용량을 넘어 돌아도 순서가 유지된다.
+		for (int round = 0; round < 10; ++round)
+		{
+			CHECK(deque.Push(&items[5]) && deque.Push(&items[6]) && deque.Push(&items[7]));
+			CHECK(deque.Steal() == &items[5]);
+			CHECK(deque.Pop() == &items[7]);
+			CHECK(deque.Pop() == &items[6]);
+		}
+	}
+
+	// 소유 스레드가 Push/Pop하는 동안 여러 스레드가 Steal하며, 모든 항목이 정확히 한 번씩 꺼내지는지 확인한다.
+	// 덱이 가득 차면 JobSystem처럼 소유 스레드가 직접 처리한다.
+	void TestDequeStress(std::uint32_t itemCount, unsigned thiefCount)
+	{
+		WorkStealingDeque<std::uint32_t> deque(256);
+		std::vector<std::uint32_t> items(itemCount);
+		std::unique_ptr<std::atomic<std::uint32_t>[]> taken(new std::atomic<std::uint32_t>[itemCount]);
+		for (std::uint32_t i = 0; i < itemCount; ++i)
+		{
+			items[i] = i;
+			taken[i].store(0);
+		}
+
+		std::atomic<bool> ownerDone(false);
+		std::atomic<std::uint64_t> stolenCount(0);
+
+		std::vector<std::thread> thieves;
+		for (unsigned t = 0; t < thiefCount; ++t)
+		{
+			thieves.emplace_back([&]()
+			{
+				std::uint64_t stolen = 0;
+				for (;;)
+				{
+					// 소유 스레드가 끝났음을 먼저 읽고 마지막으로 한 번 더 훔쳐야 남은 항목을 놓치지 않는다.
+					bool done = ownerDone.load(std::memory_order_acquire);
+					if (std::uint32_t* item = deque.Steal())
+					{
+						taken[*item].fetch_add(1, std::memory_order_relaxed);
+						++stolen;
+					}
+					else if (done)
+					{
+						break;
+					}
+					else
+					{
+						std::this_thread::yield();
+					}
+				}
+				stolenCount.fetch_add(stolen);
+			});
+		}
+
+		std::mt19937 random(16);
+		std::uint64_t popped = 0;
+		std::uint64_t inlined = 0;
+		std::uint32_t next = 0;
+		while (next < itemCount)
+		{
+			std::uint32_t pushCount = 1 + random() % 64;
+			for (std::uint32_t i = 0; i < pushCount && next < itemCount; ++i, ++next)
+			{
+				if (!deque.Push(&items[next]))
+				{
+					taken[next].fetch_add(1, std::memory_order_relaxed);
+					++inlined;
+				}
+			}
+
+			// 코어가 적은 기계에서도 훔치는 스레드가 덱이 찬 상태를 보도록 가끔 양보한다.
+			if (random() % 4 == 0)
+				std::this_thread::yield();
+
+			std::uint32_t popCount = random() % 64;
+			for (std::uint32_t i = 0; i < popCount; ++i)
+			{
+				std::uint32_t* item = deque.Pop();
+				if (item == nullptr)
+					break;
+				taken[*item].fetch_add(1, std::memory_order_relaxed);
+				++popped;
+			}
+		}
+		while (std::uint32_t* item = deque.Pop())
+		{
+			taken[*item].fetch_add(1, std::memory_order_relaxed);
+			++popped;
+		}
+
+		ownerDone.store(true, std::memory_order_release);
+		for (std::thread& thief : thieves)
+			thief.join();
+
+		std::uint32_t wrong = 0;
+		for (std::uint32_t i = 0; i < itemCount; ++i)
+		{
+			if (taken[i].load() != 1)
+				++wrong;
+		}
+		CHECK(wrong == 0);
+		CHECK(popped + inlined + stolenCount.load() == itemCount);
+		CHECK(deque.GetApproximateSize() == 0);
+
+		std::printf("  deque: %u items, %u thieves: %llu popped, %llu stolen, %llu inlined\n", itemCount, thiefCount,
+			(unsigned long long)popped, (unsigned long long)stolenCount.load(), (unsigned long long)inlined);
+	}
+
+	void TestRunAndWait(JobSystem& jobs, std::uint32_t jobCount)
+	{
+		std::unique_ptr<std::atomic<std::uint32_t>[]> hits(new std::atomic<std::uint32_t>[jobCount]);
+		for (std::uint32_t i = 0; i < jobCount; ++i)
+			hits[i].store(0);
+
+		JobSystemStats before = jobs.GetStats();
+
+		JobCounter counter;
+		CHECK(counter.IsDone());
+		for (std::uint32_t i = 0; i < jobCount; ++i)
+			jobs.Run([&hits, i]() { hits[i].fetch_add(1, std::memory_order_relaxed); }, &counter);
+		jobs.Wait(counter);
+		CHECK(counter.IsDone());
+
+		std::uint32_t wrong = 0;
+		for (std::uint32_t i = 0; i < jobCount; ++i)
+		{
+			if (hits[i].load() != 1)
+				++wrong;
+		}
+		CHECK(wrong == 0);
+
+		// 메인 스레드와 작업 스레드가 실행한 작업은 모두 통계에 잡힌다.
+		JobSystemStats after = jobs.GetStats();
+		CHECK(after.Executed - before.Executed == jobCount);
+		CHECK(after.Stolen - before.Stolen <= jobCount);
+	}
+
+	// 작업 안에서 작업을 만들고 기다린다. Wait가 대신 실행하므로 스레드 수보다 깊어도 멈추지 않는다.
+	std::uint64_t SumTree(JobSystem& jobs, std::uint64_t begin, std::uint64_t end)
+	{
+		if (end - begin <= 16)
+		{
+			std::uint64_t sum = 0;
+			for (std::uint64_t i = begin; i < end; ++i)
+				sum += i;
+			return sum;
+		}
+
+		std::uint64_t middle = begin + (end - begin) / 2;
+		std::uint64_t left = 0;
+		JobCounter counter;
+		jobs.Run([&]() { left = SumTree(jobs, begin, middle); }, &counter);
+		std::uint64_t right = SumTree(jobs, middle, end);
+		jobs.Wait(counter);
+		return left + right;
+	}
+
+	void TestNestedWait(JobSystem& jobs)
+	{
+		const std::uint64_t count = 100000;
+		CHECK(SumTree(jobs, 0, count) == count * (count - 1) / 2);
+	}
+
+	void TestRunAfter(JobSystem& jobs)
+	{
+		for (int round = 0; round < 50; ++round)
+		{
+			std::atomic<int> finished(0);
+			std::atomic<int> seenByContinuation(-1);
+
+			JobCounter dependency;
+			JobCounter done;
+			for (int i = 0; i < 64; ++i)
+				jobs.Run([&finished]() { finished.fetch_add(1); }, &dependency);
+
+			// 선행 작업이 모두 끝난 뒤에만 실행된다.
+			jobs.RunAfter(dependency, [&]() { seenByContinuation.store(finished.load()); }, &done);
+			jobs.Wait(done);
+			CHECK(seenByContinuation.load() == 64);
+			jobs.Wait(dependency);
+
+			// 이미 끝난 카운터에 붙이면 바로 예약된다.
+			bool ran = false;
+			JobCounter late;
+			jobs.RunAfter(dependency, [&ran]() { ran = true; }, &late);
+			jobs.Wait(late);
+			CHECK(ran);
+		}
+	}
+
+	// 작업 시스템 밖의 스레드가 넣은 작업은 공유 큐를 거친다.
+	void TestExternalThread(JobSystem& jobs)
+	{
+		std::atomic<int> count(0);
+		std::thread external([&]()
+		{
+			JobCounter counter;
+			for (int i = 0; i < 1000; ++i)
+				jobs.Run([&count]() { count.fetch_add(1); }, &counter);
+			jobs.Wait(counter);
+		});
+		external.join();
+		CHECK(count.load() == 1000);
+	}
+
+	void TestParallelFor(JobSystem& jobs)
+	{
+		const size_t counts[] = { 0, 1, 63, 64, 65, 1000, 10007 };
+		for (size_t count : counts)
+		{
+			for (size_t grainSize : { (size_t)0, (size_t)1, (size_t)7, (size_t)64, (size_t)5000 })
+			{
+				std::vector<std::atomic<int>> hits(count);
+				for (auto& hit : hits)
+					hit.store(0);
+
+				std::atomic<bool> rangeTooLarge(false);
+				jobs.ParallelFor(count, grainSize, [&](size_t begin, size_t end)
+				{
+					if (begin >= end || end - begin > std::max<size_t>(grainSize, 1))
+						rangeTooLarge.store(true);
+					for (size_t i = begin; i < end; ++i)
+						hits[i].fetch_add(1);
+				});
+
+				CHECK(!rangeTooLarge.load());
+				bool once = true;
+				for (auto& hit : hits)
+					once = once && hit.load() == 1;
+				CHECK(once);
+			}
+		}
+
+		// 본문이 던진 예외는 모든 구간이 끝난 뒤 호출자에게 다시 던져진다.
+		std::vector<std::atomic<int>> hits(1000);
+		for (auto& hit : hits)
+			hit.store(0);
+		bool caught = false;
+		try
+		{
+			jobs.ParallelFor(hits.size(), 10, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					hits[i].fetch_add(1);
+				if (begin == 500)
+					throw std::runtime_error("chunk failed");
+			});
+		}
+		catch (const std::runtime_error&)
+		{
+			caught = true;
+		}
+		CHECK(caught);
+		bool once = true;
+		for (auto& hit : hits)
+			once = once && hit.load() == 1;
+		CHECK(once);
+	}
+
+	// 작은 작업을 많이 만들고 훔치는 비용. 비교를 위해 구간마다 std::thread를 만드는 방식도 잰다.
+	void BenchmarkSpawnSteal(JobSystem& jobs, std::uint32_t jobCount)
+	{
+		std::atomic<std::uint64_t> sink(0);
+
+		JobSystemStats before = jobs.GetStats();
+		Test::Stopwatch stopwatch;
+		JobCounter counter;
+		for (std::uint32_t i = 0; i < jobCount; ++i)
+			jobs.Run([&sink, i]() { sink.fetch_add(i, std::memory_order_relaxed); }, &counter);
+		jobs.Wait(counter);
+		double runMs = stopwatch.ElapsedMs();
+		JobSystemStats after = jobs.GetStats();
+
+		stopwatch.Reset();
+		std::uint64_t nested = SumTree(jobs, 0, jobCount * 16ull);
+		double nestedMs = stopwatch.ElapsedMs();
+		CHECK(nested == jobCount * 16ull * (jobCount * 16ull - 1) / 2);
+
+		const size_t chunkCount = 64;
+		const std::uint32_t parallelForRounds = 1000;
+		stopwatch.Reset();
+		for (std::uint32_t round = 0; round < parallelForRounds; ++round)
+			jobs.ParallelFor(chunkCount, 1, [&sink](size_t begin, size_t) { sink.fetch_add(begin, std::memory_order_relaxed); });
+		double parallelForUs = stopwatch.ElapsedMs() * 1000.0 / parallelForRounds;
+
+		const std::uint32_t threadRounds = 50;
+		stopwatch.Reset();
+		for (std::uint32_t round = 0; round < threadRounds; ++round)
+		{
+			std::vector<std::thread> threads;
+			for (unsigned t = 0; t < jobs.GetThreadCount(); ++t)
+				threads.emplace_back([&sink, t]() { sink.fetch_add(t, std::memory_order_relaxed); });
+			for (std::thread& thread : threads)
+				thread.join();
+		}
+		double threadUs = stopwatch.ElapsedMs() * 1000.0 / threadRounds;
+
+		std::printf("  %u threads: Run+Wait %u jobs %.1f ms (%.0f ns/job, %.0f%% stolen), nested %u leaves %.1f ms\n",
+			jobs.GetThreadCount(), jobCount, runMs, runMs * 1e6 / jobCount,
+			100.0 * (after.Stolen - before.Stolen) / std::max<std::uint64_t>(after.Executed - before.Executed, 1),
+			jobCount, nestedMs);
+		std::printf("  ParallelFor over %zu chunks: %.1f us, spawning %u std::threads: %.1f us\n",
+			chunkCount, parallelForUs, jobs.GetThreadCount(), threadUs);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestDequeSemantics();
+	TestDequeStress(quick ? 200000 : 5000000, 3);
+
+	{
+		JobSystem jobs(3);
+		CHECK(jobs.GetThreadCount() == 4);
+		TestRunAndWait(jobs, quick ? 10000 : 1000000);
+		TestNestedWait(jobs);
+		TestRunAfter(jobs);
+		TestExternalThread(jobs);
+		TestParallelFor(jobs);
+		if (!quick)
+			BenchmarkSpawnSteal(jobs, 1000000);
+	}
+
+	// 작업 스레드가 하나뿐이면 대부분의 작업을 호출 스레드가 Wait에서 대신 실행한다.
+	{
+		JobSystem jobs(1);
+		TestRunAndWait(jobs, 1000);
+		TestNestedWait(jobs);
+		TestParallelFor(jobs);
+	}
+
+	return Test::Finish("JobSystemTest");
+}
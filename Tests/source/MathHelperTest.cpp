@@ -0,0 +1,192 @@
+#include "TestCommon.h"
+#include "MathHelper.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+namespace
+{
+	/// <summary>
+	/// stride 간격으로 위치를 담는 버퍼. 위치 사이의 여유 바이트는 NaN으로 채워 잘못된 간격으로 읽으면 드러나게 한다.
+	/// </summary>
+	class PositionStream
+	{
+	public:
+		PositionStream(size_t count, size_t stride)
+			: mStride(stride), mData(count * stride / sizeof(float) + 1, std::numeric_limits<float>::quiet_NaN()) {}
+
+		XMFLOAT3& operator[](size_t i) { return *reinterpret_cast<XMFLOAT3*>(reinterpret_cast<std::uint8_t*>(mData.data()) + i * mStride); }
+		const XMFLOAT3& operator[](size_t i) const { return *reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const std::uint8_t*>(mData.data()) + i * mStride); }
+		const void* GetData() const { return mData.data(); }
+		size_t GetStride() const { return mStride; }
+
+	private:
+		size_t mStride;
+		std::vector<float> mData;
+	};
+
+	/// <summary>
+	/// 누산기 하나로 차례대로 구한 경계. ComputeBounds의 4개 누산기 축소와 결과가 같아야 한다.
+	/// </summary>
+	void ReferenceBounds(const PositionStream& positions, size_t count, XMFLOAT3& boundsMin, XMFLOAT3& boundsMax, float& radius)
+	{
+		boundsMin = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+		boundsMax = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const XMFLOAT3& p = positions[i];
+			boundsMin = XMFLOAT3(std::min(boundsMin.x, p.x), std::min(boundsMin.y, p.y), std::min(boundsMin.z, p.z));
+			boundsMax = XMFLOAT3(std::max(boundsMax.x, p.x), std::max(boundsMax.y, p.y), std::max(boundsMax.z, p.z));
+		}
+
+		XMFLOAT3 center(0.5f * (boundsMin.x + boundsMax.x), 0.5f * (boundsMin.y + boundsMax.y), 0.5f * (boundsMin.z + boundsMax.z));
+		float maxDistSq = 0.0f;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const XMFLOAT3& p = positions[i];
+			float dx = p.x - center.x, dy = p.y - center.y, dz = p.z - center.z;
+			maxDistSq = std::max(maxDistSq, dx * dx + dy * dy + dz * dz);
+		}
+		radius = std::sqrt(maxDistSq);
+	}
+
+	bool CheckBounds(const PositionStream& positions, size_t count)
+	{
+		BoundingBox box;
+		BoundingSphere sphere;
+		MathHelper::ComputeBounds(positions.GetData(), count, positions.GetStride(), box, sphere);
+
+		XMFLOAT3 boundsMin, boundsMax;
+		float radius;
+		ReferenceBounds(positions, count, boundsMin, boundsMax, radius);
+
+		// min/max는 정확하다. 중심과 반지름은 계산 순서만 다르므로 반올림 오차만큼 허용한다.
+		const float* c = &box.Center.x;
+		const float* e = &box.Extents.x;
+		const float* lo = &boundsMin.x;
+		const float* hi = &boundsMax.x;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float tolerance = 1e-6f * (std::fabs(lo[axis]) + std::fabs(hi[axis])) + 1e-30f;
+			if (!CHECK(std::fabs(c[axis] - e[axis] - lo[axis]) <= tolerance) || !CHECK(std::fabs(c[axis] + e[axis] - hi[axis]) <= tolerance))
+				return false;
+		}
+		return CHECK(sphere.Center.x == box.Center.x && sphere.Center.y == box.Center.y && sphere.Center.z == box.Center.z) &&
+			CHECK(std::fabs(sphere.Radius - radius) <= radius * 1e-6f);
+	}
+
+	/// <summary>
+	/// 4의 배수가 아닌 개수와 XMFLOAT3보다 큰 간격에서 누산기 축소를 스칼라 min/max와 비교한다.
+	/// 극값을 모든 위치(4개 묶음 안과 나머지)에 한 번씩 두어 어느 누산기나 나머지 반복문도 빠뜨리지 않는지 본다.
+	/// </summary>
+	void TestComputeBounds()
+	{
+		std::mt19937 random(10);
+		std::uniform_real_distribution<float> coordinate(-5.0f, 5.0f);
+
+		for (size_t stride : { sizeof(XMFLOAT3), sizeof(XMFLOAT4), (size_t)20, (size_t)44 })
+		{
+			for (size_t count = 1; count <= 41; ++count)
+			{
+				PositionStream positions(count, stride);
+				for (size_t i = 0; i < count; ++i)
+					positions[i] = XMFLOAT3(coordinate(random), coordinate(random), coordinate(random));
+				if (!CheckBounds(positions, count))
+				{
+					std::printf("  stride %zu, %zu positions: bounds differ\n", stride, count);
+					continue;
+				}
+
+				for (size_t extreme = 0; extreme < count; ++extreme)
+				{
+					XMFLOAT3 original = positions[extreme];
+					positions[extreme] = XMFLOAT3(100.0f, -100.0f, 50.0f + (float)extreme);
+					if (!CheckBounds(positions, count))
+						std::printf("  stride %zu, %zu positions, extreme at %zu: bounds differ\n", stride, count, extreme);
+					positions[extreme] = original;
+				}
+			}
+		}
+
+		// 위치 하나는 크기 0인 경계, 위치가 없으면 원점에 크기 0인 경계
+		PositionStream single(1, 44);
+		single[0] = XMFLOAT3(1.0f, 2.0f, 3.0f);
+		BoundingBox box;
+		BoundingSphere sphere;
+		MathHelper::ComputeBounds(single.GetData(), 1, 44, box, sphere);
+		CHECK(box.Center.x == 1.0f && box.Center.y == 2.0f && box.Center.z == 3.0f);
+		CHECK(box.Extents.x == 0.0f && box.Extents.y == 0.0f && box.Extents.z == 0.0f && sphere.Radius == 0.0f);
+
+		MathHelper::ComputeBounds(nullptr, 0, 44, box, sphere);
+		CHECK(box.Center.x == 0.0f && box.Extents.x == 0.0f && sphere.Radius == 0.0f);
+	}
+
+	// 두 함수는 조건문 뒤의 세미콜론 때문에 항상 continue해서 끝나지 않았다.
+	void TestRandomVectors()
+	{
+		std::srand(7);
+		XMVECTOR n = XMVector3Normalize(XMVectorSet(1.0f, 2.0f, -0.5f, 0.0f));
+		for (int i = 0; i < 1000; ++i)
+		{
+			XMVECTOR v = MathHelper::RandUnitVec3();
+			if (!CHECK(std::fabs(XMVectorGetX(XMVector3Length(v)) - 1.0f) < 1e-5f))
+				break;
+			XMVECTOR h = MathHelper::RandHemisphereUnitVec3(n);
+			if (!CHECK(std::fabs(XMVectorGetX(XMVector3Length(h)) - 1.0f) < 1e-5f) || !CHECK(XMVectorGetX(XMVector3Dot(h, n)) >= 0.0f))
+				break;
+		}
+	}
+
+	/// <summary>
+	/// 정점 구조체 간격(44바이트)과 촘촘한 XMFLOAT3 배열에서 ComputeBounds의 처리량을 스칼라 반복문과 비교한다.
+	/// </summary>
+	void BenchmarkComputeBounds(size_t count, int repeatCount)
+	{
+		std::mt19937 random(20);
+		std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+		for (size_t stride : { sizeof(XMFLOAT3), (size_t)44 })
+		{
+			PositionStream positions(count, stride);
+			for (size_t i = 0; i < count; ++i)
+				positions[i] = XMFLOAT3(coordinate(random), coordinate(random), coordinate(random));
+
+			BoundingBox box;
+			BoundingSphere sphere;
+			Test::Stopwatch stopwatch;
+			for (int r = 0; r < repeatCount; ++r)
+				MathHelper::ComputeBounds(positions.GetData(), count, stride, box, sphere);
+			double boundsMs = stopwatch.ElapsedMs() / repeatCount;
+
+			XMFLOAT3 boundsMin, boundsMax;
+			float radius = 0.0f;
+			stopwatch.Reset();
+			for (int r = 0; r < repeatCount; ++r)
+				ReferenceBounds(positions, count, boundsMin, boundsMax, radius);
+			double scalarMs = stopwatch.ElapsedMs() / repeatCount;
+			CHECK(std::fabs(sphere.Radius - radius) <= radius * 1e-6f);
+
+			// 두 번 훑으므로 위치마다 두 번 읽는다.
+			double megabytes = 2.0 * count * stride / 1048576.0;
+			std::printf("  stride %2zu, %zu positions: ComputeBounds %7.2f ms (%6.1f M positions/s, %5.2f GB/s), scalar loop %7.2f ms (x%.2f)\n",
+				stride, count, boundsMs, count / boundsMs / 1e3, megabytes / boundsMs * 1000.0 / 1024.0, scalarMs, scalarMs / boundsMs);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestComputeBounds();
+	TestRandomVectors();
+	BenchmarkComputeBounds(quick ? (1 << 16) : (4 << 20), quick ? 2 : 10);
+
+	return Test::Finish("MathHelperTest");
+}
@@ -0,0 +1,305 @@
+#include "TestCommon.h"
+#include "MeshCacheFormat.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "VertexEncoder.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+namespace
+{
+	typedef MeshCacheFormat::Header Header;
+	typedef MeshCacheFormat::Submesh Submesh;
+	typedef GeometryGenerator::MeshData MeshData;
+	typedef GeometryGenerator::uint16 uint16;
+	typedef GeometryGenerator::uint32 uint32;
+
+	// DXGI_FORMAT_R16_UINT / DXGI_FORMAT_R32_UINT
+	const std::uint32_t IndexFormatR16 = 57;
+	const std::uint32_t IndexFormatR32 = 42;
+
+	const std::uint64_t ParamHash = 0x0123456789ABCDEFull;
+
+	/// <summary>
+	/// MeshCacheFile::Create/Close와 같은 순서로 파일 내용을 만든다. sealed가 false이면 기록 도중 중단된 파일이다.
+	/// </summary>
+	std::vector<std::uint8_t> BuildImage(
+		std::uint64_t paramHash,
+		std::uint32_t vertexStride,
+		const std::vector<std::uint8_t>& vertices,
+		std::uint32_t indexFormat,
+		const std::vector<std::uint8_t>& indices,
+		const std::vector<std::string>& names,
+		bool sealed = true)
+	{
+		Header header = MeshCacheFormat::MakeHeader(
+			paramHash, vertexStride, (std::uint32_t)vertices.size(), indexFormat, (std::uint32_t)indices.size(), (std::uint32_t)names.size());
+
+		std::vector<std::uint8_t> image((size_t)header.FileSize, 0);
+		std::memcpy(image.data(), &header, sizeof(header));
+		Submesh* table = MeshCacheFormat::GetSubmeshTable(image.data());
+		for (size_t i = 0; i < names.size(); ++i)
+		{
+			Submesh entry = {};
+			std::memcpy(entry.Name, names[i].c_str(), std::min(names[i].size(), MeshCacheFormat::MaxSubmeshName - 1));
+			entry.IndexCount = (std::uint32_t)i * 3;
+			std::memcpy(&table[i], &entry, sizeof(entry));
+		}
+		if (!vertices.empty())
+			std::memcpy(image.data() + header.VertexDataOffset, vertices.data(), vertices.size());
+		if (!indices.empty())
+			std::memcpy(image.data() + header.IndexDataOffset, indices.data(), indices.size());
+
+		if (sealed)
+			reinterpret_cast<Header*>(image.data())->Magic = MeshCacheFormat::Magic;
+		return image;
+	}
+
+	Header& GetHeader(std::vector<std::uint8_t>& image)
+	{
+		return *reinterpret_cast<Header*>(image.data());
+	}
+
+	bool IsValid(const std::vector<std::uint8_t>& image, std::uint64_t paramHash = ParamHash)
+	{
+		return MeshCacheFormat::Validate(image.data(), image.size(), paramHash);
+	}
+
+	void TestMakeHeader()
+	{
+		// 데이터 구간은 16바이트 정렬로 표 뒤에 차례로 놓인다.
+		for (std::uint32_t submeshCount : { 0u, 1u, 3u, 10u })
+		{
+			for (std::uint32_t vertexBytes : { 0u, 12u, 1000u, 1004u })
+			{
+				Header header = MeshCacheFormat::MakeHeader(ParamHash, 12, vertexBytes, IndexFormatR16, 66, submeshCount);
+				CHECK(header.Magic == 0 && header.Version == MeshCacheFormat::Version && header.ParamHash == ParamHash);
+				CHECK(header.VertexDataOffset % MeshCacheFormat::DataAlignment == 0);
+				CHECK(header.IndexDataOffset % MeshCacheFormat::DataAlignment == 0);
+				CHECK(header.VertexDataOffset >= sizeof(Header) + submeshCount * sizeof(Submesh));
+				CHECK(header.VertexDataOffset < sizeof(Header) + submeshCount * sizeof(Submesh) + MeshCacheFormat::DataAlignment);
+				CHECK(header.IndexDataOffset >= header.VertexDataOffset + vertexBytes);
+				CHECK(header.IndexDataOffset < header.VertexDataOffset + vertexBytes + MeshCacheFormat::DataAlignment);
+				CHECK(header.FileSize == header.IndexDataOffset + 66);
+			}
+		}
+	}
+
+	/// <summary>
+	/// 올바른 파일만 통과하고, 마법 값/버전/매개변수 해시/크기가 다르거나 잘린 파일은 모두 거부된다.
+	/// </summary>
+	void TestValidate()
+	{
+		std::vector<std::uint8_t> vertices(12 * 37, 0xAB);
+		std::vector<std::uint8_t> indices(2 * 99, 0x11);
+		std::vector<std::string> names = { "box", "grid", "sphere", "sphere_lod1" };
+		std::vector<std::uint8_t> image = BuildImage(ParamHash, 12, vertices, IndexFormatR16, indices, names);
+		CHECK(IsValid(image));
+		CHECK(std::strcmp(MeshCacheFormat::GetSubmeshTable(image.data())[2].Name, "sphere") == 0);
+
+		// 기록 도중 중단되어 마법 값이 없는 파일과 다른 형식의 파일
+		CHECK(!IsValid(BuildImage(ParamHash, 12, vertices, IndexFormatR16, indices, names, false)));
+		std::vector<std::uint8_t> corrupted = image;
+		GetHeader(corrupted).Magic = 0x434F5350; // "PSOC"
+		CHECK(!IsValid(corrupted));
+
+		// 이전/다음 버전
+		for (std::uint32_t version : { (std::uint32_t)MeshCacheFormat::Version - 1, (std::uint32_t)MeshCacheFormat::Version + 1 })
+		{
+			corrupted = image;
+			GetHeader(corrupted).Version = version;
+			CHECK(!IsValid(corrupted));
+		}
+
+		// 생성 매개변수나 정점 형식이 바뀌면 해시가 달라진다.
+		CHECK(!IsValid(image, ParamHash ^ 1));
+		CHECK(!IsValid(image, 0));
+
+		// 잘린 파일. 헤더의 FileSize를 함께 고쳐도 데이터 구간이 파일 밖으로 나가면 거부된다.
+		for (size_t size = 0; size < image.size(); ++size)
+		{
+			std::vector<std::uint8_t> truncated(image.begin(), image.begin() + size);
+			if (!CHECK(!MeshCacheFormat::Validate(truncated.data(), truncated.size(), ParamHash)))
+				break;
+			if (size >= sizeof(Header))
+			{
+				GetHeader(truncated).FileSize = size;
+				if (!CHECK(!IsValid(truncated)))
+					break;
+			}
+		}
+		CHECK(!MeshCacheFormat::Validate(nullptr, image.size(), ParamHash));
+
+		// 뒤에 데이터가 더 붙은 파일
+		std::vector<std::uint8_t> extended = image;
+		extended.resize(image.size() + 16);
+		CHECK(!IsValid(extended));
+
+		// 헤더의 구간이 겹치거나 파일 밖을 가리키는 경우 (더해서 넘치는 값 포함)
+		corrupted = image;
+		GetHeader(corrupted).SubmeshCount = 1000;
+		CHECK(!IsValid(corrupted));
+		corrupted = image;
+		GetHeader(corrupted).SubmeshCount = 0xFFFFFFFFu;
+		CHECK(!IsValid(corrupted));
+		corrupted = image;
+		GetHeader(corrupted).VertexBufferByteSize += 16;
+		CHECK(!IsValid(corrupted));
+		corrupted = image;
+		GetHeader(corrupted).IndexBufferByteSize += 1;
+		CHECK(!IsValid(corrupted));
+		corrupted = image;
+		GetHeader(corrupted).IndexDataOffset = 0xFFFFFFFFFFFFFFF0ull;
+		CHECK(!IsValid(corrupted));
+		corrupted = image;
+		GetHeader(corrupted).VertexDataOffset = 0xFFFFFFFFFFFFFFF0ull;
+		GetHeader(corrupted).VertexBufferByteSize = 0x20;
+		CHECK(!IsValid(corrupted));
+
+		// 서브메쉬와 데이터가 없는 파일도 형식은 올바르다.
+		CHECK(IsValid(BuildImage(ParamHash, 12, {}, IndexFormatR32, {}, {})));
+	}
+
+	/// <summary>
+	/// ShapesApp::BakeShapeGeometry와 같은 단계로 도형을 만들고 최적화/LOD/압축/인덱스 변환을 거쳐 캐시 내용을 만든다.
+	/// (경계 계산은 생략한다)
+	/// </summary>
+	std::vector<std::uint8_t> BakeShapes(std::uint32_t detail)
+	{
+		GeometryGenerator geoGen;
+		std::vector<MeshData> meshes;
+		meshes.push_back(geoGen.CreateBox(1.5f, 0.5f, 1.5f, 3));
+		meshes.push_back(geoGen.CreateGrid(20.0f, 30.0f, 3 * detail, 2 * detail));
+		meshes.push_back(geoGen.CreateSphere(0.5f, detail, detail));
+		meshes.push_back(geoGen.CreateCylinder(0.5f, 0.3f, 3.0f, detail, detail));
+
+		const std::vector<float> lodRatios = { 0.5f, 0.25f };
+		std::vector<std::vector<uint32>> indexSources;
+		std::vector<std::string> names = { "box", "grid", "sphere", "cylinder" };
+		for (MeshData& mesh : meshes)
+		{
+			MeshOptimizer::Optimize(mesh);
+			indexSources.push_back(mesh.Indices32);
+		}
+		for (size_t m = 2; m < 4; ++m)
+		{
+			std::vector<MeshLod> lods = MeshSimplifier::BuildLodChain(meshes[m], lodRatios, 0.02f);
+			for (size_t i = 0; i < lods.size(); ++i)
+			{
+				MeshOptimizer::OptimizeVertexCache(lods[i].Indices32, (uint32)meshes[m].Vertices.size());
+				indexSources.push_back(lods[i].Indices32);
+				names.push_back(names[m] + "_lod" + std::to_string(i + 1));
+			}
+		}
+
+		VertexFormat format = { PositionEncoding::Unorm16x4, false, false, false, true };
+		std::vector<std::uint8_t> vertices;
+		for (const MeshData& mesh : meshes)
+		{
+			EncodedVertices encoded = VertexEncoder::Encode(mesh.Vertices, format, XMFLOAT4(0.2f, 0.6f, 0.2f, 1.0f));
+			vertices.insert(vertices.end(), encoded.Data.begin(), encoded.Data.end());
+		}
+
+		bool fits = true;
+		size_t indexCount = 0;
+		for (const std::vector<uint32>& indices : indexSources)
+		{
+			fits = fits && GeometryGenerator::FitsIn16Bits(indices.data(), indices.size());
+			indexCount += indices.size();
+		}
+		std::vector<std::uint8_t> indices(indexCount * (fits ? sizeof(uint16) : sizeof(uint32)));
+		std::uint8_t* dest = indices.data();
+		for (const std::vector<uint32>& source : indexSources)
+		{
+			if (fits)
+				GeometryGenerator::NarrowIndices(source.data(), reinterpret_cast<uint16*>(dest), source.size());
+			else
+				std::memcpy(dest, source.data(), source.size() * sizeof(uint32));
+			dest += source.size() * (fits ? sizeof(uint16) : sizeof(uint32));
+		}
+
+		return BuildImage(ParamHash, VertexEncoder::GetVertexStride(format), vertices,
+			fits ? IndexFormatR16 : IndexFormatR32, indices, names);
+	}
+
+	/// <summary>
+	/// 캐시 파일을 읽어 검사하고 서브메쉬 표를 읽는다. (MeshCacheFile::Open/GetLayout에서 매핑 대신 읽기를 쓴다)
+	/// </summary>
+	bool LoadCache(const char* filename, std::vector<std::uint8_t>& image, size_t& submeshCount)
+	{
+		FILE* file = std::fopen(filename, "rb");
+		if (file == nullptr)
+			return false;
+		std::fseek(file, 0, SEEK_END);
+		long size = std::ftell(file);
+		std::fseek(file, 0, SEEK_SET);
+		image.resize(size > 0 ? (size_t)size : 0);
+		bool read = std::fread(image.data(), 1, image.size(), file) == image.size();
+		std::fclose(file);
+		if (!read || !MeshCacheFormat::Validate(image.data(), image.size(), ParamHash))
+			return false;
+
+		const Header* header = reinterpret_cast<const Header*>(image.data());
+		const Submesh* table = MeshCacheFormat::GetSubmeshTable(static_cast<const void*>(image.data()));
+		submeshCount = 0;
+		for (std::uint32_t i = 0; i < header->SubmeshCount; ++i)
+			submeshCount += table[i].Name[0] != 0;
+		return true;
+	}
+
+	/// <summary>
+	/// 시작할 때 도형을 굽는 경우와 구운 캐시 파일을 읽는 경우의 시간을 비교한다.
+	/// </summary>
+	void BenchmarkStartup(std::uint32_t detail, int repeatCount)
+	{
+		const char* filename = "MeshCacheTest.meshcache";
+
+		Test::Stopwatch stopwatch;
+		std::vector<std::uint8_t> baked;
+		for (int r = 0; r < repeatCount; ++r)
+			baked = BakeShapes(detail);
+		double bakeMs = stopwatch.ElapsedMs() / repeatCount;
+
+		FILE* file = std::fopen(filename, "wb");
+		if (!CHECK(file != nullptr))
+			return;
+		bool written = std::fwrite(baked.data(), 1, baked.size(), file) == baked.size();
+		std::fclose(file);
+		CHECK(written);
+
+		stopwatch.Reset();
+		std::vector<std::uint8_t> loaded;
+		size_t submeshCount = 0;
+		bool valid = true;
+		for (int r = 0; r < repeatCount; ++r)
+			valid = LoadCache(filename, loaded, submeshCount) && valid;
+		double loadMs = stopwatch.ElapsedMs() / repeatCount;
+		std::remove(filename);
+
+		CHECK(valid && loaded == baked);
+		CHECK(submeshCount >= 4);
+		std::printf("  shapes detail %4u: %8.1f KB, %zu submeshes, bake %9.3f ms, load cache %7.3f ms (x%.0f)\n",
+			detail, baked.size() / 1024.0, submeshCount, bakeMs, loadMs, bakeMs / loadMs);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestMakeHeader();
+	TestValidate();
+
+	// 20은 ShapesApp의 기본 설정과 같은 크기
+	BenchmarkStartup(20, quick ? 1 : 10);
+	if (!quick)
+		BenchmarkStartup(200, 3);
+
+	return Test::Finish("MeshCacheTest");
+}
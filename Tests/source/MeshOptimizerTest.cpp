@@ -0,0 +1,192 @@
+#include "TestCommon.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+namespace
+{
+	typedef GeometryGenerator::Vertex Vertex;
+	typedef GeometryGenerator::MeshData MeshData;
+	typedef GeometryGenerator::uint32 uint32;
+
+	struct NamedMesh
+	{
+		std::string Name;
+		MeshData Mesh;
+	};
+
+	std::vector<NamedMesh> CreateMeshes(bool large)
+	{
+		GeometryGenerator generator;
+		std::vector<NamedMesh> meshes;
+		meshes.push_back({ "grid", large ? generator.CreateGrid(100.0f, 100.0f, 512, 512) : generator.CreateGrid(20.0f, 20.0f, 64, 64) });
+		meshes.push_back({ "sphere", large ? generator.CreateSphere(1.0f, 256, 256) : generator.CreateSphere(1.0f, 40, 40) });
+		meshes.push_back({ "geosphere", generator.CreateGeosphere(1.0f, large ? 6 : 4) });
+		return meshes;
+	}
+
+	// 삼각형을 위치 세 개로 바꾸고, 감는 순서를 유지한 채 가장 작은 꼭짓점부터 시작하도록 회전한다.
+	std::vector<std::vector<float>> GetTriangles(const MeshData& meshData)
+	{
+		std::vector<std::vector<float>> triangles;
+		for (size_t t = 0; t + 2 < meshData.Indices32.size(); t += 3)
+		{
+			std::vector<std::vector<float>> corners;
+			for (int k = 0; k < 3; ++k)
+			{
+				const XMFLOAT3& p = meshData.Vertices[meshData.Indices32[t + k]].Position;
+				corners.push_back({ p.x, p.y, p.z });
+			}
+			size_t first = std::min_element(corners.begin(), corners.end()) - corners.begin();
+			std::vector<float> triangle;
+			for (size_t k = 0; k < 3; ++k)
+				triangle.insert(triangle.end(), corners[(first + k) % 3].begin(), corners[(first + k) % 3].end());
+			triangles.push_back(triangle);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	void TestAnalyze()
+	{
+		// 삼각형 하나는 정점 3개를 모두 변환한다.
+		std::vector<uint32> triangle = { 0, 1, 2 };
+		VertexCacheStatistics single = MeshOptimizer::AnalyzeVertexCache(triangle, 3);
+		CHECK(single.VerticesTransformed == 3 && single.ACMR == 3.0f && single.ATVR == 1.0f);
+
+		// 같은 삼각형을 반복하면 캐시에 남아 있어 더 변환하지 않는다.
+		std::vector<uint32> repeated = { 0, 1, 2, 0, 1, 2, 2, 1, 0 };
+		VertexCacheStatistics hits = MeshOptimizer::AnalyzeVertexCache(repeated, 3);
+		CHECK(hits.VerticesTransformed == 3 && hits.ACMR == 1.0f);
+
+		// FIFO 캐시는 적중해도 순서가 바뀌지 않으므로 크기가 3이면 3이 가장 먼저 들어온 0을 밀어내고,
+		// 이어서 0, 1, 2가 차례로 서로를 밀어낸다. (LRU였다면 1이 적중해서 6이 된다)
+		std::vector<uint32> evicting = { 0, 1, 2, 2, 1, 3, 0, 1, 2 };
+		CHECK(MeshOptimizer::AnalyzeVertexCache(evicting, 4, 3).VerticesTransformed == 7);
+	}
+
+	/// <summary>
+	/// 행 순서로 생성된 메쉬는 OptimizeVertexCache 후에 ACMR/ATVR이 줄어야 하고 삼각형 집합은 같아야 한다.
+	/// </summary>
+	void TestVertexCache()
+	{
+		for (NamedMesh& entry : CreateMeshes(false))
+		{
+			MeshData& mesh = entry.Mesh;
+			uint32 vertexCount = (uint32)mesh.Vertices.size();
+			std::vector<std::vector<float>> triangles = GetTriangles(mesh);
+
+			VertexCacheStatistics before = MeshOptimizer::AnalyzeVertexCache(mesh.Indices32, vertexCount);
+			MeshOptimizer::OptimizeVertexCache(mesh.Indices32, vertexCount);
+			VertexCacheStatistics after = MeshOptimizer::AnalyzeVertexCache(mesh.Indices32, vertexCount);
+
+			CHECK(after.ACMR < before.ACMR);
+			CHECK(after.ATVR < before.ATVR);
+			// 정규 격자의 최적 ACMR은 0.5에 가깝다. 행 순서는 캐시 크기보다 긴 행에서 1.0에 가깝다.
+			CHECK(after.ACMR < 0.8f);
+			CHECK(after.ATVR >= 1.0f && before.ACMR <= 3.0f);
+			CHECK(GetTriangles(mesh) == triangles);
+
+			std::printf("  %-9s ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", entry.Name.c_str(), before.ACMR, after.ACMR, before.ATVR, after.ATVR);
+		}
+	}
+
+	/// <summary>
+	/// 전체 최적화 후에도 삼각형 집합이 같고, 오버드로우 정렬 후에도 캐시 효율이 유지되고,
+	/// 정점은 인덱스 버퍼에서 처음 참조되는 순서로 놓인다.
+	/// </summary>
+	void TestOptimize()
+	{
+		const float threshold = 1.05f;
+		for (NamedMesh& entry : CreateMeshes(false))
+		{
+			MeshData& mesh = entry.Mesh;
+			std::vector<std::vector<float>> triangles = GetTriangles(mesh);
+			size_t vertexCount = mesh.Vertices.size();
+
+			float originalAcmr = MeshOptimizer::AnalyzeVertexCache(mesh.Indices32, (uint32)vertexCount).ACMR;
+			std::vector<uint32> cacheOnly = mesh.Indices32;
+			MeshOptimizer::OptimizeVertexCache(cacheOnly, (uint32)vertexCount);
+			float cacheOnlyAcmr = MeshOptimizer::AnalyzeVertexCache(cacheOnly, (uint32)vertexCount).ACMR;
+
+			MeshOptimizer::Optimize(mesh, threshold);
+			CHECK(GetTriangles(mesh) == triangles);
+			CHECK(mesh.Vertices.size() == vertexCount);
+
+			// threshold는 차가운 캐시로 시작한 클러스터 하나의 ACMR만 제한한다. 클러스터 순서가 바뀌면
+			// 경계마다 캐시가 다시 차므로 전체 ACMR은 threshold보다 조금 더 나빠질 수 있다.
+			float optimizedAcmr = MeshOptimizer::AnalyzeVertexCache(mesh.Indices32, (uint32)mesh.Vertices.size()).ACMR;
+			CHECK(optimizedAcmr <= cacheOnlyAcmr * threshold * threshold);
+			CHECK(optimizedAcmr < originalAcmr);
+
+			uint32 nextNew = 0;
+			for (uint32 index : mesh.Indices32)
+			{
+				if (index == nextNew)
+					++nextNew;
+				else if (!CHECK(index < nextNew))
+					break;
+			}
+			CHECK(nextNew == mesh.Vertices.size());
+		}
+
+		// 참조되지 않는 정점은 제거된다.
+		GeometryGenerator generator;
+		MeshData grid = generator.CreateGrid(1.0f, 1.0f, 4, 4);
+		grid.Indices32.resize(6);
+		CHECK(MeshOptimizer::OptimizeVertexFetch(grid) == 4 && grid.Vertices.size() == 4);
+	}
+
+	/// <summary>
+	/// 큰 메쉬에서 각 단계의 시간을 잰다.
+	/// </summary>
+	void BenchmarkPasses()
+	{
+		for (NamedMesh& entry : CreateMeshes(true))
+		{
+			MeshData& mesh = entry.Mesh;
+			uint32 vertexCount = (uint32)mesh.Vertices.size();
+			size_t triangleCount = mesh.Indices32.size() / 3;
+			float acmrBefore = MeshOptimizer::AnalyzeVertexCache(mesh.Indices32, vertexCount).ACMR;
+
+			Test::Stopwatch stopwatch;
+			MeshOptimizer::OptimizeVertexCache(mesh.Indices32, vertexCount);
+			double cacheMs = stopwatch.ElapsedMs();
+			float acmrCache = MeshOptimizer::AnalyzeVertexCache(mesh.Indices32, vertexCount).ACMR;
+
+			stopwatch.Reset();
+			MeshOptimizer::OptimizeOverdraw(mesh.Indices32, mesh.Vertices, 1.05f);
+			double overdrawMs = stopwatch.ElapsedMs();
+
+			stopwatch.Reset();
+			MeshOptimizer::OptimizeVertexFetch(mesh);
+			double fetchMs = stopwatch.ElapsedMs();
+
+			stopwatch.Reset();
+			VertexCacheStatistics after = MeshOptimizer::AnalyzeVertexCache(mesh.Indices32, vertexCount);
+			double analyzeMs = stopwatch.ElapsedMs();
+
+			std::printf("  %-9s %8zu triangles: vertex cache %8.2f ms, overdraw %8.2f ms, vertex fetch %6.2f ms, analyze %6.2f ms, "
+				"ACMR %.3f -> %.3f -> %.3f\n",
+				entry.Name.c_str(), triangleCount, cacheMs, overdrawMs, fetchMs, analyzeMs, acmrBefore, acmrCache, after.ACMR);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestAnalyze();
+	TestVertexCache();
+	TestOptimize();
+	if (!quick)
+		BenchmarkPasses();
+
+	return Test::Finish("MeshOptimizerTest");
+}
@@ -0,0 +1,217 @@
+#include "TestCommon.h"
+#include "MeshletBuilder.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+namespace
+{
+	typedef GeometryGenerator::MeshData MeshData;
+	typedef GeometryGenerator::uint32 uint32;
+	typedef std::array<uint32, 3> Triangle;
+
+	struct NamedMesh
+	{
+		std::string Name;
+		MeshData Mesh;
+	};
+
+	std::vector<NamedMesh> CreateMeshes()
+	{
+		GeometryGenerator generator;
+		std::vector<NamedMesh> meshes;
+		meshes.push_back({ "geosphere", generator.CreateGeosphere(1.0f, 4) });
+		meshes.push_back({ "grid", generator.CreateGrid(10.0f, 10.0f, 100, 100) });
+		meshes.push_back({ "sphere", generator.CreateSphere(1.0f, 40, 30) });
+		meshes.push_back({ "cylinder", generator.CreateCylinder(1.0f, 0.5f, 2.0f, 24, 8) });
+		meshes.push_back({ "box", generator.CreateBox(1.0f, 1.0f, 1.0f, 3) });
+		return meshes;
+	}
+
+	// 감는 순서를 유지한 채 가장 작은 인덱스부터 시작하도록 회전한다.
+	Triangle Canonical(uint32 a, uint32 b, uint32 c)
+	{
+		if (b < a && b < c)
+			return Triangle{ { b, c, a } };
+		if (c < a && c < b)
+			return Triangle{ { c, a, b } };
+		return Triangle{ { a, b, c } };
+	}
+
+	/// <summary>
+	/// 메쉬렛 한도, 로컬 인덱스 범위, 삼각형 전체가 정확히 한 번씩 나오는지, 경계 구가 정점을 모두 포함하는지 확인한다.
+	/// </summary>
+	bool Validate(const MeshData& mesh, const MeshletData& meshlets, uint32 maxVertices, uint32 maxTriangles)
+	{
+		if (!CHECK(meshlets.Bounds.size() == meshlets.Meshlets.size()))
+			return false;
+
+		std::vector<Triangle> emitted;
+		size_t vertexEnd = 0;
+		size_t triangleEnd = 0;
+		for (size_t m = 0; m < meshlets.Meshlets.size(); ++m)
+		{
+			const Meshlet& meshlet = meshlets.Meshlets[m];
+			if (!CHECK(meshlet.VertexCount >= 3 && meshlet.VertexCount <= maxVertices) ||
+				!CHECK(meshlet.TriangleCount >= 1 && meshlet.TriangleCount <= maxTriangles))
+				return false;
+
+			// 메쉬렛 구간은 겹치지 않고 차례로 이어진다.
+			if (!CHECK(meshlet.VertexOffset == vertexEnd && meshlet.TriangleOffset == triangleEnd))
+				return false;
+			vertexEnd += meshlet.VertexCount;
+			triangleEnd += meshlet.TriangleCount;
+			if (!CHECK(vertexEnd <= meshlets.UniqueVertexIndices.size() && triangleEnd <= meshlets.PrimitiveIndices.size()))
+				return false;
+
+			const uint32* vertexIndices = &meshlets.UniqueVertexIndices[meshlet.VertexOffset];
+			std::vector<uint32> unique(vertexIndices, vertexIndices + meshlet.VertexCount);
+			std::sort(unique.begin(), unique.end());
+			if (!CHECK(std::adjacent_find(unique.begin(), unique.end()) == unique.end()) || !CHECK(unique.back() < mesh.Vertices.size()))
+				return false;
+
+			std::vector<char> used(meshlet.VertexCount, 0);
+			for (uint32 t = 0; t < meshlet.TriangleCount; ++t)
+			{
+				uint32 i0, i1, i2;
+				MeshletBuilder::UnpackTriangle(meshlets.PrimitiveIndices[meshlet.TriangleOffset + t], i0, i1, i2);
+				if (!CHECK(i0 < meshlet.VertexCount && i1 < meshlet.VertexCount && i2 < meshlet.VertexCount))
+					return false;
+				used[i0] = used[i1] = used[i2] = 1;
+				emitted.push_back(Canonical(vertexIndices[i0], vertexIndices[i1], vertexIndices[i2]));
+			}
+			// 삼각형이 쓰지 않는 정점은 넣지 않는다.
+			if (!CHECK(std::find(used.begin(), used.end(), 0) == used.end()))
+				return false;
+
+			const MeshletBounds& bounds = meshlets.Bounds[m];
+			XMVECTOR center = XMLoadFloat3(&bounds.Center);
+			for (uint32 i = 0; i < meshlet.VertexCount; ++i)
+			{
+				float distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&mesh.Vertices[vertexIndices[i]].Position) - center));
+				if (!CHECK(distance <= bounds.Radius * (1.0f + 1e-5f) + 1e-6f))
+					return false;
+			}
+		}
+		CHECK(vertexEnd == meshlets.UniqueVertexIndices.size() && triangleEnd == meshlets.PrimitiveIndices.size());
+
+		std::vector<Triangle> expected;
+		for (size_t i = 0; i + 2 < mesh.Indices32.size(); i += 3)
+			expected.push_back(Canonical(mesh.Indices32[i], mesh.Indices32[i + 1], mesh.Indices32[i + 2]));
+		std::sort(expected.begin(), expected.end());
+		std::sort(emitted.begin(), emitted.end());
+		return CHECK(emitted == expected);
+	}
+
+	/// <summary>
+	/// 원뿔 검사가 컬링한다고 판단한 카메라에서는 메쉬렛의 모든 삼각형이 뒷면이어야 한다.
+	/// </summary>
+	bool ValidateNormalCones(const MeshData& mesh, const MeshletData& meshlets, std::mt19937& random, int cameraCount, int& culled)
+	{
+		std::uniform_real_distribution<float> coordinate(-4.0f, 4.0f);
+		for (int c = 0; c < cameraCount; ++c)
+		{
+			XMVECTOR camera = XMVectorSet(coordinate(random), coordinate(random), coordinate(random), 0.0f);
+			for (size_t m = 0; m < meshlets.Meshlets.size(); ++m)
+			{
+				const Meshlet& meshlet = meshlets.Meshlets[m];
+				const MeshletBounds& bounds = meshlets.Bounds[m];
+				XMFLOAT3 axis;
+				float cutoff;
+				MeshletBuilder::UnpackNormalCone(bounds.NormalCone, axis, cutoff);
+
+				XMVECTOR view = XMVector3Normalize(XMLoadFloat3(&bounds.ConeApex) - camera);
+				if (XMVectorGetX(XMVector3Dot(view, XMLoadFloat3(&axis))) < cutoff)
+					continue;
+
+				++culled;
+				const uint32* vertexIndices = &meshlets.UniqueVertexIndices[meshlet.VertexOffset];
+				for (uint32 t = 0; t < meshlet.TriangleCount; ++t)
+				{
+					uint32 i0, i1, i2;
+					MeshletBuilder::UnpackTriangle(meshlets.PrimitiveIndices[meshlet.TriangleOffset + t], i0, i1, i2);
+					XMVECTOR p0 = XMLoadFloat3(&mesh.Vertices[vertexIndices[i0]].Position);
+					XMVECTOR p1 = XMLoadFloat3(&mesh.Vertices[vertexIndices[i1]].Position);
+					XMVECTOR p2 = XMLoadFloat3(&mesh.Vertices[vertexIndices[i2]].Position);
+					XMVECTOR n = XMVector3Cross(p1 - p0, p2 - p0);
+					if (!CHECK(XMVectorGetX(XMVector3Dot(n, camera - p0)) <= 1e-6f))
+						return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void TestBuild()
+	{
+		std::mt19937 random(3);
+		int culled = 0;
+		const uint32 limits[][2] = { { MeshletBuilder::MaxVertices, MeshletBuilder::MaxTriangles }, { 32, 40 }, { 3, 1 } };
+		for (const NamedMesh& entry : CreateMeshes())
+		{
+			for (const auto& limit : limits)
+			{
+				MeshletData meshlets = MeshletBuilder::Build(entry.Mesh, limit[0], limit[1]);
+				if (!Validate(entry.Mesh, meshlets, limit[0], limit[1]))
+					std::printf("  %s (%u vertices, %u triangles): invalid meshlets\n", entry.Name.c_str(), limit[0], limit[1]);
+			}
+
+			MeshletData meshlets = MeshletBuilder::Build(entry.Mesh);
+			if (!ValidateNormalCones(entry.Mesh, meshlets, random, 20, culled))
+				std::printf("  %s: normal cone culls a front-facing triangle\n", entry.Name.c_str());
+		}
+		// 평평한 격자와 상자 면은 아래/뒤에서 보면 원뿔 검사로 컬링되어야 한다.
+		CHECK(culled > 0);
+
+		// 한도보다 큰 값은 MaxVertices/MaxTriangles로 제한된다.
+		GeometryGenerator generator;
+		MeshData grid = generator.CreateGrid(1.0f, 1.0f, 64, 64);
+		Validate(grid, MeshletBuilder::Build(grid, 1000, 1000), MeshletBuilder::MaxVertices, MeshletBuilder::MaxTriangles);
+
+		MeshData empty;
+		CHECK(MeshletBuilder::Build(empty).Meshlets.empty());
+	}
+
+	/// <summary>
+	/// 높은 분할의 지오스피어와 1000x1000 격자에서 메쉬렛 생성 시간과 메쉬렛 채움 정도를 잰다.
+	/// </summary>
+	void BenchmarkBuild(bool quick)
+	{
+		GeometryGenerator generator;
+		std::vector<NamedMesh> meshes;
+		meshes.push_back({ "geosphere", generator.CreateGeosphere(1.0f, quick ? 4 : 6) });
+		meshes.push_back({ "grid", quick ? generator.CreateGrid(100.0f, 100.0f, 100, 100) : generator.CreateGrid(100.0f, 100.0f, 1000, 1000) });
+
+		for (const NamedMesh& entry : meshes)
+		{
+			Test::Stopwatch stopwatch;
+			MeshletData meshlets = MeshletBuilder::Build(entry.Mesh);
+			double buildMs = stopwatch.ElapsedMs();
+
+			size_t triangleCount = entry.Mesh.Indices32.size() / 3;
+			size_t meshletCount = meshlets.Meshlets.size();
+			std::printf("  %-9s %8zu triangles: %6zu meshlets in %8.2f ms (%.1f ns per triangle), "
+				"%.1f vertices and %.1f triangles per meshlet, %.2f vertex references per vertex\n",
+				entry.Name.c_str(), triangleCount, meshletCount, buildMs, buildMs * 1e6 / triangleCount,
+				(double)meshlets.UniqueVertexIndices.size() / meshletCount, (double)triangleCount / meshletCount,
+				(double)meshlets.UniqueVertexIndices.size() / entry.Mesh.Vertices.size());
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestBuild();
+	BenchmarkBuild(quick);
+
+	return Test::Finish("MeshletBuilderTest");
+}
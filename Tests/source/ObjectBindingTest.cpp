@@ -0,0 +1,281 @@
+#include "TestCommon.h"
+#include "ObjectBindingLayout.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	const std::uint32_t ObjectByteSize = 64;     // float4x4 World
+	const std::uint32_t DescriptorSize = 32;     // 일반적인 CBV/SRV/UAV 서술자 크기
+	const std::uint64_t HeapStart = 0x100000000ull;
+	const char* const ModeNames[] = { "DescriptorTable", "RootConstantBuffer", "RootConstantIndex" };
+
+	// 프레임 리소스마다 떨어진 객체 버퍼 주소
+	std::uint64_t GetBufferAddress(std::uint32_t frame)
+	{
+		return 0x200000000ull + (std::uint64_t)frame * 0x10000000ull;
+	}
+
+	// 셰이더 가시 힙 대신 CBV 내용(주소, 크기)만 담는 배열
+	struct FakeDescriptor
+	{
+		std::uint64_t BufferLocation = 0;
+		std::uint32_t SizeInBytes = 0;
+	};
+
+	std::vector<FakeDescriptor> CreateDescriptors(const ObjectBindingLayout& layout)
+	{
+		std::vector<FakeDescriptor> heap(layout.DescriptorCount);
+		for (std::uint32_t frame = 0; frame < layout.FrameCount; ++frame)
+		{
+			layout.ForEachDescriptor(frame, GetBufferAddress(frame), [&](std::uint32_t index, std::uint64_t address, std::uint32_t byteSize)
+			{
+				heap[index].BufferLocation = address;
+				heap[index].SizeInBytes = byteSize;
+			});
+		}
+		return heap;
+	}
+
+	/// <summary>
+	/// ID3D12GraphicsCommandList 대신 루트 인자 설정과 그리기를 명령 스트림으로 기록한다.
+	/// 인자 크기는 D3D12 호출과 같다. (서술자 테이블과 루트 CBV는 8 바이트, 루트 상수는 4 바이트)
+	/// </summary>
+	class MockCommandList
+	{
+	public:
+		enum Opcode : std::uint32_t
+		{
+			SetRootDescriptorTable,
+			SetRootConstantBufferView,
+			SetRoot32BitConstant,
+			DrawIndexedInstanced,
+		};
+
+		void Clear() { mStream.clear(); }
+
+		void SetGraphicsRootDescriptorTable(std::uint32_t rootParameterIndex, std::uint64_t gpuHandle)
+		{
+			Write(SetRootDescriptorTable);
+			Write(rootParameterIndex);
+			Write(gpuHandle);
+		}
+		void SetGraphicsRootConstantBufferView(std::uint32_t rootParameterIndex, std::uint64_t address)
+		{
+			Write(SetRootConstantBufferView);
+			Write(rootParameterIndex);
+			Write(address);
+		}
+		void SetGraphicsRoot32BitConstant(std::uint32_t rootParameterIndex, std::uint32_t value, std::uint32_t destOffset)
+		{
+			Write(SetRoot32BitConstant);
+			Write(rootParameterIndex);
+			Write(value);
+			Write(destOffset);
+		}
+		void DrawIndexed(std::uint32_t indexCount)
+		{
+			Write(DrawIndexedInstanced);
+			Write(indexCount);
+		}
+
+		const std::vector<std::uint8_t>& GetStream() const { return mStream; }
+
+	private:
+		template<typename T>
+		void Write(const T& value)
+		{
+			size_t offset = mStream.size();
+			mStream.resize(offset + sizeof(T));
+			std::memcpy(mStream.data() + offset, &value, sizeof(T));
+		}
+
+		std::vector<std::uint8_t> mStream;
+	};
+
+	/// <summary>
+	/// ObjectBinding::Bind와 같이 루트 인자를 계산해서 방식에 맞는 호출로 기록한다.
+	/// </summary>
+	void BindObject(MockCommandList& cmdList, const ObjectBindingLayout& layout, std::uint32_t rootParameterIndex,
+		std::uint32_t frame, std::uint32_t object)
+	{
+		ObjectRootArgument argument = layout.GetRootArgument(frame, object, GetBufferAddress(frame), HeapStart, DescriptorSize);
+		switch (argument.Mode)
+		{
+		case ObjectBindingMode::DescriptorTable:
+			cmdList.SetGraphicsRootDescriptorTable(rootParameterIndex, argument.Value);
+			break;
+		case ObjectBindingMode::RootConstantBuffer:
+			cmdList.SetGraphicsRootConstantBufferView(rootParameterIndex, argument.Value);
+			break;
+		case ObjectBindingMode::RootConstantIndex:
+			cmdList.SetGraphicsRoot32BitConstant(rootParameterIndex, (std::uint32_t)argument.Value, 0);
+			break;
+		}
+	}
+
+	void RecordFrame(MockCommandList& cmdList, const ObjectBindingLayout& layout, std::uint32_t frame)
+	{
+		for (std::uint32_t object = 0; object < layout.ObjectCount; ++object)
+		{
+			BindObject(cmdList, layout, 3, frame, object);
+			cmdList.DrawIndexed(36);
+		}
+	}
+
+	template<typename T>
+	T Read(const std::vector<std::uint8_t>& stream, size_t& offset)
+	{
+		T value;
+		std::memcpy(&value, stream.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return value;
+	}
+
+	/// <summary>
+	/// GPU가 하듯이 기록된 스트림을 재생하면서 그리기마다 셰이더가 읽을 객체 상수의 주소를 구해
+	/// 그 그리기의 객체 주소와 같은지 확인한다.
+	/// </summary>
+	bool ReplayFrame(const MockCommandList& cmdList, const ObjectBindingLayout& layout, const std::vector<FakeDescriptor>& heap, std::uint32_t frame)
+	{
+		const std::vector<std::uint8_t>& stream = cmdList.GetStream();
+		std::uint64_t bufferAddress = GetBufferAddress(frame);
+		std::uint64_t objectAddress = 0;
+		std::uint32_t objectByteSize = 0;
+		std::uint32_t draw = 0;
+		size_t offset = 0;
+		while (offset < stream.size())
+		{
+			std::uint32_t opcode = Read<std::uint32_t>(stream, offset);
+			if (opcode == MockCommandList::DrawIndexedInstanced)
+			{
+				Read<std::uint32_t>(stream, offset);
+				if (!CHECK(objectAddress == layout.GetObjectAddress(bufferAddress, draw)) || !CHECK(objectByteSize >= ObjectByteSize))
+					return false;
+				++draw;
+				continue;
+			}
+
+			if (!CHECK(Read<std::uint32_t>(stream, offset) == 3))
+				return false;
+			if (opcode == MockCommandList::SetRootDescriptorTable)
+			{
+				// 테이블 시작 핸들이 가리키는 CBV를 읽는다.
+				std::uint64_t handle = Read<std::uint64_t>(stream, offset);
+				if (!CHECK(handle >= HeapStart && (handle - HeapStart) % DescriptorSize == 0))
+					return false;
+				const FakeDescriptor& descriptor = heap[(size_t)((handle - HeapStart) / DescriptorSize)];
+				objectAddress = descriptor.BufferLocation;
+				objectByteSize = descriptor.SizeInBytes;
+			}
+			else if (opcode == MockCommandList::SetRootConstantBufferView)
+			{
+				objectAddress = Read<std::uint64_t>(stream, offset);
+				objectByteSize = layout.ElementByteSize;
+			}
+			else
+			{
+				// 셰이더가 구조적 버퍼를 요소 크기 간격으로 색인한다.
+				std::uint32_t index = Read<std::uint32_t>(stream, offset);
+				CHECK(Read<std::uint32_t>(stream, offset) == 0);
+				objectAddress = bufferAddress + (std::uint64_t)index * layout.ElementByteSize;
+				objectByteSize = layout.ElementByteSize;
+			}
+		}
+		return CHECK(draw == layout.ObjectCount);
+	}
+
+	void TestLayout()
+	{
+		ObjectBindingLayout table = ObjectBindingLayout::Create(ObjectBindingMode::DescriptorTable, 100, ObjectByteSize, 3);
+		CHECK(table.ElementByteSize == 256 && table.BufferByteSize == 25600 && table.DescriptorCount == 300);
+		CHECK(table.GetDescriptorIndex(2, 5) == 205);
+
+		ObjectBindingLayout rootCbv = ObjectBindingLayout::Create(ObjectBindingMode::RootConstantBuffer, 100, ObjectByteSize, 3);
+		CHECK(rootCbv.ElementByteSize == 256 && rootCbv.DescriptorCount == 0);
+		CHECK(rootCbv.GetObjectAddress(0x1000, 2) == 0x1000 + 512);
+
+		// 구조적 버퍼는 256 바이트 정렬이 필요 없어서 버퍼가 4배 작다.
+		ObjectBindingLayout rootIndex = ObjectBindingLayout::Create(ObjectBindingMode::RootConstantIndex, 100, ObjectByteSize, 3);
+		CHECK(rootIndex.ElementByteSize == ObjectByteSize && rootIndex.BufferByteSize == 6400 && rootIndex.DescriptorCount == 0);
+		CHECK(!rootIndex.UsesConstantBufferView() && rootCbv.UsesConstantBufferView());
+
+		int calls = 0;
+		rootIndex.ForEachDescriptor(0, 0, [&](std::uint32_t, std::uint64_t, std::uint32_t) { ++calls; });
+		CHECK(calls == 0);
+
+		// 인스턴싱 묶음의 시작 위치는 프레임과 관계없이 그대로 루트 상수가 된다.
+		ObjectRootArgument instanceBase = rootIndex.GetInstanceBaseArgument(1234);
+		CHECK(instanceBase.Mode == ObjectBindingMode::RootConstantIndex && instanceBase.Value == 1234);
+	}
+
+	// 방식마다 모든 프레임의 루트 인자를 기록하고 재생해서 그리기마다 올바른 객체를 읽는지 확인한다.
+	void TestRootArguments()
+	{
+		for (std::uint32_t mode = 0; mode < 3; ++mode)
+		{
+			ObjectBindingLayout layout = ObjectBindingLayout::Create((ObjectBindingMode)mode, 500, ObjectByteSize, 3);
+			std::vector<FakeDescriptor> heap = CreateDescriptors(layout);
+			MockCommandList cmdList;
+			for (std::uint32_t frame = 0; frame < layout.FrameCount; ++frame)
+			{
+				cmdList.Clear();
+				RecordFrame(cmdList, layout, frame);
+				if (!ReplayFrame(cmdList, layout, heap, frame))
+					std::printf("  %s: frame %u reads the wrong object\n", ModeNames[mode], frame);
+			}
+		}
+	}
+
+	/// <summary>
+	/// 방식마다 준비 비용(서술자 생성), 객체 버퍼 크기, 그리기마다 루트 인자를 계산해서 기록하는 비용을 비교한다.
+	/// </summary>
+	void BenchmarkRecording(std::uint32_t objectCount, std::uint32_t frameCount)
+	{
+		for (std::uint32_t mode = 0; mode < 3; ++mode)
+		{
+			ObjectBindingLayout layout = ObjectBindingLayout::Create((ObjectBindingMode)mode, objectCount, ObjectByteSize, 3);
+
+			Test::Stopwatch stopwatch;
+			std::vector<FakeDescriptor> heap = CreateDescriptors(layout);
+			double setupMs = stopwatch.ElapsedMs();
+
+			MockCommandList cmdList;
+			RecordFrame(cmdList, layout, 0);
+			stopwatch.Reset();
+			for (std::uint32_t frame = 0; frame < frameCount; ++frame)
+			{
+				cmdList.Clear();
+				RecordFrame(cmdList, layout, frame % layout.FrameCount);
+			}
+			double recordMs = stopwatch.ElapsedMs() / frameCount;
+			ReplayFrame(cmdList, layout, heap, (frameCount - 1) % layout.FrameCount);
+
+			std::printf("  %7u objects, %-18s: %8u descriptors, setup %7.3f ms, buffer %9llu bytes, record %.2f ns per draw\n",
+				objectCount, ModeNames[mode], layout.DescriptorCount, setupMs, (unsigned long long)layout.BufferByteSize,
+				recordMs * 1e6 / objectCount);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestLayout();
+	TestRootArguments();
+	if (quick)
+	{
+		BenchmarkRecording(1000, 3);
+	}
+	else
+	{
+		BenchmarkRecording(10000, 30);
+		BenchmarkRecording(100000, 10);
+	}
+
+	return Test::Finish("ObjectBindingTest");
+}
@@ -0,0 +1,204 @@
+#include "TestCommon.h"
+#include "JobSystem.h"
+#include "ParallelRecording.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	void TestPartition()
+	{
+		for (size_t count = 0; count < 300; ++count)
+		{
+			std::vector<std::uint64_t> costs(count);
+			std::uint64_t totalCost = 0;
+			std::uint64_t maxCost = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				costs[i] = 1 + (i * 7919) % 13;
+				totalCost += costs[i];
+				maxCost = std::max(maxCost, costs[i]);
+			}
+
+			for (size_t maxParts = 1; maxParts < 10; ++maxParts)
+			{
+				std::vector<RecordRange> ranges = PartitionRecordRanges(costs, maxParts);
+				if (count == 0)
+				{
+					CHECK(ranges.empty());
+					continue;
+				}
+
+				// 빈 구간 없이 처음부터 끝까지 순서대로 이어진다.
+				CHECK(ranges.size() == std::min(maxParts, count));
+				CHECK(ranges.front().Begin == 0 && ranges.back().End == count);
+				for (size_t k = 0; k < ranges.size(); ++k)
+				{
+					CHECK(ranges[k].Begin < ranges[k].End);
+					if (k > 0)
+						CHECK(ranges[k].Begin == ranges[k - 1].End);
+
+					// 구간 비용은 균등 분할에서 아이템 하나 이상 벗어나지 않는다.
+					std::uint64_t partCost = 0;
+					for (size_t i = ranges[k].Begin; i < ranges[k].End; ++i)
+						partCost += costs[i];
+					if (count >= maxParts * 2)
+						CHECK(partCost <= totalCost / ranges.size() + maxCost);
+				}
+			}
+		}
+
+		// 작업이 적으면 최소 비용을 채울 만큼만 나눈다.
+		std::vector<std::uint64_t> costs(22, 1);
+		CHECK(PartitionRecordRanges(costs, 4, 8).size() == 2);
+		CHECK(PartitionRecordRanges(costs, 4, 100).size() == 1);
+		CHECK(PartitionRecordRanges(costs, 0, 1).size() == 1);
+	}
+
+	void TestFencedPool()
+	{
+		// 명령 할당자 풀: GPU가 3 프레임 늦게 따라오면 구간 수 x 4개면 충분하고, 완료 전에는 재사용하지 않는다.
+		struct Allocator
+		{
+			int Id = -1;
+			std::uint64_t LastFence = 0;
+		};
+
+		FencedPool<Allocator> pool;
+		std::vector<Allocator> created;
+		std::uint64_t completedFence = 0;
+		const size_t partCount = 4;
+		const std::uint64_t frameLag = 3;
+
+		for (std::uint64_t frame = 1; frame <= 1000; ++frame)
+		{
+			if (frame > frameLag)
+				completedFence = frame - frameLag;
+
+			std::vector<Allocator> used;
+			for (size_t p = 0; p < partCount; ++p)
+			{
+				Allocator allocator;
+				if (pool.TryAcquire(completedFence, allocator))
+				{
+					CHECK(allocator.LastFence <= completedFence);
+				}
+				else
+				{
+					allocator.Id = (int)created.size();
+					created.push_back(allocator);
+				}
+				used.push_back(allocator);
+			}
+
+			for (Allocator& allocator : used)
+			{
+				allocator.LastFence = frame;
+				pool.Release(allocator, frame);
+			}
+		}
+		CHECK(created.size() == partCount * frameLag);
+		CHECK(pool.GetPooledCount() == created.size());
+	}
+
+	// ID3D12GraphicsCommandList 대신 기록된 그리기 번호를 모으는 가짜 명령 목록
+	struct MockCommandList
+	{
+		std::vector<std::uint32_t> Draws;
+		std::uint64_t Checksum = 0;
+		bool Closed = false;
+	};
+
+	// 그리기 하나를 기록하는 비용을 흉내 낸다 (루트 인자 설정, 검증 계층 없는 드라이버 호출 정도).
+	void RecordMockDraw(MockCommandList& cmdList, std::uint32_t draw, std::uint32_t workPerDraw)
+	{
+		std::uint64_t hash = cmdList.Checksum ^ draw;
+		for (std::uint32_t i = 0; i < workPerDraw; ++i)
+			hash = hash * 6364136223846793005ull + 1442695040888963407ull;
+		cmdList.Checksum = hash;
+		cmdList.Draws.push_back(draw);
+	}
+
+	/// <summary>
+	/// ParallelCommandRecorder::Record와 같은 방식으로 구간을 나누고 구간마다 명령 목록 하나를 JobSystem에서 기록한다.
+	/// </summary>
+	double RecordFrames(JobSystem& jobs, unsigned threadCount, size_t drawCount, std::uint32_t workPerDraw, std::uint32_t frameCount, size_t& partCount)
+	{
+		const std::uint64_t minDrawsPerCommandList = 64;
+
+		std::vector<std::uint64_t> costs(drawCount, 1);
+		std::vector<RecordRange> ranges = PartitionRecordRanges(costs, threadCount, minDrawsPerCommandList);
+		std::vector<MockCommandList> cmdLists(ranges.size());
+		partCount = ranges.size();
+
+		Test::Stopwatch stopwatch;
+		for (std::uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			for (MockCommandList& cmdList : cmdLists)
+			{
+				cmdList.Draws.clear();
+				cmdList.Closed = false;
+			}
+
+			jobs.ParallelFor(ranges.size(), 1, [&](size_t begin, size_t end)
+			{
+				for (size_t part = begin; part < end; ++part)
+				{
+					MockCommandList& cmdList = cmdLists[part];
+					for (size_t draw = ranges[part].Begin; draw < ranges[part].End; ++draw)
+						RecordMockDraw(cmdList, (std::uint32_t)draw, workPerDraw);
+					cmdList.Closed = true;
+				}
+			});
+		}
+		double ms = stopwatch.ElapsedMs() / frameCount;
+
+		// 목록을 구간 순서대로 제출하면 한 스레드에서 기록한 것과 그리기 순서가 같다.
+		std::uint32_t next = 0;
+		for (const MockCommandList& cmdList : cmdLists)
+		{
+			CHECK(cmdList.Closed);
+			for (std::uint32_t draw : cmdList.Draws)
+				CHECK(draw == next++);
+		}
+		CHECK(next == drawCount);
+		return ms;
+	}
+
+	// 기록 스레드 수를 늘려 가며 한 프레임 기록 시간을 잰다. 하드웨어 스레드 수 이상에서는 빨라지지 않는다.
+	void TestRecordingScaling(size_t drawCount, std::uint32_t workPerDraw, std::uint32_t frameCount, bool printStats)
+	{
+		double serialMs = 0.0;
+		for (unsigned threadCount : { 1u, 2u, 4u, 8u })
+		{
+			// JobSystem(0)은 하드웨어 스레드 수를 쓰므로 작업 스레드는 하나 이상 만든다.
+			// 구간이 하나면 ParallelFor가 호출 스레드에서 바로 실행하므로 한 스레드 기록과 같다.
+			JobSystem jobs(std::max(threadCount - 1, 1u));
+			size_t partCount = 0;
+			double ms = RecordFrames(jobs, threadCount, drawCount, workPerDraw, frameCount, partCount);
+			CHECK(partCount == std::min<size_t>(threadCount, drawCount / 64));
+
+			if (threadCount == 1)
+				serialMs = ms;
+			if (printStats)
+			{
+				std::printf("  %zu draws, %u threads: %zu command lists, %.3f ms per frame (x%.2f)\n",
+					drawCount, threadCount, partCount, ms, serialMs / ms);
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestPartition();
+	TestFencedPool();
+	TestRecordingScaling(quick ? 2000 : 20000, 200, quick ? 5 : 100, !quick);
+
+	return Test::Finish("ParallelRecordingTest");
+}
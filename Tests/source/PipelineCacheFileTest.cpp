@@ -0,0 +1,379 @@
+#include "TestCommon.h"
+#include "PipelineCacheFile.h"
+#include "ResourceRegistry.h"
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	// D3D12_GRAPHICS_PIPELINE_STATE_DESC와 필드 이름이 같은 장치 없는 서술. 열거형과 BOOL은 같은 크기의 정수로 둔다.
+	struct ShaderBytecode
+	{
+		const void* pShaderBytecode = nullptr;
+		size_t BytecodeLength = 0;
+	};
+
+	struct SODeclarationEntry
+	{
+		std::uint32_t Stream = 0;
+		const char* SemanticName = nullptr;
+		std::uint32_t SemanticIndex = 0;
+		std::uint8_t StartComponent = 0;
+		std::uint8_t ComponentCount = 0;
+		std::uint8_t OutputSlot = 0;
+	};
+
+	struct StreamOutputDesc
+	{
+		const SODeclarationEntry* pSODeclaration = nullptr;
+		std::uint32_t NumEntries = 0;
+		const std::uint32_t* pBufferStrides = nullptr;
+		std::uint32_t NumStrides = 0;
+		std::uint32_t RasterizedStream = 0;
+	};
+
+	struct RenderTargetBlendDesc
+	{
+		std::int32_t BlendEnable = 0;
+		std::int32_t LogicOpEnable = 0;
+		std::uint32_t SrcBlend = 2;
+		std::uint32_t DestBlend = 1;
+		std::uint32_t BlendOp = 1;
+		std::uint32_t SrcBlendAlpha = 2;
+		std::uint32_t DestBlendAlpha = 1;
+		std::uint32_t BlendOpAlpha = 1;
+		std::uint32_t LogicOp = 4;
+		std::uint8_t RenderTargetWriteMask = 0xF;
+	};
+
+	struct BlendDesc
+	{
+		std::int32_t AlphaToCoverageEnable = 0;
+		std::int32_t IndependentBlendEnable = 0;
+		RenderTargetBlendDesc RenderTarget[8];
+	};
+
+	struct RasterizerDesc
+	{
+		std::uint32_t FillMode = 3;
+		std::uint32_t CullMode = 3;
+		std::int32_t FrontCounterClockwise = 0;
+		std::int32_t DepthBias = 0;
+		float DepthBiasClamp = 0.0f;
+		float SlopeScaledDepthBias = 0.0f;
+		std::int32_t DepthClipEnable = 1;
+		std::int32_t MultisampleEnable = 0;
+		std::int32_t AntialiasedLineEnable = 0;
+		std::uint32_t ForcedSampleCount = 0;
+		std::uint32_t ConservativeRaster = 0;
+	};
+
+	struct DepthStencilOpDesc
+	{
+		std::uint32_t StencilFailOp = 1;
+		std::uint32_t StencilDepthFailOp = 1;
+		std::uint32_t StencilPassOp = 1;
+		std::uint32_t StencilFunc = 8;
+	};
+
+	struct DepthStencilDesc
+	{
+		std::int32_t DepthEnable = 1;
+		std::uint32_t DepthWriteMask = 1;
+		std::uint32_t DepthFunc = 2;
+		std::int32_t StencilEnable = 0;
+		std::uint8_t StencilReadMask = 0xFF;
+		std::uint8_t StencilWriteMask = 0xFF;
+		DepthStencilOpDesc FrontFace;
+		DepthStencilOpDesc BackFace;
+	};
+
+	struct InputElementDesc
+	{
+		const char* SemanticName = nullptr;
+		std::uint32_t SemanticIndex = 0;
+		std::uint32_t Format = 0;
+		std::uint32_t InputSlot = 0;
+		std::uint32_t AlignedByteOffset = 0;
+		std::uint32_t InputSlotClass = 0;
+		std::uint32_t InstanceDataStepRate = 0;
+	};
+
+	struct InputLayoutDesc
+	{
+		const InputElementDesc* pInputElementDescs = nullptr;
+		std::uint32_t NumElements = 0;
+	};
+
+	struct SampleCountDesc
+	{
+		std::uint32_t Count = 1;
+		std::uint32_t Quality = 0;
+	};
+
+	struct GraphicsPipelineDesc
+	{
+		ShaderBytecode VS;
+		ShaderBytecode PS;
+		ShaderBytecode DS;
+		ShaderBytecode HS;
+		ShaderBytecode GS;
+		StreamOutputDesc StreamOutput;
+		BlendDesc BlendState;
+		std::uint32_t SampleMask = 0xFFFFFFFF;
+		RasterizerDesc RasterizerState;
+		DepthStencilDesc DepthStencilState;
+		InputLayoutDesc InputLayout;
+		std::uint32_t IBStripCutValue = 0;
+		std::uint32_t PrimitiveTopologyType = 3;
+		std::uint32_t NumRenderTargets = 1;
+		std::uint32_t RTVFormats[8] = { 28, 0, 0, 0, 0, 0, 0, 0 };
+		std::uint32_t DSVFormat = 45;
+		SampleCountDesc SampleDesc;
+		std::uint32_t NodeMask = 0;
+		std::uint32_t Flags = 0;
+	};
+
+	/// <summary>
+	/// 셰이더 바이트코드와 의미 이름을 자기 버퍼에 복사해 두는 PSO 서술.
+	/// 두 인스턴스는 내용이 같아도 포인터가 다르므로 해시가 가리키는 내용을 쓰는지 확인할 수 있다.
+	/// </summary>
+	class PipelineDescStorage
+	{
+	public:
+		// fill 바이트로 채운 메모리 위에 서술을 만든다. 채움 바이트가 해시에 섞이면 fill에 따라 값이 달라진다.
+		explicit PipelineDescStorage(std::uint8_t fill)
+			: mVertexShader(256), mPixelShader(128), mPosition("POSITION"), mColor("COLOR")
+		{
+			std::memset(mDescBytes, fill, sizeof(mDescBytes));
+			// 값 초기화는 채움 바이트까지 0으로 만들므로 기본 초기화로 만든다.
+			mDesc = new (mDescBytes) GraphicsPipelineDesc;
+
+			for (size_t i = 0; i < mVertexShader.size(); ++i)
+				mVertexShader[i] = (std::uint8_t)(i * 7);
+			for (size_t i = 0; i < mPixelShader.size(); ++i)
+				mPixelShader[i] = (std::uint8_t)(i * 13);
+
+			mElements[0].SemanticName = mPosition.c_str();
+			mElements[0].Format = 6;
+			mElements[1].SemanticName = mColor.c_str();
+			mElements[1].Format = 2;
+			mElements[1].AlignedByteOffset = 12;
+
+			Bind();
+		}
+
+		PipelineDescStorage(const PipelineDescStorage&) = delete;
+		PipelineDescStorage& operator=(const PipelineDescStorage&) = delete;
+
+		GraphicsPipelineDesc& GetDesc() { return *mDesc; }
+		std::vector<std::uint8_t>& GetVertexShader() { return mVertexShader; }
+		std::string& GetColorSemantic() { return mColor; }
+
+		// 버퍼를 바꾼 뒤 포인터를 다시 연결한다.
+		void Bind()
+		{
+			mDesc->VS.pShaderBytecode = mVertexShader.data();
+			mDesc->VS.BytecodeLength = mVertexShader.size();
+			mDesc->PS.pShaderBytecode = mPixelShader.data();
+			mDesc->PS.BytecodeLength = mPixelShader.size();
+			mElements[0].SemanticName = mPosition.c_str();
+			mElements[1].SemanticName = mColor.c_str();
+			mDesc->InputLayout.pInputElementDescs = mElements;
+			mDesc->InputLayout.NumElements = 2;
+		}
+
+	private:
+		alignas(GraphicsPipelineDesc) unsigned char mDescBytes[sizeof(GraphicsPipelineDesc)];
+		GraphicsPipelineDesc* mDesc;
+		std::vector<std::uint8_t> mVertexShader;
+		std::vector<std::uint8_t> mPixelShader;
+		std::string mPosition;
+		std::string mColor;
+		InputElementDesc mElements[2];
+	};
+
+	void TestHashHelpers()
+	{
+		// 세 곳(이름, 메쉬 캐시, PSO 캐시)이 같은 FNV-1a를 쓴다.
+		static_assert(Fnv1aString("") == Fnv1aOffsetBasis, "empty string hashes to the offset basis");
+		static_assert(HashName("foobar") == Fnv1aString("foobar"), "HashName is FNV-1a");
+		CHECK(Fnv1aBytes("a", 1) == 0xaf63dc4c8601ec8cull);
+		CHECK(Fnv1aBytes("foobar", 6) == 0x85944171f73967e8ull);
+		CHECK(PipelineStateHasher::HashBytes("foobar", 6) == HashName("foobar"));
+
+		// 이어서 해시한 값은 한 번에 해시한 값과 같다.
+		CHECK(Fnv1aBytes("bar", 3, Fnv1aBytes("foo", 3)) == Fnv1aBytes("foobar", 6));
+		PipelineStateHasher hasher;
+		hasher.AddBytes("foo", 3);
+		hasher.AddBytes("bar", 3);
+		CHECK(hasher.GetHash() == Fnv1aBytes("foobar", 6));
+
+		// nullptr 문자열과 빈 문자열은 다르다.
+		PipelineStateHasher nullText;
+		nullText.AddString(nullptr);
+		PipelineStateHasher emptyText;
+		emptyText.AddString("");
+		CHECK(nullText.GetHash() != emptyText.GetHash());
+	}
+
+	void TestDescHash()
+	{
+		const std::uint64_t rootSignatureHash = Fnv1aString("root signature");
+
+		// 포인터와 채움 바이트가 달라도 내용이 같으면 같은 키다.
+		PipelineDescStorage a(0x00);
+		PipelineDescStorage b(0xAB);
+		std::uint64_t baseHash = HashGraphicsPipelineDesc(a.GetDesc(), rootSignatureHash);
+		CHECK(a.GetDesc().VS.pShaderBytecode != b.GetDesc().VS.pShaderBytecode);
+		CHECK(HashGraphicsPipelineDesc(b.GetDesc(), rootSignatureHash) == baseHash);
+		CHECK(HashGraphicsPipelineDesc(a.GetDesc(), rootSignatureHash) == baseHash);
+
+		// 필드 하나만 바꿔도 키가 달라져야 한다. 바꾼 뒤에는 새 서술로 다시 시작한다.
+		int changed = 0;
+		int collided = 0;
+		auto expectChange = [&](const char* name, auto&& modify)
+		{
+			PipelineDescStorage storage(0x00);
+			modify(storage);
+			storage.Bind();
+			++changed;
+			if (!CHECK(HashGraphicsPipelineDesc(storage.GetDesc(), rootSignatureHash) != baseHash))
+			{
+				++collided;
+				std::printf("  changing %s does not change the key\n", name);
+			}
+		};
+
+		expectChange("vertex shader byte", [](PipelineDescStorage& s) { s.GetVertexShader()[100] ^= 1; });
+		expectChange("vertex shader length", [](PipelineDescStorage& s) { s.GetVertexShader().pop_back(); });
+		expectChange("semantic name", [](PipelineDescStorage& s) { s.GetColorSemantic() = "COLOUR"; });
+		expectChange("cull mode", [](PipelineDescStorage& s) { s.GetDesc().RasterizerState.CullMode = 1; });
+		expectChange("fill mode", [](PipelineDescStorage& s) { s.GetDesc().RasterizerState.FillMode = 2; });
+		expectChange("depth bias clamp", [](PipelineDescStorage& s) { s.GetDesc().RasterizerState.DepthBiasClamp = 0.5f; });
+		expectChange("blend on last target", [](PipelineDescStorage& s) { s.GetDesc().BlendState.RenderTarget[7].BlendEnable = 1; });
+		expectChange("write mask", [](PipelineDescStorage& s) { s.GetDesc().BlendState.RenderTarget[0].RenderTargetWriteMask = 0x7; });
+		expectChange("back face stencil", [](PipelineDescStorage& s) { s.GetDesc().DepthStencilState.BackFace.StencilFunc = 3; });
+		expectChange("depth write", [](PipelineDescStorage& s) { s.GetDesc().DepthStencilState.DepthWriteMask = 0; });
+		expectChange("RTV format", [](PipelineDescStorage& s) { s.GetDesc().RTVFormats[0] = 29; });
+		expectChange("DSV format", [](PipelineDescStorage& s) { s.GetDesc().DSVFormat = 40; });
+		expectChange("MSAA count", [](PipelineDescStorage& s) { s.GetDesc().SampleDesc.Count = 4; });
+		expectChange("MSAA quality", [](PipelineDescStorage& s) { s.GetDesc().SampleDesc.Quality = 1; });
+		expectChange("topology type", [](PipelineDescStorage& s) { s.GetDesc().PrimitiveTopologyType = 2; });
+		expectChange("sample mask", [](PipelineDescStorage& s) { s.GetDesc().SampleMask = 1; });
+		expectChange("flags", [](PipelineDescStorage& s) { s.GetDesc().Flags = 1; });
+
+		CHECK(HashGraphicsPipelineDesc(a.GetDesc(), Fnv1aString("other root signature")) != baseHash);
+
+		// 스트림 출력 항목도 내용으로 비교한다.
+		SODeclarationEntry entries[2];
+		entries[0].SemanticName = "SV_POSITION";
+		entries[0].ComponentCount = 4;
+		entries[1].SemanticName = nullptr;
+		entries[1].ComponentCount = 3;
+		std::uint32_t strides[1] = { 28 };
+		PipelineDescStorage withStreamOutput(0x00);
+		withStreamOutput.GetDesc().StreamOutput.pSODeclaration = entries;
+		withStreamOutput.GetDesc().StreamOutput.NumEntries = 2;
+		withStreamOutput.GetDesc().StreamOutput.pBufferStrides = strides;
+		withStreamOutput.GetDesc().StreamOutput.NumStrides = 1;
+		std::uint64_t streamOutputHash = HashGraphicsPipelineDesc(withStreamOutput.GetDesc(), rootSignatureHash);
+		CHECK(streamOutputHash != baseHash);
+		entries[1].SemanticName = "";
+		CHECK(HashGraphicsPipelineDesc(withStreamOutput.GetDesc(), rootSignatureHash) != streamOutputHash);
+
+		CHECK(collided == 0 && changed == 17);
+	}
+
+	// 헤더를 붙이고 떼어 낸 라이브러리가 원래 내용과 같아야 한다.
+	void TestRoundTrip()
+	{
+		for (size_t byteSize : { (size_t)0, (size_t)1, (size_t)1000, (size_t)65537 })
+		{
+			std::vector<std::uint8_t> library(byteSize);
+			for (size_t i = 0; i < byteSize; ++i)
+				library[i] = (std::uint8_t)(i * 31 + 7);
+
+			std::vector<std::uint8_t> file = PipelineCacheFile::Pack(library.data(), library.size());
+			CHECK(file.size() > byteSize);
+
+			const void* unpacked = nullptr;
+			size_t unpackedSize = 1;
+			if (!CHECK(PipelineCacheFile::Unpack(file.data(), file.size(), unpacked, unpackedSize)))
+				continue;
+			CHECK(unpackedSize == byteSize);
+			CHECK(unpacked == file.data() + (file.size() - byteSize));
+			CHECK(byteSize == 0 || std::memcmp(unpacked, library.data(), byteSize) == 0);
+		}
+	}
+
+	// 헤더, 크기, 내용 중 어디가 손상되어도 드라이버에 넘기기 전에 거부한다.
+	void TestCorruptFiles()
+	{
+		std::vector<std::uint8_t> library(4096);
+		for (size_t i = 0; i < library.size(); ++i)
+			library[i] = (std::uint8_t)(i * 17);
+		const std::vector<std::uint8_t> file = PipelineCacheFile::Pack(library.data(), library.size());
+		const size_t headerSize = file.size() - library.size();
+
+		auto rejects = [](const std::vector<std::uint8_t>& data)
+		{
+			const void* unpacked = &data;
+			size_t unpackedSize = 1;
+			bool accepted = PipelineCacheFile::Unpack(data.data(), data.size(), unpacked, unpackedSize);
+			// 실패하면 출력도 비운다.
+			return !accepted && unpacked == nullptr && unpackedSize == 0;
+		};
+
+		// 헤더의 모든 바이트 (마법 값, 버전, 크기, 해시)
+		for (size_t i = 0; i < headerSize; ++i)
+		{
+			std::vector<std::uint8_t> corrupt = file;
+			corrupt[i] ^= 0x01;
+			if (!CHECK(rejects(corrupt)))
+				std::printf("  header byte %zu flipped and still accepted\n", i);
+		}
+
+		// 다음 버전 파일
+		std::vector<std::uint8_t> nextVersion = file;
+		std::uint32_t version = PipelineCacheFile::Version + 1;
+		std::memcpy(nextVersion.data() + 4, &version, sizeof(version));
+		CHECK(rejects(nextVersion));
+
+		// 기록 도중 끊긴 파일과 뒤에 쓰레기가 붙은 파일
+		CHECK(rejects(std::vector<std::uint8_t>(file.begin(), file.end() - 1)));
+		CHECK(rejects(std::vector<std::uint8_t>(file.begin(), file.begin() + headerSize)));
+		CHECK(rejects(std::vector<std::uint8_t>(file.begin(), file.begin() + headerSize - 1)));
+		std::vector<std::uint8_t> extended = file;
+		extended.push_back(0);
+		CHECK(rejects(extended));
+
+		// 라이브러리 내용 (해시)
+		for (size_t i = headerSize; i < file.size(); i += 509)
+		{
+			std::vector<std::uint8_t> corrupt = file;
+			corrupt[i] ^= 0x80;
+			CHECK(rejects(corrupt));
+		}
+
+		CHECK(rejects(std::vector<std::uint8_t>()));
+		const void* unpacked = nullptr;
+		size_t unpackedSize = 0;
+		CHECK(!PipelineCacheFile::Unpack(nullptr, 100, unpacked, unpackedSize));
+	}
+}
+
+int main(int, char**)
+{
+	TestHashHelpers();
+	TestDescHash();
+	TestRoundTrip();
+	TestCorruptFiles();
+
+	return Test::Finish("PipelineCacheFileTest");
+}
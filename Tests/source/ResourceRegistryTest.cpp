@@ -0,0 +1,212 @@
+#include "TestCommon.h"
+#include "ResourceRegistry.h"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	// 이름 상수는 컴파일 시간에 계산된다.
+	constexpr NameHash OpaqueName = HashName("opaque");
+	static_assert(OpaqueName != HashName("opaque_wireframe"), "distinct names must hash differently");
+
+	struct PipelineState
+	{
+		int Id = 0;
+	};
+
+	typedef ResourceRegistry<std::unique_ptr<PipelineState>> PipelineRegistry;
+
+	std::unique_ptr<PipelineState> MakePipeline(int id)
+	{
+		std::unique_ptr<PipelineState> pipeline(new PipelineState());
+		pipeline->Id = id;
+		return pipeline;
+	}
+
+	void TestHashName()
+	{
+		// FNV-1a 64비트 기준 값
+		CHECK(HashName("") == 14695981039346656037ull);
+		CHECK(HashName("a") == 0xaf63dc4c8601ec8cull);
+		CHECK(HashName("foobar") == 0x85944171f73967e8ull);
+		CHECK(OpaqueName == HashName(std::string("opaque").c_str()));
+	}
+
+	void TestAddFind()
+	{
+		PipelineRegistry registry;
+		PipelineRegistry::HandleType a = registry.Add(HashName("a"), MakePipeline(1));
+		PipelineRegistry::HandleType b = registry.Add(HashName("b"), MakePipeline(2));
+		CHECK(a.IsValid() && b.IsValid() && a != b);
+		CHECK(registry.Find(HashName("a")) == a);
+		CHECK(registry[b]->Id == 2);
+		CHECK(registry.GetCount() == 2 && registry.GetSlotCount() == 2);
+		CHECK(!registry.Find(HashName("missing")).IsValid());
+		CHECK(!registry.IsValid(PipelineRegistry::HandleType()));
+
+		int sum = 0;
+		registry.ForEach([&](PipelineRegistry::HandleType handle, std::unique_ptr<PipelineState>& value)
+		{
+			CHECK(registry.IsValid(handle));
+			sum += value->Id;
+		});
+		CHECK(sum == 3);
+	}
+
+	// 지운 칸을 다시 쓰면 세대가 올라가서 이전 핸들은 새 항목을 가리키지 않는다.
+	void TestStaleGeneration()
+	{
+		PipelineRegistry registry;
+		PipelineRegistry::HandleType a = registry.Add(HashName("a"), MakePipeline(1));
+		PipelineRegistry::HandleType b = registry.Add(HashName("b"), MakePipeline(2));
+
+		registry.Remove(a);
+		CHECK(!registry.IsValid(a));
+		CHECK(registry.TryGet(a) == nullptr);
+		CHECK(!registry.Find(HashName("a")).IsValid());
+		CHECK(registry.GetCount() == 1);
+
+		PipelineRegistry::HandleType c = registry.Add(HashName("c"), MakePipeline(3));
+		CHECK(c.Index == a.Index && c.Generation == a.Generation + 1);
+		CHECK(!registry.IsValid(a) && registry.IsValid(c));
+		CHECK(registry.TryGet(a) == nullptr && registry.TryGet(c) != nullptr && (*registry.TryGet(c))->Id == 3);
+
+		// 이전 핸들로 지워도 새 항목은 남는다. 두 번 지워도 개수가 어긋나지 않는다.
+		registry.Remove(a);
+		CHECK(registry.IsValid(c) && registry.GetCount() == 2);
+		registry.Remove(c);
+		registry.Remove(c);
+		CHECK(registry.GetCount() == 1 && registry.IsValid(b));
+
+		// 같은 이름을 다시 등록하면 새 세대의 핸들이 나온다.
+		PipelineRegistry::HandleType a2 = registry.Add(HashName("a"), MakePipeline(4));
+		CHECK(registry.Find(HashName("a")) == a2 && a2 != a);
+
+		// 칸 범위 밖의 핸들
+		PipelineRegistry::HandleType outOfRange;
+		outOfRange.Index = 100;
+		CHECK(!registry.IsValid(outOfRange) && registry.TryGet(outOfRange) == nullptr);
+	}
+
+	// 무작위로 추가/삭제를 반복하면서 지금까지 나온 모든 핸들의 유효성을 기준 상태와 비교한다.
+	void TestRandomChurn(std::uint32_t operationCount)
+	{
+		std::mt19937 random(22);
+		PipelineRegistry registry;
+		struct Issued
+		{
+			PipelineRegistry::HandleType Handle;
+			int Id;
+			bool Alive;
+		};
+		std::vector<Issued> issued;
+		std::vector<size_t> alive;
+		int nextId = 0;
+
+		for (std::uint32_t op = 0; op < operationCount; ++op)
+		{
+			if (alive.empty() || random() % 3 != 0)
+			{
+				std::string name = "resource_" + std::to_string(nextId);
+				Issued entry;
+				entry.Id = nextId++;
+				entry.Handle = registry.Add(HashName(name.c_str()), MakePipeline(entry.Id));
+				entry.Alive = true;
+				alive.push_back(issued.size());
+				issued.push_back(entry);
+			}
+			else
+			{
+				size_t pick = random() % alive.size();
+				Issued& entry = issued[alive[pick]];
+				registry.Remove(entry.Handle);
+				entry.Alive = false;
+				alive[pick] = alive.back();
+				alive.pop_back();
+			}
+		}
+
+		CHECK(registry.GetCount() == alive.size());
+		CHECK(registry.GetSlotCount() < issued.size());
+		for (const Issued& entry : issued)
+		{
+			if (!CHECK(registry.IsValid(entry.Handle) == entry.Alive))
+				break;
+			if (entry.Alive && !CHECK(registry[entry.Handle]->Id == entry.Id))
+				break;
+		}
+	}
+
+	/// <summary>
+	/// 그리기마다 PSO를 찾는 비용. std::string 키 해시 맵과 핸들 색인, 문자열 상수로 찾는 경우를 비교한다.
+	/// </summary>
+	void BenchmarkLookup(std::uint32_t drawCount)
+	{
+		const int kindCount = 64;
+		std::unordered_map<std::string, std::unique_ptr<PipelineState>> map;
+		PipelineRegistry registry;
+		std::vector<std::string> names;
+		std::vector<PipelineRegistry::HandleType> handles;
+		for (int i = 0; i < kindCount; ++i)
+		{
+			names.push_back("pipeline_state_" + std::to_string(i));
+			map[names.back()] = MakePipeline(i);
+			handles.push_back(registry.Add(HashName(names.back().c_str()), MakePipeline(i)));
+		}
+
+		std::mt19937 random(220);
+		std::vector<int> sequence(drawCount);
+		long long expected = 0;
+		for (int& kind : sequence)
+		{
+			kind = (int)(random() % kindCount);
+			expected += kind;
+		}
+
+		long long mapSum = 0;
+		Test::Stopwatch stopwatch;
+		for (int kind : sequence)
+			mapSum += map[names[kind]]->Id;
+		double mapMs = stopwatch.ElapsedMs();
+
+		long long handleSum = 0;
+		stopwatch.Reset();
+		for (int kind : sequence)
+			handleSum += registry[handles[kind]]->Id;
+		double handleMs = stopwatch.ElapsedMs();
+
+		// mPSOs["opaque"]처럼 문자열 상수로 찾으면 호출마다 std::string이 만들어진다.
+		std::unordered_map<std::string, std::unique_ptr<PipelineState>> literalMap;
+		literalMap["opaque"] = MakePipeline(0);
+		literalMap["opaque_wireframe"] = MakePipeline(1);
+		long long literalSum = 0;
+		stopwatch.Reset();
+		for (std::uint32_t i = 0; i < drawCount; ++i)
+			literalSum += (i & 1) ? literalMap["opaque_wireframe"]->Id : literalMap["opaque"]->Id;
+		double literalMs = stopwatch.ElapsedMs();
+
+		CHECK(mapSum == expected && handleSum == expected);
+		CHECK(literalSum == drawCount / 2);
+		std::printf("  %u lookups: string map %.2f ns, handle %.2f ns, string literal key %.2f ns per lookup\n",
+			drawCount, mapMs * 1e6 / drawCount, handleMs * 1e6 / drawCount, literalMs * 1e6 / drawCount);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestHashName();
+	TestAddFind();
+	TestStaleGeneration();
+	TestRandomChurn(quick ? 5000 : 100000);
+	BenchmarkLookup(quick ? 10000 : 1000000);
+
+	return Test::Finish("ResourceRegistryTest");
+}
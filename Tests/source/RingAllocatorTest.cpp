@@ -0,0 +1,143 @@
+#include "TestCommon.h"
+#include "RingAllocator.h"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <random>
+
+using namespace Engine;
+
+namespace
+{
+	struct LiveRange
+	{
+		std::uint64_t Offset;
+		std::uint64_t Size;
+		std::uint64_t FenceValue; // 이 값이 완료되기 전까지 GPU가 읽을 수 있는 구간
+	};
+
+	bool Overlaps(std::uint64_t offset, std::uint64_t size, const LiveRange& range)
+	{
+		return offset < range.Offset + range.Size && range.Offset < offset + size;
+	}
+
+	// 크기와 정렬이 무작위인 할당을 여러 프레임 동안 반복하며 GPU가 몇 프레임 늦게 따라오는 가짜 펜스로 회수한다.
+	// 완료되지 않은 펜스에 묶인 구간과 새 할당이 겹치면 실패다.
+	void TestRandomFrames(std::uint32_t frameCount)
+	{
+		const std::uint64_t capacity = 64 * 1024;
+		const std::uint32_t maxFramesInFlight = 6;
+
+		RingAllocator ring(capacity);
+		std::mt19937 random(11);
+
+		std::uint64_t submittedFence = 0;
+		std::uint64_t completedFence = 0;
+		std::uint64_t waits = 0;
+		std::uint64_t allocations = 0;
+		std::deque<LiveRange> live;
+
+		auto retireLive = [&]()
+		{
+			live.erase(std::remove_if(live.begin(), live.end(),
+				[&](const LiveRange& range) { return range.FenceValue <= completedFence; }), live.end());
+		};
+
+		RingAllocator::WaitForFence waitForFence = [&](std::uint64_t fenceValue)
+		{
+			// 아직 제출되지 않은 펜스를 기다리면 영원히 끝나지 않는다.
+			CHECK(fenceValue <= submittedFence);
+			CHECK(fenceValue > completedFence);
+			completedFence = fenceValue;
+			++waits;
+			return completedFence;
+		};
+
+		for (std::uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			// 한 프레임의 할당은 자기 자신을 기다릴 수 없으므로 용량의 1/4 안에서 끝낸다.
+			std::uint64_t frameBytes = 0;
+			std::uint32_t allocationCount = 1 + random() % 40;
+			for (std::uint32_t i = 0; i < allocationCount; ++i)
+			{
+				// 대부분은 작은 상수 버퍼 크기이고 가끔 큰 블록이 섞인다.
+				std::uint64_t size = (random() % 8 == 0) ? 1 + random() % (capacity / 8) : 1 + random() % 1024;
+				std::uint64_t alignment = 1ull << (random() % 9);
+				if (frameBytes + size + alignment > capacity / 4)
+					break;
+				frameBytes += size + alignment;
+
+				std::uint64_t offset = ring.Allocate(size, alignment, waitForFence);
+				retireLive();
+				if (!CHECK(offset != RingAllocator::InvalidOffset))
+					continue;
+				++allocations;
+
+				CHECK(offset % alignment == 0);
+				CHECK(offset + size <= capacity);
+				for (const LiveRange& range : live)
+					CHECK(!Overlaps(offset, size, range));
+
+				live.push_back({ offset, size, submittedFence + 1 });
+				CHECK(ring.GetUsedBytes() <= capacity);
+			}
+
+			ring.EndFrame(++submittedFence);
+
+			// GPU는 0 ~ maxFramesInFlight 프레임 늦게 따라온다.
+			std::uint64_t lag = random() % (maxFramesInFlight + 1);
+			if (submittedFence > lag)
+				completedFence = std::max(completedFence, submittedFence - lag);
+			ring.Retire(completedFence);
+			retireLive();
+		}
+
+		// 모든 프레임이 끝나면 링이 완전히 비어야 한다.
+		completedFence = submittedFence;
+		ring.Retire(completedFence);
+		CHECK(ring.GetUsedBytes() == 0);
+		CHECK(!ring.HasPendingFrames());
+
+		const RingAllocatorStats& stats = ring.GetStats();
+		CHECK(stats.AllocationCount == allocations);
+		CHECK(stats.StallCount == waits);
+		// 이 설정이면 랩어라운드와 대기가 모두 일어나야 검사가 의미 있다.
+		CHECK(stats.WrapCount > 0);
+		CHECK(stats.StallCount > 0);
+
+		std::printf("  %u frames, %llu allocations, %llu wraps, %llu stalls, peak %llu / %llu bytes\n",
+			frameCount, (unsigned long long)allocations, (unsigned long long)stats.WrapCount,
+			(unsigned long long)stats.StallCount, (unsigned long long)stats.PeakUsedBytes, (unsigned long long)capacity);
+	}
+
+	void TestLimits()
+	{
+		RingAllocator ring(1024);
+		auto neverWaits = [](std::uint64_t fenceValue) { CHECK(false); return fenceValue; };
+
+		// 진행 중인 프레임이 없으면 기다리지 않고 실패한다.
+		CHECK(ring.Allocate(2048, 1, neverWaits) == RingAllocator::InvalidOffset);
+		CHECK(ring.TryAllocate(1024, 256) == 0);
+		CHECK(ring.TryAllocate(1, 1) == RingAllocator::InvalidOffset);
+
+		// 같은 프레임 안에서는 회수할 것이 없으므로 Allocate도 실패한다.
+		CHECK(ring.Allocate(1, 1, neverWaits) == RingAllocator::InvalidOffset);
+
+		ring.EndFrame(1);
+		ring.Retire(0);
+		CHECK(ring.GetUsedBytes() == 1024);
+		ring.Retire(1);
+		CHECK(ring.GetUsedBytes() == 0);
+		CHECK(ring.TryAllocate(100, 64) == 0);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestLimits();
+	TestRandomFrames(quick ? 2000 : 100000);
+
+	return Test::Finish("RingAllocatorTest");
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace Test
+{
+	/// <summary>
+	/// 실패한 검사 수. Finish가 이 값으로 종료 코드를 정해 ctest가 실패를 알 수 있게 한다.
+	/// </summary>
+	inline int& FailureCount()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	inline bool Check(bool condition, const char* expression, const char* file, int line)
+	{
+		if (!condition)
+		{
+			// 반복문 안의 검사가 한꺼번에 실패해도 출력이 넘치지 않도록 앞의 몇 개만 보여준다.
+			if (++FailureCount() <= 20)
+				std::fprintf(stderr, "%s(%d): CHECK failed: %s\n", file, line, expression);
+		}
+		return condition;
+	}
+
+	/// <summary>
+	/// --quick이 있으면 반복 횟수와 벤치마크 크기를 줄인다. ctest는 항상 --quick으로 실행한다.
+	/// </summary>
+	inline bool IsQuick(int argc, char** argv)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(argv[i], "--quick") == 0)
+				return true;
+		}
+		return false;
+	}
+
+	class Stopwatch
+	{
+	public:
+		Stopwatch() : mStart(std::chrono::steady_clock::now()) {}
+
+		void Reset() { mStart = std::chrono::steady_clock::now(); }
+		double ElapsedMs() const
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mStart).count();
+		}
+
+	private:
+		std::chrono::steady_clock::time_point mStart;
+	};
+
+	/// <summary>
+	/// 결과를 출력하고 main이 반환할 종료 코드를 돌려준다.
+	/// </summary>
+	inline int Finish(const char* name)
+	{
+		if (FailureCount() == 0)
+		{
+			std::printf("%s: passed\n", name);
+			return 0;
+		}
+		std::printf("%s: %d check(s) failed\n", name, FailureCount());
+		return 1;
+	}
+}
+
+#define CHECK(expression) ::Test::Check((expression), #expression, __FILE__, __LINE__)
@@ -0,0 +1,232 @@
+#include "TestCommon.h"
+#include "JobSystem.h"
+#include "TransformArray.h"
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	// 항목마다 성분이 모두 다른 행 우선 행렬. 전치가 틀리면 값이 바로 어긋난다.
+	void MakeMatrix(size_t index, float* matrix)
+	{
+		for (int k = 0; k < 16; ++k)
+			matrix[k] = (float)(index * 16 + k) * 0.5f;
+	}
+
+	/// <summary>
+	/// 업로드 힙을 흉내 낸 출력 버퍼. offset만큼 정렬에서 어긋나게 해서 흘려 쓰기가 아닌 경로도 확인한다.
+	/// </summary>
+	class OutputBuffer
+	{
+	public:
+		OutputBuffer(size_t size, size_t offset) : mStorage(size + 256 + offset)
+		{
+			std::uintptr_t address = reinterpret_cast<std::uintptr_t>(mStorage.data());
+			mData = mStorage.data() + (256 - address % 256) % 256 + offset;
+			mSize = size;
+		}
+
+		std::uint8_t* GetData() { return mData; }
+		void Fill(std::uint8_t value) { std::memset(mData, value, mSize); }
+
+	private:
+		std::vector<std::uint8_t> mStorage;
+		std::uint8_t* mData;
+		size_t mSize;
+	};
+
+	// dst + index * stride에 index 행렬의 전치가 들어 있는지 확인한다.
+	bool IsTransposed(const std::uint8_t* dst, size_t stride, size_t index)
+	{
+		float matrix[16];
+		float written[16];
+		MakeMatrix(index, matrix);
+		std::memcpy(written, dst + index * stride, sizeof(written));
+		for (int r = 0; r < 4; ++r)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				if (written[r * 4 + c] != matrix[c * 4 + r])
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// 무작위 더티 패턴을 Flush하고 더티 항목만 전치되어 기록되는지 확인한다.
+	void TestFlush(JobSystem& jobs, std::uint32_t trialCount)
+	{
+		std::mt19937 random(19);
+		for (std::uint32_t trial = 0; trial < trialCount; ++trial)
+		{
+			size_t count = 1 + random() % 20000;
+			JobSystem* flushJobs = trial % 2 ? &jobs : nullptr;
+			// 상수 버퍼(256), 구조적 버퍼(64), 정렬되지 않은 보폭(72) 순서로 돌린다.
+			const size_t strides[] = { 256, 64, 72 };
+			size_t stride = strides[trial % 3];
+			OutputBuffer output(count * stride, trial % 5 == 4 ? 4 : 0);
+			std::uint8_t* dst = output.GetData();
+
+			TransformArray transforms(3);
+			transforms.Resize(count);
+			CHECK(transforms.Flush(0, dst, stride, flushJobs) == count);
+			CHECK(transforms.Flush(0, dst, stride, flushJobs) == 0);
+
+			// 흩어진 항목과 워드 경계를 넘는 연속 구간을 바꾼다.
+			std::vector<bool> expected(count, false);
+			size_t expectedCount = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (random() % 7 == 0 || (i > count / 3 && i < count / 3 + 300))
+				{
+					float matrix[16];
+					MakeMatrix(i, matrix);
+					transforms.Set(i, matrix);
+					expected[i] = true;
+					++expectedCount;
+				}
+			}
+
+			output.Fill(0xCD);
+			CHECK(transforms.Flush(0, dst, stride, flushJobs) == expectedCount);
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (expected[i])
+				{
+					if (!CHECK(IsTransposed(dst, stride, i)))
+						break;
+				}
+				else if (!CHECK(dst[i * stride] == 0xCD))
+				{
+					break;
+				}
+				CHECK(!transforms.IsDirty(0, i));
+			}
+
+			// 다른 슬롯은 영향을 받지 않고 Resize 이후 모든 항목이 더티로 남아 있다.
+			CHECK(transforms.IsDirty(1, 0) && transforms.IsDirty(1, count - 1));
+			CHECK(transforms.Flush(2, dst, stride, flushJobs) == count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (expected[i] && !CHECK(IsTransposed(dst, stride, i)))
+					break;
+			}
+		}
+	}
+
+	// 줄인 뒤에는 범위 밖 항목을 기록하지 않는다.
+	void TestResize()
+	{
+		TransformArray transforms;
+		transforms.Resize(200);
+		transforms.Resize(70);
+		OutputBuffer output(200 * 64, 0);
+		output.Fill(0xCD);
+		CHECK(transforms.Flush(0, output.GetData(), 64) == 70);
+		CHECK(output.GetData()[70 * 64] == 0xCD);
+
+		transforms.MarkAllDirty();
+		CHECK(transforms.Flush(0, output.GetData(), 64) == 70);
+
+		float matrix[16];
+		MakeMatrix(69, matrix);
+		transforms.Set(69, matrix);
+		float read[16];
+		transforms.Get(69, read);
+		CHECK(std::memcmp(matrix, read, sizeof(matrix)) == 0);
+	}
+
+	/// <summary>
+	/// 행 우선 배열을 한 항목씩 전치해서 복사하는 방식과 TransformArray::Flush를 비교한다.
+	/// 보폭은 구조적 버퍼와 같은 64 바이트.
+	/// </summary>
+	void BenchmarkFlush(JobSystem& jobs, size_t count, std::uint32_t iterations)
+	{
+		const size_t stride = 64;
+		TransformArray transforms;
+		transforms.Resize(count);
+		std::vector<float> source(count * 16);
+		for (size_t i = 0; i < count; ++i)
+		{
+			MakeMatrix(i, &source[i * 16]);
+			transforms.Set(i, &source[i * 16]);
+		}
+		OutputBuffer output(count * stride, 0);
+		std::uint8_t* dst = output.GetData();
+
+		auto measure = [&](const char* name, auto&& fn)
+		{
+			fn();
+			Test::Stopwatch stopwatch;
+			for (std::uint32_t k = 0; k < iterations; ++k)
+				fn();
+			double ms = stopwatch.ElapsedMs() / iterations;
+			std::printf("  %7zu transforms, %-26s %8.3f ms (%.2f ns per transform)\n", count, name, ms, ms * 1e6 / count);
+		};
+
+		measure("AoS transpose + memcpy", [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float* matrix = &source[i * 16];
+				float transposed[16];
+				for (int r = 0; r < 4; ++r)
+				{
+					for (int c = 0; c < 4; ++c)
+						transposed[r * 4 + c] = matrix[c * 4 + r];
+				}
+				std::memcpy(dst + i * stride, transposed, sizeof(transposed));
+			}
+		});
+		measure("Flush, all dirty", [&]()
+		{
+			transforms.MarkAllDirty();
+			transforms.Flush(0, dst, stride);
+		});
+		measure("Flush, all dirty, jobs", [&]()
+		{
+			transforms.MarkAllDirty();
+			transforms.Flush(0, dst, stride, &jobs);
+		});
+		measure("Flush, 1% dirty", [&]()
+		{
+			for (size_t i = 0; i < count; i += 100)
+				transforms.Set(i, &source[i * 16]);
+			transforms.Flush(0, dst, stride);
+		});
+		measure("Flush, clean", [&]()
+		{
+			transforms.Flush(0, dst, stride);
+		});
+
+		// 측정 후에도 결과가 맞는지 확인한다.
+		for (size_t i = 0; i < count; i += 997)
+			CHECK(IsTransposed(dst, stride, i));
+		CHECK(IsTransposed(dst, stride, count - 1));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+	JobSystem jobs(3);
+
+	TestFlush(jobs, quick ? 12 : 60);
+	TestResize();
+	if (quick)
+	{
+		BenchmarkFlush(jobs, 10000, 2);
+	}
+	else
+	{
+		BenchmarkFlush(jobs, 10000, 200);
+		BenchmarkFlush(jobs, 100000, 20);
+		BenchmarkFlush(jobs, 1000000, 5);
+	}
+
+	return Test::Finish("TransformArrayTest");
+}
@@ -0,0 +1,149 @@
+#include "TestCommon.h"
+#include "UploadBatchQueue.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+
+namespace
+{
+	// 스테이징 버퍼 대신 배치에 들어간 복사 크기와 티켓을 기록한다.
+	struct BatchRecord
+	{
+		std::vector<std::uint64_t> CopySizes;
+		std::vector<std::uint64_t> Tickets;
+	};
+
+	void TestTickets()
+	{
+		UploadBatchQueue<BatchRecord> queue(1024, 4, 101);
+		CHECK(!queue.HasOpenBatch());
+		CHECK(queue.GetLastClosedFenceValue() == 100);
+
+		UploadTicket first = queue.AddCopy(16);
+		UploadTicket second = queue.AddCopy(16);
+		CHECK(first.FenceValue == 101 && second.FenceValue == 101);
+		CHECK(queue.IsOpen(first));
+
+		CHECK(queue.CloseBatch() == 101);
+		CHECK(!queue.IsOpen(first));
+		CHECK(!queue.HasOpenBatch());
+		CHECK(queue.GetLastClosedFenceValue() == 101);
+
+		// 다음 배치의 티켓은 다음 펜스 값을 가리키고, 이전 배치의 티켓은 열린 배치로 보지 않는다.
+		UploadTicket third = queue.AddCopy(16);
+		CHECK(third.FenceValue == 102);
+		CHECK(queue.IsOpen(third) && !queue.IsOpen(first));
+
+		CHECK(!UploadBatchQueue<BatchRecord>::IsComplete(first, 100));
+		CHECK(UploadBatchQueue<BatchRecord>::IsComplete(first, 101));
+		CHECK(UploadBatchQueue<BatchRecord>::IsComplete(UploadTicket(), 0));
+
+		// 완료되지 않은 배치는 회수하지 않는다.
+		CHECK(queue.Retire(100) == 0);
+		CHECK(queue.HasBatchesInFlight());
+		CHECK(queue.Retire(101) == 1);
+		CHECK(!queue.HasBatchesInFlight());
+	}
+
+	// UploadBatcher와 같은 방식(복사를 추가한 뒤 IsBatchFull이면 닫기)으로 무작위 크기의 복사를 넣고
+	// 배치가 크기와 개수 한도에서 나뉘는지, 회수가 펜스 순서를 지키는지 확인한다.
+	void TestBatchSplitting(std::uint32_t copyCount)
+	{
+		const std::uint64_t maxBatchBytes = 4 * 1024 * 1024;
+		const std::uint32_t maxBatchCopies = 64;
+
+		UploadBatchQueue<BatchRecord> queue(maxBatchBytes, maxBatchCopies);
+		std::mt19937 random(13);
+
+		std::uint64_t totalBytes = 0;
+		std::uint64_t closedByLimit = 0;
+		std::uint64_t completedFence = 0;
+		std::uint64_t lastRetiredFence = 0;
+		std::uint64_t retiredCopies = 0;
+
+		auto onRetire = [&](BatchRecord& batch)
+		{
+			// 같은 배치의 티켓은 모두 같고, 배치는 제출 순서대로 회수된다.
+			CHECK(!batch.Tickets.empty());
+			std::uint64_t fenceValue = batch.Tickets.front();
+			for (std::uint64_t ticket : batch.Tickets)
+				CHECK(ticket == fenceValue);
+			CHECK(fenceValue == lastRetiredFence + 1);
+			CHECK(fenceValue <= completedFence);
+			lastRetiredFence = fenceValue;
+
+			// 한도에 도달하기 전까지만 복사를 더하므로 마지막 복사를 빼면 크기가 한도 아래다.
+			std::uint64_t bytes = 0;
+			for (std::uint64_t size : batch.CopySizes)
+				bytes += size;
+			CHECK(batch.CopySizes.size() <= maxBatchCopies);
+			CHECK(bytes - batch.CopySizes.back() < maxBatchBytes);
+			retiredCopies += batch.CopySizes.size();
+		};
+
+		for (std::uint32_t i = 0; i < copyCount; ++i)
+		{
+			// 대부분은 작은 메쉬이고 가끔 큰 텍스처가 섞인다.
+			std::uint64_t size = (random() % 16 == 0) ? 1 + random() % (3 * 1024 * 1024) : 1 + random() % (64 * 1024);
+			UploadTicket ticket = queue.AddCopy(size);
+			CHECK(ticket.FenceValue == queue.GetLastClosedFenceValue() + 1);
+			CHECK(queue.IsOpen(ticket));
+			queue.GetOpenPayload().CopySizes.push_back(size);
+			queue.GetOpenPayload().Tickets.push_back(ticket.FenceValue);
+			totalBytes += size;
+
+			if (queue.IsBatchFull())
+			{
+				++closedByLimit;
+				CHECK(queue.CloseBatch() == ticket.FenceValue);
+				CHECK(!queue.IsOpen(ticket));
+			}
+			else if (random() % 50 == 0)
+			{
+				// 로딩 중 프레임 끝 등에서 한도 전에 닫는 경우
+				queue.CloseBatch();
+			}
+
+			// 복사 큐는 배치 두 개 정도 뒤처져 따라온다.
+			if (random() % 8 == 0 && queue.GetLastClosedFenceValue() > completedFence + 2)
+			{
+				completedFence = queue.GetLastClosedFenceValue() - 2;
+				queue.Retire(completedFence, onRetire);
+			}
+		}
+
+		if (queue.HasOpenBatch())
+			queue.CloseBatch();
+		completedFence = queue.GetLastClosedFenceValue();
+		queue.Retire(completedFence, onRetire);
+		CHECK(!queue.HasBatchesInFlight());
+		CHECK(lastRetiredFence == completedFence);
+		CHECK(retiredCopies == copyCount);
+
+		const UploadBatchStats& stats = queue.GetStats();
+		CHECK(stats.Copies == copyCount);
+		CHECK(stats.Bytes == totalBytes);
+		CHECK(stats.Batches == completedFence);
+		CHECK(stats.FullBatches == closedByLimit);
+		CHECK(stats.MaxCopiesPerBatch <= maxBatchCopies);
+		// 두 한도 모두에서 배치가 나뉘어야 검사가 의미 있다.
+		CHECK(stats.MaxCopiesPerBatch == maxBatchCopies);
+		CHECK(stats.FullBatches > 0);
+
+		std::printf("  %u copies, %llu batches (%llu closed at a limit), %.1f copies per batch\n",
+			copyCount, (unsigned long long)stats.Batches, (unsigned long long)stats.FullBatches,
+			(double)stats.Copies / stats.Batches);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestTickets();
+	TestBatchSplitting(quick ? 5000 : 200000);
+
+	return Test::Finish("UploadBatchQueueTest");
+}
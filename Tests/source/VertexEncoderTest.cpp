@@ -0,0 +1,262 @@
+#include "TestCommon.h"
+#include "VertexEncoder.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace Engine;
+using namespace DirectX;
+
+namespace
+{
+	typedef GeometryGenerator::Vertex Vertex;
+	typedef GeometryGenerator::MeshData MeshData;
+	typedef GeometryGenerator::uint32 uint32;
+
+	const char* const PositionNames[] = { "Float3", "Half4", "Unorm16x4" };
+
+	// half는 가수가 10비트이므로 가장 가까운 값으로 반올림하면 상대 오차가 2^-11 이하이다.
+	// 아주 작은 값은 비정규 half의 간격(2^-24)의 절반이 한도가 된다.
+	const float HalfRelativeError = 1.0f / 2048.0f;
+	const float HalfAbsoluteError = 1.0f / (1 << 25);
+
+	// 성분마다 snorm16으로 양자화한 팔면체 좌표를 복원했을 때의 최대 각도 오차보다 조금 큰 값 (라디안)
+	const float OctahedralAngleError = 1e-4f;
+
+	struct NamedMesh
+	{
+		std::string Name;
+		MeshData Mesh;
+	};
+
+	std::vector<NamedMesh> CreateMeshes()
+	{
+		GeometryGenerator generator;
+		std::vector<NamedMesh> meshes;
+		meshes.push_back({ "geosphere", generator.CreateGeosphere(3.0f, 4) });
+		meshes.push_back({ "sphere", generator.CreateSphere(0.5f, 32, 24) });
+		meshes.push_back({ "grid", generator.CreateGrid(200.0f, 80.0f, 60, 90) });
+		meshes.push_back({ "cylinder", generator.CreateCylinder(1.5f, 0.5f, 4.0f, 20, 6) });
+		meshes.push_back({ "box", generator.CreateBox(1.0f, 2.0f, 3.0f, 2) });
+		return meshes;
+	}
+
+	bool WithinHalfError(float decoded, float original)
+	{
+		return std::fabs(decoded - original) <= std::fabs(original) * HalfRelativeError + HalfAbsoluteError;
+	}
+
+	float Length(const XMFLOAT3& v)
+	{
+		return XMVectorGetX(XMVector3Length(XMLoadFloat3(&v)));
+	}
+
+	// 단위 벡터 사이의 각도. 작은 각도에서는 float acos의 정밀도가 부족하므로 atan2를 쓴다.
+	float AngleBetween(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		XMVECTOR va = XMLoadFloat3(&a);
+		XMVECTOR vb = XMLoadFloat3(&b);
+		return std::atan2(XMVectorGetX(XMVector3Length(XMVector3Cross(va, vb))), XMVectorGetX(XMVector3Dot(va, vb)));
+	}
+
+	// 길이가 0인 벡터는 팔면체 인코딩으로 보존되지 않으므로 건너뛴다.
+	bool CheckDirection(const XMFLOAT3& decoded, const XMFLOAT3& original, float& maxAngle)
+	{
+		float length = Length(original);
+		if (length < 1e-6f)
+			return true;
+
+		XMFLOAT3 unit;
+		XMStoreFloat3(&unit, XMVector3Normalize(XMLoadFloat3(&original)));
+		float angle = AngleBetween(decoded, unit);
+		maxAngle = std::max(maxAngle, angle);
+		return CHECK(std::fabs(Length(decoded) - 1.0f) < 1e-5f) && CHECK(angle <= OctahedralAngleError);
+	}
+
+	/// <summary>
+	/// 위치 인코딩마다 모든 정점을 복원해 속성별 오차가 양자화 한도 안에 있는지 확인한다.
+	/// </summary>
+	void TestRoundTrip()
+	{
+		for (const NamedMesh& entry : CreateMeshes())
+		{
+			const std::vector<Vertex>& vertices = entry.Mesh.Vertices;
+
+			XMFLOAT3 boundsMin(+FLT_MAX, +FLT_MAX, +FLT_MAX);
+			XMFLOAT3 boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+			for (const Vertex& v : vertices)
+			{
+				XMStoreFloat3(&boundsMin, XMVectorMin(XMLoadFloat3(&boundsMin), XMLoadFloat3(&v.Position)));
+				XMStoreFloat3(&boundsMax, XMVectorMax(XMLoadFloat3(&boundsMax), XMLoadFloat3(&v.Position)));
+			}
+			const float size[3] = { boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y, boundsMax.z - boundsMin.z };
+
+			for (int encoding = 0; encoding < 3; ++encoding)
+			{
+				VertexFormat format;
+				format.Position = (PositionEncoding)encoding;
+				EncodedVertices encoded = VertexEncoder::Encode(vertices, format);
+				if (!CHECK(encoded.VertexCount == vertices.size()) ||
+					!CHECK(encoded.Data.size() == vertices.size() * VertexEncoder::GetVertexStride(format)))
+					continue;
+
+				float maxPositionError = 0.0f;
+				float maxNormalAngle = 0.0f;
+				float maxTangentAngle = 0.0f;
+				bool valid = true;
+				for (uint32 i = 0; i < encoded.VertexCount && valid; ++i)
+				{
+					Vertex decoded = VertexEncoder::Decode(encoded, format, i);
+					const Vertex& original = vertices[i];
+					const float* d = &decoded.Position.x;
+					const float* o = &original.Position.x;
+					const float* center = &encoded.PositionOffset.x;
+
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						float error = std::fabs(d[axis] - o[axis]);
+						maxPositionError = std::max(maxPositionError, error);
+						switch (format.Position)
+						{
+						case PositionEncoding::Float3:
+							valid = valid && CHECK(d[axis] == o[axis]);
+							break;
+						case PositionEncoding::Half4:
+							// 경계 상자 중심 기준 상대 위치를 half로 저장한다.
+							valid = valid && CHECK(WithinHalfError(d[axis] - center[axis], o[axis] - center[axis]));
+							break;
+						case PositionEncoding::Unorm16x4:
+							// 경계 상자를 65535 칸으로 나눈 격자의 절반 칸 (복원할 때의 float 오차만큼 여유를 둔다)
+							valid = valid && CHECK(error <= size[axis] / 65535.0f * 0.5f + size[axis] * 1e-6f + 1e-6f);
+							break;
+						}
+					}
+
+					valid = valid && CheckDirection(decoded.Normal, original.Normal, maxNormalAngle);
+					valid = valid && CheckDirection(decoded.TangentU, original.TangentU, maxTangentAngle);
+					valid = valid && CHECK(WithinHalfError(decoded.TexC.x, original.TexC.x) && WithinHalfError(decoded.TexC.y, original.TexC.y));
+				}
+
+				if (!valid)
+				{
+					std::printf("  %s %s: round trip error out of bounds\n", entry.Name.c_str(), PositionNames[encoding]);
+					continue;
+				}
+				if (entry.Name == "geosphere")
+				{
+					std::printf("  %-9s %-9s: max position error %.2e, normal %.2e rad, tangent %.2e rad\n",
+						entry.Name.c_str(), PositionNames[encoding], maxPositionError, maxNormalAngle, maxTangentAngle);
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// 위치 복원 행렬을 저장된 위치에 곱하면 Decode와 같은 메쉬 공간 위치가 된다.
+	/// </summary>
+	void TestPositionDecodeMatrix()
+	{
+		GeometryGenerator generator;
+		MeshData cylinder = generator.CreateCylinder(2.0f, 1.0f, 5.0f, 16, 4);
+		for (int encoding = 0; encoding < 3; ++encoding)
+		{
+			VertexFormat format;
+			format.Position = (PositionEncoding)encoding;
+			format.Normal = format.Tangent = format.TexC = false;
+			EncodedVertices encoded = VertexEncoder::Encode(cylinder.Vertices, format);
+			XMMATRIX decode = VertexEncoder::GetPositionDecodeMatrix(encoded.PositionScale, encoded.PositionOffset);
+
+			// 저장된 위치는 복원 변환을 적용하기 전의 값이다. (Unorm16은 [0, 1], Half는 중심 기준)
+			VertexFormat unscaledFormat = format;
+			EncodedVertices unscaled = encoded;
+			unscaled.PositionScale = XMFLOAT3(1.0f, 1.0f, 1.0f);
+			unscaled.PositionOffset = XMFLOAT3(0.0f, 0.0f, 0.0f);
+			for (uint32 i = 0; i < encoded.VertexCount; ++i)
+			{
+				XMFLOAT3 stored = VertexEncoder::Decode(unscaled, unscaledFormat, i).Position;
+				XMFLOAT3 transformed;
+				XMStoreFloat3(&transformed, XMVector3Transform(XMLoadFloat3(&stored), decode));
+				XMFLOAT3 decoded = VertexEncoder::Decode(encoded, format, i).Position;
+				if (!CHECK(XMVectorGetX(XMVector3Length(XMLoadFloat3(&transformed) - XMLoadFloat3(&decoded))) < 1e-5f))
+					break;
+			}
+		}
+	}
+
+	void TestLayout()
+	{
+		VertexFormat format;
+		CHECK(VertexEncoder::GetVertexStride(format) == 20);
+		format.Color = true;
+		CHECK(VertexEncoder::GetVertexStride(format) == 24);
+		format.Position = PositionEncoding::Float3;
+		CHECK(VertexEncoder::GetVertexStride(format) == 28);
+		format.Normal = format.Tangent = format.TexC = format.Color = false;
+		CHECK(VertexEncoder::GetVertexStride(format) == 12);
+
+		// 색상은 정점 끝에 R8G8B8A8_UNORM으로 저장된다.
+		GeometryGenerator generator;
+		MeshData box = generator.CreateBox(1.0f, 1.0f, 1.0f, 0);
+		VertexFormat colored;
+		colored.Color = true;
+		EncodedVertices encoded = VertexEncoder::Encode(box.Vertices, colored, XMFLOAT4(1.0f, 0.5f, 0.0f, 0.25f));
+		const std::uint8_t expected[4] = { 255, 128, 0, 64 };
+		for (uint32 i = 0; i < encoded.VertexCount; ++i)
+		{
+			if (!CHECK(std::equal(expected, expected + 4, encoded.Data.begin() + (i + 1) * encoded.VertexStride - 4)))
+				break;
+		}
+
+		EncodedVertices empty = VertexEncoder::Encode(std::vector<Vertex>(), format);
+		CHECK(empty.VertexCount == 0 && empty.Data.empty());
+	}
+
+	/// <summary>
+	/// 형식마다 정점당 바이트 수와 압축/복원 처리량을 잰다.
+	/// </summary>
+	void BenchmarkEncode(uint32 gridSize)
+	{
+		GeometryGenerator generator;
+		MeshData grid = generator.CreateGrid(100.0f, 100.0f, gridSize, gridSize);
+		double vertexCount = (double)grid.Vertices.size();
+
+		const char* const names[] = { "Float3 full", "Half4 full", "Unorm16x4 full", "Unorm16x4 position only" };
+		for (int f = 0; f < 4; ++f)
+		{
+			VertexFormat format;
+			format.Position = f < 3 ? (PositionEncoding)f : PositionEncoding::Unorm16x4;
+			if (f == 3)
+				format.Normal = format.Tangent = format.TexC = false;
+
+			Test::Stopwatch stopwatch;
+			EncodedVertices encoded = VertexEncoder::Encode(grid.Vertices, format);
+			double encodeMs = stopwatch.ElapsedMs();
+
+			stopwatch.Reset();
+			float checksum = 0.0f;
+			for (uint32 i = 0; i < encoded.VertexCount; ++i)
+				checksum += VertexEncoder::Decode(encoded, format, i).Position.x;
+			double decodeMs = stopwatch.ElapsedMs();
+			CHECK(checksum == checksum);
+
+			std::printf("  %-24s: %2u bytes per vertex (%.2fx smaller than %zu), %6.1f MB, encode %7.1f M vertices/s, decode %7.1f M vertices/s\n",
+				names[f], encoded.VertexStride, (double)sizeof(Vertex) / encoded.VertexStride, sizeof(Vertex),
+				encoded.Data.size() / 1048576.0, vertexCount / encodeMs / 1e3, vertexCount / decodeMs / 1e3);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = Test::IsQuick(argc, argv);
+
+	TestRoundTrip();
+	TestPositionDecodeMatrix();
+	TestLayout();
+	BenchmarkEncode(quick ? 100 : 1000);
+
+	return Test::Finish("VertexEncoderTest");
+}